@@ -0,0 +1,45 @@
+// Messages per second over a fork()ed child's IPC channel.
+if (process.send) {
+  var msg;
+  if (process.argv[2] === 'stats') {
+    msg = { cmd: 'stats', pid: process.pid, requests: 0, bytes: 123456789,
+            latency: [0.5, 1.25, 3.75, 12.5], route: '/api/v1/items' };
+  } else {
+    msg = { cmd: 'data', payload: new Buffer(4096) };
+  }
+
+  // Send in bursts, backing off whenever the channel says it's full.
+  (function send() {
+    for (var i = 0; i < 1000; i++) {
+      if (msg.requests !== undefined) msg.requests = i;
+      if (!process.send(msg)) break;
+    }
+    setImmediate(send);
+  })();
+  return;
+}
+
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  serialization: ['json', 'binary'],
+  payload: ['stats', 'buffer'],
+  dur: [5]
+});
+
+var fork = require('child_process').fork;
+function main(conf) {
+  var child = fork(__filename, [conf.payload], {
+    serialization: conf.serialization
+  });
+
+  var messages = 0;
+  child.on('message', function(msg) {
+    messages++;
+  });
+
+  bench.start();
+  setTimeout(function() {
+    child.kill();
+    bench.end(messages);
+  }, +conf.dur * 1000);
+}
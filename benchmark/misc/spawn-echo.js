@@ -1,12 +1,28 @@
 var common = require('../common.js');
 var bench = common.createBenchmark(main, {
-  thousands: [1]
+  thousands: [1],
+  heap: [0, 256, 1024]
 });
 
 var spawn = require('child_process').spawn;
+
+// Spawning gets slower as the parent grows when it has to fork(). Hold on
+// to `heap` MB, in Buffers so that V8's heap limit doesn't get in the way,
+// and touch every page of it so that it is really there.
+var retained = [];
+function grow(mb) {
+  for (var i = 0; i < mb; i++) {
+    var b = new Buffer(1024 * 1024);
+    b.fill(i & 0xff);
+    retained.push(b);
+  }
+}
+
 function main(conf) {
   var len = +conf.thousands * 1000;
 
+  grow(+conf.heap);
+
   bench.start();
   go(len, len);
 }
@@ -79,6 +79,7 @@ TESTS= \
 	test/test-fail-always.o \
 	test/test-fs.o \
 	test/test-fs-event.o \
+	test/test-fs-many.o \
 	test/test-fs-poll.o \
 	test/test-getaddrinfo.o \
 	test/test-get-currentexe.o \
@@ -92,6 +93,7 @@ TESTS= \
 	test/test-loop-handles.o \
 	test/test-loop-stop.o \
 	test/test-loop-configure.o \
+	test/test-loop-metrics.o \
 	test/test-multiple-listen.o \
 	test/test-mutexes.o \
 	test/test-osx-select.o \
@@ -129,13 +131,16 @@ TESTS= \
 	test/test-tcp-open.o \
 	test/test-tcp-oob.o \
 	test/test-tcp-read-stop.o \
+	test/test-tcp-reuseport.o \
 	test/test-tcp-shutdown-after-write.o \
+	test/test-tcp-sendfile.o \
 	test/test-tcp-unexpected-read.o \
 	test/test-tcp-writealot.o \
 	test/test-tcp-write-to-half-open-connection.o \
 	test/test-thread.o \
 	test/test-threadpool.o \
 	test/test-threadpool-cancel.o \
+	test/test-threadpool-lanes.o \
 	test/test-timer-again.o \
 	test/test-timer-from-check.o \
 	test/test-timer.o \
@@ -146,6 +151,7 @@ TESTS= \
 	test/test-udp-multicast-ttl.o \
 	test/test-udp-open.o \
 	test/test-udp-options.o \
+	test/test-udp-mmsg.o \
 	test/test-udp-send-and-recv.o \
 	test/test-util.o \
 	test/test-walk-handles.o \
@@ -104,6 +104,7 @@ RUNNER_CFLAGS += -D_GNU_SOURCE
 OBJS += src/unix/linux-core.o \
         src/unix/linux-inotify.o \
         src/unix/linux-syscalls.o \
+        src/unix/linux-uring.o \
         src/unix/proctitle.o
 endif
 
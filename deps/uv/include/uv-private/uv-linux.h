@@ -26,6 +26,7 @@
   uv__io_t inotify_read_watcher;                                              \
   void* inotify_watchers;                                                     \
   int inotify_fd;                                                             \
+  void* uring;                                                                \
 
 #define UV_PLATFORM_FS_EVENT_FIELDS                                           \
   ngx_queue_t watchers;                                                       \
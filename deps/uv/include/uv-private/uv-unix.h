@@ -97,6 +97,8 @@ struct uv__work {
   void (*done)(struct uv__work *w, int status);
   struct uv_loop_s* loop;
   ngx_queue_t wq;
+  unsigned int lane;
+  uint64_t queued_time;
 };
 
 #ifndef UV_PLATFORM_SEM_T
@@ -191,6 +193,8 @@ typedef struct {
   uv_signal_t child_watcher;                                                  \
   int emfile_fd;                                                              \
   uint64_t timer_counter;                                                     \
+  void (*metrics_cb)(uv_loop_t*, const uv_loop_metrics_t*);                   \
+  uv_loop_metrics_t metrics;                                                  \
   UV_PLATFORM_LOOP_FIELDS                                                     \
 
 #define UV_REQ_TYPE_PRIVATE /* empty */
@@ -206,6 +210,10 @@ typedef struct {
   int bufcnt;                                                                 \
   int error;                                                                  \
   uv_buf_t bufsml[4];                                                         \
+  int sendfile_fd;                                                            \
+  int64_t sendfile_offset;                                                    \
+  int64_t sendfile_ready;                                                     \
+  struct uv__sendfile_prefetch* sendfile_prefetch;                            \
 
 #define UV_CONNECT_PRIVATE_FIELDS                                             \
   ngx_queue_t queue;                                                          \
@@ -244,6 +252,7 @@ typedef struct {
   uv__io_t io_watcher;                                                        \
   ngx_queue_t write_queue;                                                    \
   ngx_queue_t write_completed_queue;                                          \
+  unsigned int batch_size;                                                    \
 
 #define UV_PIPE_PRIVATE_FIELDS                                                \
   const char* pipe_fname; /* strdup'ed */
@@ -225,6 +225,8 @@ typedef struct uv_work_s uv_work_t;
 /* None of the above. */
 typedef struct uv_cpu_info_s uv_cpu_info_t;
 typedef struct uv_interface_address_s uv_interface_address_t;
+typedef struct uv_threadpool_stats_s uv_threadpool_stats_t;
+typedef struct uv_loop_metrics_s uv_loop_metrics_t;
 
 typedef enum {
   /* Block a signal when polling for new events.  The second argument to
@@ -234,9 +236,36 @@ typedef enum {
    * to suppress unnecessary wakeups when using a sampling profiler.
    * Requesting other signals will fail with UV_EINVAL.
    */
-  UV_LOOP_BLOCK_SIGNAL
+  UV_LOOP_BLOCK_SIGNAL,
+  /* Measure where the time goes in every iteration of the loop. The second
+   * argument is a uv_loop_metrics_cb that gets the measurements at the end
+   * of each iteration, or NULL to stop measuring. Can be changed at any
+   * time, it takes effect from the next iteration.
+   *
+   * Only implemented on UNIX platforms.
+   */
+  UV_LOOP_METRICS
 } uv_loop_option;
 
+/* The phases of a loop iteration, in the order that uv_run() runs them. */
+typedef enum {
+  UV_LOOP_PHASE_TIMERS,
+  UV_LOOP_PHASE_IDLE,
+  UV_LOOP_PHASE_PREPARE,
+  UV_LOOP_PHASE_PENDING,
+  UV_LOOP_PHASE_POLL,
+  UV_LOOP_PHASE_CHECK,
+  UV_LOOP_PHASE_CLOSING,
+  UV_LOOP_PHASE_MAX
+} uv_loop_phase;
+
+struct uv_loop_metrics_s {
+  uint64_t start;                         /* uv_hrtime() at the start. */
+  uint64_t phase_time[UV_LOOP_PHASE_MAX]; /* In nanoseconds. */
+  uint64_t poll_wait;   /* The part of the poll phase spent in the kernel. */
+  unsigned int events;  /* I/O callbacks made by the poll phase. */
+};
+
 typedef enum {
   UV_RUN_DEFAULT = 0,
   UV_RUN_ONCE,
@@ -283,6 +312,13 @@ UV_EXTERN uv_loop_t* uv_default_loop(void);
  */
 UV_EXTERN int uv_loop_configure(uv_loop_t* loop, uv_loop_option option, ...);
 
+/*
+ * Called at the end of every loop iteration when UV_LOOP_METRICS is on. The
+ * measurements are only valid for the duration of the callback.
+ */
+typedef void (*uv_loop_metrics_cb)(uv_loop_t* loop,
+                                   const uv_loop_metrics_t* metrics);
+
 /*
  * This function runs the event loop. It will act differently depending on the
  * specified mode:
@@ -662,6 +698,20 @@ UV_EXTERN int uv_write(uv_write_t* req, uv_stream_t* handle,
 UV_EXTERN int uv_write2(uv_write_t* req, uv_stream_t* handle, uv_buf_t bufs[],
     int bufcnt, uv_stream_t* send_handle, uv_write_cb cb);
 
+/*
+ * Queue `length` bytes of the regular file `in_fd`, starting at `offset`,
+ * for writing to the stream. The request is ordered with respect to the
+ * other writes on the stream exactly like uv_write() and completes through
+ * the same callback. Where the platform supports it the data is copied by
+ * the kernel (sendfile) without passing through user space.
+ *
+ * The file must remain open until the callback is called. A file that is
+ * shorter than `offset + length` makes the request fail with UV_EIO.
+ * Not supported on Windows (UV_ENOSYS).
+ */
+UV_EXTERN int uv_sendfile(uv_write_t* req, uv_stream_t* handle, uv_file in_fd,
+    int64_t offset, size_t length, uv_write_cb cb);
+
 /* uv_write_t is a subclass of uv_req_t */
 struct uv_write_s {
   UV_REQ_FIELDS
@@ -729,6 +779,18 @@ UV_EXTERN int uv_tcp_keepalive(uv_tcp_t* handle,
  */
 UV_EXTERN int uv_tcp_simultaneous_accepts(uv_tcp_t* handle, int enable);
 
+/*
+ * Enable/disable SO_REUSEPORT. Call it before uv_tcp_bind(). When several
+ * processes bind a SO_REUSEPORT socket to the same address, the kernel
+ * spreads incoming connections evenly over them, instead of waking up
+ * whoever happens to be blocked in accept() on a shared socket.
+ *
+ * Sets the UV_ENOTSUP error on platforms that don't have SO_REUSEPORT.
+ * Only Linux 3.9 and later balance connections across the sockets; other
+ * systems accept the option but don't spread the load.
+ */
+UV_EXTERN int uv_tcp_reuseport(uv_tcp_t* handle, int enable);
+
 UV_EXTERN int uv_tcp_bind(uv_tcp_t* handle, struct sockaddr_in);
 UV_EXTERN int uv_tcp_bind6(uv_tcp_t* handle, struct sockaddr_in6);
 UV_EXTERN int uv_tcp_getsockname(uv_tcp_t* handle, struct sockaddr* name,
@@ -767,7 +829,13 @@ enum uv_udp_flags {
    * Indicates message was truncated because read buffer was too small. The
    * remainder was discarded by the OS. Used in uv_udp_recv_cb.
    */
-  UV_UDP_PARTIAL = 2
+  UV_UDP_PARTIAL = 2,
+  /*
+   * Indicates the message is one of a batch, see uv_udp_set_batch(). Its
+   * buffer is a slice of the one that alloc_cb returned and must not be
+   * freed. Used in uv_udp_recv_cb.
+   */
+  UV_UDP_MMSG_CHUNK = 4
 };
 
 /*
@@ -918,6 +986,31 @@ UV_EXTERN int uv_udp_set_broadcast(uv_udp_t* handle, int on);
  */
 UV_EXTERN int uv_udp_set_ttl(uv_udp_t* handle, int ttl);
 
+/*
+ * Read and write up to `count` datagrams per system call, with recvmmsg(2)
+ * and sendmmsg(2). Linux only.
+ *
+ * When batching is on, alloc_cb is asked for `count` times 64 KB and the
+ * buffer it returns is split into 64 KB slots, one per datagram; a smaller
+ * buffer means fewer datagrams per call. Each datagram is passed to recv_cb
+ * with the UV_UDP_MMSG_CHUNK flag and a buffer that points into the slot.
+ * After the last datagram of a batch, recv_cb is called once more with
+ * nread == 0, addr == NULL and the buffer that alloc_cb returned.
+ *
+ * Sends that are queued when the socket becomes writable go out together.
+ *
+ * Arguments:
+ *  handle              UDP handle. Should have been initialized with
+ *                      `uv_udp_init`.
+ *  count               Datagrams per system call, at most 64. 0 or 1 turns
+ *                      batching off.
+ *
+ * Returns:
+ *  0 on success, -1 on error. The error is UV_ENOSYS on platforms that
+ *  don't support batching.
+ */
+UV_EXTERN int uv_udp_set_batch(uv_udp_t* handle, unsigned int count);
+
 /*
  * Send data. If the socket has not previously been bound with `uv_udp_bind`
  * or `uv_udp_bind6`, it is bound to 0.0.0.0 (the "all interfaces" address)
@@ -1453,17 +1546,67 @@ struct uv_work_s {
   UV_WORK_PRIVATE_FIELDS
 };
 
-/* Queues a work request to execute asynchronously on the thread pool. */
+/*
+ * The thread pool is split into lanes, one per kind of work. Each lane has
+ * its own queue and its own set of threads so that, for example, a burst of
+ * slow file system requests cannot starve DNS lookups.
+ *
+ * Lanes start with a small number of threads and grow on demand up to their
+ * maximum size. Threads above the minimum exit again after they have been
+ * idle for a while. The maximum size of a lane can be set with the
+ * UV_THREADPOOL_FS_SIZE, UV_THREADPOOL_DNS_SIZE and UV_THREADPOOL_CPU_SIZE
+ * environment variables. UV_THREADPOOL_SIZE, if set, is the maximum size of
+ * every lane that doesn't have a size of its own.
+ */
+typedef enum {
+  UV_WORK_FS = 0,
+  UV_WORK_DNS,
+  UV_WORK_CPU,
+  UV_WORK_LANE_MAX
+} uv_work_lane_t;
+
+struct uv_threadpool_stats_s {
+  unsigned int threads;       /* Threads currently alive. */
+  unsigned int idle;          /* Threads waiting for work. */
+  unsigned int min_threads;
+  unsigned int max_threads;
+  unsigned int queued;        /* Requests waiting for a thread. */
+  uint64_t submitted;
+  uint64_t completed;
+  uint64_t wait_time;         /* Total time spent queued, in nanoseconds. */
+  uint64_t max_wait_time;     /* Longest time spent queued, in nanoseconds. */
+};
+
+/*
+ * Queues a work request to execute asynchronously on the thread pool.
+ * The request runs in the UV_WORK_CPU lane.
+ */
 UV_EXTERN int uv_queue_work(uv_loop_t* loop, uv_work_t* req,
     uv_work_cb work_cb, uv_after_work_cb after_work_cb);
 
+/* Like uv_queue_work() but runs the request in the given lane. */
+UV_EXTERN int uv_queue_work_lane(uv_loop_t* loop, uv_work_t* req,
+    uv_work_lane_t lane, uv_work_cb work_cb, uv_after_work_cb after_work_cb);
+
+/*
+ * Fills `stats` with a snapshot of the counters of the given lane.
+ * The counters are process-wide, not per-loop.
+ *
+ * Returns 0 on success, -1 on error. This function is currently only
+ * implemented on UNIX platforms. On Windows, it always returns -1.
+ */
+UV_EXTERN int uv_threadpool_stats(uv_work_lane_t lane,
+    uv_threadpool_stats_t* stats);
+
 /* Cancel a pending request. Fails if the request is executing or has finished
  * executing.
  *
  * Returns 0 on success, -1 on error. The loop error code is not touched.
  *
  * Only cancellation of uv_fs_t, uv_getaddrinfo_t and uv_work_t requests is
- * currently supported.
+ * currently supported. On Linux, file system requests that were handed to
+ * io_uring rather than the thread pool count as executing and can't be
+ * cancelled. Set UV_USE_IO_URING=0 in the environment to disable io_uring.
  *
  * Cancelled requests have their callbacks invoked some time in the future.
  * It's _not_ safe to free the memory associated with the request until your
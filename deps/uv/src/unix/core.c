@@ -300,7 +300,24 @@ static int uv__loop_alive(uv_loop_t* loop) {
 }
 
 
+/* Runs `stmt`, adding the time it takes to `phase` when the iteration is
+ * being measured.
+ */
+#define UV__METER(loop, metered, phase, stmt)                                 \
+  do {                                                                        \
+    if (metered) {                                                            \
+      uint64_t start_ = uv__hrtime();                                         \
+      stmt;                                                                   \
+      (loop)->metrics.phase_time[phase] += uv__hrtime() - start_;             \
+    } else {                                                                  \
+      stmt;                                                                   \
+    }                                                                         \
+  }                                                                           \
+  while (0)
+
+
 int uv_run(uv_loop_t* loop, uv_run_mode mode) {
+  int metered;
   int timeout;
   int r;
 
@@ -308,21 +325,37 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
   while (r != 0 && loop->stop_flag == 0) {
     UV_TICK_START(loop, mode);
 
+    /* Callbacks can turn metrics on and off, the check is made once per
+     * iteration so that an iteration is either measured in full or not at
+     * all.
+     */
+    metered = (loop->metrics_cb != NULL);
+    if (metered) {
+      memset(&loop->metrics, 0, sizeof(loop->metrics));
+      loop->metrics.start = uv__hrtime();
+    }
+
     uv__update_time(loop);
-    uv__run_timers(loop);
-    uv__run_idle(loop);
-    uv__run_prepare(loop);
-    uv__run_pending(loop);
+    UV__METER(loop, metered, UV_LOOP_PHASE_TIMERS, uv__run_timers(loop));
+    UV__METER(loop, metered, UV_LOOP_PHASE_IDLE, uv__run_idle(loop));
+    UV__METER(loop, metered, UV_LOOP_PHASE_PREPARE, uv__run_prepare(loop));
+    UV__METER(loop, metered, UV_LOOP_PHASE_PENDING, uv__run_pending(loop));
 
     timeout = 0;
     if ((mode & UV_RUN_NOWAIT) == 0)
       timeout = uv_backend_timeout(loop);
 
-    uv__io_poll(loop, timeout);
-    uv__run_check(loop);
-    uv__run_closing_handles(loop);
+    UV__METER(loop, metered, UV_LOOP_PHASE_POLL, uv__io_poll(loop, timeout));
+    UV__METER(loop, metered, UV_LOOP_PHASE_CHECK, uv__run_check(loop));
+    UV__METER(loop,
+              metered,
+              UV_LOOP_PHASE_CLOSING,
+              uv__run_closing_handles(loop));
     r = uv__loop_alive(loop);
 
+    if (metered && loop->metrics_cb != NULL)
+      loop->metrics_cb(loop, &loop->metrics);
+
     UV_TICK_STOP(loop, mode);
 
     if (mode & (UV_RUN_ONCE | UV_RUN_NOWAIT))
@@ -85,7 +85,13 @@
 #define POST                                                                  \
   do {                                                                        \
     if ((cb) != NULL) {                                                       \
-      uv__work_submit((loop), &(req)->work_req, uv__fs_work, uv__fs_done);    \
+      if (uv__fs_submit_native((loop), (req)) == 0)                           \
+        return 0;                                                             \
+      uv__work_submit((loop),                                                 \
+                      &(req)->work_req,                                       \
+                      UV_WORK_FS,                                             \
+                      uv__fs_work,                                            \
+                      uv__fs_done);                                           \
       return 0;                                                               \
     }                                                                         \
     else {                                                                    \
@@ -513,7 +519,7 @@ static ssize_t uv__fs_write(uv_fs_t* req) {
 }
 
 
-static void uv__fs_work(struct uv__work* w) {
+void uv__fs_work(struct uv__work* w) {
   int retry_on_eintr;
   uv_fs_t* req;
   ssize_t r;
@@ -573,7 +579,7 @@ static void uv__fs_work(struct uv__work* w) {
 }
 
 
-static void uv__fs_done(struct uv__work* w, int status) {
+void uv__fs_done(struct uv__work* w, int status) {
   uv_fs_t* req;
 
   req = container_of(w, uv_fs_t, work_req);
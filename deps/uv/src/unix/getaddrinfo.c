@@ -151,6 +151,7 @@ int uv_getaddrinfo(uv_loop_t* loop,
 
   uv__work_submit(loop,
                   &req->work_req,
+                  UV_WORK_DNS,
                   uv__getaddrinfo_work,
                   uv__getaddrinfo_done);
 
@@ -133,7 +133,8 @@ enum {
   UV_STREAM_BLOCKING  = 0x80,   /* Synchronous writes. */
   UV_TCP_NODELAY      = 0x100,  /* Disable Nagle. */
   UV_TCP_KEEPALIVE    = 0x200,  /* Turn on keep-alive. */
-  UV_TCP_SINGLE_ACCEPT = 0x400  /* Only accept() when idle. */
+  UV_TCP_SINGLE_ACCEPT = 0x400, /* Only accept() when idle. */
+  UV_TCP_REUSEPORT    = 0x800   /* Set SO_REUSEPORT before bind(). */
 };
 
 /* loop flags */
@@ -204,10 +205,24 @@ void uv__signal_loop_cleanup(uv_loop_t* loop);
 /* thread pool */
 void uv__work_submit(uv_loop_t* loop,
                      struct uv__work *w,
+                     unsigned int lane,
                      void (*work)(struct uv__work *w),
                      void (*done)(struct uv__work *w, int status));
 void uv__work_done(uv_async_t* handle, int status);
 
+/* fs */
+void uv__fs_work(struct uv__work* w);
+void uv__fs_done(struct uv__work* w, int status);
+
+#if defined(__linux__)
+int uv__uring_fs_submit(uv_loop_t* loop, uv_fs_t* req);
+void uv__uring_flush(uv_loop_t* loop);
+void uv__uring_delete(uv_loop_t* loop);
+# define uv__fs_submit_native(loop, req) uv__uring_fs_submit((loop), (req))
+#else
+# define uv__fs_submit_native(loop, req) (-1)
+#endif
+
 /* platform specific */
 uint64_t uv__hrtime(void);
 int uv__kqueue_init(uv_loop_t* loop);
@@ -59,6 +59,7 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   uv__io_t* w;
   sigset_t* pset;
   sigset_t set;
+  uint64_t wait_start = 0;
   uint64_t base;
   uint64_t diff;
   int filter;
@@ -140,6 +141,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
     if (pset != NULL)
       pthread_sigmask(SIG_BLOCK, pset, NULL);
 
+    if (loop->metrics_cb != NULL)
+      wait_start = uv__hrtime();
+
     nfds = kevent(loop->backend_fd,
                   events,
                   nevents,
@@ -147,6 +151,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
                   ARRAY_SIZE(events),
                   timeout == -1 ? NULL : &spec);
 
+    if (loop->metrics_cb != NULL)
+      loop->metrics.poll_wait += uv__hrtime() - wait_start;
+
     if (pset != NULL)
       pthread_sigmask(SIG_UNBLOCK, pset, NULL);
 
@@ -251,6 +258,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
     loop->watchers[loop->nwatchers] = NULL;
     loop->watchers[loop->nwatchers + 1] = NULL;
 
+    if (loop->metrics_cb != NULL)
+      loop->metrics.events += nevents;
+
     if (nevents != 0) {
       if (nfds == ARRAY_SIZE(events) && --count != 0) {
         /* Poll for more events but don't block this time. */
@@ -81,6 +81,7 @@ int uv__platform_loop_init(uv_loop_t* loop, int default_loop) {
   loop->backend_fd = fd;
   loop->inotify_fd = -1;
   loop->inotify_watchers = NULL;
+  loop->uring = NULL;
 
   if (fd == -1)
     return -1;
@@ -90,6 +91,7 @@ int uv__platform_loop_init(uv_loop_t* loop, int default_loop) {
 
 
 void uv__platform_loop_delete(uv_loop_t* loop) {
+  uv__uring_delete(loop);
   if (loop->inotify_fd == -1) return;
   uv__io_stop(loop, &loop->inotify_read_watcher, UV__POLLIN);
   close(loop->inotify_fd);
@@ -133,6 +135,7 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   ngx_queue_t* q;
   uv__io_t* w;
   sigset_t sigset;
+  uint64_t wait_start = 0;
   uint64_t sigmask;
   uint64_t base;
   uint64_t diff;
@@ -143,6 +146,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   int op;
   int i;
 
+  /* Hand queued fs requests to the kernel in one go. */
+  uv__uring_flush(loop);
+
   if (loop->nfds == 0) {
     assert(ngx_queue_empty(&loop->watcher_queue));
     return;
@@ -199,6 +205,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
       if (pthread_sigmask(SIG_BLOCK, &sigset, NULL))
         abort();
 
+    if (loop->metrics_cb != NULL)
+      wait_start = uv__hrtime();
+
     if (sigmask != 0 && no_epoll_pwait == 0) {
       nfds = uv__epoll_pwait(loop->backend_fd,
                              events,
@@ -216,6 +225,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
         no_epoll_wait = 1;
     }
 
+    if (loop->metrics_cb != NULL)
+      loop->metrics.poll_wait += uv__hrtime() - wait_start;
+
     if (sigmask != 0 && no_epoll_pwait != 0)
       if (pthread_sigmask(SIG_UNBLOCK, &sigset, NULL))
         abort();
@@ -312,6 +324,9 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
     loop->watchers[loop->nwatchers] = NULL;
     loop->watchers[loop->nwatchers + 1] = NULL;
 
+    if (loop->metrics_cb != NULL)
+      loop->metrics.events += nevents;
+
     if (nevents != 0) {
       if (nfds == ARRAY_SIZE(events) && --count != 0) {
         /* Poll for more events but don't block this time. */
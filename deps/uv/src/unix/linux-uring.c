@@ -0,0 +1,542 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Submits file system requests through io_uring instead of the thread pool.
+ *
+ * The ring is created lazily, the first time a loop posts an asynchronous
+ * fs request that the ring can handle. Requests are queued in the submission
+ * ring and handed to the kernel in one batch right before the loop blocks
+ * in epoll_wait(). The ring's file descriptor is watched like any other fd;
+ * when it becomes readable, the completion ring is drained and the requests
+ * are finished with the same uv__fs_done() the thread pool uses.
+ *
+ * Anything the ring can't take - an unsupported operation, a full ring or
+ * a kernel without io_uring - silently goes to the thread pool. Setting
+ * UV_USE_IO_URING=0 in the environment turns the ring off altogether.
+ */
+
+#include "uv.h"
+#include "internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define UV__URING_ENTRIES 256
+
+/* Largest count read(2) and write(2) will transfer in one go. */
+#define UV__URING_MAX_RW 0x7ffff000
+
+#ifndef AT_EMPTY_PATH
+# define AT_EMPTY_PATH 0x1000
+#endif
+
+#ifndef AT_SYMLINK_NOFOLLOW
+# define AT_SYMLINK_NOFOLLOW 0x100
+#endif
+
+struct uv__uring {
+  uv__io_t watcher;
+  int fd;
+  void* ring;
+  size_t ringlen;
+  struct uv__io_uring_sqe* sqes;
+  size_t sqeslen;
+  uint32_t* sqhead;
+  uint32_t* sqtail;
+  uint32_t* sqarray;
+  uint32_t sqmask;
+  uint32_t sqentries;
+  uint32_t* cqhead;
+  uint32_t* cqtail;
+  struct uv__io_uring_cqe* cqes;
+  uint32_t cqmask;
+  uint32_t cqentries;
+  unsigned int pending;   /* Queued but not yet handed to the kernel. */
+  unsigned int in_flight; /* Queued or submitted, not yet completed. */
+  unsigned char ops[32];  /* Bitmap of supported opcodes. */
+};
+
+/* Marks a loop that tried to set up a ring and failed. */
+static struct uv__uring no_uring;
+
+
+static void uv__uring_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
+
+
+static int uv__uring_supported(const struct uv__uring* u, unsigned int op) {
+  return (u->ops[op / 8] >> (op % 8)) & 1;
+}
+
+
+static int uv__uring_probe(struct uv__uring* u) {
+  struct uv__io_uring_probe* probe;
+  unsigned int op;
+  unsigned int i;
+
+  probe = calloc(1, sizeof(*probe));
+  if (probe == NULL)
+    return -1;
+
+  if (uv__io_uring_register(u->fd,
+                            UV__IORING_REGISTER_PROBE,
+                            probe,
+                            ARRAY_SIZE(probe->ops))) {
+    free(probe);
+    return -1;
+  }
+
+  for (i = 0; i < probe->ops_len && i <= probe->last_op; i++) {
+    op = probe->ops[i].op;
+    if (probe->ops[i].flags & UV__IO_URING_OP_SUPPORTED)
+      u->ops[op / 8] |= 1 << (op % 8);
+  }
+
+  free(probe);
+  return 0;
+}
+
+
+static int uv__uring_setup(struct uv__uring* u) {
+  struct uv__io_uring_params params;
+  size_t sqlen;
+  size_t cqlen;
+  char* ring;
+  void* sqes;
+  int fd;
+
+  memset(&params, 0, sizeof(params));
+
+  fd = uv__io_uring_setup(UV__URING_ENTRIES, &params);
+  if (fd == -1)
+    return -1;
+
+  /* Older kernels map the rings separately and can't do reads or writes
+   * at the current file position. Not worth supporting.
+   */
+  if (!(params.features & UV__IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & UV__IORING_FEAT_RW_CUR_POS)) {
+    close(fd);
+    return -1;
+  }
+
+  sqlen = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cqlen = params.cq_off.cqes +
+          params.cq_entries * sizeof(struct uv__io_uring_cqe);
+  if (cqlen > sqlen)
+    sqlen = cqlen;
+
+  ring = mmap(NULL,
+              sqlen,
+              PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE,
+              fd,
+              UV__IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED) {
+    close(fd);
+    return -1;
+  }
+
+  sqes = mmap(NULL,
+              params.sq_entries * sizeof(struct uv__io_uring_sqe),
+              PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE,
+              fd,
+              UV__IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    munmap(ring, sqlen);
+    close(fd);
+    return -1;
+  }
+
+  uv__cloexec(fd, 1);
+
+  u->fd = fd;
+  u->ring = ring;
+  u->ringlen = sqlen;
+  u->sqes = sqes;
+  u->sqeslen = params.sq_entries * sizeof(struct uv__io_uring_sqe);
+  u->sqhead = (uint32_t*) (ring + params.sq_off.head);
+  u->sqtail = (uint32_t*) (ring + params.sq_off.tail);
+  u->sqarray = (uint32_t*) (ring + params.sq_off.array);
+  u->sqmask = *(uint32_t*) (ring + params.sq_off.ring_mask);
+  u->sqentries = *(uint32_t*) (ring + params.sq_off.ring_entries);
+  u->cqhead = (uint32_t*) (ring + params.cq_off.head);
+  u->cqtail = (uint32_t*) (ring + params.cq_off.tail);
+  u->cqes = (struct uv__io_uring_cqe*) (ring + params.cq_off.cqes);
+  u->cqmask = *(uint32_t*) (ring + params.cq_off.ring_mask);
+  u->cqentries = *(uint32_t*) (ring + params.cq_off.ring_entries);
+  u->pending = 0;
+  u->in_flight = 0;
+
+  if (uv__uring_probe(u)) {
+    munmap(u->sqes, u->sqeslen);
+    munmap(u->ring, u->ringlen);
+    close(fd);
+    return -1;
+  }
+
+  return 0;
+}
+
+
+static struct uv__uring* uv__uring_get(uv_loop_t* loop) {
+  struct uv__uring* u;
+  const char* val;
+
+  u = loop->uring;
+  if (u != NULL)
+    return u == &no_uring ? NULL : u;
+
+  loop->uring = &no_uring;
+
+  val = getenv("UV_USE_IO_URING");
+  if (val != NULL && atoi(val) == 0)
+    return NULL;
+
+  u = calloc(1, sizeof(*u));
+  if (u == NULL)
+    return NULL;
+
+  if (uv__uring_setup(u)) {
+    free(u);
+    return NULL;
+  }
+
+  uv__io_init(&u->watcher, uv__uring_io, u->fd);
+  uv__io_start(loop, &u->watcher, UV__POLLIN);
+  loop->uring = u;
+
+  return u;
+}
+
+
+static unsigned int uv__uring_opcode(const uv_fs_t* req) {
+  switch (req->fs_type) {
+  case UV_FS_CLOSE: return UV__IORING_OP_CLOSE;
+  case UV_FS_FDATASYNC: return UV__IORING_OP_FSYNC;
+  case UV_FS_FSYNC: return UV__IORING_OP_FSYNC;
+  case UV_FS_FSTAT: return UV__IORING_OP_STATX;
+  case UV_FS_LSTAT: return UV__IORING_OP_STATX;
+  case UV_FS_OPEN: return UV__IORING_OP_OPENAT;
+  case UV_FS_READ: return UV__IORING_OP_READ;
+  case UV_FS_STAT: return UV__IORING_OP_STATX;
+  case UV_FS_WRITE: return UV__IORING_OP_WRITE;
+  default: return 0;  /* UV__IORING_OP_NOP, never used. */
+  }
+}
+
+
+int uv__uring_fs_submit(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__statx* statxbuf;
+  struct uv__uring* u;
+  unsigned int opcode;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t slot;
+
+  opcode = uv__uring_opcode(req);
+  if (opcode == 0)
+    return -1;
+
+  u = uv__uring_get(loop);
+  if (u == NULL)
+    return -1;
+
+  if (!uv__uring_supported(u, opcode))
+    return -1;
+
+  /* Don't let completions outnumber the completion ring. */
+  if (u->in_flight >= u->cqentries)
+    return -1;
+
+  tail = *u->sqtail;
+  head = *(volatile uint32_t*) u->sqhead;
+  if (tail - head >= u->sqentries)
+    return -1;
+
+  statxbuf = NULL;
+  if (opcode == UV__IORING_OP_STATX) {
+    statxbuf = malloc(sizeof(*statxbuf));
+    if (statxbuf == NULL)
+      return -1;
+  }
+
+  slot = tail & u->sqmask;
+  sqe = u->sqes + slot;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->user_data = (uintptr_t) req;
+
+  switch (req->fs_type) {
+  case UV_FS_CLOSE:
+    sqe->fd = req->file;
+    break;
+
+  case UV_FS_FDATASYNC:
+    sqe->fd = req->file;
+    sqe->rw_flags = UV__IORING_FSYNC_DATASYNC;
+    break;
+
+  case UV_FS_FSYNC:
+    sqe->fd = req->file;
+    break;
+
+  case UV_FS_OPEN:
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t) req->path;
+    sqe->len = req->mode;
+    sqe->rw_flags = req->flags;
+    break;
+
+  case UV_FS_READ:
+  case UV_FS_WRITE:
+    sqe->fd = req->file;
+    sqe->addr = (uintptr_t) req->buf;
+    sqe->len = req->len > UV__URING_MAX_RW ? UV__URING_MAX_RW : req->len;
+    sqe->off = req->off < 0 ? (uint64_t) -1 : (uint64_t) req->off;
+    break;
+
+  case UV_FS_FSTAT:
+    sqe->fd = req->file;
+    sqe->addr = (uintptr_t) "";
+    sqe->len = UV__STATX_BASIC_STATS;
+    sqe->rw_flags = AT_EMPTY_PATH;
+    sqe->off = (uintptr_t) statxbuf;
+    break;
+
+  case UV_FS_LSTAT:
+  case UV_FS_STAT:
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t) req->path;
+    sqe->len = UV__STATX_BASIC_STATS;
+    sqe->rw_flags = req->fs_type == UV_FS_LSTAT ? AT_SYMLINK_NOFOLLOW : 0;
+    sqe->off = (uintptr_t) statxbuf;
+    break;
+
+  default:
+    abort();
+  }
+
+  u->sqarray[slot] = slot;
+  __sync_synchronize();
+  *u->sqtail = tail + 1;
+
+  /* Looks like a running thread pool request to uv_cancel(), which then
+   * reports it as busy.
+   */
+  req->ptr = statxbuf;
+  req->work_req.loop = loop;
+  req->work_req.work = NULL;
+  req->work_req.done = uv__fs_done;
+  req->work_req.lane = UV_WORK_FS;
+  ngx_queue_init(&req->work_req.wq);
+
+  u->pending++;
+  u->in_flight++;
+
+  return 0;
+}
+
+
+/* Takes the requests that the kernel hasn't consumed back off the
+ * submission ring and runs them on the thread pool instead.
+ */
+static void uv__uring_requeue(uv_loop_t* loop, struct uv__uring* u) {
+  struct uv__io_uring_sqe* sqe;
+  uv_fs_t* req;
+  uint32_t head;
+  uint32_t tail;
+
+  head = *(volatile uint32_t*) u->sqhead;
+  tail = *u->sqtail;
+
+  /* The kernel only looks at the ring in io_uring_enter(), the tail can
+   * be moved back.
+   */
+  *u->sqtail = head;
+  u->pending = 0;
+
+  for (; head != tail; head++) {
+    sqe = u->sqes + u->sqarray[head & u->sqmask];
+    req = (uv_fs_t*) (uintptr_t) sqe->user_data;
+    u->in_flight--;
+
+    if (req->ptr != NULL) {
+      free(req->ptr);
+      req->ptr = NULL;
+    }
+    uv__work_submit(loop,
+                    &req->work_req,
+                    UV_WORK_FS,
+                    uv__fs_work,
+                    uv__fs_done);
+  }
+}
+
+
+void uv__uring_flush(uv_loop_t* loop) {
+  struct uv__uring* u;
+  int n;
+
+  u = loop->uring;
+  if (u == NULL || u == &no_uring || u->pending == 0)
+    return;
+
+  do
+    n = uv__io_uring_enter(u->fd, u->pending, 0, 0);
+  while (n == -1 && errno == EINTR);
+
+  if (n > 0) {
+    u->pending -= n;
+    return;
+  }
+
+  /* EAGAIN and EBUSY are transient; try again on the next tick. Anything
+   * else means the kernel won't take the requests, ever.
+   */
+  if (n == -1 && errno != EAGAIN && errno != EBUSY)
+    uv__uring_requeue(loop, u);
+}
+
+
+static void uv__uring_statx_to_stat(const struct uv__statx* sx,
+                                    uv_statbuf_t* st) {
+  memset(st, 0, sizeof(*st));
+  st->st_dev = makedev(sx->stx_dev_major, sx->stx_dev_minor);
+  st->st_ino = sx->stx_ino;
+  st->st_mode = sx->stx_mode;
+  st->st_nlink = sx->stx_nlink;
+  st->st_uid = sx->stx_uid;
+  st->st_gid = sx->stx_gid;
+  st->st_rdev = makedev(sx->stx_rdev_major, sx->stx_rdev_minor);
+  st->st_size = sx->stx_size;
+  st->st_blksize = sx->stx_blksize;
+  st->st_blocks = sx->stx_blocks;
+  st->st_atim.tv_sec = sx->stx_atime.tv_sec;
+  st->st_atim.tv_nsec = sx->stx_atime.tv_nsec;
+  st->st_mtim.tv_sec = sx->stx_mtime.tv_sec;
+  st->st_mtim.tv_nsec = sx->stx_mtime.tv_nsec;
+  st->st_ctim.tv_sec = sx->stx_ctime.tv_sec;
+  st->st_ctim.tv_nsec = sx->stx_ctime.tv_nsec;
+}
+
+
+static void uv__uring_fs_done(uv_fs_t* req, int res) {
+  struct uv__statx* statxbuf;
+
+  if (res == -EINTR && req->fs_type != UV_FS_CLOSE) {
+    /* Let the thread pool deal with the retry. Same as uv__fs_work(). */
+    if (req->ptr != NULL) {
+      free(req->ptr);
+      req->ptr = NULL;
+    }
+    uv__work_submit(req->loop,
+                    &req->work_req,
+                    UV_WORK_FS,
+                    uv__fs_work,
+                    uv__fs_done);
+    return;
+  }
+
+  if (res < 0) {
+    req->result = -1;
+    req->errorno = -res;
+  } else {
+    req->result = res;
+    req->errorno = 0;
+  }
+
+  if (req->fs_type == UV_FS_STAT ||
+      req->fs_type == UV_FS_FSTAT ||
+      req->fs_type == UV_FS_LSTAT) {
+    statxbuf = req->ptr;
+    req->ptr = NULL;
+    if (res == 0) {
+      uv__uring_statx_to_stat(statxbuf, &req->statbuf);
+      req->ptr = &req->statbuf;
+    }
+    free(statxbuf);
+  }
+
+  uv__fs_done(&req->work_req, 0);
+}
+
+
+static void uv__uring_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+  struct uv__io_uring_cqe* cqe;
+  struct uv__uring* u;
+  uv_fs_t* req;
+  uint32_t head;
+  uint32_t tail;
+  int res;
+
+  u = container_of(w, struct uv__uring, watcher);
+  assert(u == loop->uring);
+
+  for (;;) {
+    head = *u->cqhead;
+    tail = *(volatile uint32_t*) u->cqtail;
+    __sync_synchronize();
+
+    if (head == tail)
+      break;
+
+    cqe = u->cqes + (head & u->cqmask);
+    req = (uv_fs_t*) (uintptr_t) cqe->user_data;
+    res = cqe->res;
+
+    /* Release the slot before running the callback, which may well
+     * submit new requests.
+     */
+    __sync_synchronize();
+    *u->cqhead = head + 1;
+    u->in_flight--;
+
+    uv__uring_fs_done(req, res);
+  }
+}
+
+
+void uv__uring_delete(uv_loop_t* loop) {
+  struct uv__uring* u;
+
+  u = loop->uring;
+  loop->uring = NULL;
+
+  if (u == NULL || u == &no_uring)
+    return;
+
+  uv__io_stop(loop, &u->watcher, UV__POLLIN);
+  munmap(u->sqes, u->sqeslen);
+  munmap(u->ring, u->ringlen);
+  close(u->fd);
+  free(u);
+}
@@ -115,6 +115,11 @@ void uv__loop_delete(uv_loop_t* loop) {
 
 
 int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap) {
+  if (option == UV_LOOP_METRICS) {
+    loop->metrics_cb = va_arg(ap, uv_loop_metrics_cb);
+    return 0;
+  }
+
   if (option != UV_LOOP_BLOCK_SIGNAL)
     return UV_ENOSYS;
 
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -44,6 +45,17 @@ extern char **environ;
 # include <grp.h>
 #endif
 
+/* glibc 2.29 and up start posix_spawn() children with clone(CLONE_VM |
+ * CLONE_VFORK), report exec errors, clear FD_CLOEXEC on dup2(fd, fd)
+ * actions and have posix_spawn_file_actions_addchdir_np().
+ */
+#if defined(__linux__) && defined(__GLIBC_PREREQ)
+# if __GLIBC_PREREQ(2, 29)
+#  define UV__POSIX_SPAWN 1
+#  include <spawn.h>
+# endif
+#endif
+
 
 static ngx_queue_t* uv__process_queue(uv_loop_t* loop, int pid) {
   assert(pid > 0);
@@ -366,45 +378,127 @@ static void uv__process_child_init(uv_process_options_t options,
 }
 
 
-int uv_spawn(uv_loop_t* loop,
-             uv_process_t* process,
-             const uv_process_options_t options) {
-  int signal_pipe[2] = { -1, -1 };
-  int (*pipes)[2];
-  int stdio_count;
-  ngx_queue_t* q;
-  ssize_t r;
-  pid_t pid;
-  int i;
+#if defined(UV__POSIX_SPAWN)
+/* execvp() in the child looks the file up in the PATH of the environment
+ * it is given, posix_spawnp() in ours. Only equal PATHs give the same file.
+ */
+static int uv__process_same_path(const uv_process_options_t* options) {
+  const char* path;
+  char** env;
 
-  assert(options.file != NULL);
-  assert(!(options.flags & ~(UV_PROCESS_DETACHED |
-                             UV_PROCESS_SETGID |
-                             UV_PROCESS_SETUID |
-                             UV_PROCESS_WINDOWS_HIDE |
-                             UV_PROCESS_WINDOWS_VERBATIM_ARGUMENTS)));
+  if (options->env == NULL || strchr(options->file, '/') != NULL)
+    return 1;
 
-  uv__handle_init(loop, (uv_handle_t*)process, UV_PROCESS);
-  ngx_queue_init(&process->queue);
+  path = getenv("PATH");
 
-  stdio_count = options.stdio_count;
-  if (stdio_count < 3)
-    stdio_count = 3;
+  for (env = options->env; *env != NULL; env++)
+    if (strncmp(*env, "PATH=", 5) == 0)
+      return path != NULL && strcmp(*env + 5, path) == 0;
 
-  pipes = malloc(stdio_count * sizeof(*pipes));
-  if (pipes == NULL) {
-    errno = ENOMEM;
-    goto error;
+  return path == NULL;
+}
+
+
+/* Starts the child with posix_spawnp(). Unlike fork(), that doesn't copy
+ * the page tables of the parent, which gets slow when the parent is big.
+ * The file actions are the steps of uv__process_child_init(), in the same
+ * order.
+ *
+ * Returns -1 when the options need the fork() path, or when the spawn
+ * fails. The fork() path then reports the error like it always has,
+ * through the exit callback.
+ */
+static int uv__process_spawn(const uv_process_options_t* options,
+                             int stdio_count,
+                             int (*pipes)[2],
+                             pid_t* pid) {
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  int close_fd;
+  int use_fd;
+  int err;
+  int fd;
+
+  if (options->flags & (UV_PROCESS_SETUID | UV_PROCESS_SETGID))
+    return -1;
+
+  if (!uv__process_same_path(options))
+    return -1;
+
+  if (posix_spawn_file_actions_init(&actions))
+    return -1;
+
+  if (posix_spawnattr_init(&attr)) {
+    posix_spawn_file_actions_destroy(&actions);
+    return -1;
   }
 
-  for (i = 0; i < stdio_count; i++) {
-    pipes[i][0] = -1;
-    pipes[i][1] = -1;
+  err = 0;
+
+  if (options->flags & UV_PROCESS_DETACHED)
+    err = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+
+  for (fd = 0; fd < stdio_count && err == 0; fd++) {
+    close_fd = pipes[fd][0];
+    use_fd = pipes[fd][1];
+
+    if (use_fd < 0) {
+      if (fd < 3)
+        err = posix_spawn_file_actions_addopen(&actions,
+                                               fd,
+                                               "/dev/null",
+                                               fd == 0 ? O_RDONLY : O_RDWR,
+                                               0);
+      continue;
+    }
+
+    /* Also clears FD_CLOEXEC when fd == use_fd. */
+    err = posix_spawn_file_actions_adddup2(&actions, use_fd, fd);
+
+    /* O_NONBLOCK belongs to the open file, which the parent shares. */
+    if (fd <= 2)
+      uv__nonblock(use_fd, 0);
+
+    if (err == 0 && close_fd >= stdio_count)
+      err = posix_spawn_file_actions_addclose(&actions, close_fd);
   }
 
-  for (i = 0; i < options.stdio_count; i++)
-    if (uv__process_init_stdio(options.stdio + i, pipes[i]))
-      goto error;
+  for (fd = 0; fd < stdio_count && err == 0; fd++) {
+    use_fd = pipes[fd][1];
+
+    if (use_fd >= 0 && fd != use_fd)
+      err = posix_spawn_file_actions_addclose(&actions, use_fd);
+  }
+
+  if (err == 0 && options->cwd != NULL)
+    err = posix_spawn_file_actions_addchdir_np(&actions, options->cwd);
+
+  if (err == 0)
+    err = posix_spawnp(pid,
+                       options->file,
+                       &actions,
+                       &attr,
+                       options->args,
+                       options->env != NULL ? options->env : environ);
+
+  posix_spawnattr_destroy(&attr);
+  posix_spawn_file_actions_destroy(&actions);
+
+  return err ? -1 : 0;
+}
+#endif
+
+
+/* Starts the child with fork(). Returns the pid, or -1 with errno set. The
+ * child's error, if it fails to start, ends up in *errorno.
+ */
+static pid_t uv__process_fork(const uv_process_options_t* options,
+                              int stdio_count,
+                              int (*pipes)[2],
+                              int* errorno) {
+  int signal_pipe[2] = { -1, -1 };
+  ssize_t r;
+  pid_t pid;
 
   /* This pipe is used by the parent to wait until
    * the child has called `execve()`. We need this
@@ -427,33 +521,31 @@ int uv_spawn(uv_loop_t* loop,
    * the parent polls the read end until it EOFs or errors with EPIPE.
    */
   if (uv__make_pipe(signal_pipe, 0))
-    goto error;
-
-  uv_signal_start(&loop->child_watcher, uv__chld, SIGCHLD);
+    return -1;
 
   pid = fork();
 
   if (pid == -1) {
-    close(signal_pipe[0]);
-    close(signal_pipe[1]);
-    goto error;
+    SAVE_ERRNO(close(signal_pipe[0]));
+    SAVE_ERRNO(close(signal_pipe[1]));
+    return -1;
   }
 
   if (pid == 0) {
-    uv__process_child_init(options, stdio_count, pipes, signal_pipe[1]);
+    uv__process_child_init(*options, stdio_count, pipes, signal_pipe[1]);
     abort();
   }
 
   close(signal_pipe[1]);
 
-  process->errorno = 0;
+  *errorno = 0;
   do
-    r = read(signal_pipe[0], &process->errorno, sizeof(process->errorno));
+    r = read(signal_pipe[0], errorno, sizeof(*errorno));
   while (r == -1 && errno == EINTR);
 
   if (r == 0)
     ; /* okay, EOF */
-  else if (r == sizeof(process->errorno))
+  else if (r == sizeof(*errorno))
     ; /* okay, read errorno */
   else if (r == -1 && errno == EPIPE)
     ; /* okay, got EPIPE */
@@ -462,6 +554,64 @@ int uv_spawn(uv_loop_t* loop,
 
   close(signal_pipe[0]);
 
+  return pid;
+}
+
+
+int uv_spawn(uv_loop_t* loop,
+             uv_process_t* process,
+             const uv_process_options_t options) {
+  int (*pipes)[2];
+  int stdio_count;
+  ngx_queue_t* q;
+  pid_t pid;
+  int i;
+
+  assert(options.file != NULL);
+  assert(!(options.flags & ~(UV_PROCESS_DETACHED |
+                             UV_PROCESS_SETGID |
+                             UV_PROCESS_SETUID |
+                             UV_PROCESS_WINDOWS_HIDE |
+                             UV_PROCESS_WINDOWS_VERBATIM_ARGUMENTS)));
+
+  uv__handle_init(loop, (uv_handle_t*)process, UV_PROCESS);
+  ngx_queue_init(&process->queue);
+
+  stdio_count = options.stdio_count;
+  if (stdio_count < 3)
+    stdio_count = 3;
+
+  pipes = malloc(stdio_count * sizeof(*pipes));
+  if (pipes == NULL) {
+    errno = ENOMEM;
+    goto error;
+  }
+
+  for (i = 0; i < stdio_count; i++) {
+    pipes[i][0] = -1;
+    pipes[i][1] = -1;
+  }
+
+  for (i = 0; i < options.stdio_count; i++)
+    if (uv__process_init_stdio(options.stdio + i, pipes[i]))
+      goto error;
+
+  uv_signal_start(&loop->child_watcher, uv__chld, SIGCHLD);
+
+  process->errorno = 0;
+  pid = -1;
+
+#if defined(UV__POSIX_SPAWN)
+  if (uv__process_spawn(&options, stdio_count, pipes, &pid))
+    pid = -1;
+#endif
+
+  if (pid == -1)
+    pid = uv__process_fork(&options, stdio_count, pipes, &process->errorno);
+
+  if (pid == -1)
+    goto error;
+
   for (i = 0; i < options.stdio_count; i++) {
     if (uv__process_open_stream(options.stdio + i, pipes[i], i == 0)) {
       while (i--) uv__process_close_stream(options.stdio + i);
@@ -32,9 +32,14 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/un.h>
+#include <fcntl.h> /* posix_fadvise */
 #include <unistd.h>
 #include <limits.h> /* IOV_MAX */
 
+#if defined(__linux__)
+# include <sys/sendfile.h>
+#endif
+
 #if defined(__APPLE__)
 # include <sys/event.h>
 # include <sys/time.h>
@@ -65,6 +70,7 @@ static void uv__write(uv_stream_t* stream);
 static void uv__read(uv_stream_t* stream);
 static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
 static size_t uv__write_req_size(uv_write_t* req);
+static void uv__sendfile_detach(uv_write_t* req);
 
 
 /* Used by the accept() EMFILE party trick. */
@@ -454,6 +460,7 @@ void uv__stream_destroy(uv_stream_t* stream) {
 
     req = ngx_queue_data(q, uv_write_t, queue);
     uv__req_unregister(stream->loop, req);
+    uv__sendfile_detach(req);
 
     if (req->bufs != req->bufsml)
       free(req->bufs);
@@ -732,6 +739,7 @@ static void uv__write_req_finish(uv_write_t* req) {
 
   /* Pop the req off tcp->write_queue. */
   ngx_queue_remove(&req->queue);
+  uv__sendfile_detach(req);
 
   /* Only free when there was no error. On error, we touch up write_queue_size
    * right before making the callback. The reason we don't do that right away
@@ -768,6 +776,180 @@ static int uv__handle_fd(uv_handle_t* handle) {
 }
 
 
+/* The file range of a uv_sendfile() request is read into the page cache on
+ * the thread pool, a window at a time, before the loop sends it. Otherwise
+ * a cold file blocks the whole loop in sendfile() or pread() while the disk
+ * catches up. The next window is requested when half of the current one is
+ * left, so a warm file is never waited for.
+ */
+#define UV__SENDFILE_WINDOW (1024 * 1024)
+
+struct uv__sendfile_prefetch {
+  struct uv__work work_req;
+  ngx_queue_t active_queue;  /* Keeps the loop alive, see uv__req_register. */
+  uv_loop_t* loop;
+  uv_write_t* req;  /* NULL when the request finished in the meantime. */
+  int fd;
+  int64_t offset;
+  int64_t end;
+};
+
+
+static void uv__sendfile_prefetch_work(struct uv__work* w) {
+  struct uv__sendfile_prefetch* p;
+  int64_t pagesize;
+  int64_t off;
+  ssize_t n;
+  char c;
+
+  p = container_of(w, struct uv__sendfile_prefetch, work_req);
+
+#if defined(POSIX_FADV_WILLNEED)
+  /* Get the reads for the whole window going at once... */
+  posix_fadvise(p->fd, p->offset, p->end - p->offset, POSIX_FADV_WILLNEED);
+#endif
+
+  /* ...then wait for them. Reading a byte of a page brings in all of it. */
+  pagesize = getpagesize();
+  for (off = p->offset; off < p->end; off = (off / pagesize + 1) * pagesize) {
+    do
+      n = pread(p->fd, &c, 1, off);
+    while (n == -1 && errno == EINTR);
+
+    /* Errors and a short file are reported when the range is sent. */
+    if (n <= 0)
+      break;
+  }
+}
+
+
+static void uv__sendfile_prefetch_done(struct uv__work* w, int status) {
+  struct uv__sendfile_prefetch* p;
+  uv_stream_t* stream;
+  uv_write_t* req;
+
+  p = container_of(w, struct uv__sendfile_prefetch, work_req);
+  uv__req_unregister(p->loop, p);
+  req = p->req;
+
+  if (req != NULL) {
+    req->sendfile_ready = p->end;
+    req->sendfile_prefetch = NULL;
+
+    stream = req->handle;
+    if (!uv__is_closing(stream))
+      uv__io_start(stream->loop, &stream->io_watcher, UV__POLLOUT);
+  }
+
+  free(p);
+}
+
+
+/* Reads the file from req->sendfile_ready up to `end` into the page cache. */
+static void uv__sendfile_prefetch(uv_write_t* req, int64_t end) {
+  struct uv__sendfile_prefetch* p;
+
+  p = malloc(sizeof(*p));
+  if (p == NULL) {
+    /* Send it anyway, at the risk of blocking. */
+    req->sendfile_ready = end;
+    return;
+  }
+
+  p->loop = req->handle->loop;
+  p->req = req;
+  p->fd = req->sendfile_fd;
+  p->offset = req->sendfile_ready;
+  p->end = end;
+  req->sendfile_prefetch = p;
+
+  uv__req_register(p->loop, p);
+  uv__work_submit(p->loop,
+                  &p->work_req,
+                  UV_WORK_FS,
+                  uv__sendfile_prefetch_work,
+                  uv__sendfile_prefetch_done);
+}
+
+
+/* The request is done with, a prefetch still running must not touch it. */
+static void uv__sendfile_detach(uv_write_t* req) {
+  if (req->sendfile_prefetch != NULL) {
+    req->sendfile_prefetch->req = NULL;
+    req->sendfile_prefetch = NULL;
+  }
+}
+
+
+/* Copies at most `len` bytes of the file `in_fd`, starting at `offset`, to
+ * the non-blocking stream `out_fd`. Returns the number of bytes written, 0
+ * when the file ends before `offset`, or -1 with errno set. Never blocks on
+ * the stream: the emulation only reads what it then tries to write once and
+ * re-reads any part that did not fit the next time around.
+ */
+static ssize_t uv__sendfile_nb(int out_fd,
+                               int in_fd,
+                               int64_t offset,
+                               size_t len) {
+  char buf[65536];
+  ssize_t nread;
+  ssize_t n;
+
+#if defined(__linux__)
+  {
+    off_t off;
+
+    off = offset;
+    do
+      n = sendfile(out_fd, in_fd, &off, len);
+    while (n == -1 && errno == EINTR);
+
+    if (n != -1 || (errno != EINVAL && errno != ENOSYS && errno != EXDEV))
+      return n;
+
+    errno = 0;
+  }
+#elif defined(__FreeBSD__) || defined(__APPLE__)
+  {
+    off_t nsent;
+
+#if defined(__FreeBSD__)
+    nsent = 0;
+    n = sendfile(in_fd, out_fd, offset, len, NULL, &nsent, 0);
+#else
+    nsent = len;
+    n = sendfile(in_fd, out_fd, offset, &nsent, NULL, 0);
+#endif
+
+    /* Partial writes to a non-blocking socket are reported as EAGAIN. */
+    if (n != -1 || nsent != 0)
+      return (ssize_t) nsent;
+
+    if (errno != EINVAL && errno != ENOTSOCK && errno != EOPNOTSUPP)
+      return -1;
+
+    errno = 0;
+  }
+#endif
+
+  if (len > sizeof(buf))
+    len = sizeof(buf);
+
+  do
+    nread = pread(in_fd, buf, len, offset);
+  while (nread == -1 && errno == EINTR);
+
+  if (nread <= 0)
+    return nread;
+
+  do
+    n = write(out_fd, buf, nread);
+  while (n == -1 && errno == EINTR);
+
+  return n;
+}
+
+
 static void uv__write(uv_stream_t* stream) {
   struct iovec* iov;
   ngx_queue_t* q;
@@ -803,7 +985,48 @@ start:
    * inside the iov each time we write. So there is no need to offset it.
    */
 
-  if (req->send_handle) {
+  if (req->sendfile_fd != -1) {
+    int64_t end;
+    size_t len;
+
+    assert(req->bufcnt == 1);
+    end = req->sendfile_offset + req->bufs[0].len;
+    len = req->bufs[0].len;
+
+    /* Blocking streams block the loop anyway. */
+    if (!(stream->flags & UV_STREAM_BLOCKING)) {
+      if (req->sendfile_prefetch == NULL &&
+          req->sendfile_ready < end &&
+          req->sendfile_ready - req->sendfile_offset <=
+              UV__SENDFILE_WINDOW / 2) {
+        if (end - req->sendfile_ready > UV__SENDFILE_WINDOW)
+          uv__sendfile_prefetch(req, req->sendfile_ready + UV__SENDFILE_WINDOW);
+        else
+          uv__sendfile_prefetch(req, end);
+      }
+
+      if (req->sendfile_offset == req->sendfile_ready) {
+        /* Nothing read ahead yet, uv__sendfile_prefetch_done() resumes. */
+        uv__io_stop(stream->loop, &stream->io_watcher, UV__POLLOUT);
+        return;
+      }
+
+      if ((int64_t) len > req->sendfile_ready - req->sendfile_offset)
+        len = req->sendfile_ready - req->sendfile_offset;
+    }
+
+    n = uv__sendfile_nb(uv__stream_fd(stream),
+                        req->sendfile_fd,
+                        req->sendfile_offset,
+                        len);
+    if (n == 0) {
+      /* The file is shorter than the caller promised. */
+      n = -1;
+      errno = EIO;
+    } else if (n > 0) {
+      req->sendfile_offset += n;
+    }
+  } else if (req->send_handle) {
     struct msghdr msg;
     char scratch[64];
     struct cmsghdr *cmsg;
@@ -870,7 +1093,8 @@ start:
       assert(req->write_index < req->bufcnt);
 
       if ((size_t)n < len) {
-        buf->base += n;
+        if (req->sendfile_fd == -1)
+          buf->base += n;
         buf->len -= n;
         stream->write_queue_size -= n;
         n = 0;
@@ -1228,12 +1452,12 @@ static void uv__stream_connect(uv_stream_t* stream) {
 }
 
 
-int uv_write2(uv_write_t* req,
-              uv_stream_t* stream,
-              uv_buf_t bufs[],
-              int bufcnt,
-              uv_stream_t* send_handle,
-              uv_write_cb cb) {
+static int uv__write_queue(uv_write_t* req,
+                           uv_stream_t* stream,
+                           uv_buf_t bufs[],
+                           int bufcnt,
+                           uv_stream_t* send_handle,
+                           uv_write_cb cb) {
   int empty_queue;
 
   assert(bufcnt > 0);
@@ -1312,6 +1536,45 @@ int uv_write2(uv_write_t* req,
 }
 
 
+int uv_write2(uv_write_t* req,
+              uv_stream_t* stream,
+              uv_buf_t bufs[],
+              int bufcnt,
+              uv_stream_t* send_handle,
+              uv_write_cb cb) {
+  req->sendfile_fd = -1;
+  req->sendfile_offset = 0;
+  req->sendfile_ready = 0;
+  req->sendfile_prefetch = NULL;
+  return uv__write_queue(req, stream, bufs, bufcnt, send_handle, cb);
+}
+
+
+int uv_sendfile(uv_write_t* req,
+                uv_stream_t* stream,
+                uv_file in_fd,
+                int64_t offset,
+                size_t length,
+                uv_write_cb cb) {
+  uv_buf_t buf;
+
+  if (in_fd < 0 || offset < 0 || length == 0)
+    return uv__set_artificial_error(stream->loop, UV_EINVAL);
+
+  /* The length rides in a placeholder buffer so that write_queue_size and
+   * the write_index bookkeeping treat the file range like any other write.
+   */
+  buf.base = NULL;
+  buf.len = length;
+
+  req->sendfile_fd = in_fd;
+  req->sendfile_offset = offset;
+  req->sendfile_ready = offset;
+  req->sendfile_prefetch = NULL;
+  return uv__write_queue(req, stream, &buf, 1, NULL, cb);
+}
+
+
 /* The buffers to be written must remain valid until the callback is called.
  * This is not required for the uv_buf_t array.
  */
@@ -67,6 +67,16 @@ static int uv__bind(uv_tcp_t* tcp,
   if (setsockopt(tcp->io_watcher.fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)))
     return uv__set_sys_error(tcp->loop, errno);
 
+#if defined(SO_REUSEPORT)
+  if (tcp->flags & UV_TCP_REUSEPORT)
+    if (setsockopt(tcp->io_watcher.fd,
+                   SOL_SOCKET,
+                   SO_REUSEPORT,
+                   &on,
+                   sizeof(on)))
+      return uv__set_sys_error(tcp->loop, errno);
+#endif
+
   errno = 0;
   if (bind(tcp->io_watcher.fd, addr, addrsize) && errno != EADDRINUSE)
     return uv__set_sys_error(tcp->loop, errno);
@@ -352,6 +362,27 @@ int uv_tcp_simultaneous_accepts(uv_tcp_t* handle, int enable) {
 }
 
 
+int uv_tcp_reuseport(uv_tcp_t* handle, int enable) {
+#if defined(SO_REUSEPORT)
+  int fd;
+
+  fd = uv__stream_fd(handle);
+  if (fd != -1)
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)))
+      return uv__set_sys_error(handle->loop, errno);
+
+  if (enable)
+    handle->flags |= UV_TCP_REUSEPORT;
+  else
+    handle->flags &= ~UV_TCP_REUSEPORT;
+
+  return 0;
+#else
+  return uv__set_artificial_error(handle->loop, UV_ENOTSUP);
+#endif
+}
+
+
 void uv__tcp_close(uv_tcp_t* handle) {
   uv__stream_close((uv_stream_t*)handle);
 }
@@ -20,18 +20,57 @@
  */
 
 #include "internal.h"
+#include <assert.h>
 #include <stdlib.h>
 
 #define MAX_THREADPOOL_SIZE 128
 
+/* Threads above a lane's minimum exit after idling for this long. */
+#define IDLE_TIMEOUT ((uint64_t) 5e9)
+
+enum {
+  SLOT_UNUSED = 0,
+  SLOT_RUNNING,
+  SLOT_EXITED  /* Thread has returned but has not been joined yet. */
+};
+
+struct lane;
+
+struct slot {
+  struct lane* lane;
+  uv_thread_t thread;
+  int state;
+};
+
+struct lane {
+  uv_mutex_t mutex;
+  uv_cond_t cond;
+  ngx_queue_t wq;
+  ngx_queue_t exit_message;
+  unsigned int nthreads;
+  unsigned int idle;
+  unsigned int min_threads;
+  unsigned int max_threads;
+  unsigned int queued;
+  uint64_t submitted;
+  uint64_t completed;
+  uint64_t wait_time;
+  uint64_t max_wait_time;
+  struct slot slots[MAX_THREADPOOL_SIZE];
+};
+
+static const struct {
+  const char* env;
+  unsigned int min_threads;
+  unsigned int max_threads;
+} lane_defaults[UV_WORK_LANE_MAX] = {
+  { "UV_THREADPOOL_FS_SIZE", 2, 16 },  /* UV_WORK_FS */
+  { "UV_THREADPOOL_DNS_SIZE", 1, 8 },  /* UV_WORK_DNS */
+  { "UV_THREADPOOL_CPU_SIZE", 1, 4 }   /* UV_WORK_CPU */
+};
+
 static uv_once_t once = UV_ONCE_INIT;
-static uv_cond_t cond;
-static uv_mutex_t mutex;
-static unsigned int nthreads;
-static uv_thread_t* threads;
-static uv_thread_t default_threads[4];
-static ngx_queue_t exit_message;
-static ngx_queue_t wq;
+static struct lane lanes[UV_WORK_LANE_MAX];
 static volatile int initialized;
 
 
@@ -41,38 +80,70 @@ static void uv__cancelled(struct uv__work* w) {
 
 
 /* To avoid deadlock with uv_cancel() it's crucial that the worker
- * never holds the global mutex and the loop-local mutex at the same time.
+ * never holds the lane mutex and the loop-local mutex at the same time.
  */
 static void worker(void* arg) {
   struct uv__work* w;
+  struct slot* slot;
+  struct lane* lane;
   ngx_queue_t* q;
+  uint64_t wait;
+  int timedout;
 
-  (void) arg;
+  slot = arg;
+  lane = slot->lane;
 
   for (;;) {
-    uv_mutex_lock(&mutex);
-
-    while (ngx_queue_empty(&wq))
-      uv_cond_wait(&cond, &mutex);
-
-    q = ngx_queue_head(&wq);
-
-    if (q == &exit_message)
-      uv_cond_signal(&cond);
-    else {
-      ngx_queue_remove(q);
-      ngx_queue_init(q);  /* Signal uv_cancel() that the work req is
-                             executing. */
+    uv_mutex_lock(&lane->mutex);
+
+    while (ngx_queue_empty(&lane->wq)) {
+      lane->idle++;
+      if (lane->nthreads > lane->min_threads)
+        timedout = uv_cond_timedwait(&lane->cond, &lane->mutex, IDLE_TIMEOUT);
+      else {
+        uv_cond_wait(&lane->cond, &lane->mutex);
+        timedout = 0;
+      }
+      lane->idle--;
+
+      if (timedout &&
+          ngx_queue_empty(&lane->wq) &&
+          lane->nthreads > lane->min_threads) {
+        lane->nthreads--;
+        slot->state = SLOT_EXITED;  /* Joined by the next spawn() or
+                                       cleanup(). */
+        uv_mutex_unlock(&lane->mutex);
+        return;
+      }
     }
 
-    uv_mutex_unlock(&mutex);
+    q = ngx_queue_head(&lane->wq);
 
-    if (q == &exit_message)
+    if (q == &lane->exit_message) {
+      uv_cond_signal(&lane->cond);
+      uv_mutex_unlock(&lane->mutex);
       break;
+    }
+
+    ngx_queue_remove(q);
+    ngx_queue_init(q);  /* Signal uv_cancel() that the work req is
+                           executing. */
+    lane->queued--;
 
     w = ngx_queue_data(q, struct uv__work, wq);
+    wait = uv__hrtime() - w->queued_time;
+    lane->wait_time += wait;
+    if (wait > lane->max_wait_time)
+      lane->max_wait_time = wait;
+
+    uv_mutex_unlock(&lane->mutex);
+
     w->work(w);
 
+    uv_mutex_lock(&lane->mutex);
+    lane->completed++;
+    uv_mutex_unlock(&lane->mutex);
+
     uv_mutex_lock(&w->loop->wq_mutex);
     w->work = NULL;  /* Signal uv_cancel() that the work req is done
                         executing. */
@@ -83,48 +154,115 @@ static void worker(void* arg) {
 }
 
 
-static void post(ngx_queue_t* q) {
-  uv_mutex_lock(&mutex);
-  ngx_queue_insert_tail(&wq, q);
-  uv_cond_signal(&cond);
-  uv_mutex_unlock(&mutex);
+/* Starts a new thread in the lane. Must be called with the lane mutex held. */
+static int spawn(struct lane* lane) {
+  struct slot* slot;
+  unsigned int i;
+
+  slot = NULL;
+  for (i = 0; i < ARRAY_SIZE(lane->slots); i++) {
+    if (lane->slots[i].state == SLOT_EXITED) {
+      if (uv_thread_join(&lane->slots[i].thread))
+        abort();
+      lane->slots[i].state = SLOT_UNUSED;
+    }
+
+    if (lane->slots[i].state == SLOT_UNUSED) {
+      slot = lane->slots + i;
+      break;
+    }
+  }
+
+  if (slot == NULL)
+    return -1;
+
+  slot->lane = lane;
+  slot->state = SLOT_RUNNING;
+  if (uv_thread_create(&slot->thread, worker, slot)) {
+    slot->state = SLOT_UNUSED;
+    return -1;
+  }
+
+  lane->nthreads++;
+  return 0;
+}
+
+
+static void post(struct lane* lane, ngx_queue_t* q) {
+  uv_mutex_lock(&lane->mutex);
+  ngx_queue_insert_tail(&lane->wq, q);
+
+  if (q != &lane->exit_message) {
+    lane->queued++;
+    lane->submitted++;
+
+    /* Grow the lane when there are more requests waiting than there are
+     * threads to pick them up. Failure is not fatal, the request simply
+     * waits for one of the existing threads.
+     */
+    if (lane->queued > lane->idle && lane->nthreads < lane->max_threads)
+      spawn(lane);
+  }
+
+  uv_cond_signal(&lane->cond);
+  uv_mutex_unlock(&lane->mutex);
+}
+
+
+static unsigned int getenv_size(const char* name, unsigned int def) {
+  const char* val;
+  unsigned int n;
+
+  val = getenv(name);
+  if (val == NULL)
+    return def;
+
+  n = atoi(val);
+  if (n == 0)
+    n = 1;
+  if (n > MAX_THREADPOOL_SIZE)
+    n = MAX_THREADPOOL_SIZE;
+
+  return n;
 }
 
 
 static void init_once(void) {
+  struct lane* lane;
+  unsigned int legacy;
   unsigned int i;
-  const char* val;
+  unsigned int k;
 
-  nthreads = ARRAY_SIZE(default_threads);
-  val = getenv("UV_THREADPOOL_SIZE");
-  if (val != NULL)
-    nthreads = atoi(val);
-  if (nthreads == 0)
-    nthreads = 1;
-  if (nthreads > MAX_THREADPOOL_SIZE)
-    nthreads = MAX_THREADPOOL_SIZE;
-
-  threads = default_threads;
-  if (nthreads > ARRAY_SIZE(default_threads)) {
-    threads = malloc(nthreads * sizeof(threads[0]));
-    if (threads == NULL) {
-      nthreads = ARRAY_SIZE(default_threads);
-      threads = default_threads;
-    }
-  }
+  /* UV_THREADPOOL_SIZE predates the lanes. When set, it replaces the default
+   * maximum of every lane that doesn't have a size of its own.
+   */
+  legacy = getenv_size("UV_THREADPOOL_SIZE", 0);
 
-  if (uv_cond_init(&cond))
-    abort();
+  for (i = 0; i < ARRAY_SIZE(lanes); i++) {
+    lane = lanes + i;
 
-  if (uv_mutex_init(&mutex))
-    abort();
+    lane->max_threads = lane_defaults[i].max_threads;
+    if (legacy != 0)
+      lane->max_threads = legacy;
+    lane->max_threads = getenv_size(lane_defaults[i].env, lane->max_threads);
 
-  ngx_queue_init(&wq);
+    lane->min_threads = lane_defaults[i].min_threads;
+    if (lane->min_threads > lane->max_threads)
+      lane->min_threads = lane->max_threads;
 
-  for (i = 0; i < nthreads; i++)
-    if (uv_thread_create(threads + i, worker, NULL))
+    if (uv_cond_init(&lane->cond))
       abort();
 
+    if (uv_mutex_init(&lane->mutex))
+      abort();
+
+    ngx_queue_init(&lane->wq);
+
+    for (k = 0; k < lane->min_threads; k++)
+      if (spawn(lane))
+        abort();
+  }
+
   initialized = 1;
 }
 
@@ -132,25 +270,32 @@ static void init_once(void) {
 #if defined(__GNUC__)
 __attribute__((destructor))
 static void cleanup(void) {
+  struct lane* lane;
   unsigned int i;
+  unsigned int k;
 
   if (initialized == 0)
     return;
 
-  post(&exit_message);
+  for (i = 0; i < ARRAY_SIZE(lanes); i++)
+    post(lanes + i, &lanes[i].exit_message);
 
-  for (i = 0; i < nthreads; i++)
-    if (uv_thread_join(threads + i))
-      abort();
+  for (i = 0; i < ARRAY_SIZE(lanes); i++) {
+    lane = lanes + i;
 
-  if (threads != default_threads)
-    free(threads);
+    for (k = 0; k < ARRAY_SIZE(lane->slots); k++) {
+      if (lane->slots[k].state == SLOT_UNUSED)
+        continue;
+      if (uv_thread_join(&lane->slots[k].thread))
+        abort();
+      lane->slots[k].state = SLOT_UNUSED;
+    }
 
-  uv_mutex_destroy(&mutex);
-  uv_cond_destroy(&cond);
+    uv_mutex_destroy(&lane->mutex);
+    uv_cond_destroy(&lane->cond);
+    lane->nthreads = 0;
+  }
 
-  threads = NULL;
-  nthreads = 0;
   initialized = 0;
 }
 #endif
@@ -158,28 +303,36 @@ static void cleanup(void) {
 
 void uv__work_submit(uv_loop_t* loop,
                      struct uv__work* w,
+                     unsigned int lane,
                      void (*work)(struct uv__work* w),
                      void (*done)(struct uv__work* w, int status)) {
+  assert(lane < UV_WORK_LANE_MAX);
   uv_once(&once, init_once);
   w->loop = loop;
   w->work = work;
   w->done = done;
-  post(&w->wq);
+  w->lane = lane;
+  w->queued_time = uv__hrtime();
+  post(lanes + lane, &w->wq);
 }
 
 
 static int uv__work_cancel(uv_loop_t* loop, uv_req_t* req, struct uv__work* w) {
+  struct lane* lane;
   int cancelled;
 
-  uv_mutex_lock(&mutex);
+  lane = lanes + w->lane;
+  uv_mutex_lock(&lane->mutex);
   uv_mutex_lock(&w->loop->wq_mutex);
 
   cancelled = !ngx_queue_empty(&w->wq) && w->work != NULL;
-  if (cancelled)
+  if (cancelled) {
     ngx_queue_remove(&w->wq);
+    lane->queued--;
+  }
 
   uv_mutex_unlock(&w->loop->wq_mutex);
-  uv_mutex_unlock(&mutex);
+  uv_mutex_unlock(&lane->mutex);
 
   if (!cancelled)
     return -1;
@@ -249,14 +402,52 @@ int uv_queue_work(uv_loop_t* loop,
                   uv_work_t* req,
                   uv_work_cb work_cb,
                   uv_after_work_cb after_work_cb) {
-  if (work_cb == NULL)
+  return uv_queue_work_lane(loop, req, UV_WORK_CPU, work_cb, after_work_cb);
+}
+
+
+int uv_queue_work_lane(uv_loop_t* loop,
+                       uv_work_t* req,
+                       uv_work_lane_t lane,
+                       uv_work_cb work_cb,
+                       uv_after_work_cb after_work_cb) {
+  if (work_cb == NULL || (unsigned int) lane >= UV_WORK_LANE_MAX)
     return uv__set_artificial_error(loop, UV_EINVAL);
 
   uv__req_init(loop, req, UV_WORK);
   req->loop = loop;
   req->work_cb = work_cb;
   req->after_work_cb = after_work_cb;
-  uv__work_submit(loop, &req->work_req, uv__queue_work, uv__queue_done);
+  uv__work_submit(loop,
+                  &req->work_req,
+                  lane,
+                  uv__queue_work,
+                  uv__queue_done);
+  return 0;
+}
+
+
+int uv_threadpool_stats(uv_work_lane_t lane, uv_threadpool_stats_t* stats) {
+  struct lane* l;
+
+  if ((unsigned int) lane >= UV_WORK_LANE_MAX || stats == NULL)
+    return -1;
+
+  uv_once(&once, init_once);
+  l = lanes + lane;
+
+  uv_mutex_lock(&l->mutex);
+  stats->threads = l->nthreads;
+  stats->idle = l->idle;
+  stats->min_threads = l->min_threads;
+  stats->max_threads = l->max_threads;
+  stats->queued = l->queued;
+  stats->submitted = l->submitted;
+  stats->completed = l->completed;
+  stats->wait_time = l->wait_time;
+  stats->max_wait_time = l->max_wait_time;
+  uv_mutex_unlock(&l->mutex);
+
   return 0;
 }
 
@@ -28,6 +28,12 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+/* Largest datagram that a single read is sized for. */
+#define UV__UDP_DGRAM_MAXSIZE (64 * 1024)
+
+/* Upper bound for uv_udp_set_batch(). */
+#define UV__MMSG_MAXWIDTH 64
+
 
 static void uv__udp_run_completed(uv_udp_t* handle);
 static void uv__udp_run_pending(uv_udp_t* handle);
@@ -85,12 +91,95 @@ void uv__udp_finish_close(uv_udp_t* handle) {
 }
 
 
+#if defined(__linux__)
+/* Returns -1 with errno set to ENOSYS when the kernel doesn't have
+ * sendmmsg(), 0 otherwise.
+ */
+static int uv__udp_run_pending_mmsg(uv_udp_t* handle) {
+  struct uv__mmsghdr msgs[UV__MMSG_MAXWIDTH];
+  struct msghdr* h;
+  uv_udp_send_t* req;
+  ngx_queue_t* q;
+  unsigned int pkts;
+  int npkts;
+  int i;
+
+  while (!ngx_queue_empty(&handle->write_queue)) {
+    pkts = 0;
+
+    for (q = ngx_queue_head(&handle->write_queue);
+         q != ngx_queue_sentinel(&handle->write_queue) &&
+         pkts < handle->batch_size;
+         q = ngx_queue_next(q)) {
+      req = ngx_queue_data(q, uv_udp_send_t, queue);
+
+      h = &msgs[pkts++].msg_hdr;
+      memset(h, 0, sizeof(*h));
+      h->msg_name = &req->addr;
+      h->msg_namelen = (req->addr.sin6_family == AF_INET6 ?
+        sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
+      h->msg_iov = (struct iovec*)req->bufs;
+      h->msg_iovlen = req->bufcnt;
+    }
+
+    do {
+      npkts = uv__sendmmsg(handle->io_watcher.fd, msgs, pkts, 0);
+    }
+    while (npkts == -1 && errno == EINTR);
+
+    if (npkts == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return 0;
+
+      if (errno == ENOSYS)
+        return -1;
+
+      /* sendmmsg() only fails when the first datagram can't be sent. Fail
+       * that one request, the ones behind it go out with the next call.
+       */
+      q = ngx_queue_head(&handle->write_queue);
+      req = ngx_queue_data(q, uv_udp_send_t, queue);
+      req->status = -errno;
+      ngx_queue_remove(&req->queue);
+      ngx_queue_insert_tail(&handle->write_completed_queue, &req->queue);
+      continue;
+    }
+
+    /* Datagrams are sent whole or not at all, see uv__udp_run_pending(). */
+    for (i = 0; i < npkts; i++) {
+      q = ngx_queue_head(&handle->write_queue);
+      req = ngx_queue_data(q, uv_udp_send_t, queue);
+      req->status = msgs[i].msg_len;
+      ngx_queue_remove(&req->queue);
+      ngx_queue_insert_tail(&handle->write_completed_queue, &req->queue);
+    }
+
+    /* Socket buffer is full. */
+    if ((unsigned int) npkts < pkts)
+      return 0;
+  }
+
+  return 0;
+}
+#endif /* __linux__ */
+
+
 static void uv__udp_run_pending(uv_udp_t* handle) {
   uv_udp_send_t* req;
   ngx_queue_t* q;
   struct msghdr h;
   ssize_t size;
 
+#if defined(__linux__)
+  if (handle->batch_size > 1) {
+    if (uv__udp_run_pending_mmsg(handle) == 0)
+      return;
+
+    /* No sendmmsg(), turn batching off and send one datagram at a time. */
+    handle->batch_size = 0;
+  }
+#endif
+
   while (!ngx_queue_empty(&handle->write_queue)) {
     q = ngx_queue_head(&handle->write_queue);
     assert(q != NULL);
@@ -183,6 +272,85 @@ static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents) {
 }
 
 
+#if defined(__linux__)
+/* Reads a batch of datagrams into `buf`, see uv_udp_set_batch(). Returns the
+ * number of datagrams read or -1 on error. The buffer is passed back to
+ * recv_cb except when errno is ENOSYS, then the caller still owns it.
+ */
+static int uv__udp_recvmmsg(uv_udp_t* handle, uv_buf_t buf) {
+  struct sockaddr_storage peers[UV__MMSG_MAXWIDTH];
+  struct iovec iov[UV__MMSG_MAXWIDTH];
+  struct uv__mmsghdr msgs[UV__MMSG_MAXWIDTH];
+  struct msghdr* h;
+  unsigned int chunks;
+  unsigned int k;
+  uv_buf_t chunk;
+  int nread;
+  int flags;
+
+  chunks = buf.len / UV__UDP_DGRAM_MAXSIZE;
+  if (chunks > handle->batch_size)
+    chunks = handle->batch_size;
+
+  for (k = 0; k < chunks; k++) {
+    iov[k].iov_base = buf.base + k * UV__UDP_DGRAM_MAXSIZE;
+    iov[k].iov_len = UV__UDP_DGRAM_MAXSIZE;
+
+    h = &msgs[k].msg_hdr;
+    memset(h, 0, sizeof(*h));
+    h->msg_iov = iov + k;
+    h->msg_iovlen = 1;
+    h->msg_name = peers + k;
+    h->msg_namelen = sizeof(peers[k]);
+  }
+
+  do {
+    nread = uv__recvmmsg(handle->io_watcher.fd, msgs, chunks, 0, NULL);
+  }
+  while (nread == -1 && errno == EINTR);
+
+  if (nread == -1) {
+    if (errno == ENOSYS)
+      return -1;
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      uv__set_sys_error(handle->loop, EAGAIN);
+      handle->recv_cb(handle, 0, buf, NULL, 0);
+    }
+    else {
+      uv__set_sys_error(handle->loop, errno);
+      handle->recv_cb(handle, -1, buf, NULL, 0);
+    }
+
+    return -1;
+  }
+
+  for (k = 0; k < (unsigned int) nread; k++) {
+    /* recv_cb callback may decide to pause or close the handle */
+    if (handle->io_watcher.fd == -1 || handle->recv_cb == NULL)
+      return nread;
+
+    flags = UV_UDP_MMSG_CHUNK;
+    if (msgs[k].msg_hdr.msg_flags & MSG_TRUNC)
+      flags |= UV_UDP_PARTIAL;
+
+    chunk = uv_buf_init(iov[k].iov_base, msgs[k].msg_len);
+    handle->recv_cb(handle,
+                    msgs[k].msg_len,
+                    chunk,
+                    (struct sockaddr*)(peers + k),
+                    flags);
+  }
+
+  /* End of the batch, hand the buffer back. */
+  if (handle->io_watcher.fd != -1 && handle->recv_cb != NULL)
+    handle->recv_cb(handle, 0, buf, NULL, 0);
+
+  return nread;
+}
+#endif /* __linux__ */
+
+
 static void uv__udp_recvmsg(uv_loop_t* loop,
                             uv__io_t* w,
                             unsigned int revents) {
@@ -210,10 +378,25 @@ static void uv__udp_recvmsg(uv_loop_t* loop,
   h.msg_name = &peer;
 
   do {
-    buf = handle->alloc_cb((uv_handle_t*)handle, 64 * 1024);
+    if (handle->batch_size > 1)
+      buf = handle->alloc_cb((uv_handle_t*)handle,
+                             handle->batch_size * UV__UDP_DGRAM_MAXSIZE);
+    else
+      buf = handle->alloc_cb((uv_handle_t*)handle, UV__UDP_DGRAM_MAXSIZE);
     assert(buf.len > 0);
     assert(buf.base != NULL);
 
+#if defined(__linux__)
+    if (handle->batch_size > 1 && buf.len >= 2 * UV__UDP_DGRAM_MAXSIZE) {
+      nread = uv__udp_recvmmsg(handle, buf);
+      if (nread != -1 || errno != ENOSYS)
+        continue;
+
+      /* No recvmmsg(), turn batching off and read into `buf` below. */
+      handle->batch_size = 0;
+    }
+#endif
+
     h.msg_namelen = sizeof(peer);
     h.msg_iov = (void*) &buf;
     h.msg_iovlen = 1;
@@ -463,6 +646,7 @@ int uv_udp_init(uv_loop_t* loop, uv_udp_t* handle) {
   uv__handle_init(loop, (uv_handle_t*)handle, UV_UDP);
   handle->alloc_cb = NULL;
   handle->recv_cb = NULL;
+  handle->batch_size = 0;
   uv__io_init(&handle->io_watcher, uv__udp_io, -1);
   ngx_queue_init(&handle->write_queue);
   ngx_queue_init(&handle->write_completed_queue);
@@ -598,6 +782,19 @@ int uv_udp_set_ttl(uv_udp_t* handle, int ttl) {
 }
 
 
+int uv_udp_set_batch(uv_udp_t* handle, unsigned int count) {
+#if defined(__linux__)
+  if (count > UV__MMSG_MAXWIDTH)
+    return uv__set_artificial_error(handle->loop, UV_EINVAL);
+
+  handle->batch_size = (count > 1 ? count : 0);
+  return 0;
+#else
+  return uv__set_artificial_error(handle->loop, UV_ENOSYS);
+#endif
+}
+
+
 int uv_udp_set_multicast_ttl(uv_udp_t* handle, int ttl) {
   return uv__setsockopt_maybe_char(handle, IP_MULTICAST_TTL, ttl);
 }
@@ -1283,6 +1283,12 @@ int uv_tcp_simultaneous_accepts(uv_tcp_t* handle, int enable) {
 }
 
 
+int uv_tcp_reuseport(uv_tcp_t* handle, int enable) {
+  uv__set_artificial_error(handle->loop, UV_ENOTSUP);
+  return -1;
+}
+
+
 static int uv_tcp_try_cancel_io(uv_tcp_t* tcp) {
   SOCKET socket = tcp->socket;
   int non_ifs_lsp;
@@ -70,6 +70,21 @@ int uv_queue_work(uv_loop_t* loop, uv_work_t* req, uv_work_cb work_cb,
 }
 
 
+int uv_queue_work_lane(uv_loop_t* loop, uv_work_t* req, uv_work_lane_t lane,
+    uv_work_cb work_cb, uv_after_work_cb after_work_cb) {
+  /* The system thread pool doesn't have lanes. */
+  if ((unsigned int) lane >= UV_WORK_LANE_MAX)
+    return uv__set_artificial_error(loop, UV_EINVAL);
+
+  return uv_queue_work(loop, req, work_cb, after_work_cb);
+}
+
+
+int uv_threadpool_stats(uv_work_lane_t lane, uv_threadpool_stats_t* stats) {
+  return -1;
+}
+
+
 int uv_cancel(uv_req_t* req) {
   return -1;
 }
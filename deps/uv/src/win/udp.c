@@ -741,3 +741,8 @@ SOCKOPT_SETTER(multicast_loop,
 #undef VALIDATE_TTL
 #undef VALIDATE_MULTICAST_TTL
 #undef VALIDATE_MULTICAST_LOOP
+
+
+int uv_udp_set_batch(uv_udp_t* handle, unsigned int count) {
+  return uv__set_artificial_error(handle->loop, UV_ENOSYS);
+}
@@ -155,5 +155,19 @@ static int maybe_run_test(int argc, char **argv) {
     return 1;
   }
 
+  if (strcmp(argv[1], "spawn_helper8") == 0) {
+    char buffer[1024];
+    uv_err_t err;
+    int r;
+
+    err = uv_cwd(buffer, sizeof(buffer));
+    ASSERT(err.code == UV_OK);
+
+    r = fprintf(stdout, "%s", buffer);
+    ASSERT(r > 0);
+
+    return 1;
+  }
+
   return run_test(argv[1], TEST_TIMEOUT, 0, 1);
 }
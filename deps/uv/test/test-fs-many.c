@@ -0,0 +1,195 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Puts more requests in flight than the io_uring backend has room for, so
+ * that part of them spills over to the thread pool. Either way every
+ * request must complete with the right result.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+# include <io.h>
+# define unlink _unlink
+#else
+# include <unistd.h>
+#endif
+
+#define FIXTURE "test_file_many"
+#define FILE_SIZE 4096
+#define NUM_REQS 1000
+
+static uv_fs_t read_reqs[NUM_REQS];
+static uv_fs_t fstat_reqs[NUM_REQS];
+static uv_fs_t stat_reqs[NUM_REQS];
+static char read_bufs[NUM_REQS];
+static char contents[FILE_SIZE];
+
+static uv_fs_t open_req;
+static uv_fs_t chain_read_req;
+static uv_fs_t close_req;
+static char chain_buf[16];
+
+static int read_cb_called;
+static int stat_cb_called;
+static int open_cb_called;
+static int chain_read_cb_called;
+static int close_cb_called;
+
+
+static int read_offset(int i) {
+  return (i * 13) % FILE_SIZE;
+}
+
+
+static void read_cb(uv_fs_t* req) {
+  int i;
+
+  i = req - read_reqs;
+  ASSERT(i >= 0 && i < NUM_REQS);
+  ASSERT(req->fs_type == UV_FS_READ);
+  ASSERT(req->result == 1);
+  ASSERT(read_bufs[i] == contents[read_offset(i)]);
+  read_cb_called++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void stat_cb(uv_fs_t* req) {
+  uv_statbuf_t* s;
+
+  ASSERT(req->fs_type == UV_FS_STAT || req->fs_type == UV_FS_FSTAT);
+  ASSERT(req->result == 0);
+  s = req->ptr;
+  ASSERT(s == &req->statbuf);
+  ASSERT(s->st_size == FILE_SIZE);
+  ASSERT(S_ISREG(s->st_mode));
+  stat_cb_called++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void close_cb(uv_fs_t* req) {
+  ASSERT(req == &close_req);
+  ASSERT(req->result == 0);
+  close_cb_called++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void chain_read_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req == &chain_read_req);
+  ASSERT(req->result == sizeof(chain_buf));
+  ASSERT(memcmp(chain_buf, contents, sizeof(chain_buf)) == 0);
+  chain_read_cb_called++;
+  uv_fs_req_cleanup(req);
+
+  r = uv_fs_close(req->loop, &close_req, open_req.result, close_cb);
+  ASSERT(r == 0);
+}
+
+
+static void open_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req == &open_req);
+  ASSERT(req->result >= 0);
+  open_cb_called++;
+
+  /* Offset -1 means "read from the current file position". */
+  r = uv_fs_read(req->loop,
+                 &chain_read_req,
+                 req->result,
+                 chain_buf,
+                 sizeof(chain_buf),
+                 -1,
+                 chain_read_cb);
+  ASSERT(r == 0);
+}
+
+
+TEST_IMPL(fs_read_many) {
+  uv_loop_t* loop;
+  uv_fs_t req;
+  int file;
+  int r;
+  int i;
+
+  loop = uv_default_loop();
+
+  for (i = 0; i < FILE_SIZE; i++)
+    contents[i] = (char) (i * 7);
+
+  unlink(FIXTURE);
+  r = uv_fs_open(loop, &req, FIXTURE, O_RDWR | O_CREAT, S_IWUSR | S_IRUSR,
+                 NULL);
+  ASSERT(r >= 0);
+  file = req.result;
+  uv_fs_req_cleanup(&req);
+
+  r = uv_fs_write(loop, &req, file, contents, sizeof(contents), 0, NULL);
+  ASSERT(r == FILE_SIZE);
+  uv_fs_req_cleanup(&req);
+
+  for (i = 0; i < NUM_REQS; i++) {
+    r = uv_fs_read(loop,
+                   read_reqs + i,
+                   file,
+                   read_bufs + i,
+                   1,
+                   read_offset(i),
+                   read_cb);
+    ASSERT(r == 0);
+    r = uv_fs_fstat(loop, fstat_reqs + i, file, stat_cb);
+    ASSERT(r == 0);
+    r = uv_fs_stat(loop, stat_reqs + i, FIXTURE, stat_cb);
+    ASSERT(r == 0);
+  }
+
+  r = uv_fs_open(loop, &open_req, FIXTURE, O_RDONLY, 0, open_cb);
+  ASSERT(r == 0);
+
+  r = uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(r == 0);
+
+  ASSERT(read_cb_called == NUM_REQS);
+  ASSERT(stat_cb_called == 2 * NUM_REQS);
+  ASSERT(open_cb_called == 1);
+  ASSERT(chain_read_cb_called == 1);
+  ASSERT(close_cb_called == 1);
+  uv_fs_req_cleanup(&open_req);
+
+  r = uv_fs_close(loop, &req, file, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&req);
+
+  unlink(FIXTURE);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,91 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include "uv.h"
+#include "task.h"
+
+static uv_timer_t timer_handle;
+static uint64_t poll_wait;
+static int timer_cb_called;
+static int metrics_cb_called;
+static int metrics_cb_called_before_stop;
+
+
+static void metrics_cb(uv_loop_t* loop, const uv_loop_metrics_t* metrics) {
+  uint64_t total;
+  int i;
+
+  ASSERT(loop == uv_default_loop());
+  ASSERT(metrics->start != 0);
+  ASSERT(metrics->start <= uv_hrtime());
+  ASSERT(metrics->poll_wait <= metrics->phase_time[UV_LOOP_PHASE_POLL]);
+
+  total = 0;
+  for (i = 0; i < UV_LOOP_PHASE_MAX; i++)
+    total += metrics->phase_time[i];
+  ASSERT(total <= uv_hrtime() - metrics->start);
+
+  poll_wait += metrics->poll_wait;
+  metrics_cb_called++;
+}
+
+
+static void timer_cb2(uv_timer_t* handle, int status) {
+  timer_cb_called++;
+  uv_close((uv_handle_t*) handle, NULL);
+}
+
+
+static void timer_cb(uv_timer_t* handle, int status) {
+  timer_cb_called++;
+
+  /* Takes effect right away, this iteration isn't reported. */
+  ASSERT(0 == uv_loop_configure(handle->loop, UV_LOOP_METRICS, NULL));
+  metrics_cb_called_before_stop = metrics_cb_called;
+
+  ASSERT(0 == uv_timer_start(handle, timer_cb2, 10, 0));
+}
+
+
+TEST_IMPL(loop_metrics) {
+  uv_loop_t* loop;
+
+  loop = uv_default_loop();
+#ifdef _WIN32
+  ASSERT(UV_ENOSYS == uv_loop_configure(loop, UV_LOOP_METRICS, metrics_cb));
+#else
+  ASSERT(0 == uv_loop_configure(loop, UV_LOOP_METRICS, metrics_cb));
+  ASSERT(0 == uv_timer_init(loop, &timer_handle));
+  ASSERT(0 == uv_timer_start(&timer_handle, timer_cb, 50, 0));
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(timer_cb_called == 2);
+  ASSERT(metrics_cb_called > 0);
+  ASSERT(metrics_cb_called == metrics_cb_called_before_stop);
+
+  /* Most of the 50 ms went by waiting for the timer. */
+  ASSERT(poll_wait >= 40 * 1000000);
+#endif
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
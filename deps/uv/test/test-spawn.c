@@ -495,6 +495,46 @@ TEST_IMPL(spawn_preserve_env) {
 }
 
 
+TEST_IMPL(spawn_cwd) {
+  int r;
+  uv_pipe_t out;
+  uv_stdio_container_t stdio[2];
+#ifdef _WIN32
+  char cwd[] = "C:\\";
+#else
+  char cwd[] = "/";
+#endif
+
+  init_process_options("spawn_helper8", exit_cb);
+
+  uv_pipe_init(uv_default_loop(), &out, 0);
+  options.stdio = stdio;
+  options.stdio[0].flags = UV_IGNORE;
+  options.stdio[1].flags = UV_CREATE_PIPE | UV_WRITABLE_PIPE;
+  options.stdio[1].data.stream = (uv_stream_t*) &out;
+  options.stdio_count = 2;
+  options.cwd = cwd;
+
+  r = uv_spawn(uv_default_loop(), &process, options);
+  ASSERT(r == 0);
+
+  r = uv_read_start((uv_stream_t*) &out, on_alloc, on_read);
+  ASSERT(r == 0);
+
+  r = uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+  ASSERT(r == 0);
+
+  ASSERT(exit_cb_called == 1);
+  ASSERT(close_cb_called == 2);
+
+  printf("output is: %s\n", output);
+  ASSERT(strcmp(cwd, output) == 0);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
 TEST_IMPL(spawn_detached) {
   int r;
   uv_err_t err;
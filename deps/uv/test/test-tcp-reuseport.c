@@ -0,0 +1,134 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_CLIENTS 32
+
+static uv_tcp_t servers[2];
+static uv_tcp_t clients[NUM_CLIENTS];
+static uv_connect_t connect_reqs[NUM_CLIENTS];
+static int accepted[2];
+static int connect_cb_called;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void free_close_cb(uv_handle_t* handle) {
+  free(handle);
+  close_cb_called++;
+}
+
+
+static void connection_cb(uv_stream_t* server, int status) {
+  uv_tcp_t* conn;
+  int r;
+
+  ASSERT(status == 0);
+
+  conn = malloc(sizeof(*conn));
+  ASSERT(conn != NULL);
+
+  r = uv_tcp_init(server->loop, conn);
+  ASSERT(r == 0);
+
+  r = uv_accept(server, (uv_stream_t*) conn);
+  ASSERT(r == 0);
+
+  uv_close((uv_handle_t*) conn, free_close_cb);
+
+  accepted[(uv_tcp_t*) server - servers]++;
+
+  if (accepted[0] + accepted[1] == NUM_CLIENTS) {
+    uv_close((uv_handle_t*) &servers[0], close_cb);
+    uv_close((uv_handle_t*) &servers[1], close_cb);
+  }
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+  connect_cb_called++;
+  uv_close((uv_handle_t*) req->handle, close_cb);
+}
+
+
+TEST_IMPL(tcp_reuseport) {
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  int i;
+  int r;
+
+  addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+  loop = uv_default_loop();
+
+  for (i = 0; i < 2; i++) {
+    r = uv_tcp_init(loop, &servers[i]);
+    ASSERT(r == 0);
+
+    r = uv_tcp_reuseport(&servers[i], 1);
+    if (r != 0) {
+      ASSERT(uv_last_error(loop).code == UV_ENOTSUP);
+      RETURN_SKIP("SO_REUSEPORT not supported");
+    }
+
+    r = uv_tcp_bind(&servers[i], addr);
+    ASSERT(r == 0);
+
+    r = uv_listen((uv_stream_t*) &servers[i], NUM_CLIENTS, connection_cb);
+    ASSERT(r == 0);
+  }
+
+  for (i = 0; i < NUM_CLIENTS; i++) {
+    r = uv_tcp_init(loop, &clients[i]);
+    ASSERT(r == 0);
+
+    r = uv_tcp_connect(&connect_reqs[i], &clients[i], addr, connect_cb);
+    ASSERT(r == 0);
+  }
+
+  r = uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(r == 0);
+
+  ASSERT(connect_cb_called == NUM_CLIENTS);
+  ASSERT(accepted[0] + accepted[1] == NUM_CLIENTS);
+  ASSERT(close_cb_called == 2 * NUM_CLIENTS + 2);
+
+#if defined(__linux__)
+  /* Linux hashes connections over the sockets. Both of them should have
+   * seen some, the chance that one got all 32 is 2^-31.
+   */
+  ASSERT(accepted[0] > 0);
+  ASSERT(accepted[1] > 0);
+#endif
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
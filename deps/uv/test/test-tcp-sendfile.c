@@ -0,0 +1,329 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+/* Large enough to fill the socket buffers so that the file range is sent in
+ * several rounds, interleaved with EAGAIN.
+ */
+#define FILE_SIZE (4 * 1024 * 1024)
+#define FILE_OFFSET 3
+#define TEST_FILE "test_file_tcp_sendfile"
+
+static uv_tcp_t server;
+static uv_tcp_t client;
+static uv_tcp_t incoming;
+static uv_connect_t connect_req;
+static uv_write_t head_req;
+static uv_write_t file_req;
+static uv_write_t tail_req;
+static uv_shutdown_t shutdown_req;
+
+static char* file_data;
+static char* received;
+static size_t nreceived;
+static size_t expected_len;
+static uv_file file_fd;
+
+static int write_cb_called;
+static int shutdown_cb_called;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static uv_buf_t alloc_cb(uv_handle_t* handle, size_t suggested_size) {
+  static char slab[65536];
+  return uv_buf_init(slab, sizeof(slab));
+}
+
+
+static void read_cb(uv_stream_t* handle, ssize_t nread, uv_buf_t buf) {
+  if (nread < 0) {
+    ASSERT(uv_last_error(handle->loop).code == UV_EOF);
+    uv_close((uv_handle_t*) handle, close_cb);
+    uv_close((uv_handle_t*) &server, close_cb);
+    return;
+  }
+
+  ASSERT(nreceived + nread <= expected_len);
+  memcpy(received + nreceived, buf.base, nread);
+  nreceived += nread;
+}
+
+
+static void connection_cb(uv_stream_t* handle, int status) {
+  int r;
+
+  ASSERT(status == 0);
+
+  r = uv_tcp_init(handle->loop, &incoming);
+  ASSERT(r == 0);
+
+  r = uv_accept(handle, (uv_stream_t*) &incoming);
+  ASSERT(r == 0);
+
+  r = uv_read_start((uv_stream_t*) &incoming, alloc_cb, read_cb);
+  ASSERT(r == 0);
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+
+  /* Writes complete in the order they were queued. */
+  if (write_cb_called == 0)
+    ASSERT(req == &head_req);
+  else if (write_cb_called == 1)
+    ASSERT(req == &file_req);
+  else
+    ASSERT(req == &tail_req);
+
+  write_cb_called++;
+}
+
+
+static void shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(status == 0);
+  ASSERT(client.write_queue_size == 0);
+  shutdown_cb_called++;
+  uv_close((uv_handle_t*) &client, close_cb);
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_buf_t buf;
+  int r;
+
+  ASSERT(status == 0);
+
+  buf = uv_buf_init("head", 4);
+  r = uv_write(&head_req, (uv_stream_t*) &client, &buf, 1, write_cb);
+  ASSERT(r == 0);
+
+  r = uv_sendfile(&file_req,
+                  (uv_stream_t*) &client,
+                  file_fd,
+                  FILE_OFFSET,
+                  FILE_SIZE - FILE_OFFSET,
+                  write_cb);
+  ASSERT(r == 0);
+  ASSERT(client.write_queue_size > 0);
+
+  buf = uv_buf_init("tail", 4);
+  r = uv_write(&tail_req, (uv_stream_t*) &client, &buf, 1, write_cb);
+  ASSERT(r == 0);
+
+  r = uv_shutdown(&shutdown_req, (uv_stream_t*) &client, shutdown_cb);
+  ASSERT(r == 0);
+}
+
+
+TEST_IMPL(tcp_sendfile) {
+#ifdef _WIN32
+  RETURN_SKIP("uv_sendfile() is not supported on Windows");
+#else
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  uv_fs_t req;
+  size_t i;
+  int r;
+
+  loop = uv_default_loop();
+  addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+
+  file_data = malloc(FILE_SIZE);
+  ASSERT(file_data != NULL);
+  for (i = 0; i < FILE_SIZE; i++)
+    file_data[i] = (char) (i * 7 + (i >> 12));
+
+  expected_len = 4 + (FILE_SIZE - FILE_OFFSET) + 4;
+  received = malloc(expected_len);
+  ASSERT(received != NULL);
+
+  unlink(TEST_FILE);
+  r = uv_fs_open(loop, &req, TEST_FILE, O_RDWR | O_CREAT,
+      S_IWUSR | S_IRUSR, NULL);
+  ASSERT(r >= 0);
+  file_fd = r;
+  uv_fs_req_cleanup(&req);
+
+  r = uv_fs_write(loop, &req, file_fd, file_data, FILE_SIZE, 0, NULL);
+  ASSERT(r == FILE_SIZE);
+  uv_fs_req_cleanup(&req);
+
+  /* Invalid ranges are rejected up front. */
+  r = uv_tcp_init(loop, &client);
+  ASSERT(r == 0);
+  r = uv_sendfile(&file_req, (uv_stream_t*) &client, file_fd, -1, 1, NULL);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(loop).code == UV_EINVAL);
+  r = uv_sendfile(&file_req, (uv_stream_t*) &client, file_fd, 0, 0, NULL);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(loop).code == UV_EINVAL);
+
+  r = uv_tcp_init(loop, &server);
+  ASSERT(r == 0);
+  r = uv_tcp_bind(&server, addr);
+  ASSERT(r == 0);
+  r = uv_listen((uv_stream_t*) &server, 1, connection_cb);
+  ASSERT(r == 0);
+
+  r = uv_tcp_connect(&connect_req, &client, addr, connect_cb);
+  ASSERT(r == 0);
+
+  r = uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(r == 0);
+
+  ASSERT(write_cb_called == 3);
+  ASSERT(shutdown_cb_called == 1);
+  ASSERT(close_cb_called == 3);
+
+  ASSERT(nreceived == expected_len);
+  ASSERT(memcmp(received, "head", 4) == 0);
+  ASSERT(memcmp(received + 4,
+                file_data + FILE_OFFSET,
+                FILE_SIZE - FILE_OFFSET) == 0);
+  ASSERT(memcmp(received + expected_len - 4, "tail", 4) == 0);
+
+  r = uv_fs_close(loop, &req, file_fd, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&req);
+  unlink(TEST_FILE);
+
+  free(file_data);
+  free(received);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+#endif
+}
+
+
+static void close_write_cb(uv_write_t* req, int status) {
+  ASSERT(req == &file_req);
+  ASSERT(status == -1);
+  ASSERT(uv_last_error(req->handle->loop).code == UV_ECANCELED);
+  write_cb_called++;
+}
+
+
+static void close_connect_cb(uv_connect_t* req, int status) {
+  int r;
+
+  ASSERT(status == 0);
+
+  /* The file is still being read ahead on the thread pool when the stream
+   * goes away. The request is cancelled and the read ahead left to finish
+   * on its own.
+   */
+  r = uv_sendfile(&file_req,
+                  (uv_stream_t*) &client,
+                  file_fd,
+                  0,
+                  FILE_SIZE,
+                  close_write_cb);
+  ASSERT(r == 0);
+
+  uv_close((uv_handle_t*) &client, close_cb);
+  uv_close((uv_handle_t*) &server, close_cb);
+}
+
+
+static void close_connection_cb(uv_stream_t* handle, int status) {
+  int r;
+
+  ASSERT(status == 0);
+
+  r = uv_tcp_init(handle->loop, &incoming);
+  ASSERT(r == 0);
+  r = uv_accept(handle, (uv_stream_t*) &incoming);
+  ASSERT(r == 0);
+  uv_close((uv_handle_t*) &incoming, close_cb);
+}
+
+
+TEST_IMPL(tcp_sendfile_close) {
+#ifdef _WIN32
+  RETURN_SKIP("uv_sendfile() is not supported on Windows");
+#else
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  uv_fs_t req;
+  int r;
+
+  loop = uv_default_loop();
+  addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+
+  file_data = calloc(1, FILE_SIZE);
+  ASSERT(file_data != NULL);
+
+  unlink(TEST_FILE);
+  r = uv_fs_open(loop, &req, TEST_FILE, O_RDWR | O_CREAT,
+      S_IWUSR | S_IRUSR, NULL);
+  ASSERT(r >= 0);
+  file_fd = r;
+  uv_fs_req_cleanup(&req);
+
+  r = uv_fs_write(loop, &req, file_fd, file_data, FILE_SIZE, 0, NULL);
+  ASSERT(r == FILE_SIZE);
+  uv_fs_req_cleanup(&req);
+
+  r = uv_tcp_init(loop, &server);
+  ASSERT(r == 0);
+  r = uv_tcp_bind(&server, addr);
+  ASSERT(r == 0);
+  r = uv_listen((uv_stream_t*) &server, 1, close_connection_cb);
+  ASSERT(r == 0);
+
+  r = uv_tcp_init(loop, &client);
+  ASSERT(r == 0);
+  r = uv_tcp_connect(&connect_req, &client, addr, close_connect_cb);
+  ASSERT(r == 0);
+
+  r = uv_run(loop, UV_RUN_DEFAULT);
+  ASSERT(r == 0);
+
+  ASSERT(write_cb_called == 1);
+
+  r = uv_fs_close(loop, &req, file_fd, NULL);
+  ASSERT(r == 0);
+  uv_fs_req_cleanup(&req);
+  unlink(TEST_FILE);
+
+  free(file_data);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+#endif
+}
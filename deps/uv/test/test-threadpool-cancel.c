@@ -22,6 +22,8 @@
 #include "uv.h"
 #include "task.h"
 
+#include <stdlib.h>
+
 #define INIT_CANCEL_INFO(ci, what)                                            \
   do {                                                                        \
     (ci)->reqs = (what);                                                      \
@@ -67,7 +69,10 @@ static void done_cb(uv_work_t* req, int status) {
 }
 
 
-static void saturate_threadpool(void) {
+/* Work requests only compete for threads with other requests in the same
+ * lane so block every thread in the lane that the test exercises.
+ */
+static void saturate_threadpool(uv_work_lane_t lane) {
   uv_work_t* req;
 
   ASSERT(0 == uv_cond_init(&signal_cond));
@@ -80,7 +85,11 @@ static void saturate_threadpool(void) {
   for (num_threads = 0; /* empty */; num_threads++) {
     req = malloc(sizeof(*req));
     ASSERT(req != NULL);
-    ASSERT(0 == uv_queue_work(uv_default_loop(), req, work_cb, done_cb));
+    ASSERT(0 == uv_queue_work_lane(uv_default_loop(),
+                                   req,
+                                   lane,
+                                   work_cb,
+                                   done_cb));
 
     /* Expect to get signalled within 350 ms, otherwise assume that
      * the thread pool is saturated. As with any timing dependent test,
@@ -174,7 +183,7 @@ TEST_IMPL(threadpool_cancel_getaddrinfo) {
 
   INIT_CANCEL_INFO(&ci, reqs);
   loop = uv_default_loop();
-  saturate_threadpool();
+  saturate_threadpool(UV_WORK_DNS);
 
   r = uv_getaddrinfo(loop, reqs + 0, getaddrinfo_cb, "fail", NULL, NULL);
   ASSERT(r == 0);
@@ -208,7 +217,7 @@ TEST_IMPL(threadpool_cancel_work) {
 
   INIT_CANCEL_INFO(&ci, reqs);
   loop = uv_default_loop();
-  saturate_threadpool();
+  saturate_threadpool(UV_WORK_CPU);
 
   for (i = 0; i < ARRAY_SIZE(reqs); i++)
     ASSERT(0 == uv_queue_work(loop, reqs + i, work2_cb, done2_cb));
@@ -232,9 +241,14 @@ TEST_IMPL(threadpool_cancel_fs) {
   uv_loop_t* loop;
   unsigned n;
 
+#if defined(__linux__)
+  /* Requests submitted through io_uring can't be cancelled. */
+  setenv("UV_USE_IO_URING", "0", 1);
+#endif
+
   INIT_CANCEL_INFO(&ci, reqs);
   loop = uv_default_loop();
-  saturate_threadpool();
+  saturate_threadpool(UV_WORK_FS);
 
   /* Needs to match ARRAY_SIZE(fs_reqs). */
   n = 0;
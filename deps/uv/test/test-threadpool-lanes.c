@@ -0,0 +1,181 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdlib.h>
+
+static uv_cond_t signal_cond;
+static uv_mutex_t signal_mutex;
+static uv_mutex_t wait_mutex;
+static unsigned blocking_cb_called;
+static unsigned nop_cb_called;
+static unsigned done_cb_called;
+
+
+static void blocking_work_cb(uv_work_t* req) {
+  uv_mutex_lock(&signal_mutex);
+  uv_cond_signal(&signal_cond);
+  uv_mutex_unlock(&signal_mutex);
+
+  uv_mutex_lock(&wait_mutex);
+  uv_mutex_unlock(&wait_mutex);
+
+  blocking_cb_called++;
+}
+
+
+static void nop_work_cb(uv_work_t* req) {
+  nop_cb_called++;
+}
+
+
+static void done_cb(uv_work_t* req, int status) {
+  ASSERT(status == 0);
+  done_cb_called++;
+}
+
+
+static void unblock_done_cb(uv_work_t* req, int status) {
+  ASSERT(status == 0);
+  ASSERT(blocking_cb_called == 0);
+  uv_mutex_unlock(&wait_mutex);
+  done_cb_called++;
+}
+
+
+/* Queues a request that blocks its thread until wait_mutex is released. */
+static void queue_blocking_work(uv_work_t* req, uv_work_lane_t lane) {
+  ASSERT(0 == uv_queue_work_lane(uv_default_loop(),
+                                 req,
+                                 lane,
+                                 blocking_work_cb,
+                                 done_cb));
+  ASSERT(0 == uv_cond_timedwait(&signal_cond, &signal_mutex, 5 * 1e9));
+}
+
+
+static void init_sync(void) {
+  ASSERT(0 == uv_cond_init(&signal_cond));
+  ASSERT(0 == uv_mutex_init(&signal_mutex));
+  ASSERT(0 == uv_mutex_init(&wait_mutex));
+  uv_mutex_lock(&signal_mutex);
+  uv_mutex_lock(&wait_mutex);
+}
+
+
+static void destroy_sync(void) {
+  uv_mutex_unlock(&signal_mutex);
+  uv_cond_destroy(&signal_cond);
+  uv_mutex_destroy(&signal_mutex);
+  uv_mutex_destroy(&wait_mutex);
+}
+
+
+TEST_IMPL(threadpool_lanes_isolated) {
+  uv_work_t blocking_req;
+  uv_work_t req;
+
+  /* One thread per lane. With a single shared queue the cpu request below
+   * would never run because the only thread is stuck in the fs lane.
+   */
+  ASSERT(0 == setenv("UV_THREADPOOL_SIZE", "1", 1));
+  ASSERT(0 == unsetenv("UV_THREADPOOL_FS_SIZE"));
+  ASSERT(0 == unsetenv("UV_THREADPOOL_CPU_SIZE"));
+
+  init_sync();
+  queue_blocking_work(&blocking_req, UV_WORK_FS);
+
+  ASSERT(0 == uv_queue_work_lane(uv_default_loop(),
+                                 &req,
+                                 UV_WORK_CPU,
+                                 nop_work_cb,
+                                 unblock_done_cb));
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(nop_cb_called == 1);
+  ASSERT(blocking_cb_called == 1);
+  ASSERT(done_cb_called == 2);
+
+  destroy_sync();
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(threadpool_lanes_stats) {
+  uv_threadpool_stats_t stats;
+  uv_work_t blocking_reqs[3];
+  uv_work_t req;
+  unsigned i;
+
+  ASSERT(0 == setenv("UV_THREADPOOL_CPU_SIZE", "3", 1));
+
+  ASSERT(-1 == uv_threadpool_stats(UV_WORK_LANE_MAX, &stats));
+  ASSERT(-1 == uv_queue_work_lane(uv_default_loop(),
+                                  &req,
+                                  UV_WORK_LANE_MAX,
+                                  nop_work_cb,
+                                  done_cb));
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EINVAL);
+
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_CPU, &stats));
+  ASSERT(stats.min_threads == 1);
+  ASSERT(stats.max_threads == 3);
+  ASSERT(stats.threads == 1);
+  ASSERT(stats.submitted == 0);
+
+  /* The lane grows to its maximum size while all its threads are busy. */
+  init_sync();
+  for (i = 0; i < ARRAY_SIZE(blocking_reqs); i++)
+    queue_blocking_work(blocking_reqs + i, UV_WORK_CPU);
+
+  ASSERT(0 == uv_queue_work(uv_default_loop(), &req, nop_work_cb, done_cb));
+
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_CPU, &stats));
+  ASSERT(stats.threads == 3);
+  ASSERT(stats.idle == 0);
+  ASSERT(stats.queued == 1);
+  ASSERT(stats.submitted == 4);
+  ASSERT(stats.completed == 0);
+
+  uv_mutex_unlock(&wait_mutex);
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(done_cb_called == 4);
+
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_CPU, &stats));
+  ASSERT(stats.queued == 0);
+  ASSERT(stats.submitted == 4);
+  ASSERT(stats.completed == 4);
+  ASSERT(stats.wait_time > 0);
+  ASSERT(stats.max_wait_time <= stats.wait_time);
+
+  /* The other lanes are unaffected. */
+  ASSERT(0 == uv_threadpool_stats(UV_WORK_DNS, &stats));
+  ASSERT(stats.submitted == 0);
+
+  destroy_sync();
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
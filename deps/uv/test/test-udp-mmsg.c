@@ -0,0 +1,142 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_SENDS 40
+#define BATCH_SIZE 8
+
+static uv_udp_t sender;
+static uv_udp_t receiver;
+static uv_udp_send_t send_reqs[NUM_SENDS];
+
+static int send_cb_called;
+static int recv_cb_called;
+static int end_cb_called;
+static int received_bytes;
+
+
+static uv_buf_t alloc_cb(uv_handle_t* handle, size_t suggested_size) {
+  ASSERT(suggested_size == BATCH_SIZE * 64 * 1024);
+  return uv_buf_init(malloc(suggested_size), suggested_size);
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  ASSERT(handle != NULL);
+}
+
+
+static void send_cb(uv_udp_send_t* req, int status) {
+  ASSERT(req != NULL);
+  ASSERT(status == 0);
+  send_cb_called++;
+}
+
+
+static void recv_cb(uv_udp_t* handle,
+                    ssize_t nread,
+                    uv_buf_t buf,
+                    struct sockaddr* addr,
+                    unsigned flags) {
+  ASSERT(handle == &receiver);
+
+  if (nread == 0 && addr == NULL) {
+    /* End of a batch or nothing to read, we get the whole buffer back. */
+    ASSERT(flags == 0);
+    free(buf.base);
+    end_cb_called++;
+
+    if (recv_cb_called == NUM_SENDS) {
+      uv_close((uv_handle_t*)&receiver, close_cb);
+      uv_close((uv_handle_t*)&sender, close_cb);
+    }
+  }
+  else {
+    ASSERT(nread == 4);
+    ASSERT(addr != NULL);
+    ASSERT(flags == UV_UDP_MMSG_CHUNK);
+    ASSERT(memcmp(buf.base, "PING", 4) == 0);
+    recv_cb_called++;
+    received_bytes += nread;
+  }
+}
+
+
+TEST_IMPL(udp_mmsg) {
+  struct sockaddr_in addr;
+  uv_buf_t buf;
+  int i, r;
+
+  r = uv_udp_init(uv_default_loop(), &receiver);
+  ASSERT(r == 0);
+
+  r = uv_udp_init(uv_default_loop(), &sender);
+  ASSERT(r == 0);
+
+  r = uv_udp_set_batch(&receiver, 1000);
+  ASSERT(r == -1);
+
+#ifdef __linux__
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EINVAL);
+
+  r = uv_udp_set_batch(&receiver, BATCH_SIZE);
+  ASSERT(r == 0);
+
+  r = uv_udp_set_batch(&sender, BATCH_SIZE);
+  ASSERT(r == 0);
+#else
+  RETURN_SKIP("Batched UDP I/O is only supported on Linux.");
+#endif
+
+  addr = uv_ip4_addr("0.0.0.0", TEST_PORT);
+  r = uv_udp_bind(&receiver, addr, 0);
+  ASSERT(r == 0);
+
+  r = uv_udp_recv_start(&receiver, alloc_cb, recv_cb);
+  ASSERT(r == 0);
+
+  /* Queued in one loop iteration, flushed with sendmmsg() when the socket
+   * becomes writable.
+   */
+  addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+  buf = uv_buf_init("PING", 4);
+  for (i = 0; i < NUM_SENDS; i++) {
+    r = uv_udp_send(&send_reqs[i], &sender, &buf, 1, addr, send_cb);
+    ASSERT(r == 0);
+  }
+
+  r = uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+  ASSERT(r == 0);
+
+  ASSERT(send_cb_called == NUM_SENDS);
+  ASSERT(recv_cb_called == NUM_SENDS);
+  ASSERT(received_bytes == 4 * NUM_SENDS);
+  ASSERT(end_cb_called >= NUM_SENDS / BATCH_SIZE);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -210,6 +210,7 @@
             'src/unix/linux-inotify.c',
             'src/unix/linux-syscalls.c',
             'src/unix/linux-syscalls.h',
+            'src/unix/linux-uring.c',
           ],
           'link_settings': {
             'libraries': [ '-ldl', '-lrt' ],
@@ -303,6 +304,7 @@
         'test/test-fail-always.c',
         'test/test-fs.c',
         'test/test-fs-event.c',
+        'test/test-fs-many.c',
         'test/test-get-currentexe.c',
         'test/test-get-memory.c',
         'test/test-getaddrinfo.c',
@@ -315,6 +317,7 @@
         'test/test-loop-handles.c',
         'test/test-loop-stop.c',
         'test/test-loop-configure.c',
+        'test/test-loop-metrics.c',
         'test/test-walk-handles.c',
         'test/test-watcher-cross-stop.c',
         'test/test-multiple-listen.c',
@@ -349,7 +352,9 @@
         'test/test-tcp-close-while-connecting.c',
         'test/test-tcp-connect-error-after-write.c',
         'test/test-tcp-shutdown-after-write.c',
+        'test/test-tcp-sendfile.c',
         'test/test-tcp-flags.c',
+        'test/test-tcp-reuseport.c',
         'test/test-tcp-connect-error.c',
         'test/test-tcp-connect-timeout.c',
         'test/test-tcp-connect6-error.c',
@@ -361,6 +366,7 @@
         'test/test-tcp-read-stop.c',
         'test/test-threadpool.c',
         'test/test-threadpool-cancel.c',
+        'test/test-threadpool-lanes.c',
         'test/test-mutexes.c',
         'test/test-thread.c',
         'test/test-barrier.c',
@@ -373,6 +379,7 @@
         'test/test-udp-ipv6.c',
         'test/test-udp-open.c',
         'test/test-udp-options.c',
+        'test/test-udp-mmsg.c',
         'test/test-udp-send-and-recv.c',
         'test/test-udp-multicast-join.c',
         'test/test-dlerror.c',
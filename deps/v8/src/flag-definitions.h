@@ -487,7 +487,8 @@ DEFINE_string(testing_serialization_file, "/tmp/serdes",
 
 // mksnapshot.cc
 DEFINE_string(extra_code, NULL, "A filename with extra code to be included in"
-                  " the snapshot (mksnapshot only)")
+                  " the snapshot, lines of the form '// @script <name>'"
+                  " start a new script (mksnapshot only)")
 
 //
 // Dev shell flags
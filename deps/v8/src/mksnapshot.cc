@@ -291,6 +291,38 @@ class BZip2Decompressor : public StartupDataDecompressor {
 #endif
 
 
+static void RunExtraCode(const char* chars, const char* name) {
+  HandleScope scope;
+  Local<String> source = String::New(chars);
+  TryCatch try_catch;
+  Local<Script> script = Script::Compile(source, String::New(name));
+  if (try_catch.HasCaught()) {
+    fprintf(stderr, "Failure compiling '%s' (see above)\n", name);
+    exit(1);
+  }
+  script->Run();
+  if (try_catch.HasCaught()) {
+    fprintf(stderr, "Failure running '%s'\n", name);
+    Local<Message> message = try_catch.Message();
+    Local<String> message_string = message->Get();
+    Local<String> message_line = message->GetSourceLine();
+    int len = 2 + message_string->Utf8Length() + message_line->Utf8Length();
+    char* buf = new char[len];
+    message_string->WriteUtf8(buf);
+    fprintf(stderr, "%s at line %d\n", buf, message->GetLineNumber());
+    message_line->WriteUtf8(buf);
+    fprintf(stderr, "%s\n", buf);
+    int from = message->GetStartColumn();
+    int to = message->GetEndColumn();
+    int i;
+    for (i = 0; i < from; i++) fprintf(stderr, " ");
+    for ( ; i <= to; i++) fprintf(stderr, "^");
+    fprintf(stderr, "\n");
+    exit(1);
+  }
+}
+
+
 int main(int argc, char** argv) {
   // By default, log code create information in the snapshot.
   i::FLAG_log_code = true;
@@ -345,32 +377,28 @@ int main(int argc, char** argv) {
       i += read;
     }
     fclose(file);
-    Local<String> source = String::New(chars);
-    TryCatch try_catch;
-    Local<Script> script = Script::Compile(source);
-    if (try_catch.HasCaught()) {
-      fprintf(stderr, "Failure compiling '%s' (see above)\n", name);
-      exit(1);
-    }
-    script->Run();
-    if (try_catch.HasCaught()) {
-      fprintf(stderr, "Failure running '%s'\n", name);
-      Local<Message> message = try_catch.Message();
-      Local<String> message_string = message->Get();
-      Local<String> message_line = message->GetSourceLine();
-      int len = 2 + message_string->Utf8Length() + message_line->Utf8Length();
-      char* buf = new char(len);
-      message_string->WriteUtf8(buf);
-      fprintf(stderr, "%s at line %d\n", buf, message->GetLineNumber());
-      message_line->WriteUtf8(buf);
-      fprintf(stderr, "%s\n", buf);
-      int from = message->GetStartColumn();
-      int to = message->GetEndColumn();
-      int i;
-      for (i = 0; i < from; i++) fprintf(stderr, " ");
-      for ( ; i <= to; i++) fprintf(stderr, "^");
-      fprintf(stderr, "\n");
-      exit(1);
+
+    // The file may hold several scripts, each one starts with a line
+    // "// @script <name>". Functions keep the name of the script they
+    // come from, it shows up in stack traces.
+    static const char kMarker[] = "// @script ";
+    const int marker_length = sizeof(kMarker) - 1;
+    char* source = chars;
+    const char* script_name = name;
+    for (;;) {
+      char* next = source;
+      while ((next = strstr(next, kMarker)) != NULL) {
+        if (next == source || next[-1] == '\n') break;
+        next += marker_length;
+      }
+      if (next != NULL) *next = '\0';
+      RunExtraCode(source, script_name);
+      if (next == NULL) break;
+      char* eol = strchr(next + marker_length, '\n');
+      if (eol == NULL) break;
+      *eol = '\0';
+      script_name = next + marker_length;
+      source = eol + 1;
     }
     context->Exit();
   }
@@ -422,5 +450,18 @@ int main(int argc, char** argv) {
       ser.CurrentAllocationAddress(i::CODE_SPACE),
       ser.CurrentAllocationAddress(i::MAP_SPACE),
       ser.CurrentAllocationAddress(i::CELL_SPACE));
+
+  // The deserializer needs each space to fit in the first page.
+  for (int space = i::OLD_POINTER_SPACE; space <= i::CELL_SPACE; space++) {
+    if (space == i::CODE_SPACE) continue;
+    int used = ser.CurrentAllocationAddress(space) +
+               partial_ser.CurrentAllocationAddress(space);
+    if (used > i::Page::kMaxNonCodeHeapObjectSize) {
+      fprintf(stderr,
+              "Snapshot space %d uses %d bytes, more than a page (%d).\n",
+              space, used, i::Page::kMaxNonCodeHeapObjectSize);
+      return 1;
+    }
+  }
   return 0;
 }
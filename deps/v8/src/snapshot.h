@@ -48,6 +48,9 @@ class Snapshot {
   // Returns whether or not the snapshot is enabled.
   static bool IsEnabled() { return size_ != 0; }
 
+  // Bytes the linked-in startup and context snapshots take up in |space|.
+  static int SpaceUsed(AllocationSpace space);
+
   // Write snapshot to the given file. Returns true if snapshot was written
   // successfully.
   static bool WriteToFile(const char* snapshot_file);
@@ -140,6 +140,16 @@
                 ],
               },
               'conditions': [
+                ['v8_extra_code!=""', {
+                  'inputs': [
+                    '<(v8_extra_code)',
+                  ],
+                  'variables': {
+                    'mksnapshot_flags': [
+                      '--extra_code', '<(v8_extra_code)',
+                    ],
+                  },
+                }],
                 ['v8_target_arch=="arm"', {
                   # The following rules should be consistent with chromium's
                   # common.gypi and V8's runtime rule to ensure they all generate
@@ -173,7 +183,7 @@
                 }],
               ],
               'action': [
-                '<@(_inputs)',
+                '<(PRODUCT_DIR)/<(EXECUTABLE_PREFIX)mksnapshot<(EXECUTABLE_SUFFIX)',
                 '<@(mksnapshot_flags)',
                 '<@(_outputs)'
               ],
@@ -0,0 +1,89 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Sets up the global object of a worker. This runs inside the worker's own
+// isolate (see src/worker_wrap.cc), not in the main context; there is no
+// require() and no process object in there.
+
+// Must match BYTES_KEY in lib/worker.js.
+var BYTES_KEY = '\u0000bytes';
+
+function isBytesRef(value) {
+  return value !== null &&
+         typeof value === 'object' &&
+         typeof value[BYTES_KEY] === 'number';
+}
+
+function format(args) {
+  var out = [];
+  for (var i = 0; i < args.length; i++) {
+    var arg = args[i];
+    if (typeof arg === 'string')
+      out.push(arg);
+    else if (arg instanceof Error)
+      out.push(arg.stack || String(arg));
+    else
+      out.push(JSON.stringify(arg));
+  }
+  return out.join(' ') + '\n';
+}
+
+module.exports = function(binding, global) {
+  var Bytes = binding.Bytes;
+
+  global.Bytes = Bytes;
+
+  global.onmessage = null;
+
+  global.postMessage = function(value) {
+    var transfer = [];
+    var json = JSON.stringify(value, function(key, val) {
+      var orig = this[key];
+      if (orig instanceof Bytes) {
+        var ref = {};
+        ref[BYTES_KEY] = transfer.push(orig) - 1;
+        return ref;
+      }
+      return val;
+    });
+    binding.send(json === undefined ? 'null' : json, transfer);
+  };
+
+  global.close = function() {
+    binding.close();
+  };
+
+  global.console = {
+    log: function() { binding.print(1, format(arguments)); },
+    info: function() { binding.print(1, format(arguments)); },
+    warn: function() { binding.print(2, format(arguments)); },
+    error: function() { binding.print(2, format(arguments)); }
+  };
+
+  // Called from C++ for every message the parent sends.
+  return function(json, bytes) {
+    var value = JSON.parse(json, function(key, val) {
+      return isBytesRef(val) ? bytes[val[BYTES_KEY]] : val;
+    });
+    if (typeof global.onmessage === 'function')
+      global.onmessage(value);
+  };
+};
@@ -26,6 +26,7 @@ var dgram = require('dgram');
 var Process = process.binding('process_wrap').Process;
 var assert = require('assert');
 var util = require('util');
+var serdes = process.binding('serdes');
 var constants; // if (!constants) constants = process.binding('constants');
 
 var handleWraps = {};
@@ -322,45 +323,84 @@ function handleMessage(target, message, handle) {
   target.emit(eventName, message, handle);
 }
 
-function setupChannel(target, channel) {
+function setupChannel(target, channel, serialization) {
   target._channel = channel;
   target._handleQueue = null;
 
-  var decoder = new StringDecoder('utf8');
-  var jsonBuffer = '';
+  var binary = serialization === 'binary';
   channel.buffering = false;
-  channel.onread = function(pool, offset, length, recvHandle) {
-    if (pool) {
-      jsonBuffer += decoder.write(pool.slice(offset, offset + length));
-
-      var i, start = 0;
-
-      //Linebreak is used as a message end sign
-      while ((i = jsonBuffer.indexOf('\n', start)) >= 0) {
-        var json = jsonBuffer.slice(start, i);
-        var message = JSON.parse(json);
-
-        // There will be at most one NODE_HANDLE message in every chunk we
-        // read because SCM_RIGHTS messages don't get coalesced. Make sure
-        // that we deliver the handle with the right message however.
-        if (message && message.cmd === 'NODE_HANDLE')
-          handleMessage(target, message, recvHandle);
-        else
-          handleMessage(target, message, undefined);
-
-        start = i + 1;
+
+  if (binary) {
+    // Length prefixed frames, see src/node_serdes.cc. A frame can be split
+    // over reads, `pending` holds the part that has been read so far.
+    var pending = null;
+    var pendingHandle;
+    channel.onread = function(pool, offset, length, recvHandle) {
+      if (pool) {
+        var chunk = pool.slice(offset, offset + length);
+        if (pending) chunk = Buffer.concat([pending, chunk]);
+        if (recvHandle) pendingHandle = recvHandle;
+
+        var messages = [];
+        var consumed = serdes.decode(chunk, messages);
+        pending = consumed < chunk.length ? chunk.slice(consumed) : null;
+        this.buffering = pending !== null;
+
+        for (var i = 0; i < messages.length; i++) {
+          var message = messages[i];
+          // The handle comes with the first read of its message's frame.
+          if (message && message.cmd === 'NODE_HANDLE') {
+            handleMessage(target, message, pendingHandle);
+            pendingHandle = undefined;
+          } else {
+            handleMessage(target, message, undefined);
+          }
+        }
+
+      } else {
+        closeChannel();
       }
-      jsonBuffer = jsonBuffer.slice(start);
-      this.buffering = jsonBuffer.length !== 0;
+    };
+  } else {
+    var decoder = new StringDecoder('utf8');
+    var jsonBuffer = '';
+    channel.onread = function(pool, offset, length, recvHandle) {
+      if (pool) {
+        jsonBuffer += decoder.write(pool.slice(offset, offset + length));
+
+        var i, start = 0;
+
+        //Linebreak is used as a message end sign
+        while ((i = jsonBuffer.indexOf('\n', start)) >= 0) {
+          var json = jsonBuffer.slice(start, i);
+          var message = JSON.parse(json);
+
+          // There will be at most one NODE_HANDLE message in every chunk we
+          // read because SCM_RIGHTS messages don't get coalesced. Make sure
+          // that we deliver the handle with the right message however.
+          if (message && message.cmd === 'NODE_HANDLE')
+            handleMessage(target, message, recvHandle);
+          else
+            handleMessage(target, message, undefined);
+
+          start = i + 1;
+        }
+        jsonBuffer = jsonBuffer.slice(start);
+        this.buffering = jsonBuffer.length !== 0;
 
-    } else {
-      this.buffering = false;
-      target.disconnect();
-      channel.onread = nop;
-      channel.close();
-      maybeClose(target);
-    }
-  };
+      } else {
+        closeChannel();
+      }
+    };
+  }
+
+  function closeChannel() {
+    channel.buffering = false;
+    target.disconnect();
+    channel.onread = nop;
+    channel.close();
+    maybeClose(target);
+  }
 
   // object where socket lists will live
   channel.sockets = { got: {}, send: {} };
@@ -458,8 +498,23 @@ function setupChannel(target, channel) {
       return;
     }
 
-    var string = JSON.stringify(message) + '\n';
-    var writeReq = channel.writeUtf8String(string, handle);
+    var writeReq;
+    if (binary) {
+      var frame = serdes.encode(message);
+      if (!handle) {
+        // Messages without a handle go out together, at the end of the tick.
+        if (batch.length === 0) scheduleFlush(flush);
+        batch.push(frame, 'buffer');
+        batchSize += frame.length;
+        return channel.writeQueueSize + batchSize < (65536 * 2);
+      }
+      // A handle is sent along with a single write, keep the order intact.
+      flush();
+      writeReq = channel.writeBuffer(frame, handle);
+    } else {
+      var string = JSON.stringify(message) + '\n';
+      writeReq = channel.writeUtf8String(string, handle);
+    }
 
     if (!writeReq) {
       var er = errnoException(process._errno,
@@ -488,6 +543,9 @@ function setupChannel(target, channel) {
       return;
     }
 
+    // Whatever has been sent so far still goes out.
+    flush();
+
     // do not allow messages to be written
     this.connected = false;
     this._channel = null;
@@ -512,10 +570,62 @@ function setupChannel(target, channel) {
     finish();
   };
 
+  // Frames of the binary messages that are waiting to be written, as
+  // (chunk, encoding) pairs for channel.writev().
+  var batch = [];
+  var batchSize = 0;
+
+  function flush() {
+    if (batch.length === 0) return;
+
+    var chunks = batch;
+    batch = [];
+    batchSize = 0;
+
+    if (!target.connected) {
+      target.emit('error', new Error('channel closed'));
+      return;
+    }
+
+    var writeReq = channel.writev(chunks);
+    if (!writeReq) {
+      var er = errnoException(process._errno,
+                              'write',
+                              'cannot write to IPC channel.');
+      target.emit('error', er);
+      return;
+    }
+    writeReq.oncomplete = nop;
+  }
+
   channel.readStart();
 }
 
 
+// Channels that have binary messages waiting. They are all flushed at the
+// end of the tick, or when the process exits before that.
+var flushQueue = [];
+var flushOnExit = false;
+
+function scheduleFlush(flush) {
+  if (!flushOnExit) {
+    process.on('exit', flushAll);
+    flushOnExit = true;
+  }
+  if (flushQueue.length === 0) {
+    process.nextTick(flushAll);
+  }
+  flushQueue.push(flush);
+}
+
+function flushAll() {
+  var queue = flushQueue;
+  flushQueue = [];
+  for (var i = 0; i < queue.length; i++)
+    queue[i]();
+}
+
+
 function nop() { }
 
 exports.fork = function(modulePath /*, args, options*/) {
@@ -547,12 +657,12 @@ exports.fork = function(modulePath /*, args, options*/) {
 };
 
 
-exports._forkChild = function(fd) {
+exports._forkChild = function(fd, serialization) {
   // set process.send()
   var p = createPipe(true);
   p.open(fd);
   p.unref();
-  setupChannel(process, p);
+  setupChannel(process, p, serialization);
 
   var refs = 0;
   process.on('newListener', function(name) {
@@ -752,7 +862,8 @@ var spawn = exports.spawn = function(file /*, args, options*/) {
     envPairs: envPairs,
     stdio: options ? options.stdio : null,
     uid: options ? options.uid : null,
-    gid: options ? options.gid : null
+    gid: options ? options.gid : null,
+    serialization: options ? options.serialization : null
   });
 
   return child;
@@ -862,7 +973,13 @@ ChildProcess.prototype.spawn = function(options) {
       ipc,
       ipcFd,
       // If no `stdio` option was given - use default
-      stdio = options.stdio || 'pipe';
+      stdio = options.stdio || 'pipe',
+      serialization = options.serialization || 'json';
+
+  if (serialization !== 'json' && serialization !== 'binary') {
+    throw new TypeError('Incorrect value of serialization option: ' +
+                        serialization);
+  }
 
   // Replace shortcut with an array
   if (typeof stdio === 'string') {
@@ -941,6 +1058,9 @@ ChildProcess.prototype.spawn = function(options) {
     // Let child process know about opened IPC channel
     options.envPairs = options.envPairs || [];
     options.envPairs.push('NODE_CHANNEL_FD=' + ipcFd);
+    if (serialization !== 'json') {
+      options.envPairs.push('NODE_CHANNEL_SERIALIZATION=' + serialization);
+    }
   }
 
   var r = this._handle.spawn(options);
@@ -994,7 +1114,7 @@ ChildProcess.prototype.spawn = function(options) {
   });
 
   // Add .send() method and start listening for IPC data
-  if (ipc !== undefined) setupChannel(this, ipc);
+  if (ipc !== undefined) setupChannel(this, ipc, serialization);
 
   return r;
 };
@@ -24,6 +24,9 @@ var fork = require('child_process').fork;
 var net = require('net');
 var EventEmitter = require('events').EventEmitter;
 var util = require('util');
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
 
 function isObject(o) {
   return (typeof o === 'object' && o !== null);
@@ -53,11 +56,17 @@ var cluster = module.exports = new Cluster();
 var masterStarted = false;
 var ids = 0;
 var serverHandlers = {};
+var loopLags = {};
 
 // Used in the worker:
 var serverListeners = {};
 var queryIds = 0;
 var queryCallbacks = {};
+var rrHandles = {};
+var rrAcks = null;
+var loopLag = 0;
+var sessionCacheFile = null;
+var reusePort = false;
 
 // Define isWorker and isMaster
 cluster.isWorker = 'NODE_UNIQUE_ID' in process.env;
@@ -71,6 +80,23 @@ cluster.workers = cluster.isMaster ? {} : null;
 // Settings object
 var settings = cluster.settings = {};
 
+// Creates the memory that backs the TLS session cache all workers share.
+// The workers find it through the environment, see cluster._getServer().
+function createSessionCacheFile(size) {
+  var dir = fs.existsSync('/dev/shm') ? '/dev/shm' : os.tmpdir();
+  var file = path.join(dir, 'node-tls-sessions-' + process.pid);
+
+  // Left behind by an earlier master that had the same pid.
+  try { fs.unlinkSync(file); } catch (e) {}
+
+  process.binding('crypto').createSessionCache(file, size);
+  process.on('exit', function() {
+    try { fs.unlinkSync(file); } catch (e) {}
+  });
+
+  return file;
+}
+
 // Simple function to call a function on each worker
 function eachWorker(cb) {
   // Go through all workers
@@ -131,9 +157,23 @@ cluster.setupMaster = function(options) {
     exec: options.exec || process.argv[1],
     execArgv: execArgv,
     args: options.args || process.argv.slice(2),
-    silent: options.silent || false
+    silent: options.silent || false,
+    reusePort: options.reusePort || false,
+    schedulingPolicy: options.schedulingPolicy || 'none',
+    serialization: options.serialization || 'json'
   };
 
+  if (settings.schedulingPolicy !== 'none' &&
+      settings.schedulingPolicy !== 'rr') {
+    throw new Error('Unknown scheduling policy: ' + settings.schedulingPolicy);
+  }
+
+  if (options.tlsSessionCacheSize > 0) {
+    settings.tlsSessionCacheSize = options.tlsSessionCacheSize;
+    settings.tlsSessionCacheFile =
+        createSessionCacheFile(options.tlsSessionCacheSize);
+  }
+
   // emit setup event
   cluster.emit('setup');
 };
@@ -194,7 +234,7 @@ function handleMessage(worker, inMessage, inHandle) {
 
   // Run handler if it exists
   if (messageHandler[message.cmd]) {
-    messageHandler[message.cmd](message, worker, respond);
+    messageHandler[message.cmd](message, worker, respond, inHandle);
   }
 
   // Send respond if it hasn't been called yet
@@ -228,6 +268,16 @@ if (cluster.isMaster) {
 
     if (serverHandlers.hasOwnProperty(key)) {
       handler = serverHandlers[key];
+    } else if (settings.schedulingPolicy === 'rr' &&
+               (message.addressType === 4 || message.addressType === 6) &&
+               !(typeof message.fd === 'number' && message.fd >= 0)) {
+      handler = new RoundRobinHandle(key);
+      var err = handler.listen.apply(handler, args);
+      if (err) {
+        send({ content: { error: err } }, null);
+        return;
+      }
+      serverHandlers[key] = handler;
     } else {
       if (message.addressType === 'udp4' ||
           message.addressType === 'udp6') {
@@ -243,10 +293,36 @@ if (cluster.isMaster) {
       serverHandlers[key] = handler;
     }
 
+    // In round-robin mode the worker gets no handle, the master accepts the
+    // connections and sends them over one by one.
+    if (handler instanceof RoundRobinHandle) {
+      handler.add(worker);
+      send({ content: { key: key, sockname: handler.sockname } }, null);
+      return;
+    }
+
     // echo callback with the fd handler associated with it
     send({}, handler);
   };
 
+  // Handle batched connection acknowledgements from workers
+  messageHandler.rrack = function(message, worker) {
+    loopLags[worker.id] = message.lag;
+
+    for (var key in message.acks) {
+      var handler = serverHandlers[key];
+      if (handler instanceof RoundRobinHandle)
+        handler.ack(worker, message.acks[key]);
+    }
+  };
+
+  // Handle a worker closing its round-robin server
+  messageHandler.rrclose = function(message, worker) {
+    var handler = serverHandlers[message.key];
+    if (handler instanceof RoundRobinHandle)
+      handler.remove(worker, true);
+  };
+
   // Handle listening messages from workers
   messageHandler.listening = function(message, worker) {
 
@@ -281,6 +357,259 @@ else if (cluster.isWorker) {
   messageHandler.disconnect = function(message, worker) {
     worker.disconnect();
   };
+
+  // Handle a connection the master accepted in round-robin mode
+  messageHandler.newconn = function(message, worker, send, handle) {
+    var server = rrHandles[message.key];
+    var accepted = !!(server && server.onconnection);
+
+    if (accepted)
+      server.onconnection(handle);
+    else
+      handle.close();
+
+    if (rrAcks === null) {
+      rrAcks = {};
+      setImmediate(flushAcks);
+    }
+    if (!rrAcks[message.key])
+      rrAcks[message.key] = [];
+    rrAcks[message.key].push(accepted);
+  };
+}
+
+// Used in the master. Listens on behalf of the workers and hands every
+// accepted connection to the least loaded one. A worker's load is the number
+// of connections sent to it that it hasn't acknowledged yet, weighted by how
+// far its event loop lags behind. Connections accepted in the same loop
+// iteration are distributed together. The master keeps its copy of a
+// connection until the worker has acknowledged it, so connections a worker
+// turns down can go to another one.
+var LAG_UNIT = 10;  // Milliseconds of loop lag that count as one connection.
+
+function RoundRobinHandle(key) {
+  this.key = key;
+  this.handle = null;
+  this.sockname = null;
+  this.workers = [];  // { worker, inFlight: [handles] }
+  this.pending = [];
+  this.next = 0;
+  this.scheduled = false;
+}
+
+RoundRobinHandle.prototype.listen = function(address, port, addressType, fd) {
+  var self = this;
+
+  this.handle = net._createServerHandle(address, port, addressType, fd);
+  if (!this.handle)
+    return process._errno;
+
+  this.handle.onconnection = function(clientHandle) {
+    if (!clientHandle) {
+      debug('round-robin accept failed: ' + process._errno);
+      return;
+    }
+    self.pending.push(clientHandle);
+    self.schedule();
+  };
+
+  if (this.handle.listen(511)) {
+    var err = process._errno;
+    this.handle.close();
+    this.handle = null;
+    return err;
+  }
+
+  this.sockname = this.handle.getsockname();
+  return null;
+};
+
+RoundRobinHandle.prototype.find = function(worker) {
+  for (var i = 0; i < this.workers.length; i++) {
+    if (this.workers[i].worker === worker)
+      return i;
+  }
+  return -1;
+};
+
+RoundRobinHandle.prototype.add = function(worker) {
+  if (this.find(worker) !== -1)
+    return;
+
+  var self = this;
+  var entry = { worker: worker, inFlight: [] };
+  this.workers.push(entry);
+
+  // A worker that goes away before acknowledging its connections may have
+  // taken them already, don't send them to anybody else.
+  entry.onexit = function() {
+    self.remove(worker, false);
+  };
+  worker.once('disconnect', entry.onexit);
+  worker.once('exit', entry.onexit);
+
+  this.schedule();
+};
+
+RoundRobinHandle.prototype.remove = function(worker, redistribute) {
+  var index = this.find(worker);
+  if (index === -1)
+    return;
+
+  var entry = this.workers.splice(index, 1)[0];
+  worker.removeListener('disconnect', entry.onexit);
+  worker.removeListener('exit', entry.onexit);
+
+  if (redistribute) {
+    this.pending = entry.inFlight.concat(this.pending);
+    this.schedule();
+  } else {
+    entry.inFlight.forEach(function(handle) {
+      handle.close();
+    });
+  }
+};
+
+RoundRobinHandle.prototype.ack = function(worker, results) {
+  var index = this.find(worker);
+  if (index === -1)
+    return;
+
+  var entry = this.workers[index];
+  for (var i = 0; i < results.length; i++) {
+    var handle = entry.inFlight.shift();
+    if (!handle)
+      break;
+    if (results[i])
+      handle.close();
+    else
+      this.pending.push(handle);
+  }
+
+  this.schedule();
+};
+
+RoundRobinHandle.prototype.schedule = function() {
+  if (this.scheduled || this.pending.length === 0)
+    return;
+  this.scheduled = true;
+  setImmediate(this.distribute.bind(this));
+};
+
+RoundRobinHandle.prototype.distribute = function() {
+  this.scheduled = false;
+
+  // Connections wait in the master while there are no workers, a worker
+  // that is restarted picks them up.
+  while (this.pending.length > 0 && this.workers.length > 0) {
+    var entry = this.pick();
+    var handle = this.pending.shift();
+    entry.inFlight.push(handle);
+    sendInternalMessage(entry.worker, { cmd: 'newconn', key: this.key },
+                        handle);
+  }
+};
+
+// Least loaded worker. Ties go to the worker after the last one picked, so
+// equally loaded workers take turns.
+RoundRobinHandle.prototype.pick = function() {
+  var count = this.workers.length;
+  var best = -1;
+  var bestLoad = Infinity;
+
+  for (var i = 0; i < count; i++) {
+    var index = (this.next + i) % count;
+    var entry = this.workers[index];
+    var lag = loopLags[entry.worker.id] || 0;
+    var load = (entry.inFlight.length + 1) * (1 + lag / LAG_UNIT);
+    if (load < bestLoad) {
+      best = index;
+      bestLoad = load;
+    }
+  }
+
+  this.next = (best + 1) % count;
+  return this.workers[best];
+};
+
+RoundRobinHandle.prototype.close = function() {
+  while (this.workers.length > 0)
+    this.remove(this.workers[0].worker, false);
+
+  this.pending.forEach(function(handle) {
+    handle.close();
+  });
+  this.pending = [];
+
+  if (this.handle) {
+    this.handle.close();
+    this.handle = null;
+  }
+};
+
+// Used in the worker. Stands in for a server handle the master listens on in
+// round-robin mode, connections arrive as 'newconn' messages.
+function SharedServerHandle(key, sockname) {
+  this.key = key;
+  this.sockname = sockname;
+  this.onconnection = null;
+  this.owner = null;
+}
+
+SharedServerHandle.prototype.listen = function() {
+  rrHandles[this.key] = this;
+  startLagMonitor();
+  return 0;
+};
+
+SharedServerHandle.prototype.getsockname = function() {
+  return this.sockname;
+};
+
+SharedServerHandle.prototype.ref = function() {};
+SharedServerHandle.prototype.unref = function() {};
+
+SharedServerHandle.prototype.close = function() {
+  if (rrHandles[this.key] !== this)
+    return;
+  delete rrHandles[this.key];
+
+  // Connections acknowledged before the close are ours, the master sends
+  // everything after it elsewhere.
+  flushAcks();
+  if (process.connected)
+    sendInternalMessage(cluster.worker, { cmd: 'rrclose', key: this.key });
+};
+
+function flushAcks() {
+  var acks = rrAcks;
+  rrAcks = null;
+
+  if (acks === null || !process.connected)
+    return;
+
+  sendInternalMessage(cluster.worker, {
+    cmd: 'rrack',
+    acks: acks,
+    lag: loopLag
+  });
+}
+
+// Tracks how late timers fire, a measure of how busy the worker is.
+var lagTimer = null;
+function startLagMonitor() {
+  if (lagTimer)
+    return;
+
+  var interval = 100;
+  var last = Date.now();
+  lagTimer = setInterval(function() {
+    var now = Date.now();
+    var lag = Math.max(0, now - last - interval);
+    loopLag = Math.round((3 * loopLag + lag) / 4);
+    last = now;
+  }, interval);
+  lagTimer.unref();
 }
 
 function toDecInt(value) {
@@ -312,6 +641,12 @@ function Worker(customEnv) {
     // first: copy and add id property
     var envCopy = util._extend({}, env);
     envCopy['NODE_UNIQUE_ID'] = this.id;
+    if (settings.tlsSessionCacheFile) {
+      envCopy['NODE_TLS_SESSION_CACHE'] = settings.tlsSessionCacheFile;
+    }
+    if (settings.reusePort) {
+      envCopy['NODE_CLUSTER_REUSEPORT'] = '1';
+    }
     // second: extend envCopy with the env argument
     if (isObject(customEnv)) {
       envCopy = util._extend(envCopy, customEnv);
@@ -321,7 +656,8 @@ function Worker(customEnv) {
     this.process = fork(settings.exec, settings.args, {
       'env': envCopy,
       'silent': settings.silent,
-      'execArgv': settings.execArgv
+      'execArgv': settings.execArgv,
+      'serialization': settings.serialization
     });
   } else {
     this.process = process;
@@ -370,6 +706,7 @@ function prepareExit(worker, state) {
   // Remove from workers in the master
   if (cluster.isMaster) {
     delete cluster.workers[worker.id];
+    delete loopLags[worker.id];
   }
 }
 
@@ -545,6 +882,12 @@ cluster._setupWorker = function() {
   // Get worker class
   var worker = cluster.worker = new Worker();
 
+  // Meant for this worker's servers, not for the processes it starts.
+  sessionCacheFile = process.env.NODE_TLS_SESSION_CACHE || null;
+  delete process.env.NODE_TLS_SESSION_CACHE;
+  reusePort = !!process.env.NODE_CLUSTER_REUSEPORT;
+  delete process.env.NODE_CLUSTER_REUSEPORT;
+
   // we will terminate the worker
   // when the worker is disconnected from the parent accidentally
   process.once('disconnect', function() {
@@ -568,6 +911,11 @@ cluster._getServer = function(tcpSelf, address, port, addressType, fd, cb) {
   var key = [address, port, addressType, fd].join(':');
   serverListeners[key] = tcpSelf;
 
+  // TLS servers that listen through the cluster share the master's session
+  // cache, other servers in the worker keep their own.
+  if (sessionCacheFile && typeof tcpSelf._openSharedSessionCache === 'function')
+    tcpSelf._openSharedSessionCache(sessionCacheFile);
+
   // Send a listening message to the master
   tcpSelf.once('listening', function() {
     cluster.worker.state = 'listening';
@@ -580,6 +928,21 @@ cluster._getServer = function(tcpSelf, address, port, addressType, fd, cb) {
     });
   });
 
+  // With reusePort, TCP workers bind a SO_REUSEPORT socket of their own and
+  // let the kernel balance connections between them. Port 0 is left to the
+  // master, every worker would end up with a different random port.
+  if (reusePort &&
+      (addressType === 4 || addressType === 6) &&
+      port > 0 &&
+      !(typeof fd === 'number' && fd >= 0)) {
+    var handle = net._createServerHandle(address, port, addressType, fd, true);
+    var err = handle ? null : process._errno;
+    process.nextTick(function() {
+      cb(handle, err);
+    });
+    return;
+  }
+
   // Request the fd handler from the master process
   var message = {
     cmd: 'queryServer',
@@ -591,6 +954,8 @@ cluster._getServer = function(tcpSelf, address, port, addressType, fd, cb) {
 
   // The callback will be stored until the master has responded
   sendInternalMessage(cluster.worker, message, function(msg, handle) {
+    if (msg && msg.sockname)
+      handle = new SharedServerHandle(msg.key, msg.sockname);
     cb(handle, msg && msg.error);
   });
 
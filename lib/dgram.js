@@ -114,6 +114,7 @@ function Socket(type, listener) {
   handle.owner = this;
 
   this._handle = handle;
+  this._batchSize = 0;
   this._receiving = false;
   this._bindState = BIND_STATE_UNBOUND;
   this.type = type;
@@ -133,6 +134,7 @@ exports.createSocket = function(type, listener) {
 
 function startListening(socket) {
   socket._handle.onmessage = onMessage;
+  socket._handle.onmessages = onMessages;
   // Todo: handle errors
   socket._handle.recvStart();
   socket._receiving = true;
@@ -150,6 +152,11 @@ function replaceHandle(self, newHandle) {
   newHandle.send = self._handle.send;
   newHandle.owner = self;
 
+  if (self._batchSize > 1 && newHandle.setBatch(self._batchSize)) {
+    self._batchSize = 0;
+    self.emit('error', errnoException(process._errno, 'setBatchSize'));
+  }
+
   // Replace the existing handle by the handle we got from master.
   self._handle.close();
   self._handle = newHandle;
@@ -364,6 +371,22 @@ Socket.prototype.setTTL = function(arg) {
 };
 
 
+Socket.prototype.setBatchSize = function(count) {
+  this._healthCheck();
+
+  if (typeof count !== 'number') {
+    throw new TypeError('Argument must be a number');
+  }
+
+  if (this._handle.setBatch(count)) {
+    throw errnoException(process._errno, 'setBatchSize');
+  }
+
+  this._batchSize = count;
+  return count;
+};
+
+
 Socket.prototype.setMulticastTTL = function(arg) {
   if (typeof arg !== 'number') {
     throw new TypeError('Argument must be a number');
@@ -438,7 +461,26 @@ function onMessage(handle, slab, start, len, rinfo) {
     return self.emit('error', errnoException(process._errno, 'recvmsg'));
   }
   rinfo.size = len; // compatibility
-  self.emit('message', slab.slice(start, start + len), rinfo);
+  if (start !== 0 || len !== slab.length)
+    slab = slab.slice(start, start + len);
+  self.emit('message', slab, rinfo);
+}
+
+
+// A batch of datagrams, back to back in `buffer`.
+function onMessages(handle, buffer, sizes, rinfos) {
+  var self = handle.owner;
+  var start = 0;
+  for (var i = 0; i < sizes.length; i++) {
+    var len = sizes[i];
+    var rinfo = rinfos[i];
+    rinfo.size = len; // compatibility
+    self.emit('message', buffer.slice(start, start + len), rinfo);
+    start += len;
+    // A 'message' listener may have closed the socket.
+    if (self._handle !== handle)
+      break;
+  }
 }
 
 
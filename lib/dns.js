@@ -127,6 +127,12 @@ exports.lookup = function(domain, family, callback) {
 
   var wrap = cares.getaddrinfo(domain, family);
 
+  // Answered from the resolver cache, see exports.enableCache().
+  if (Array.isArray(wrap) || wrap === false) {
+    onanswer(wrap || null);
+    return {};
+  }
+
   if (!wrap) {
     throw errnoException(process._errno, 'getaddrinfo');
   }
@@ -162,6 +168,43 @@ function resolver(bindingName) {
 }
 
 
+exports.enableCache = function(options) {
+  options = options || {};
+
+  var maxEntries = 1000;
+  var ttl = 30000;
+  var negativeTtl = 1000;
+
+  if (options.maxEntries !== undefined) maxEntries = options.maxEntries;
+  if (options.ttl !== undefined) ttl = options.ttl;
+  if (options.negativeTtl !== undefined) negativeTtl = options.negativeTtl;
+
+  if (typeof maxEntries !== 'number' || maxEntries < 0)
+    throw new TypeError('maxEntries must be a non-negative number');
+  if (typeof ttl !== 'number' || ttl < 0)
+    throw new TypeError('ttl must be a non-negative number');
+  if (typeof negativeTtl !== 'number' || negativeTtl < 0)
+    throw new TypeError('negativeTtl must be a non-negative number');
+
+  cares.configureCache(true, maxEntries, ttl, negativeTtl);
+};
+
+
+exports.disableCache = function() {
+  cares.configureCache(false, 0, 0, 0);
+};
+
+
+exports.clearCache = function() {
+  cares.clearCache();
+};
+
+
+exports.getCacheStats = function() {
+  return cares.getCacheStats();
+};
+
+
 var resolveMap = {};
 exports.resolve4 = resolveMap.A = resolver('queryA');
 exports.resolve6 = resolveMap.AAAA = resolver('queryAaaa');
@@ -913,6 +913,167 @@ fs.futimesSync = function(fd, atime, mtime) {
   binding.futimes(fd, atime, mtime);
 };
 
+// fs.batch(ops, callback)
+//
+// Runs a list of operations back to back on one thread pool thread and
+// calls back once with all of their results. Saves a thread pool round trip
+// and an event loop wakeup for every operation after the first.
+
+// Must match BatchOpType in src/node_file.cc.
+var BATCH_STAT = 0;
+var BATCH_LSTAT = 1;
+var BATCH_FSTAT = 2;
+var BATCH_OPEN = 3;
+var BATCH_CLOSE = 4;
+var BATCH_READ = 5;
+var BATCH_WRITE = 6;
+
+function BatchFd(index) {
+  this.index = index;
+}
+
+fs.batch = function(ops, callback) {
+  callback = makeCallback(callback);
+
+  if (!Array.isArray(ops))
+    throw new TypeError('ops must be an array');
+
+  var batch = new Array(ops.length);
+  for (var i = 0; i < ops.length; i++)
+    batch[i] = batchOp(ops, i);
+
+  if (batch.length === 0) {
+    process.nextTick(function() {
+      callback(null, []);
+    });
+  } else if (binding.batch) {
+    binding.batch(batch, callback);
+  } else {
+    batchFallback(batch, callback);
+  }
+};
+
+// Refers to the file descriptor returned by the 'open' operation at `index`.
+fs.batch.fd = function(index) {
+  return new BatchFd(index);
+};
+
+function batchPath(path) {
+  nullCheck(path);
+  return pathModule._makeLong(path);
+}
+
+function batchFd(ops, i, fd) {
+  if (fd instanceof BatchFd) {
+    var op = ops[fd.index];
+    if (!(fd.index >= 0 && fd.index < i && op[0] === 'open'))
+      throw new TypeError('fs.batch.fd() must refer to an earlier open');
+    return -(fd.index + 1);
+  }
+
+  if (typeof fd !== 'number' || fd < 0 || fd !== (fd | 0))
+    throw new TypeError('Bad file descriptor');
+
+  return fd;
+}
+
+function batchOp(ops, i) {
+  var op = ops[i];
+
+  if (!Array.isArray(op))
+    throw new TypeError('Batch operation must be an array');
+
+  switch (op[0]) {
+    case 'stat':
+      return [BATCH_STAT, batchPath(op[1])];
+    case 'lstat':
+      return [BATCH_LSTAT, batchPath(op[1])];
+    case 'fstat':
+      return [BATCH_FSTAT, batchFd(ops, i, op[1])];
+    case 'close':
+      return [BATCH_CLOSE, batchFd(ops, i, op[1])];
+    case 'open':
+      return [BATCH_OPEN,
+              batchPath(op[1]),
+              stringToFlags(op[2] || 'r'),
+              modeNum(op[3], 438 /*=0666*/)];
+    case 'read':
+    case 'write':
+      var buffer = op[2];
+      if (!Buffer.isBuffer(buffer))
+        throw new TypeError('Batch ' + op[0] + ' needs a buffer');
+      var offset = op[3] | 0;
+      var length = typeof op[4] === 'number' ? op[4] : buffer.length - offset;
+      if (offset < 0 || length < 0 || offset + length > buffer.length)
+        throw new RangeError('Batch ' + op[0] + ' is out of bounds');
+      return [op[0] === 'read' ? BATCH_READ : BATCH_WRITE,
+              batchFd(ops, i, op[1]),
+              buffer,
+              offset,
+              length,
+              op[5]];
+  }
+
+  throw new TypeError('Unknown batch operation: ' + op[0]);
+}
+
+// Used where the binding has no batch support (Windows). Runs the same
+// operations one by one.
+function batchFallback(ops, callback) {
+  var syscalls = ['stat', 'lstat', 'fstat', 'open', 'close', 'read', 'write'];
+  var results = new Array(ops.length);
+  var failed = new Array(ops.length);
+  var error = null;
+  var i = 0;
+
+  next();
+
+  function next() {
+    if (i === ops.length)
+      return callback(error, results);
+
+    var index = i++;
+    var op = ops[index];
+    var fd = op[1];
+
+    function done(err, value) {
+      if (err) {
+        failed[index] = true;
+        if (!error) {
+          err.index = index;
+          error = err;
+        }
+      } else {
+        results[index] = value;
+      }
+      next();
+    }
+
+    if (typeof fd === 'number' && fd < 0) {
+      if (failed[-fd - 1])
+        return done(errnoException('EBADF', syscalls[op[0]]));
+      fd = results[-fd - 1];
+    }
+
+    switch (op[0]) {
+      case BATCH_STAT:
+        return binding.stat(op[1], done);
+      case BATCH_LSTAT:
+        return binding.lstat(op[1], done);
+      case BATCH_FSTAT:
+        return binding.fstat(fd, done);
+      case BATCH_OPEN:
+        return binding.open(op[1], op[2], op[3], done);
+      case BATCH_CLOSE:
+        return binding.close(fd, done);
+      case BATCH_READ:
+        return binding.read(fd, op[2], op[3], op[4], op[5], done);
+      case BATCH_WRITE:
+        return binding.write(fd, op[2], op[3], op[4], op[5], done);
+    }
+  }
+}
+
 function writeAll(fd, buffer, offset, length, position, callback) {
   callback = maybeCallback(arguments[arguments.length - 1]);
 
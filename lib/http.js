@@ -21,6 +21,7 @@
 
 var util = require('util');
 var net = require('net');
+var fs = require('fs');
 var Stream = require('stream');
 var timers = require('timers');
 var url = require('url');
@@ -1126,6 +1127,84 @@ ServerResponse.prototype.writeContinue = function() {
   this._sent100 = true;
 };
 
+// Sends `length` bytes of the open file `fd`, starting at `offset`, as the
+// body and ends the response. On plain sockets the file goes out through
+// socket.sendFile(); TLS connections, chunked responses and responses that
+// are still queued behind a pipelined one read the file and write it instead.
+ServerResponse.prototype.sendFile = function(fd, offset, length, cb) {
+  if (typeof offset === 'function') {
+    cb = offset;
+    offset = 0;
+  } else if (typeof length === 'function') {
+    cb = length;
+    length = undefined;
+  }
+  offset = offset || 0;
+
+  var self = this;
+  if (length === undefined || length === null) {
+    fs.fstat(fd, function(er, stat) {
+      // Nothing has been sent yet, the caller may still answer with an
+      // error page.
+      if (er) {
+        if (cb) return cb(er);
+        return self.destroy();
+      }
+      self.sendFile(fd, offset, Math.max(stat.size - offset, 0), cb);
+    });
+    return;
+  }
+
+  if (!this._header) {
+    if (!this.getHeader('content-length') &&
+        !this.getHeader('transfer-encoding')) {
+      this.setHeader('Content-Length', length);
+    }
+    this._implicitHeader();
+  }
+
+  if (!this._hasBody || length === 0) {
+    this.end();
+    if (cb) process.nextTick(cb);
+    return;
+  }
+
+  var socket = this.connection;
+  if (!this.chunkedEncoding &&
+      this.output.length === 0 &&
+      socket &&
+      socket._httpMessage === this &&
+      socket.writable &&
+      !socket.encrypted &&
+      socket instanceof net.Socket &&
+      socket._handle &&
+      typeof socket._handle.sendFile === 'function') {
+    // Flush the header, the file is queued right behind it.
+    this._send('');
+    socket.sendFile(fd, offset, length, cb);
+    this.end();
+    return;
+  }
+
+  var rs = fs.createReadStream(null, {
+    fd: fd,
+    start: offset,
+    end: offset + length - 1,
+    autoClose: false
+  });
+  rs.on('error', function(er) {
+    // The header promised `length` bytes, the connection can't be reused.
+    rs.unpipe(self);
+    self.destroy();
+    if (cb) cb(er);
+  });
+  rs.on('end', function() {
+    if (cb) cb();
+  });
+  rs.pipe(this);
+};
+
+
 ServerResponse.prototype._implicitHeader = function() {
   this.writeHead(this.statusCode);
 };
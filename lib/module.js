@@ -23,17 +23,11 @@ var NativeModule = require('native_module');
 var Script = process.binding('evals').NodeScript;
 var runInThisContext = Script.runInThisContext;
 var runInNewContext = Script.runInNewContext;
+var precompile = Script.precompile;
+var resolver = process.binding('resolver');
 var assert = require('assert').ok;
 
 
-// If obj.hasOwnProperty has been overridden, then calling
-// obj.hasOwnProperty(prop) will break.
-// See: https://github.com/joyent/node/issues/1707
-function hasOwnProperty(obj, prop) {
-  return Object.prototype.hasOwnProperty.call(obj, prop);
-}
-
-
 function Module(id, parent) {
   this.id = id;
   this.exports = {};
@@ -74,6 +68,19 @@ if (process.env.NODE_DEBUG && /module/.test(process.env.NODE_DEBUG)) {
 var debug = Module._debug;
 
 
+// Set the environ variable NODE_COMPILE_CACHE=<dir> to keep V8's preparse
+// data for every module in <dir>. Off by default: V8 3.14 still compiles
+// the whole top level, so the saving hasn't been shown to beat the extra
+// stat() and read per require().
+Module._compileCacheDir = process.env['NODE_COMPILE_CACHE'] || null;
+Module.compileCacheStats = { hits: 0, misses: 0, stores: 0, errors: 0 };
+
+
+// In order to minimize unnecessary lstat() calls,
+// this cache is a list of known-real paths.
+// Set to an empty object to reset.
+Module._realpathCache = {};
+
 // given a module name, and a list of paths to test, returns the first
 // matching file in the following precedence.
 //
@@ -84,79 +91,10 @@ var debug = Module._debug;
 //   -> a
 //   -> a.<ext>
 //   -> a/index.<ext>
-
-function statPath(path) {
-  var fs = NativeModule.require('fs');
-  try {
-    return fs.statSync(path);
-  } catch (ex) {}
-  return false;
-}
-
-// check if the directory is a package.json dir
-var packageMainCache = {};
-
-function readPackage(requestPath) {
-  if (hasOwnProperty(packageMainCache, requestPath)) {
-    return packageMainCache[requestPath];
-  }
-
-  var fs = NativeModule.require('fs');
-  try {
-    var jsonPath = path.resolve(requestPath, 'package.json');
-    var json = fs.readFileSync(jsonPath, 'utf8');
-  } catch (e) {
-    return false;
-  }
-
-  try {
-    var pkg = packageMainCache[requestPath] = JSON.parse(json).main;
-  } catch (e) {
-    e.path = jsonPath;
-    e.message = 'Error parsing ' + jsonPath + ': ' + e.message;
-    throw e;
-  }
-  return pkg;
-}
-
-function tryPackage(requestPath, exts) {
-  var pkg = readPackage(requestPath);
-
-  if (!pkg) return false;
-
-  var filename = path.resolve(requestPath, pkg);
-  return tryFile(filename) || tryExtensions(filename, exts) ||
-         tryExtensions(path.resolve(filename, 'index'), exts);
-}
-
-// In order to minimize unnecessary lstat() calls,
-// this cache is a list of known-real paths.
-// Set to an empty object to reset.
-Module._realpathCache = {};
-
-// check if the file exists and is not a directory
-function tryFile(requestPath) {
-  var fs = NativeModule.require('fs');
-  var stats = statPath(requestPath);
-  if (stats && !stats.isDirectory()) {
-    return fs.realpathSync(requestPath, Module._realpathCache);
-  }
-  return false;
-}
-
-// given a path check a the file exists with any of the set extensions
-function tryExtensions(p, exts) {
-  for (var i = 0, EL = exts.length; i < EL; i++) {
-    var filename = tryFile(p + exts[i]);
-
-    if (filename) {
-      return filename;
-    }
-  }
-  return false;
-}
-
-
+//
+// The walk over the candidates runs in src/node_resolver.cc, which lists
+// directories instead of probing each candidate with stat() and remembers
+// what does not exist.
 Module._findPath = function(request, paths) {
   var exts = Object.keys(Module._extensions);
 
@@ -171,38 +109,87 @@ Module._findPath = function(request, paths) {
     return Module._pathCache[cacheKey];
   }
 
-  // For each path
+  var basePaths = new Array(paths.length);
   for (var i = 0, PL = paths.length; i < PL; i++) {
-    var basePath = path.resolve(paths[i], request);
-    var filename;
-
-    if (!trailingSlash) {
-      // try to join the request to the path
-      filename = tryFile(basePath);
+    basePaths[i] = path.resolve(paths[i], request);
+  }
 
-      if (!filename && !trailingSlash) {
-        // try it with each of the extensions
-        filename = tryExtensions(basePath, exts);
-      }
+  var filename = resolver.findPath(basePaths, exts, trailingSlash);
+  if (filename) {
+    var fs = NativeModule.require('fs');
+    try {
+      var real = fs.realpathSync(filename, Module._realpathCache);
+    } catch (e) {
+      // Cached, but gone since. Look again without what led to it.
+      if (e.code !== 'ENOENT' && e.code !== 'ENOTDIR') throw e;
+      forgetPath(filename);
+      filename = resolver.findPath(basePaths, exts, trailingSlash);
+      if (!filename) return false;
+      real = fs.realpathSync(filename, Module._realpathCache);
     }
+    Module._pathCache[cacheKey] = real;
+    return real;
+  }
+  return false;
+};
 
-    if (!filename) {
-      filename = tryPackage(basePath, exts);
-    }
 
-    if (!filename) {
-      // try it with each of the extensions at "index"
-      filename = tryExtensions(path.resolve(basePath, 'index'), exts);
-    }
+// Drops what led the resolver and the caches to a file that isn't there.
+function forgetPath(filename) {
+  debug('resolver: ' + filename + ' is gone, looking again');
+  resolver.forget(filename);
+  Module._realpathCache = {};
+  for (var key in Module._pathCache) {
+    if (Module._pathCache[key] === filename) delete Module._pathCache[key];
+  }
+}
 
-    if (filename) {
-      Module._pathCache[cacheKey] = filename;
-      return filename;
-    }
+
+// Set the environ variable NODE_RESOLVE_MANIFEST=<file> to seed the
+// resolver's cache from <file>. If <file> doesn't exist or can't be used, it
+// is written when the process exits, for the next start to use.
+Module._initResolveManifest = function() {
+  var manifest = process.env['NODE_RESOLVE_MANIFEST'];
+  if (!manifest) return;
+
+  var fs = NativeModule.require('fs');
+  try {
+    var json = fs.readFileSync(manifest, 'utf8');
+  } catch (e) {
+    process.on('exit', function() {
+      writeResolveManifest(manifest);
+    });
+    return;
+  }
+
+  try {
+    resolver.load(JSON.parse(json));
+  } catch (e) {
+    // Truncated or not a manifest, resolve without it and replace it.
+    debug('resolver: ignoring manifest ' + manifest + ': ' + e.message);
+    resolver.clear();
+    process.on('exit', function() {
+      writeResolveManifest(manifest);
+    });
   }
-  return false;
 };
 
+
+function writeResolveManifest(manifest) {
+  var fs = NativeModule.require('fs');
+  // Every process of a cluster may get here, replace the file atomically.
+  var tmp = manifest + '.' + process.pid;
+  try {
+    fs.writeFileSync(tmp, JSON.stringify(resolver.dump()));
+    fs.renameSync(tmp, manifest);
+  } catch (e) {
+    debug('resolver: writing manifest ' + manifest + ' failed: ' + e.message);
+    try {
+      fs.unlinkSync(tmp);
+    } catch (e) { }
+  }
+}
+
 // 'from' is the __dirname of the module.
 Module._nodeModulePaths = function(from) {
   // guarantee that 'from' is absolute.
@@ -307,16 +294,27 @@ Module._load = function(request, parent, isMain) {
   Module._cache[filename] = module;
 
   var hadException = true;
+  var gone = false;
 
   try {
     module.load(filename);
     hadException = false;
+  } catch (e) {
+    // Not an error in the module, reading it failed.
+    if (e.code !== 'ENOENT' || e.path !== filename) throw e;
+    gone = true;
   } finally {
     if (hadException) {
       delete Module._cache[filename];
     }
   }
 
+  // Resolved from what the resolver knew, but removed since.
+  if (gone) {
+    forgetPath(filename);
+    return Module._load(request, parent, isMain);
+  }
+
   return module.exports;
 };
 
@@ -436,7 +434,11 @@ Module.prototype._compile = function(content, filename) {
   // create wrapper function
   var wrapper = Module.wrap(content);
 
-  var compiledWrapper = runInThisContext(wrapper, filename, true);
+  var compiledWrapper;
+  if (Module._compileCacheDir)
+    compiledWrapper = compileCached(wrapper, filename);
+  else
+    compiledWrapper = runInThisContext(wrapper, filename, true);
   if (global.v8debug) {
     if (!resolvedArgv) {
       // we enter the repl if we're not given a filename argument.
@@ -457,6 +459,110 @@ Module.prototype._compile = function(content, filename) {
 };
 
 
+// A cache entry is a 32 bit LE key length, the key and the preparse data.
+// The key has everything the data depends on: the V8 version, the file and
+// the source that was compiled.
+function compileCacheKey(source, filename) {
+  var fs = NativeModule.require('fs');
+  try {
+    var stat = fs.statSync(filename);
+  } catch (e) {
+    return null;
+  }
+  return [process.versions.v8,
+          filename,
+          stat.size,
+          stat.mtime.getTime(),
+          source.length].join('\0');
+}
+
+
+function compileCachePath(filename) {
+  // Two FNV-1a hashes with different seeds, the key in the entry settles
+  // collisions.
+  var h1 = 0x811c9dc5, h2 = 0x050c5d1f;
+  for (var i = 0; i < filename.length; i++) {
+    var c = filename.charCodeAt(i);
+    h1 = ((h1 ^ c) * 0x01000193) >>> 0;
+    h2 = ((h2 ^ c) * 0x01000193) >>> 0;
+  }
+  var name = ('0000000' + h1.toString(16)).slice(-8) +
+             ('0000000' + h2.toString(16)).slice(-8);
+  return path.join(Module._compileCacheDir, name);
+}
+
+
+function readCompileCache(cachePath, key) {
+  var fs = NativeModule.require('fs');
+  try {
+    var entry = fs.readFileSync(cachePath);
+  } catch (e) {
+    return null;
+  }
+  if (entry.length < 4)
+    return null;
+  var keyLength = entry.readUInt32LE(0);
+  if (entry.length < 4 + keyLength ||
+      entry.toString('utf8', 4, 4 + keyLength) !== key) {
+    return null;
+  }
+  return entry.slice(4 + keyLength);
+}
+
+
+function writeCompileCache(cachePath, key, data) {
+  var fs = NativeModule.require('fs');
+  var keyLength = Buffer.byteLength(key);
+  var entry = new Buffer(4 + keyLength + data.length);
+  entry.writeUInt32LE(keyLength, 0);
+  entry.write(key, 4, keyLength, 'utf8');
+  data.copy(entry, 4 + keyLength);
+
+  // Other processes may be reading the entry, replace it atomically.
+  var tmp = cachePath + '.' + process.pid;
+  try {
+    fs.writeFileSync(tmp, entry);
+    fs.renameSync(tmp, cachePath);
+  } catch (e) {
+    if (e.code !== 'ENOENT')
+      throw e;
+    fs.mkdirSync(Module._compileCacheDir);
+    fs.writeFileSync(tmp, entry);
+    fs.renameSync(tmp, cachePath);
+  }
+}
+
+
+function compileCached(source, filename) {
+  var stats = Module.compileCacheStats;
+  var key = compileCacheKey(source, filename);
+  if (key === null)
+    return runInThisContext(source, filename, true);
+
+  var cachePath = compileCachePath(filename);
+  var data = readCompileCache(cachePath, key);
+  if (data) {
+    debug('compile cache hit ' + filename);
+    stats.hits++;
+    return runInThisContext(source, filename, data, true);
+  }
+
+  debug('compile cache miss ' + filename);
+  stats.misses++;
+  data = precompile(source);
+  if (data) {
+    try {
+      writeCompileCache(cachePath, key, data);
+      stats.stores++;
+    } catch (e) {
+      debug('compile cache write failed ' + e.message);
+      stats.errors++;
+    }
+  }
+  return runInThisContext(source, filename, data, true);
+}
+
+
 function stripBOM(content) {
   // Remove byte order marker. This catches EF BB BF (the UTF-8 BOM)
   // because the buffer-to-string conversion in `fs.readFileSync()`
@@ -533,6 +639,7 @@ Module.requireRepl = function() {
 };
 
 Module._initPaths();
+Module._initResolveManifest();
 
 // backwards compatibility
 Module.Module = Module;
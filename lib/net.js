@@ -526,6 +526,7 @@ function onread(buffer, offset, length) {
     // Optimization: emit the original buffer with end points
     var ret = true;
     if (self.ondata) self.ondata(buffer, offset, end);
+    else if (offset === 0 && end === buffer.length) ret = self.push(buffer);
     else ret = self.push(buffer.slice(offset, end));
 
     if (handle.reading && !ret) {
@@ -617,7 +618,37 @@ Socket.prototype.write = function(chunk, encoding, cb) {
 };
 
 
-Socket.prototype._write = function(data, encoding, cb) {
+// A file range travels through the Writable queue as an empty Buffer that
+// carries the range, so it keeps its place among the ordinary writes and
+// only reaches the handle once everything queued before it has.
+function FileRange(fd, offset, length) {
+  this.fd = fd;
+  this.offset = offset;
+  this.length = length;
+}
+
+
+function isUint(n) {
+  return typeof n === 'number' && n >= 0 && n % 1 === 0;
+}
+
+
+Socket.prototype.sendFile = function(fd, offset, length, cb) {
+  if (!isUint(fd) || !isUint(offset) || !isUint(length))
+    throw new TypeError('fd, offset and length must be non-negative integers');
+
+  if (this._handle && typeof this._handle.sendFile !== 'function')
+    throw new Error('sendFile is not supported on this stream');
+
+  var chunk = new Buffer(0);
+  if (length > 0)
+    chunk._fileRange = new FileRange(fd, offset, length);
+
+  return stream.Duplex.prototype.write.call(this, chunk, cb);
+};
+
+
+Socket.prototype._writeGeneric = function(writev, data, encoding, cb) {
   // If we are still connecting, then buffer this for later.
   // The Writable logic will buffer up any more writes while
   // waiting for this one to be done.
@@ -625,7 +656,7 @@ Socket.prototype._write = function(data, encoding, cb) {
     this._pendingData = data;
     this._pendingEncoding = encoding;
     this.once('connect', function() {
-      this._write(data, encoding, cb);
+      this._writeGeneric(writev, data, encoding, cb);
     });
     return;
   }
@@ -639,14 +670,37 @@ Socket.prototype._write = function(data, encoding, cb) {
     return false;
   }
 
-  var enc = Buffer.isBuffer(data) ? 'buffer' : encoding;
-  var writeReq = createWriteReq(this._handle, data, enc);
-
-  if (!writeReq || typeof writeReq !== 'object')
-    return this._destroy(errnoException(process._errno, 'write'), cb);
+  var writeReq;
+  if (writev) {
+    // File ranges can't share a uv_write() with the buffers around them.
+    // They split the list into several requests; libuv completes those in
+    // order, so only the last request needs to carry the callback.
+    var start = 0;
+    for (var i = 0; i <= data.length; i++) {
+      var range = i < data.length && data[i].chunk._fileRange;
+      if (i < data.length && !range)
+        continue;
+      if (i > start) {
+        if (writeReq !== undefined && !this._dispatchWrite(writeReq, cb))
+          return;
+        writeReq = createWritevReq(this._handle, data.slice(start, i));
+      }
+      if (range) {
+        if (writeReq !== undefined && !this._dispatchWrite(writeReq, cb))
+          return;
+        writeReq = createFileReq(this._handle, range);
+      }
+      start = i + 1;
+    }
+  } else if (data._fileRange) {
+    writeReq = createFileReq(this._handle, data._fileRange);
+  } else {
+    var enc = Buffer.isBuffer(data) ? 'buffer' : encoding;
+    writeReq = createWriteReq(this._handle, data, enc);
+  }
 
-  writeReq.oncomplete = afterWrite;
-  this._bytesDispatched += writeReq.bytes;
+  if (!this._dispatchWrite(writeReq, cb))
+    return;
 
   // If it was entirely flushed, we can write some more right now.
   // However, if more is left in the queue, then wait until that clears.
@@ -656,6 +710,48 @@ Socket.prototype._write = function(data, encoding, cb) {
     writeReq.cb = cb;
 };
 
+
+Socket.prototype._dispatchWrite = function(writeReq, cb) {
+  if (!writeReq || typeof writeReq !== 'object') {
+    this._destroy(errnoException(process._errno, 'write'), cb);
+    return false;
+  }
+
+  writeReq.oncomplete = afterWrite;
+  this._bytesDispatched += writeReq.bytes;
+  return true;
+};
+
+
+Socket.prototype._writev = function(chunks, cb) {
+  this._writeGeneric(true, chunks, '', cb);
+};
+
+
+Socket.prototype._write = function(data, encoding, cb) {
+  this._writeGeneric(false, data, encoding, cb);
+};
+
+
+// Flatten a WriteReq list into (chunk, encoding) pairs, the handle submits
+// them with a single uv_write().
+function createWritevReq(handle, entries) {
+  var chunks = new Array(entries.length << 1);
+  for (var i = 0; i < entries.length; i++) {
+    var entry = entries[i];
+    chunks[i * 2] = entry.chunk;
+    chunks[i * 2 + 1] = Buffer.isBuffer(entry.chunk) ? 'buffer' :
+                                                       entry.encoding;
+  }
+  return handle.writev(chunks);
+}
+
+
+function createFileReq(handle, range) {
+  return handle.sendFile(range.fd, range.offset, range.length);
+}
+
+
 function createWriteReq(handle, data, encoding) {
   switch (encoding) {
     case 'buffer':
@@ -687,23 +783,30 @@ Socket.prototype.__defineGetter__('bytesWritten', function() {
       encoding = this._pendingEncoding;
 
   state.buffer.forEach(function(el) {
-    if (Buffer.isBuffer(el.chunk))
-      bytes += el.chunk.length;
-    else
-      bytes += Buffer.byteLength(el.chunk, el.encoding);
+    bytes += chunkLength(el.chunk, el.encoding);
   });
 
-  if (data) {
-    if (Buffer.isBuffer(data))
-      bytes += data.length;
-    else
-      bytes += Buffer.byteLength(data, encoding);
+  if (Array.isArray(data)) {
+    // was a writev, iterate over chunks to get total length
+    for (var i = 0; i < data.length; i++)
+      bytes += chunkLength(data[i].chunk, data[i].encoding);
+  } else if (data) {
+    bytes += chunkLength(data, encoding);
   }
 
   return bytes;
 });
 
 
+function chunkLength(chunk, encoding) {
+  if (!Buffer.isBuffer(chunk))
+    return Buffer.byteLength(chunk, encoding);
+  if (chunk._fileRange)
+    return chunk._fileRange.length;
+  return chunk.length;
+}
+
+
 function afterWrite(status, handle, req) {
   var self = handle.owner;
   var state = self._writableState;
@@ -960,7 +1063,7 @@ function toNumber(x) { return (x = Number(x)) >= 0 ? x : false; }
 
 
 var createServerHandle = exports._createServerHandle =
-    function(address, port, addressType, fd) {
+    function(address, port, addressType, fd, reusePort) {
   var r = 0;
   // assign handle in listen, and clean up if bind or listen fails
   var handle;
@@ -990,6 +1093,10 @@ var createServerHandle = exports._createServerHandle =
     }
   } else {
     handle = createTCP();
+    if (reusePort && handle.setReusePort(true)) {
+      handle.close();
+      return null;
+    }
   }
 
   if (address || port) {
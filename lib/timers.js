@@ -138,6 +138,7 @@ function listOnTimeout() {
 
 var unenroll = exports.unenroll = function(item) {
   L.remove(item);
+  unrefStop(item);
 
   var list = lists[item._idleTimeout];
   // if empty then stop the watcher
@@ -156,7 +157,7 @@ var unenroll = exports.unenroll = function(item) {
 exports.enroll = function(item, msecs) {
   // if this item was already in a list somewhere
   // then we should unenroll it from that
-  if (item._idleNext) unenroll(item);
+  if (item._idleNext || item._unrefId !== undefined) unenroll(item);
 
   // Ensure that msecs fits into signed int32
   if (msecs > 0x7fffffff) {
@@ -173,6 +174,7 @@ exports.enroll = function(item, msecs) {
 exports.active = function(item) {
   var msecs = item._idleTimeout;
   if (msecs >= 0) {
+    unrefStop(item);
 
     var list = lists[msecs];
     if (!list || L.isEmpty(list)) {
@@ -401,8 +403,30 @@ exports.clearImmediate = function(immediate) {
 
 // Internal APIs that need timeouts should use timers._unrefActive isntead of
 // timers.active as internal timeouts shouldn't hold the loop open
+//
+// Items passed to _unrefActive live in a native timing wheel where starting,
+// restarting and stopping them is O(1), no matter how many sockets have
+// an idle timeout or how different their timeouts are. The wheel identifies
+// items by integer ids, unrefItems maps them back. Expired items are handed
+// to unrefTimeout in one batch per timer run.
+
+var TimerWheel = process.binding('timer_wrap').TimerWheel;
+var unrefWheel;
+var unrefItems = [];
+var unrefFreeIds = [];
+
+function unrefRelease(item) {
+  var id = item._unrefId;
+  unrefItems[id] = undefined;
+  unrefFreeIds.push(id);
+  item._unrefId = undefined;
+}
 
-var unrefList, unrefTimer;
+function unrefStop(item) {
+  if (item._unrefId === undefined) return;
+  unrefWheel.stop(item._unrefId);
+  unrefRelease(item);
+}
 
 function _makeTimerTimeout(timer) {
   var domain = timer.domain;
@@ -413,94 +437,54 @@ function _makeTimerTimeout(timer) {
   if (!msecs || msecs < 0)
     return;
 
+  // Or it has been made active again.
+  if (timer._unrefId !== undefined)
+    return;
+
   if (!timer._onTimeout)
     return;
 
   if (domain && domain._disposed)
     return;
 
-  try {
-    var threw = true;
-
-    if (domain) domain.enter();
-
-    debug('unreftimer firing timeout');
-    L.remove(timer);
-    timer._onTimeout();
+  if (domain) domain.enter();
 
-    threw = false;
+  debug('unreftimer firing timeout');
+  timer._onTimeout();
 
-    if (domain)
-      domain.exit();
-  } finally {
-    if (threw) process.nextTick(unrefTimeout);
-  }
+  if (domain)
+    domain.exit();
 }
 
-function unrefTimeout() {
-  var now = Timer.now();
-
+function unrefTimeout(ids) {
   debug('unrefTimer fired');
 
-  var timeSinceLastActive;
-  var nextTimeoutTime;
-  var nextTimeoutDuration;
-  var minNextTimeoutTime;
-  var timersToTimeout = [];
-
-  // The actual timer fired and has not yet been rearmed,
-  // let's consider its next firing time is invalid for now.
-  // It may be set to a relevant time in the future once
-  // we scanned through the whole list of timeouts and if
-  // we find a timeout that needs to expire.
-  unrefTimer.when = -1;
-
-  // Iterate over the list of timeouts,
-  // call the onTimeout callback for those expired,
-  // and rearm the actual timer if the next timeout to expire
-  // will expire before the current actual timer.
-  var cur = unrefList._idlePrev;
-  while (cur != unrefList) {
-    timeSinceLastActive = now - cur._monotonicStartTime;
-
-    if (timeSinceLastActive < cur._idleTimeout) {
-      // This timer hasn't expired yet, but check if its expiring time is
-      // earlier than the actual timer's expiring time
-
-      nextTimeoutDuration = cur._idleTimeout - timeSinceLastActive;
-      nextTimeoutTime = now + nextTimeoutDuration;
-      if (minNextTimeoutTime == null ||
-          (nextTimeoutTime < minNextTimeoutTime)) {
-        // We found a timeout that will expire earlier,
-        // store its next timeout time now so that we
-        // can rearm the actual timer accordingly when
-        // we scanned through the whole list.
-        minNextTimeoutTime = nextTimeoutTime;
-      }
-    } else {
-      // We found a timer that expired. Do not call its _onTimeout callback
-      // right now, as it could mutate any item of the list (including itself).
-      // Instead, add it to another list that will be processed once the list
-      // of current timers has been fully traversed.
-      timersToTimeout.push(cur);
-    }
-
-    cur = cur._idlePrev;
+  // Resolve all ids first. Callbacks may stop other items of the batch and
+  // their ids may be reused before we get to them.
+  var timers = new Array(ids.length);
+  for (var i = 0; i < ids.length; i++) {
+    timers[i] = unrefItems[ids[i]];
+    unrefRelease(timers[i]);
   }
 
-  var nbTimersToTimeout = timersToTimeout.length;
-  for (var timerIdx = 0; timerIdx < nbTimersToTimeout; ++timerIdx)
-    _makeTimerTimeout(timersToTimeout[timerIdx]);
-
+  runUnrefTimeouts(timers, 0);
+}
 
-  // Rearm the actual timer with the timeout delay
-  // of the earliest timeout found.
-  if (minNextTimeoutTime != null) {
-    unrefTimer.start(minNextTimeoutTime - now, 0);
-    unrefTimer.when = minNextTimeoutTime;
-    debug('unrefTimer rescheduled');
-  } else if (L.isEmpty(unrefList)) {
-    debug('unrefList is empty');
+function runUnrefTimeouts(timers, index) {
+  for (var i = index; i < timers.length; i++) {
+    var threw = true;
+    try {
+      _makeTimerTimeout(timers[i]);
+      threw = false;
+    } finally {
+      // Let the remaining timers of this batch fire after the error has been
+      // handled.
+      if (threw) {
+        process.nextTick(function() {
+          runUnrefTimeouts(timers, i + 1);
+        });
+      }
+    }
   }
 }
 
@@ -512,34 +496,21 @@ exports._unrefActive = function(item) {
 
   L.remove(item);
 
-  if (!unrefList) {
-    debug('unrefList initialized');
-    unrefList = {};
-    L.init(unrefList);
-
-    debug('unrefTimer initialized');
-    unrefTimer = new Timer();
-    unrefTimer.unref();
-    unrefTimer.when = -1;
-    unrefTimer.ontimeout = unrefTimeout;
+  if (!unrefWheel) {
+    debug('unrefWheel initialized');
+    unrefWheel = new TimerWheel();
+    unrefWheel.unref();
+    unrefWheel.onexpire = unrefTimeout;
   }
 
-  var nowDate = Date.now();
-  var nowMonotonicTimestamp = Timer.now();
-
-  item._idleStart = nowDate;
-  item._monotonicStartTime = nowMonotonicTimestamp;
-
-  var when = nowMonotonicTimestamp + msecs;
+  item._idleStart = Date.now();
 
-  // If the actual timer is set to fire too late, or not set to fire at all,
-  // we need to make it fire earlier
-  if (unrefTimer.when === -1 || unrefTimer.when > when) {
-    unrefTimer.start(msecs, 0);
-    unrefTimer.when = when;
-    debug('unrefTimer scheduled');
+  var id = item._unrefId;
+  if (id === undefined) {
+    id = unrefFreeIds.length > 0 ? unrefFreeIds.pop() : unrefItems.length;
+    unrefItems[id] = item;
+    item._unrefId = id;
   }
 
-  debug('unrefList append to end');
-  L.append(unrefList, item);
+  unrefWheel.start(id, msecs);
 };
@@ -909,7 +909,13 @@ function SecurePair(credentials, isServer, requestCert, rejectUnauthorized,
     this.ssl.onhandshakestart = onhandshakestart.bind(this);
     this.ssl.onhandshakedone = onhandshakedone.bind(this);
     this.ssl.onclienthello = onclienthello.bind(this);
-    this.ssl.onnewsession = onnewsession.bind(this);
+    // A native session cache stores sessions without any help, only ask
+    // for them if someone wants to see them.
+    if (!this.server ||
+        !this.server._sessionCache ||
+        this.server.listeners('newSession').length > 0) {
+      this.ssl.onnewsession = onnewsession.bind(this);
+    }
     this.ssl.lastHandshakeTime = 0;
     this.ssl.handshakes = 0;
   }
@@ -1137,6 +1143,9 @@ function Server(/* [options], listener */) {
     crl: self.crl,
     sessionIdContext: self.sessionIdContext
   });
+  this._sharedCreds = sharedCreds;
+  this._sessionCache = attachSessionCache(sharedCreds.context,
+                                          self.sessionCacheSize);
 
   var timeout = options.handshakeTimeout || (120 * 1000);
 
@@ -1146,6 +1155,10 @@ function Server(/* [options], listener */) {
 
   // constructor call
   net.Server.call(this, function(socket) {
+    if (self.nativeWrap && socket._handle) {
+      return onNativeConnection(self, socket, sharedCreds, timeout);
+    }
+
     var connOps = {
       secureProtocol: self.secureProtocol,
       secureOptions: self.secureOptions
@@ -1270,6 +1283,40 @@ Server.prototype.setOptions = function(options) {
   }
   if (options.cleartext) this.cleartext = options.cleartext;
   if (options.encrypted) this.encrypted = options.encrypted;
+  if (typeof options.sessionCacheSize === 'number') {
+    this.sessionCacheSize = options.sessionCacheSize;
+  }
+
+  // The native stream has no NPN or SNI support yet.
+  this.nativeWrap = options.nativeWrap === true &&
+                    !this.NPNProtocols &&
+                    !options.SNICallback;
+};
+
+// Gives the context a private native session store of `size` sessions.
+// Returns true if a store was attached.
+function attachSessionCache(context, size) {
+  if (size > 0) {
+    return context.setSessionCache(size);
+  }
+
+  return false;
+}
+
+// Called by the cluster module when the server listens through the master
+// and the master set up a session cache for all workers.
+Server.prototype._openSharedSessionCache = function(file) {
+  try {
+    this._sharedCreds.context.openSessionCache(file);
+    this._sessionCache = true;
+  } catch (e) {
+    // The master is gone or never finished setting it up.
+    debug('unable to open the shared session cache: ' + e.message);
+  }
+};
+
+Server.prototype.getSessionCacheStats = function() {
+  return this._sharedCreds.context.getSessionCacheStats();
 };
 
 // SNI Contexts High-Level API
@@ -1346,8 +1393,15 @@ exports.connect = function(/* [port, host], options, cb */) {
 
   var NPN = {};
   convertNPNProtocols(options.NPNProtocols, NPN);
-  var hostname = options.servername || options.host || 'localhost',
-      pair = new SecurePair(sslcontext, false, true,
+  var hostname = options.servername || options.host || 'localhost';
+
+  if (options.nativeWrap === true &&
+      !options.socket &&
+      !NPN.NPNProtocols) {
+    return connectNative(options, sslcontext, hostname, cb);
+  }
+
+  var pair = new SecurePair(sslcontext, false, true,
                             options.rejectUnauthorized === true ? true : false,
                             {
                               NPNProtocols: NPN.NPNProtocols,
@@ -1472,3 +1526,193 @@ function pipe(pair, socket) {
 
   return cleartext;
 }
+
+
+// Native TLS. Rather than piping the socket through a SecurePair, a
+// tls_wrap is layered on top of the socket's own handle: ciphertext never
+// leaves C++ and the net.Socket itself becomes the cleartext stream.
+// NPN, SNI and the server's session resumption events are not available on
+// this path.
+var tls_wrap = null;
+
+var nativeSocketMethods = {
+  getPeerCertificate: function() {
+    var c = this.ssl.getPeerCertificate();
+
+    if (c) {
+      if (c.issuer) c.issuer = parseCertString(c.issuer);
+      if (c.subject) c.subject = parseCertString(c.subject);
+      return c;
+    }
+
+    return null;
+  },
+
+  getSession: function() {
+    return this.ssl.getSession();
+  },
+
+  isSessionReused: function() {
+    return this.ssl.isSessionReused();
+  },
+
+  getCipher: function() {
+    return this.ssl.getCurrentCipher();
+  }
+};
+
+
+function wrapSocket(socket, credentials, isServer) {
+  if (tls_wrap === null) tls_wrap = process.binding('tls_wrap');
+
+  var ssl = tls_wrap.wrap(socket._handle, credentials.context, isServer);
+  socket.ssl = ssl;
+  socket.encrypted = true;
+  socket.authorized = false;
+  socket.authorizationError = null;
+  socket._secureEstablished = false;
+  util._extend(socket, nativeSocketMethods);
+
+  return ssl;
+}
+
+
+function onNativeHandshakeStart() {
+  debug('onNativeHandshakeStart');
+
+  var socket = this;
+  var ssl = socket.ssl;
+  var now = Timer.now();
+
+  assert(now >= ssl.lastHandshakeTime);
+
+  if ((now - ssl.lastHandshakeTime) >= exports.CLIENT_RENEG_WINDOW * 1000) {
+    ssl.handshakes = 0;
+  }
+
+  var first = (ssl.lastHandshakeTime === 0);
+  ssl.lastHandshakeTime = now;
+  if (first) return;
+
+  if (++ssl.handshakes > exports.CLIENT_RENEG_LIMIT) {
+    // Called from inside OpenSSL's state machine, see onhandshakestart().
+    setImmediate(function() {
+      var err = new Error('TLS session renegotiation attack detected.');
+      socket.destroy(err);
+    });
+  }
+}
+
+
+function onNativeConnection(server, socket, credentials, timeout) {
+  var ssl = wrapSocket(socket, credentials, true);
+  ssl.setVerifyMode(server.requestCert, server.rejectUnauthorized);
+  ssl.lastHandshakeTime = 0;
+  ssl.handshakes = 0;
+  ssl.onhandshakestart = onNativeHandshakeStart.bind(socket);
+
+  function onerror(err) {
+    if (socket._secureEstablished) {
+      socket.destroy(err);
+    } else {
+      server.emit('clientError', err, socket);
+      socket.destroy();
+    }
+  }
+
+  function ontimeout() {
+    onerror(new Error('TLS handshake timeout'));
+  }
+
+  if (timeout > 0) {
+    socket.setTimeout(timeout, ontimeout);
+  }
+
+  ssl.onerror = onerror;
+  ssl.onhandshakedone = function() {
+    debug('native secure established');
+    socket._secureEstablished = true;
+    socket.setTimeout(0, ontimeout);
+
+    if (server.requestCert) {
+      var verifyError = ssl.verifyError();
+      if (verifyError) {
+        socket.authorizationError = verifyError.message;
+        if (server.rejectUnauthorized) return socket.destroy();
+      } else {
+        socket.authorized = true;
+      }
+    }
+
+    server.emit('secureConnection', socket);
+  };
+}
+
+
+function connectNative(options, credentials, hostname, cb) {
+  var socket = new net.Stream();
+
+  var connect_opt = (options.path && !options.port) ? {path: options.path} : {
+    port: options.port,
+    host: options.host,
+    localAddress: options.localAddress
+  };
+  socket.connect(connect_opt);
+
+  var ssl = wrapSocket(socket, credentials, false);
+
+  if (process.features.tls_sni) {
+    ssl.setServername(hostname);
+  }
+
+  if (options.session) {
+    var session = options.session;
+    if (typeof session === 'string')
+      session = new Buffer(session, 'binary');
+    ssl.setSession(session);
+  }
+
+  if (cb) {
+    socket.once('secureConnect', cb);
+  }
+
+  ssl.onerror = function(err) {
+    socket.destroy(err);
+  };
+
+  ssl.onhandshakedone = function() {
+    debug('native secure established');
+    socket._secureEstablished = true;
+
+    var verifyError = ssl.verifyError();
+
+    // Verify that server's identity matches it's certificate's names
+    if (!verifyError) {
+      var validCert = checkServerIdentity(hostname,
+                                          socket.getPeerCertificate());
+      if (!validCert) {
+        verifyError = new Error('Hostname/IP doesn\'t match certificate\'s ' +
+                                'altnames');
+      }
+    }
+
+    if (verifyError) {
+      socket.authorizationError = verifyError.message;
+
+      if (options.rejectUnauthorized === true) {
+        socket.destroy(verifyError);
+        return;
+      }
+    } else {
+      socket.authorized = true;
+    }
+
+    socket.emit('secureConnect');
+  };
+
+  socket.once('connect', function() {
+    ssl.start();
+  });
+
+  return socket;
+}
@@ -0,0 +1,123 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var fs = require('fs');
+var path = require('path');
+var util = require('util');
+var EventEmitter = require('events').EventEmitter;
+var Buffer = require('buffer').Buffer;
+var WorkerHandle = process.binding('worker_wrap').Worker;
+
+// Buffers travel next to the JSON text, which refers to them by index.
+// Must match BYTES_KEY in lib/_worker_context.js.
+var BYTES_KEY = '\u0000bytes';
+
+
+function Worker(filename) {
+  if (!(this instanceof Worker)) return new Worker(filename);
+  EventEmitter.call(this);
+
+  filename = path.resolve(filename);
+  // Remove shebang, like the module loader does.
+  var source = fs.readFileSync(filename, 'utf8').replace(/^\#\!.*/, '');
+
+  this._handle = new WorkerHandle();
+  this._handle.owner = this;
+  this._handle.onmessage = onmessage;
+  this._handle.onerror = onerror;
+  this._handle.onexit = onexit;
+
+  try {
+    this._handle.start(source, filename);
+  } catch (e) {
+    this._handle.close();
+    this._handle = null;
+    throw e;
+  }
+}
+util.inherits(Worker, EventEmitter);
+exports.Worker = Worker;
+
+
+Worker.prototype.postMessage = function(value) {
+  // Like in browsers, messages to a worker that is gone are dropped.
+  if (!this._handle) return;
+
+  var buffers = [];
+  var json = JSON.stringify(value, function(key, val) {
+    // `val` has been through Buffer#toJSON already, look at the original.
+    var orig = this[key];
+    if (Buffer.isBuffer(orig)) {
+      var ref = {};
+      ref[BYTES_KEY] = buffers.push(orig) - 1;
+      return ref;
+    }
+    return val;
+  });
+
+  this._handle.postMessage(json === undefined ? 'null' : json, buffers);
+};
+
+
+Worker.prototype.terminate = function() {
+  if (this._handle) this._handle.terminate();
+};
+
+
+Worker.prototype.ref = function() {
+  if (this._handle) this._handle.ref();
+};
+
+
+Worker.prototype.unref = function() {
+  if (this._handle) this._handle.unref();
+};
+
+
+function onmessage(json, buffers) {
+  var self = this.owner;
+  var value = JSON.parse(json, function(key, val) {
+    if (val !== null &&
+        typeof val === 'object' &&
+        typeof val[BYTES_KEY] === 'number') {
+      var slow = buffers[val[BYTES_KEY]];
+      return slow.slice(0, slow.length);
+    }
+    return val;
+  });
+  self.emit('message', value);
+}
+
+
+function onerror(message, stack) {
+  var self = this.owner;
+  var err = new Error(message.replace(/^\w*Error: /, ''));
+  err.stack = stack;
+  self.emit('error', err);
+}
+
+
+function onexit(code) {
+  var self = this.owner;
+  self._handle.close();
+  self._handle = null;
+  self.emit('exit', code);
+}
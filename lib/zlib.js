@@ -43,6 +43,10 @@ binding.Z_MIN_MEMLEVEL = 1;
 binding.Z_MAX_MEMLEVEL = 9;
 binding.Z_DEFAULT_MEMLEVEL = 8;
 
+// Chunks of at most this many bytes are processed on the main thread,
+// handing them to the threadpool costs more than compressing them.
+binding.Z_DEFAULT_SYNC_THRESHOLD = 1024;
+
 binding.Z_MIN_LEVEL = -1;
 binding.Z_MAX_LEVEL = 9;
 binding.Z_DEFAULT_LEVEL = binding.Z_DEFAULT_COMPRESSION;
@@ -136,6 +140,34 @@ exports.inflateRaw = function(buffer, callback) {
   zlibBuffer(new InflateRaw(), buffer, callback);
 };
 
+exports.deflateSync = function(buffer) {
+  return zlibBufferSync(new Deflate(), buffer);
+};
+
+exports.gzipSync = function(buffer) {
+  return zlibBufferSync(new Gzip(), buffer);
+};
+
+exports.deflateRawSync = function(buffer) {
+  return zlibBufferSync(new DeflateRaw(), buffer);
+};
+
+exports.unzipSync = function(buffer) {
+  return zlibBufferSync(new Unzip(), buffer);
+};
+
+exports.inflateSync = function(buffer) {
+  return zlibBufferSync(new Inflate(), buffer);
+};
+
+exports.gunzipSync = function(buffer) {
+  return zlibBufferSync(new Gunzip(), buffer);
+};
+
+exports.inflateRawSync = function(buffer) {
+  return zlibBufferSync(new InflateRaw(), buffer);
+};
+
 function zlibBuffer(engine, buffer, callback) {
   var buffers = [];
   var nread = 0;
@@ -169,6 +201,20 @@ function zlibBuffer(engine, buffer, callback) {
   }
 }
 
+function zlibBufferSync(engine, buffer) {
+  if (typeof buffer === 'string')
+    buffer = new Buffer(buffer);
+  if (!Buffer.isBuffer(buffer))
+    throw new TypeError('Not a string or buffer');
+
+  // Free the native state right away, also when the input is bad.
+  try {
+    return engine._processChunk(buffer, binding.Z_FINISH);
+  } finally {
+    engine.close();
+  }
+}
+
 
 // generic zlib
 // minimal 2-byte header
@@ -277,6 +323,14 @@ function Zlib(opts, mode) {
     }
   }
 
+  if (opts.syncThreshold !== undefined) {
+    if (typeof opts.syncThreshold !== 'number' || opts.syncThreshold < 0) {
+      throw new Error('Invalid syncThreshold: ' + opts.syncThreshold);
+    }
+  }
+  this._syncThreshold = opts.syncThreshold !== undefined ?
+      opts.syncThreshold : exports.Z_DEFAULT_SYNC_THRESHOLD;
+
   if (opts.dictionary) {
     if (!Buffer.isBuffer(opts.dictionary)) {
       throw new Error('Invalid dictionary: it should be a Buffer instance');
@@ -287,16 +341,25 @@ function Zlib(opts, mode) {
 
   var self = this;
   this._hadError = false;
+  this._writingSync = false;
+  this._syncError = null;
   this._binding.onerror = function(message, errno) {
     // there is no way to cleanly recover.
     // continuing only obscures problems.
+    // close() still has to release the native state.
+    self._failedBinding = self._binding;
     self._binding = null;
     self._hadError = true;
 
     var error = new Error(message);
     error.errno = errno;
     error.code = exports.codes[errno];
-    self.emit('error', error);
+
+    // _processChunk() decides what to do with errors from writeSync().
+    if (self._writingSync)
+      self._syncError = error;
+    else
+      self.emit('error', error);
   };
 
   var level = exports.Z_DEFAULT_COMPRESSION;
@@ -360,7 +423,7 @@ Zlib.prototype.close = function(callback) {
 
   this._closed = true;
 
-  this._binding.close();
+  (this._binding || this._failedBinding).close();
 
   var self = this;
   process.nextTick(function() {
@@ -392,12 +455,64 @@ Zlib.prototype._transform = function(chunk, encoding, cb) {
     }
   }
 
+  this._processChunk(chunk, flushFlag, cb);
+};
+
+// Compresses or decompresses one chunk. Without a callback, the work is done
+// synchronously and the output is returned as a single buffer; errors are
+// thrown. With one, the output is pushed to the stream and cb is called
+// when the chunk has been consumed.
+Zlib.prototype._processChunk = function(chunk, flushFlag, cb) {
   var availInBefore = chunk && chunk.length;
   var availOutBefore = this._chunkSize - this._offset;
   var inOff = 0;
 
-  if (this._closed)
-    return cb(new Error('zlib binding closed'));
+  var self = this;
+  var async = typeof cb === 'function';
+  var buffers = [];
+  var nread = 0;
+
+  if (this._closed) {
+    var er = new Error('zlib binding closed');
+    if (!async)
+      throw er;
+    return cb(er);
+  }
+
+  // Small chunks are processed on the main thread even for streams.
+  if (!async || availInBefore <= this._syncThreshold) {
+    var res;
+    this._writingSync = true;
+    do {
+      res = this._binding.writeSync(flushFlag,
+                                    chunk, // in
+                                    inOff, // in_off
+                                    availInBefore, // in_len
+                                    this._buffer, // out
+                                    this._offset, //out_off
+                                    availOutBefore); // out_len
+    } while (!this._hadError && handleChunk(res[0], res[1]));
+    this._writingSync = false;
+
+    if (this._hadError) {
+      var error = this._syncError;
+      this._syncError = null;
+      if (!async)
+        throw error;
+      process.nextTick(function() {
+        self.emit('error', error);
+      });
+      return;
+    }
+
+    if (async)
+      return cb();
+
+    var buf = Buffer.concat(buffers, nread);
+    this.close();
+    return buf;
+  }
+
   var req = this._binding.write(flushFlag,
                                 chunk, // in
                                 inOff, // in_off
@@ -409,11 +524,31 @@ Zlib.prototype._transform = function(chunk, encoding, cb) {
   req.buffer = chunk;
   req.callback = callback;
 
-  var self = this;
   function callback(availInAfter, availOutAfter, buffer) {
     if (self._hadError)
       return;
 
+    if (handleChunk(availInAfter, availOutAfter)) {
+      assert(!self._closed, 'zlib binding closed');
+      var newReq = self._binding.write(flushFlag,
+                                       chunk,
+                                       inOff,
+                                       availInBefore,
+                                       self._buffer,
+                                       self._offset,
+                                       self._chunkSize);
+      newReq.callback = callback; // this same function
+      newReq.buffer = chunk;
+      return;
+    }
+
+    // finished with the chunk.
+    cb();
+  }
+
+  // Takes the output of one write. Returns true if the same input has to
+  // be written again.
+  function handleChunk(availInAfter, availOutAfter) {
     var have = availOutBefore - availOutAfter;
     assert(have >= 0, 'have should not go down');
 
@@ -421,7 +556,12 @@ Zlib.prototype._transform = function(chunk, encoding, cb) {
       var out = self._buffer.slice(self._offset, self._offset + have);
       self._offset += have;
       // serve some output to the consumer.
-      self.push(out);
+      if (async) {
+        self.push(out);
+      } else {
+        buffers.push(out);
+        nread += out.length;
+      }
     }
 
     // exhausted the output buffer, or used all the input create a new one.
@@ -438,22 +578,10 @@ Zlib.prototype._transform = function(chunk, encoding, cb) {
       // it'll have the correct byte counts.
       inOff += (availInBefore - availInAfter);
       availInBefore = availInAfter;
-
-      assert(!self._closed, 'zlib binding closed');
-      var newReq = self._binding.write(flushFlag,
-                                       chunk,
-                                       inOff,
-                                       availInBefore,
-                                       self._buffer,
-                                       self._offset,
-                                       self._chunkSize);
-      newReq.callback = callback; // this same function
-      newReq.buffer = chunk;
-      return;
+      return true;
     }
 
-    // finished with the chunk.
-    cb();
+    return false;
   }
 };
 
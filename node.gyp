@@ -11,6 +11,7 @@
     'node_shared_cares%': 'false',
     'node_shared_libuv%': 'false',
     'node_use_openssl%': 'true',
+    'node_core_snapshot%': 'false',
     'node_use_systemtap%': 'false',
     'node_shared_openssl%': 'false',
     'library_files': [
@@ -54,6 +55,8 @@
       'lib/url.js',
       'lib/util.js',
       'lib/vm.js',
+      'lib/worker.js',
+      'lib/_worker_context.js',
       'lib/zlib.js',
     ],
   },
@@ -79,6 +82,7 @@
       'sources': [
         'src/fs_event_wrap.cc',
         'src/cares_wrap.cc',
+        'src/dns_cache.cc',
         'src/handle_wrap.cc',
         'src/node.cc',
         'src/node_buffer.cc',
@@ -87,29 +91,37 @@
         'src/node_file.cc',
         'src/node_http_parser.cc',
         'src/node_javascript.cc',
+        'src/node_loop_metrics.cc',
         'src/node_main.cc',
         'src/node_os.cc',
+        'src/node_resolver.cc',
         'src/node_script.cc',
+        'src/node_serdes.cc',
         'src/node_stat_watcher.cc',
         'src/node_string.cc',
         'src/node_zlib.cc',
         'src/pipe_wrap.cc',
         'src/signal_wrap.cc',
         'src/string_bytes.cc',
+        'src/string_bytes_simd.cc',
         'src/stream_wrap.cc',
-        'src/slab_allocator.cc',
+        'src/buffer_pool.cc',
         'src/tcp_wrap.cc',
+        'src/timer_wheel.cc',
         'src/timer_wrap.cc',
         'src/tty_wrap.cc',
         'src/process_wrap.cc',
         'src/v8_typed_array.cc',
         'src/udp_wrap.cc',
+        'src/worker_wrap.cc',
         # headers to make for a more pleasant IDE experience
+        'src/dns_cache.h',
         'src/handle_wrap.h',
         'src/node.h',
         'src/node_buffer.h',
         'src/node_constants.h',
         'src/node_crypto.h',
+        'src/node_crypto_session_cache.h',
         'src/node_extensions.h',
         'src/node_file.h',
         'src/node_http_parser.h',
@@ -123,10 +135,13 @@
         'src/pipe_wrap.h',
         'src/tty_wrap.h',
         'src/tcp_wrap.h',
+        'src/timer_wheel.h',
+        'src/tls_wrap.h',
         'src/udp_wrap.h',
         'src/req_wrap.h',
-        'src/slab_allocator.h',
+        'src/buffer_pool.h',
         'src/string_bytes.h',
+        'src/string_bytes_simd.h',
         'src/stream_wrap.h',
         'src/tree.h',
         'src/v8_typed_array.h',
@@ -148,7 +163,11 @@
       'conditions': [
         [ 'node_use_openssl=="true"', {
           'defines': [ 'HAVE_OPENSSL=1' ],
-          'sources': [ 'src/node_crypto.cc' ],
+          'sources': [
+            'src/node_crypto.cc',
+            'src/node_crypto_session_cache.cc',
+            'src/tls_wrap.cc',
+          ],
           'conditions': [
             [ 'node_shared_openssl=="false"', {
               'dependencies': [
@@ -236,12 +255,23 @@
           'defines': [ 'HAVE_PERFCTR=1' ],
           'dependencies': [ 'node_perfctr' ],
           'sources': [
-            'src/node_win32_perfctr_provider.h',
-            'src/node_win32_perfctr_provider.cc',
             'src/node_counters.cc',
             'src/node_counters.h',
-            'tools/msvs/genfiles/node_perfctr_provider.rc',
-          ]
+          ],
+          'conditions': [ [
+            'OS=="win"', {
+              'sources': [
+                'src/node_win32_perfctr_provider.h',
+                'src/node_win32_perfctr_provider.cc',
+                'tools/msvs/genfiles/node_perfctr_provider.rc',
+              ]
+            }, {
+              'sources': [
+                'src/node_posix_perfctr_provider.h',
+                'src/node_posix_perfctr_provider.cc',
+              ]
+            }
+          ] ]
         } ],
         # Conditionally include v8 or v8ppc or v8z
         [ 'node_shared_v8=="false" and target_arch!="ppc" and target_arch!="ppc64" and target_arch!="s390" and target_arch!="s390x"', {
@@ -381,6 +411,7 @@
       'sources': [
         'src/fs_event_wrap.cc',
         'src/cares_wrap.cc',
+        'src/dns_cache.cc',
         'src/handle_wrap.cc',
         'src/node.cc',
         'src/node_buffer.cc',
@@ -389,29 +420,37 @@
         'src/node_file.cc',
         'src/node_http_parser.cc',
         'src/node_javascript.cc',
+        'src/node_loop_metrics.cc',
         'src/node_main.cc',
         'src/node_os.cc',
+        'src/node_resolver.cc',
         'src/node_script.cc',
+        'src/node_serdes.cc',
         'src/node_stat_watcher.cc',
         'src/node_string.cc',
         'src/node_zlib.cc',
         'src/pipe_wrap.cc',
         'src/signal_wrap.cc',
         'src/string_bytes.cc',
+        'src/string_bytes_simd.cc',
         'src/stream_wrap.cc',
-        'src/slab_allocator.cc',
+        'src/buffer_pool.cc',
         'src/tcp_wrap.cc',
+        'src/timer_wheel.cc',
         'src/timer_wrap.cc',
         'src/tty_wrap.cc',
         'src/process_wrap.cc',
         'src/v8_typed_array.cc',
         'src/udp_wrap.cc',
+        'src/worker_wrap.cc',
         # headers to make for a more pleasant IDE experience
+        'src/dns_cache.h',
         'src/handle_wrap.h',
         'src/node.h',
         'src/node_buffer.h',
         'src/node_constants.h',
         'src/node_crypto.h',
+        'src/node_crypto_session_cache.h',
         'src/node_extensions.h',
         'src/node_file.h',
         'src/node_http_parser.h',
@@ -425,10 +464,13 @@
         'src/pipe_wrap.h',
         'src/tty_wrap.h',
         'src/tcp_wrap.h',
+        'src/timer_wheel.h',
+        'src/tls_wrap.h',
         'src/udp_wrap.h',
         'src/req_wrap.h',
-        'src/slab_allocator.h',
+        'src/buffer_pool.h',
         'src/string_bytes.h',
+        'src/string_bytes_simd.h',
         'src/stream_wrap.h',
         'src/tree.h',
         'src/v8_typed_array.h',
@@ -450,7 +492,11 @@
       'conditions': [
         [ 'node_use_openssl=="true"', {
           'defines': [ 'HAVE_OPENSSL=1' ],
-          'sources': [ 'src/node_crypto.cc' ],
+          'sources': [
+            'src/node_crypto.cc',
+            'src/node_crypto_session_cache.cc',
+            'src/tls_wrap.cc',
+          ],
           'conditions': [
             [ 'node_shared_openssl=="false"', {
               'dependencies': [
@@ -538,12 +584,23 @@
           'defines': [ 'HAVE_PERFCTR=1' ],
           'dependencies': [ 'node_perfctr' ],
           'sources': [
-            'src/node_win32_perfctr_provider.h',
-            'src/node_win32_perfctr_provider.cc',
             'src/node_counters.cc',
             'src/node_counters.h',
-            'tools/msvs/genfiles/node_perfctr_provider.rc',
-          ]
+          ],
+          'conditions': [ [
+            'OS=="win"', {
+              'sources': [
+                'src/node_win32_perfctr_provider.h',
+                'src/node_win32_perfctr_provider.cc',
+                'tools/msvs/genfiles/node_perfctr_provider.rc',
+              ]
+            }, {
+              'sources': [
+                'src/node_posix_perfctr_provider.h',
+                'src/node_posix_perfctr_provider.cc',
+              ]
+            }
+          ] ]
         } ],
         # Conditionally include v8ppc
         [ 'node_shared_v8=="false" and (target_arch=="ppc" or target_arch=="ppc64")', {
@@ -712,6 +769,45 @@
         },
       ],
     }, # end node_js2c
+    {
+      # Core library in the form mksnapshot runs it, see --with-core-snapshot
+      # in configure.
+      'target_name': 'node_core_snapshot_js',
+      'type': 'none',
+      'toolsets': ['host'],
+      'conditions': [
+        [ 'node_core_snapshot=="true"', {
+          'actions': [
+            {
+              'action_name': 'node_core_snapshot_js',
+              'inputs': [
+                '<@(library_files)',
+                'tools/js2c.py',
+              ],
+              'outputs': [
+                '<(SHARED_INTERMEDIATE_DIR)/node_core_snapshot.js',
+              ],
+              'conditions': [
+                [ 'node_use_dtrace=="false"'
+                  ' and node_use_etw=="false"'
+                  ' and node_use_systemtap=="false"', {
+                  'inputs': [ 'src/macros.py' ]
+                }],
+                [ 'node_use_perfctr=="false"', {
+                  'inputs': [ 'src/perfctr_macros.py' ]
+                }]
+              ],
+              'action': [
+                '<(python)',
+                'tools/js2c.py',
+                '<@(_outputs)',
+                '<@(_inputs)',
+              ],
+            },
+          ],
+        } ]
+      ]
+    }, # end node_core_snapshot_js
     {
       'target_name': 'node_dtrace_header',
       'type': 'none',
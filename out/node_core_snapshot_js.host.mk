@@ -0,0 +1,18 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := host
+TARGET := node_core_snapshot_js
+### Rules for final target.
+$(obj).host/node_core_snapshot_js.stamp: TOOLSET := $(TOOLSET)
+$(obj).host/node_core_snapshot_js.stamp:  FORCE_DO_CMD
+	$(call do_cmd,touch)
+
+all_deps += $(obj).host/node_core_snapshot_js.stamp
+# Add target alias
+.PHONY: node_core_snapshot_js
+node_core_snapshot_js: $(obj).host/node_core_snapshot_js.stamp
+
+# Add target alias to "all" target.
+.PHONY: all
+all: node_core_snapshot_js
+
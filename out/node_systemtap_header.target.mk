@@ -0,0 +1,18 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := target
+TARGET := node_systemtap_header
+### Rules for final target.
+$(obj).target/node_systemtap_header.stamp: TOOLSET := $(TOOLSET)
+$(obj).target/node_systemtap_header.stamp:  FORCE_DO_CMD
+	$(call do_cmd,touch)
+
+all_deps += $(obj).target/node_systemtap_header.stamp
+# Add target alias
+.PHONY: node_systemtap_header
+node_systemtap_header: $(obj).target/node_systemtap_header.stamp
+
+# Add target alias to "all" target.
+.PHONY: all
+all: node_systemtap_header
+
@@ -0,0 +1,225 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "v8.h"
+#include "node.h"
+#include "node_buffer.h"
+#include "buffer_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+using v8::Arguments;
+using v8::Handle;
+using v8::HandleScope;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::Persistent;
+using v8::String;
+using v8::Value;
+using v8::V8;
+
+
+namespace node {
+
+static Persistent<String> arenas_sym;
+static Persistent<String> pinned_bytes_sym;
+static Persistent<String> buffers_sym;
+static Persistent<String> used_bytes_sym;
+static Persistent<String> scratch_bytes_sym;
+static Persistent<String> fragmentation_sym;
+
+
+struct BufferPool::Arena {
+  BufferPool* pool;
+  size_t size;
+  size_t used;
+  size_t buffers;
+};
+
+// Data starts on a 16 byte boundary after the header.
+#define ARENA_HEADER_SIZE ((sizeof(BufferPool::Arena) + 15) & ~15)
+
+
+BufferPool::BufferPool() {
+  arena_ = NULL;
+  scratch_ = NULL;
+  scratch_size_ = 0;
+  arenas_ = 0;
+  arena_bytes_ = 0;
+  buffers_ = 0;
+  used_bytes_ = 0;
+}
+
+
+BufferPool::~BufferPool() {
+  // Arenas that are still referenced from JS free themselves once their
+  // SlowBuffer is collected.
+  if (arena_ != NULL) arena_->pool = NULL;
+  current_.Dispose();
+  current_.Clear();
+  free(scratch_);
+}
+
+
+BufferPool* BufferPool::Default() {
+  // Never deleted, arenas can outlive the bindings that filled them.
+  static BufferPool* pool = NULL;
+  if (pool == NULL) pool = new BufferPool();
+  return pool;
+}
+
+
+uv_buf_t BufferPool::Scratch(size_t suggested_size) {
+  if (suggested_size > scratch_size_) {
+    free(scratch_);
+    scratch_ = static_cast<char*>(malloc(suggested_size));
+    if (scratch_ == NULL) {
+      scratch_size_ = 0;
+      return uv_buf_init(NULL, 0);
+    }
+    scratch_size_ = suggested_size;
+  }
+  return uv_buf_init(scratch_, suggested_size);
+}
+
+
+BufferPool::Arena* BufferPool::NewArena(size_t size, Local<Object>* object) {
+  char* storage = static_cast<char*>(malloc(ARENA_HEADER_SIZE + size));
+  if (storage == NULL) return NULL;
+
+  Arena* arena = reinterpret_cast<Arena*>(storage);
+  arena->pool = this;
+  arena->size = size;
+  arena->used = 0;
+  arena->buffers = 0;
+
+  Buffer* buffer = Buffer::New(storage + ARENA_HEADER_SIZE,
+                               size,
+                               FreeArena,
+                               arena);
+  *object = Local<Object>::New(buffer->handle_);
+
+  arenas_++;
+  arena_bytes_ += size;
+  V8::AdjustAmountOfExternalAllocatedMemory(size);
+
+  return arena;
+}
+
+
+void BufferPool::FreeArena(char* data, void* hint) {
+  Arena* arena = static_cast<Arena*>(hint);
+  BufferPool* pool = arena->pool;
+
+  if (pool != NULL) {
+    if (pool->arena_ == arena) pool->arena_ = NULL;
+    pool->arenas_--;
+    pool->arena_bytes_ -= arena->size;
+    pool->buffers_ -= arena->buffers;
+    pool->used_bytes_ -= arena->used;
+  }
+
+  if (!V8::IsDead()) {
+    V8::AdjustAmountOfExternalAllocatedMemory(
+        -static_cast<intptr_t>(arena->size));
+  }
+
+  free(arena);
+}
+
+
+Local<Object> BufferPool::Take(const char* data, size_t size) {
+  HandleScope scope;
+  Local<Object> object;
+  Arena* arena;
+
+  if (size > kMaxShared) {
+    arena = NewArena(size, &object);
+  } else if (arena_ == NULL || arena_->size - arena_->used < size) {
+    arena = NewArena(kArenaSize, &object);
+    // The old arena lives on for as long as its Buffers do.
+    current_.Dispose();
+    current_.Clear();
+    arena_ = arena;
+    if (arena != NULL) current_ = Persistent<Object>::New(object);
+  } else {
+    arena = arena_;
+    object = Local<Object>::New(current_);
+  }
+
+  if (arena == NULL) {
+    // Out of memory. Let Buffer deal with it the way it always has.
+    Buffer* buffer = Buffer::New(data, size);
+    return scope.Close(Buffer::Slice(buffer->handle_, 0, size));
+  }
+
+  size_t offset = arena->used;
+  char* base = reinterpret_cast<char*>(arena) + ARENA_HEADER_SIZE;
+  if (size > 0) memcpy(base + offset, data, size);
+
+  // Keep allocations 8 byte aligned, like lib/buffer.js does for its pool.
+  size_t used = (offset + size + 7) & ~static_cast<size_t>(7);
+  if (used > arena->size) used = arena->size;
+  used_bytes_ += used - offset;
+  arena->used = used;
+  arena->buffers++;
+  buffers_++;
+
+  return scope.Close(Buffer::Slice(object, offset, size));
+}
+
+
+Handle<Value> BufferPool::GetStats(const Arguments& args) {
+  HandleScope scope;
+  BufferPool* pool = Default();
+
+  if (arenas_sym.IsEmpty()) {
+    arenas_sym = NODE_PSYMBOL("arenas");
+    pinned_bytes_sym = NODE_PSYMBOL("pinnedBytes");
+    buffers_sym = NODE_PSYMBOL("buffers");
+    used_bytes_sym = NODE_PSYMBOL("usedBytes");
+    scratch_bytes_sym = NODE_PSYMBOL("scratchBytes");
+    fragmentation_sym = NODE_PSYMBOL("fragmentation");
+  }
+
+  // The share of pinned arena memory that was never handed out.
+  double fragmentation = 0;
+  if (pool->arena_bytes_ > 0) {
+    fragmentation = 1.0 - static_cast<double>(pool->used_bytes_) /
+                          static_cast<double>(pool->arena_bytes_);
+  }
+
+  Local<Object> info = Object::New();
+  info->Set(arenas_sym, Number::New(pool->arenas_));
+  info->Set(pinned_bytes_sym, Number::New(pool->arena_bytes_));
+  info->Set(buffers_sym, Number::New(pool->buffers_));
+  info->Set(used_bytes_sym, Number::New(pool->used_bytes_));
+  info->Set(scratch_bytes_sym, Number::New(pool->scratch_size_));
+  info->Set(fragmentation_sym, Number::New(fragmentation));
+
+  return scope.Close(info);
+}
+
+
+} // namespace node
@@ -0,0 +1,89 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SRC_BUFFER_POOL_H_
+#define SRC_BUFFER_POOL_H_
+
+#include "v8.h"
+#include "uv.h"
+
+namespace node {
+
+// Allocator for the Buffers that native code hands to JavaScript for reads
+// and datagrams. Crypto output doesn't come from here: every Buffer in an
+// arena can reach the others through `parent`.
+//
+// libuv fills a scratch area that is shared by every handle, the bytes that
+// were actually read are then copied into an arena. An arena is a single
+// SlowBuffer and every allocation is a plain Buffer that views part of it,
+// created from C++ without running the Buffer constructor. Allocations have
+// no weak handle of their own: the arena's one weak callback releases its
+// memory once the last Buffer that points into it has been collected, so
+// the GC runs one callback per arena rather than one per read. The pool only
+// keeps the arena it is currently filling alive; handles that are not
+// reading hold no memory.
+class BufferPool {
+public:
+  BufferPool();
+  ~BufferPool();
+
+  // The pool used by the stream and UDP wraps.
+  static BufferPool* Default();
+
+  // Returns scratch memory for a single read. The memory is only valid until
+  // the next call to Scratch(), callers must Take() the data before that.
+  uv_buf_t Scratch(size_t suggested_size);
+
+  // Copies `size` bytes into the current arena and returns a Buffer that
+  // views them.
+  v8::Local<v8::Object> Take(const char* data, size_t size);
+
+  // process.binding('buffer').getPoolStats()
+  static v8::Handle<v8::Value> GetStats(const v8::Arguments& args);
+
+  // Larger allocations get an arena of their own so that they don't leave
+  // the tail of a shared arena unused.
+  static const size_t kMaxShared = 32 * 1024;
+
+private:
+  static const size_t kArenaSize = 128 * 1024;
+
+  struct Arena;
+
+  Arena* NewArena(size_t size, v8::Local<v8::Object>* object);
+  static void FreeArena(char* data, void* hint);
+
+  // The SlowBuffer of the arena that small allocations are carved from.
+  v8::Persistent<v8::Object> current_;
+  Arena* arena_;
+  char* scratch_;
+  size_t scratch_size_;
+
+  // Statistics, for the arenas that are still alive.
+  size_t arenas_;
+  size_t arena_bytes_;
+  size_t buffers_;
+  size_t used_bytes_;
+};
+
+} // namespace node
+
+#endif  // SRC_BUFFER_POOL_H_
@@ -26,6 +26,7 @@
 
 #define CARES_STATICLIB
 #include "ares.h"
+#include "dns_cache.h"
 #include "node.h"
 #include "req_wrap.h"
 #include "tree.h"
@@ -47,19 +48,42 @@ namespace cares_wrap {
 using v8::Arguments;
 using v8::Array;
 using v8::Context;
+using v8::False;
 using v8::Function;
 using v8::Handle;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::Persistent;
 using v8::String;
+using v8::Undefined;
 using v8::Value;
 
 
-typedef class ReqWrap<uv_getaddrinfo_t> GetAddrInfoReqWrap;
+class GetAddrInfoReqWrap: public ReqWrap<uv_getaddrinfo_t> {
+ public:
+  GetAddrInfoReqWrap()
+      : entry_(NULL),
+        next_waiter_(NULL),
+        last_waiter_(NULL) {
+  }
+
+  // Lookups of the same key that complete together with this request.
+  void AddWaiter(GetAddrInfoReqWrap* waiter) {
+    if (last_waiter_ == NULL)
+      next_waiter_ = waiter;
+    else
+      last_waiter_->next_waiter_ = waiter;
+    last_waiter_ = waiter;
+  }
+
+  DnsCache::Entry* entry_;
+  GetAddrInfoReqWrap* next_waiter_;
+  GetAddrInfoReqWrap* last_waiter_;
+};
 
 struct ares_task_t {
   UV_HANDLE_FIELDS
@@ -74,6 +98,16 @@ static ares_channel ares_channel;
 static uv_timer_t ares_timer;
 static RB_HEAD(ares_task_list, ares_task_t) ares_tasks;
 
+// The resolver cache is off until dns.enableCache() turns it on.
+// getaddrinfo() doesn't report TTLs, so lookup_cache keeps its answers
+// for cache_ttl. query_cache keeps A and AAAA answers for their record TTL,
+// capped at cache_ttl. Both keep NXDOMAIN and NODATA for cache_negative_ttl.
+static bool cache_enabled;
+static DnsCache* lookup_cache;
+static DnsCache* query_cache;
+static uint64_t cache_ttl;
+static uint64_t cache_negative_ttl;
+
 
 static int cmp_ares_tasks(const ares_task_t* a, const ares_task_t* b) {
   if (a->sock < b->sock) return -1;
@@ -225,6 +259,47 @@ static Local<Array> HostentToNames(struct hostent* host) {
 }
 
 
+static Local<Array> CachedAddresses(DnsCache::Entry* e) {
+  HandleScope scope;
+  Local<Array> addresses = Array::New(e->count);
+
+  for (unsigned int i = 0; i < e->count; i++) {
+    addresses->Set(i, String::New(e->addresses[i]));
+  }
+
+  return scope.Close(addresses);
+}
+
+
+static void CacheAddresses(DnsCache* cache,
+                           DnsCache::Entry* e,
+                           Handle<Array> addresses,
+                           uint64_t ttl) {
+  HandleScope scope;
+  unsigned int n = addresses->Length();
+
+  char* buf = static_cast<char*>(calloc(n, INET6_ADDRSTRLEN));
+  const char** list = static_cast<const char**>(malloc(n * sizeof(*list)));
+  if (n > 0 && (buf == NULL || list == NULL)) {
+    free(buf);
+    free(list);
+    cache->Remove(e);
+    return;
+  }
+
+  for (unsigned int i = 0; i < n; i++) {
+    char* ip = buf + i * INET6_ADDRSTRLEN;
+    addresses->Get(i)->ToString()->WriteAscii(ip, 0, INET6_ADDRSTRLEN - 1);
+    list[i] = ip;
+  }
+
+  cache->Store(e, 0, list, n, ttl, uv_now(uv_default_loop()));
+
+  free(buf);
+  free(list);
+}
+
+
 static const char* AresErrnoString(int errorno) {
   switch (errorno) {
 #define ERRNO_CASE(e) case ARES_##e: return #e;
@@ -271,7 +346,10 @@ static void SetAresErrno(int errorno) {
 
 class QueryWrap {
  public:
-  QueryWrap() {
+  QueryWrap()
+      : entry_(NULL),
+        next_waiter_(NULL),
+        last_waiter_(NULL) {
     HandleScope scope;
 
     object_ = Persistent<Object>::New(Object::New());
@@ -280,6 +358,9 @@ class QueryWrap {
   virtual ~QueryWrap() {
     assert(!object_.IsEmpty());
 
+    if (entry_ != NULL)
+      query_cache->Remove(entry_);
+
     object_->Delete(oncomplete_sym);
 
     object_.Dispose();
@@ -306,7 +387,66 @@ class QueryWrap {
     return 0;
   }
 
+  // Answers the query from the resolver cache, or has it wait for an
+  // identical query already in flight. Returns false if the query still
+  // needs to be sent. On true the wrap has been consumed.
+  bool FromCache(const char* name) {
+    int family = CacheFamily();
+    if (!cache_enabled || family == 0)
+      return false;
+
+    uint64_t now = uv_now(uv_default_loop());
+    DnsCache::Entry* e = query_cache->Find(name, family, now);
+
+    if (e == NULL) {
+      entry_ = query_cache->Begin(name, family, this);
+      return false;
+    }
+
+    if (e->pending != NULL) {
+      QueryWrap* owner = static_cast<QueryWrap*>(e->pending);
+      if (owner->last_waiter_ == NULL)
+        owner->next_waiter_ = this;
+      else
+        owner->last_waiter_->next_waiter_ = this;
+      owner->last_waiter_ = this;
+      return true;
+    }
+
+    if (e->status != ARES_SUCCESS) {
+      ParseError(e->status);
+    } else {
+      HandleScope scope;
+      CallOnComplete(CachedAddresses(e));
+    }
+
+    delete this;
+    return true;
+  }
+
  protected:
+  // Queries with a cacheable answer return the address family they resolve.
+  virtual int CacheFamily() {
+    return 0;
+  }
+
+  // Resolves the wrap's cache entry with the answer; ttl is in seconds.
+  void CacheAnswer(Handle<Array> addresses, int ttl) {
+    if (entry_ == NULL)
+      return;
+
+    uint64_t ms = static_cast<uint64_t>(ttl > 0 ? ttl : 0) * 1000;
+    if (ms > cache_ttl)
+      ms = cache_ttl;
+
+    if (cache_enabled)
+      CacheAddresses(query_cache, entry_, addresses, ms);
+    else
+      query_cache->Remove(entry_);
+
+    entry_ = NULL;
+  }
+
   void* GetQueryArg() {
     return static_cast<void*>(this);
   }
@@ -315,13 +455,19 @@ class QueryWrap {
       unsigned char* answer_buf, int answer_len) {
     QueryWrap* wrap = static_cast<QueryWrap*>(arg);
 
-    if (status != ARES_SUCCESS) {
-      wrap->ParseError(status);
-    } else {
-      wrap->Parse(answer_buf, answer_len);
-    }
+    // Queries that were coalesced into this one get the same answer.
+    while (wrap != NULL) {
+      QueryWrap* next = wrap->next_waiter_;
 
-    delete wrap;
+      if (status != ARES_SUCCESS) {
+        wrap->ParseError(status);
+      } else {
+        wrap->Parse(answer_buf, answer_len);
+      }
+
+      delete wrap;
+      wrap = next;
+    }
   }
 
   static void Callback(void *arg, int status, int timeouts,
@@ -351,6 +497,22 @@ class QueryWrap {
 
   void ParseError(int status) {
     assert(status != ARES_SUCCESS);
+
+    if (entry_ != NULL) {
+      if (cache_enabled &&
+          (status == ARES_ENOTFOUND || status == ARES_ENODATA)) {
+        query_cache->Store(entry_,
+                           status,
+                           NULL,
+                           0,
+                           cache_negative_ttl,
+                           uv_now(uv_default_loop()));
+      } else {
+        query_cache->Remove(entry_);
+      }
+      entry_ = NULL;
+    }
+
     SetAresErrno(status);
 
     HandleScope scope;
@@ -369,9 +531,24 @@ class QueryWrap {
 
  private:
   Persistent<Object> object_;
+  DnsCache::Entry* entry_;
+  QueryWrap* next_waiter_;
+  QueryWrap* last_waiter_;
 };
 
 
+// Lowest TTL of an A or AAAA answer.
+template <typename T>
+static int MinTtl(const T* addrttls, int naddrttls) {
+  int ttl = 0;
+  for (int i = 0; i < naddrttls; i++) {
+    if (i == 0 || addrttls[i].ttl < ttl)
+      ttl = addrttls[i].ttl;
+  }
+  return ttl;
+}
+
+
 class QueryAWrap: public QueryWrap {
  public:
   int Send(const char* name) {
@@ -384,8 +561,10 @@ class QueryAWrap: public QueryWrap {
     HandleScope scope;
 
     struct hostent* host;
+    struct ares_addrttl addrttls[256];
+    int naddrttls = ARRAY_SIZE(addrttls);
 
-    int status = ares_parse_a_reply(buf, len, &host, NULL, NULL);
+    int status = ares_parse_a_reply(buf, len, &host, addrttls, &naddrttls);
     if (status != ARES_SUCCESS) {
       this->ParseError(status);
       return;
@@ -394,8 +573,13 @@ class QueryAWrap: public QueryWrap {
     Local<Array> addresses = HostentToAddresses(host);
     ares_free_hostent(host);
 
+    this->CacheAnswer(addresses, MinTtl(addrttls, naddrttls));
     this->CallOnComplete(addresses);
   }
+
+  int CacheFamily() {
+    return 4;
+  }
 };
 
 
@@ -416,8 +600,10 @@ class QueryAaaaWrap: public QueryWrap {
     HandleScope scope;
 
     struct hostent* host;
+    struct ares_addr6ttl addrttls[256];
+    int naddrttls = ARRAY_SIZE(addrttls);
 
-    int status = ares_parse_aaaa_reply(buf, len, &host, NULL, NULL);
+    int status = ares_parse_aaaa_reply(buf, len, &host, addrttls, &naddrttls);
     if (status != ARES_SUCCESS) {
       this->ParseError(status);
       return;
@@ -426,8 +612,13 @@ class QueryAaaaWrap: public QueryWrap {
     Local<Array> addresses = HostentToAddresses(host);
     ares_free_hostent(host);
 
+    this->CacheAnswer(addresses, MinTtl(addrttls, naddrttls));
     this->CallOnComplete(addresses);
   }
+
+  int CacheFamily() {
+    return 6;
+  }
 };
 
 
@@ -743,6 +934,9 @@ static Handle<Value> Query(const Arguments& args) {
 
   node::Utf8Value name(args[0]);
 
+  if (wrap->FromCache(*name))
+    return scope.Close(object);
+
   int r = wrap->Send(*name);
   if (r) {
     SetAresErrno(r);
@@ -788,12 +982,13 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
   HandleScope scope;
 
   GetAddrInfoReqWrap* req_wrap = (GetAddrInfoReqWrap*) req->data;
+  uv_err_t err = uv_last_error(uv_default_loop());
 
   Local<Value> argv[1];
 
   if (status) {
     // Error
-    SetErrno(uv_last_error(uv_default_loop()));
+    SetErrno(err);
     argv[0] = Local<Value>::New(Null());
   } else {
     // Success
@@ -872,9 +1067,40 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
 
   uv_freeaddrinfo(res);
 
+  if (req_wrap->entry_ != NULL) {
+    if (!cache_enabled) {
+      lookup_cache->Remove(req_wrap->entry_);
+    } else if (status == 0) {
+      CacheAddresses(lookup_cache,
+                     req_wrap->entry_,
+                     argv[0].As<Array>(),
+                     cache_ttl);
+    } else if (err.code == UV_ENOENT) {
+      lookup_cache->Store(req_wrap->entry_,
+                          err.code,
+                          NULL,
+                          0,
+                          cache_negative_ttl,
+                          uv_now(uv_default_loop()));
+    } else {
+      lookup_cache->Remove(req_wrap->entry_);
+    }
+  }
+
   // Make the callback into JavaScript
   MakeCallback(req_wrap->object_, oncomplete_sym, ARRAY_SIZE(argv), argv);
 
+  // Lookups that were coalesced into this one get the same answer.
+  GetAddrInfoReqWrap* waiter = req_wrap->next_waiter_;
+  while (waiter != NULL) {
+    GetAddrInfoReqWrap* next = waiter->next_waiter_;
+    if (status)
+      SetErrno(err);
+    MakeCallback(waiter->object_, oncomplete_sym, ARRAY_SIZE(argv), argv);
+    delete waiter;
+    waiter = next;
+  }
+
   delete req_wrap;
 }
 
@@ -915,6 +1141,31 @@ static Handle<Value> GetAddrInfo(const Arguments& args) {
     }
   }
 
+  if (cache_enabled) {
+    uint64_t now = uv_now(uv_default_loop());
+    DnsCache::Entry* e = lookup_cache->Find(*hostname, fam, now);
+
+    if (e != NULL && e->pending != NULL) {
+      GetAddrInfoReqWrap* owner = static_cast<GetAddrInfoReqWrap*>(e->pending);
+      GetAddrInfoReqWrap* waiter = new GetAddrInfoReqWrap();
+      waiter->Dispatched();
+      owner->AddWaiter(waiter);
+      return scope.Close(waiter->object_);
+    }
+
+    // Cached answers are returned directly: the addresses, or false with
+    // process._errno set.
+    if (e != NULL && e->status != 0) {
+      uv_err_t err;
+      err.code = static_cast<uv_err_code>(e->status);
+      SetErrno(err);
+      return scope.Close(False());
+    }
+
+    if (e != NULL)
+      return scope.Close(CachedAddresses(e));
+  }
+
   GetAddrInfoReqWrap* req_wrap = new GetAddrInfoReqWrap();
 
   struct addrinfo hints;
@@ -934,9 +1185,89 @@ static Handle<Value> GetAddrInfo(const Arguments& args) {
     SetErrno(uv_last_error(uv_default_loop()));
     delete req_wrap;
     return scope.Close(v8::Null());
+  }
+
+  if (cache_enabled)
+    req_wrap->entry_ = lookup_cache->Begin(*hostname, fam, req_wrap);
+
+  return scope.Close(req_wrap->object_);
+}
+
+
+static void SetCacheStats(Handle<Object> object, DnsCache* cache) {
+  DnsCache::Stats stats;
+  cache->GetStats(&stats);
+
+#define V(name, value)                                                        \
+  object->Set(String::NewSymbol(name),                                        \
+              Number::New(static_cast<double>(value)));
+  V("capacity", stats.capacity)
+  V("entries", stats.entries)
+  V("hits", stats.hits)
+  V("negativeHits", stats.negative_hits)
+  V("misses", stats.misses)
+  V("coalesced", stats.coalesced)
+  V("stores", stats.stores)
+  V("evictions", stats.evictions)
+  V("expirations", stats.expirations)
+#undef V
+}
+
+
+// configureCache(enabled, maxEntries, ttl, negativeTtl)
+static Handle<Value> ConfigureCache(const Arguments& args) {
+  HandleScope scope;
+
+  unsigned int max_entries = args[1]->Uint32Value();
+
+  if (lookup_cache == NULL) {
+    lookup_cache = new DnsCache(max_entries);
+    query_cache = new DnsCache(max_entries);
   } else {
-    return scope.Close(req_wrap->object_);
+    lookup_cache->SetCapacity(max_entries);
+    query_cache->SetCapacity(max_entries);
+  }
+
+  cache_enabled = args[0]->BooleanValue();
+  cache_ttl = static_cast<uint64_t>(args[2]->IntegerValue());
+  cache_negative_ttl = static_cast<uint64_t>(args[3]->IntegerValue());
+
+  if (!cache_enabled) {
+    lookup_cache->Clear();
+    query_cache->Clear();
+  }
+
+  return Undefined();
+}
+
+
+static Handle<Value> ClearCache(const Arguments& args) {
+  HandleScope scope;
+
+  if (lookup_cache != NULL) {
+    lookup_cache->Clear();
+    query_cache->Clear();
   }
+
+  return Undefined();
+}
+
+
+static Handle<Value> GetCacheStats(const Arguments& args) {
+  HandleScope scope;
+
+  if (lookup_cache == NULL)
+    return scope.Close(v8::Null());
+
+  Local<Object> lookup = Object::New();
+  Local<Object> query = Object::New();
+  SetCacheStats(lookup, lookup_cache);
+  SetCacheStats(query, query_cache);
+
+  Local<Object> stats = Object::New();
+  stats->Set(String::NewSymbol("lookup"), lookup);
+  stats->Set(String::NewSymbol("resolve"), query);
+  return scope.Close(stats);
 }
 
 
@@ -977,6 +1308,10 @@ static void Initialize(Handle<Object> target) {
   NODE_SET_METHOD(target, "getaddrinfo", GetAddrInfo);
   NODE_SET_METHOD(target, "isIP", IsIP);
 
+  NODE_SET_METHOD(target, "configureCache", ConfigureCache);
+  NODE_SET_METHOD(target, "clearCache", ClearCache);
+  NODE_SET_METHOD(target, "getCacheStats", GetCacheStats);
+
   target->Set(String::NewSymbol("AF_INET"),
               Integer::New(AF_INET));
   target->Set(String::NewSymbol("AF_INET6"),
@@ -0,0 +1,303 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "dns_cache.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace node {
+
+
+static inline char Lower(char c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+
+// Host names compare case-insensitively.
+static bool NameEquals(const char* a, const char* b) {
+  while (*a != '\0' && Lower(*a) == Lower(*b)) {
+    a++;
+    b++;
+  }
+  return *a == *b;
+}
+
+
+uint32_t DnsCache::Hash(const char* name, int family) {
+  // FNV-1a over the lowercased name and the family.
+  uint32_t hash = 2166136261u;
+  for (const char* p = name; *p != '\0'; p++) {
+    hash ^= static_cast<unsigned char>(Lower(*p));
+    hash *= 16777619u;
+  }
+  hash ^= static_cast<uint32_t>(family);
+  hash *= 16777619u;
+  return hash;
+}
+
+
+DnsCache::DnsCache(unsigned int capacity)
+    : buckets_(NULL),
+      bucket_count_(0),
+      capacity_(capacity),
+      entries_(0),
+      lru_head_(NULL),
+      lru_tail_(NULL) {
+  memset(&stats_, 0, sizeof(stats_));
+  Rehash(16);
+  assert(buckets_ != NULL);
+}
+
+
+DnsCache::~DnsCache() {
+  while (lru_head_ != NULL)
+    Destroy(lru_head_);
+  free(buckets_);
+}
+
+
+void DnsCache::Rehash(unsigned int bucket_count) {
+  Entry** buckets =
+      static_cast<Entry**>(calloc(bucket_count, sizeof(*buckets)));
+  if (buckets == NULL)
+    return;  // Keep the old table, chains just get longer.
+
+  for (unsigned int i = 0; i < bucket_count_; i++) {
+    Entry* e = buckets_[i];
+    while (e != NULL) {
+      Entry* next = e->hash_next;
+      Entry** head = &buckets[e->hash & (bucket_count - 1)];
+      e->hash_next = *head;
+      *head = e;
+      e = next;
+    }
+  }
+
+  free(buckets_);
+  buckets_ = buckets;
+  bucket_count_ = bucket_count;
+}
+
+
+void DnsCache::LRUUnlink(Entry* e) {
+  if (e->lru_prev != NULL)
+    e->lru_prev->lru_next = e->lru_next;
+  else
+    lru_head_ = e->lru_next;
+
+  if (e->lru_next != NULL)
+    e->lru_next->lru_prev = e->lru_prev;
+  else
+    lru_tail_ = e->lru_prev;
+}
+
+
+void DnsCache::LRUPushFront(Entry* e) {
+  e->lru_prev = NULL;
+  e->lru_next = lru_head_;
+  if (lru_head_ != NULL)
+    lru_head_->lru_prev = e;
+  else
+    lru_tail_ = e;
+  lru_head_ = e;
+}
+
+
+void DnsCache::Unlink(Entry* e) {
+  Entry** p = &buckets_[e->hash & (bucket_count_ - 1)];
+  while (*p != e) {
+    assert(*p != NULL);
+    p = &(*p)->hash_next;
+  }
+  *p = e->hash_next;
+}
+
+
+void DnsCache::Destroy(Entry* e) {
+  Unlink(e);
+  LRUUnlink(e);
+  free(e->addresses);
+  free(e);
+  entries_--;
+}
+
+
+bool DnsCache::EvictOne() {
+  for (Entry* e = lru_tail_; e != NULL; e = e->lru_prev) {
+    if (e->pending == NULL) {
+      Destroy(e);
+      stats_.evictions++;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+DnsCache::Entry* DnsCache::Find(const char* name, int family, uint64_t now) {
+  uint32_t hash = Hash(name, family);
+  Entry* e = buckets_[hash & (bucket_count_ - 1)];
+
+  while (e != NULL) {
+    if (e->hash == hash && e->family == family && NameEquals(e->name, name))
+      break;
+    e = e->hash_next;
+  }
+
+  if (e == NULL) {
+    stats_.misses++;
+    return NULL;
+  }
+
+  if (e->pending != NULL) {
+    stats_.coalesced++;
+    return e;
+  }
+
+  if (e->expires <= now) {
+    Destroy(e);
+    stats_.expirations++;
+    stats_.misses++;
+    return NULL;
+  }
+
+  LRUUnlink(e);
+  LRUPushFront(e);
+
+  if (e->status == 0)
+    stats_.hits++;
+  else
+    stats_.negative_hits++;
+
+  return e;
+}
+
+
+DnsCache::Entry* DnsCache::Begin(const char* name, int family, void* pending) {
+  assert(pending != NULL);
+
+  if (entries_ >= capacity_ && !EvictOne())
+    return NULL;
+
+  size_t len = strlen(name);
+  Entry* e = static_cast<Entry*>(malloc(sizeof(*e) + len));
+  if (e == NULL)
+    return NULL;
+
+  e->pending = pending;
+  e->status = 0;
+  e->count = 0;
+  e->addresses = NULL;
+  e->expires = 0;
+  e->hash = Hash(name, family);
+  e->family = family;
+  memcpy(e->name, name, len + 1);
+
+  if (entries_ >= bucket_count_)
+    Rehash(bucket_count_ * 2);
+
+  Entry** head = &buckets_[e->hash & (bucket_count_ - 1)];
+  e->hash_next = *head;
+  *head = e;
+  LRUPushFront(e);
+  entries_++;
+
+  return e;
+}
+
+
+void DnsCache::Store(Entry* e,
+                     int status,
+                     const char* const* addresses,
+                     unsigned int count,
+                     uint64_t ttl,
+                     uint64_t now) {
+  assert(e->pending != NULL);
+
+  if (ttl == 0) {
+    Destroy(e);
+    return;
+  }
+
+  // The pointer array and the strings share one allocation.
+  size_t size = count * sizeof(char*);
+  for (unsigned int i = 0; i < count; i++)
+    size += strlen(addresses[i]) + 1;
+
+  char** block = NULL;
+  if (count > 0) {
+    block = static_cast<char**>(malloc(size));
+    if (block == NULL) {
+      Destroy(e);
+      return;
+    }
+
+    char* p = reinterpret_cast<char*>(block + count);
+    for (unsigned int i = 0; i < count; i++) {
+      size_t len = strlen(addresses[i]) + 1;
+      memcpy(p, addresses[i], len);
+      block[i] = p;
+      p += len;
+    }
+  }
+
+  e->pending = NULL;
+  e->status = status;
+  e->count = count;
+  e->addresses = block;
+  e->expires = now + ttl;
+  stats_.stores++;
+}
+
+
+void DnsCache::Remove(Entry* e) {
+  Destroy(e);
+}
+
+
+void DnsCache::Clear() {
+  Entry* e = lru_head_;
+  while (e != NULL) {
+    Entry* next = e->lru_next;
+    if (e->pending == NULL)
+      Destroy(e);
+    e = next;
+  }
+}
+
+
+void DnsCache::SetCapacity(unsigned int capacity) {
+  capacity_ = capacity;
+  while (entries_ > capacity_ && EvictOne());
+}
+
+
+void DnsCache::GetStats(Stats* stats) {
+  *stats = stats_;
+  stats->capacity = capacity_;
+  stats->entries = entries_;
+}
+
+
+}  // namespace node
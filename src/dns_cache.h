@@ -0,0 +1,125 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SRC_DNS_CACHE_H_
+#define SRC_DNS_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+
+// Size-bounded cache of resolver answers keyed by (name, family).
+//
+// An entry is either pending, meaning a request for the key is in flight and
+// later lookups should wait for it instead of issuing their own, or resolved,
+// in which case it holds a list of addresses or, for a negative entry, the
+// resolver's error code. Resolved entries expire after the TTL given to
+// Store(); pending entries never expire and are never evicted, their owner
+// must Store() or Remove() them.
+//
+// All times are in milliseconds on the caller's clock, normally uv_now().
+class DnsCache {
+ public:
+  struct Entry {
+    // Non-NULL while the entry is pending: the owner's request.
+    void* pending;
+    // 0 for a positive entry, the resolver's error code otherwise.
+    int status;
+    unsigned int count;
+    char** addresses;
+
+   private:
+    friend class DnsCache;
+    Entry* hash_next;
+    Entry* lru_prev;
+    Entry* lru_next;
+    uint64_t expires;
+    uint32_t hash;
+    int family;
+    char name[1];
+  };
+
+  struct Stats {
+    unsigned int capacity;
+    unsigned int entries;
+    uint64_t hits;
+    uint64_t negative_hits;
+    uint64_t misses;
+    uint64_t coalesced;
+    uint64_t stores;
+    uint64_t evictions;
+    uint64_t expirations;
+  };
+
+  explicit DnsCache(unsigned int capacity);
+  ~DnsCache();
+
+  // Returns the pending or live entry for the key, or NULL on a miss.
+  // Expired entries are dropped on the way.
+  Entry* Find(const char* name, int family, uint64_t now);
+
+  // Adds a pending entry for a key that Find() missed. Returns NULL when the
+  // cache is full of pending entries; the request then goes uncached.
+  Entry* Begin(const char* name, int family, void* pending);
+
+  // Resolves a pending entry. The addresses are copied. A zero TTL removes
+  // the entry instead, it is not worth keeping.
+  void Store(Entry* e,
+             int status,
+             const char* const* addresses,
+             unsigned int count,
+             uint64_t ttl,
+             uint64_t now);
+
+  void Remove(Entry* e);
+
+  // Drops all resolved entries. Pending entries stay with their owners.
+  void Clear();
+
+  // Evicts least recently used entries down to the new capacity.
+  void SetCapacity(unsigned int capacity);
+
+  void GetStats(Stats* stats);
+
+ private:
+  static uint32_t Hash(const char* name, int family);
+
+  void Rehash(unsigned int bucket_count);
+  void Unlink(Entry* e);
+  void Destroy(Entry* e);
+  void LRUUnlink(Entry* e);
+  void LRUPushFront(Entry* e);
+  bool EvictOne();
+
+  Entry** buckets_;
+  unsigned int bucket_count_;
+  unsigned int capacity_;
+  unsigned int entries_;
+  Entry* lru_head_;
+  Entry* lru_tail_;
+  Stats stats_;
+};
+
+}  // namespace node
+
+#endif  // SRC_DNS_CACHE_H_
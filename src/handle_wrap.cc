@@ -144,6 +144,8 @@ void HandleWrap::OnClose(uv_handle_t* handle) {
   // But the handle pointer should be gone.
   assert(wrap->handle__ == NULL);
 
+  wrap->AfterClose();
+
   if (wrap->flags_ & kCloseCallback) {
     assert(close_sym.IsEmpty() == false);
     MakeCallback(wrap->object_, close_sym, 0, NULL);
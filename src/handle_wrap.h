@@ -67,6 +67,10 @@ class HandleWrap {
 
     virtual void SetHandle(uv_handle_t* h);
 
+    // Called once the handle is closed, before the close callback runs and
+    // the wrap is deleted. libuv has cancelled its own requests by then.
+    virtual void AfterClose() { }
+
     v8::Persistent<v8::Object> object_;
 
   private:
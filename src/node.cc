@@ -71,6 +71,7 @@ typedef int mode_t;
 #include "node_http_parser.h"
 #include "node_constants.h"
 #include "node_javascript.h"
+#include "node_loop_metrics.h"
 #include "node_version.h"
 #include "node_string.h"
 #if HAVE_OPENSSL
@@ -954,6 +955,8 @@ MakeDomainCallback(const Handle<Object> object,
                    Handle<Value> argv[]) {
   // TODO Hook for long stack traces to be made here.
 
+  LoopMetricsScope metrics_scope;
+
   // lazy load domain specific symbols
   if (enter_symbol.IsEmpty()) {
     enter_symbol = NODE_PSYMBOL("enter");
@@ -1032,6 +1035,8 @@ MakeCallback(const Handle<Object> object,
   if (using_domains)
     return MakeDomainCallback(object, callback, argc, argv);
 
+  LoopMetricsScope metrics_scope;
+
   // lazy load no domain next tick callbacks
   if (process_tickCallback.IsEmpty()) {
     Local<Value> cb_v = process->Get(String::New("_tickCallback"));
@@ -1776,6 +1781,51 @@ v8::Handle<v8::Value> MemoryUsage(const v8::Arguments& args) {
 }
 
 
+Handle<Value> ThreadpoolUsage(const Arguments& args) {
+  HandleScope scope;
+
+  static const char* const lane_names[UV_WORK_LANE_MAX] = {
+    "fs",   // UV_WORK_FS
+    "dns",  // UV_WORK_DNS
+    "cpu"   // UV_WORK_CPU
+  };
+
+  Local<Object> info = Object::New();
+
+  for (int i = 0; i < UV_WORK_LANE_MAX; i++) {
+    uv_threadpool_stats_t stats;
+
+    // Not implemented on Windows, the system thread pool has no lanes.
+    if (uv_threadpool_stats(static_cast<uv_work_lane_t>(i), &stats))
+      continue;
+
+    Local<Object> lane = Object::New();
+    lane->Set(String::NewSymbol("threads"),
+              Integer::NewFromUnsigned(stats.threads));
+    lane->Set(String::NewSymbol("idle"),
+              Integer::NewFromUnsigned(stats.idle));
+    lane->Set(String::NewSymbol("minThreads"),
+              Integer::NewFromUnsigned(stats.min_threads));
+    lane->Set(String::NewSymbol("maxThreads"),
+              Integer::NewFromUnsigned(stats.max_threads));
+    lane->Set(String::NewSymbol("queued"),
+              Integer::NewFromUnsigned(stats.queued));
+    lane->Set(String::NewSymbol("submitted"),
+              Number::New(static_cast<double>(stats.submitted)));
+    lane->Set(String::NewSymbol("completed"),
+              Number::New(static_cast<double>(stats.completed)));
+    // Wait times are reported in milliseconds.
+    lane->Set(String::NewSymbol("waitTime"),
+              Number::New(static_cast<double>(stats.wait_time) / 1e6));
+    lane->Set(String::NewSymbol("maxWaitTime"),
+              Number::New(static_cast<double>(stats.max_wait_time) / 1e6));
+    info->Set(String::NewSymbol(lane_names[i]), lane);
+  }
+
+  return scope.Close(info);
+}
+
+
 Handle<Value> Kill(const Arguments& args) {
   HandleScope scope;
 
@@ -2439,6 +2489,7 @@ Handle<Object> SetupProcessObject(int argc, char *argv[]) {
 
   NODE_SET_METHOD(process, "uptime", Uptime);
   NODE_SET_METHOD(process, "memoryUsage", MemoryUsage);
+  NODE_SET_METHOD(process, "threadpoolUsage", ThreadpoolUsage);
 
   NODE_SET_METHOD(process, "binding", Binding);
 
@@ -2465,11 +2516,17 @@ Handle<Object> SetupProcessObject(int argc, char *argv[]) {
 
 static void AtExit() {
   uv_tty_reset_mode();
+#if defined HAVE_PERFCTR && !defined _WIN32
+  TermPerfCounters(Handle<Object>());
+#endif
 }
 
 
 static void SignalExit(int signal) {
   uv_tty_reset_mode();
+#if defined HAVE_PERFCTR && !defined _WIN32
+  TermPerfCounters(Handle<Object>());
+#endif
   _exit(128 + signal);
 }
 
@@ -2487,8 +2544,10 @@ void Load(Handle<Object> process_l) {
 
   TryCatch try_catch;
 
-  Local<Value> f_value = ExecuteString(MainSource(),
-                                       IMMUTABLE_STRING("node.js"));
+  // A build with the core library in the snapshot has it compiled already.
+  Local<Value> f_value = SnapshotFunction("node");
+  if (f_value.IsEmpty())
+    f_value = ExecuteString(MainSource(), IMMUTABLE_STRING("node.js"));
   if (try_catch.HasCaught())  {
     ReportException(try_catch, true);
     exit(10);
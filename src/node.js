@@ -52,6 +52,7 @@
     startup.processStdio();
     startup.processKillAndExit();
     startup.processSignalHandlers();
+    startup.processLoopMetrics();
 
     startup.processChannel();
 
@@ -818,6 +819,98 @@
   };
 
 
+  startup.processLoopMetrics = function() {
+    // uv_loop_configure(UV_LOOP_METRICS) is UNIX only.
+    if (process.platform === 'win32') return;
+
+    var binding;
+
+    function getBinding() {
+      if (!binding) binding = process.binding('loop_metrics');
+      return binding;
+    }
+
+    // The smallest value that goes into bucket `i`, the inverse of
+    // BucketIndex() in src/node_loop_metrics.cc.
+    function bucketValue(i, subBits) {
+      var subBuckets = 1 << subBits;
+      if (i < subBuckets) return i;
+      var exponent = Math.floor(i / subBuckets) + subBits - 1;
+      return (subBuckets + i % subBuckets) * Math.pow(2, exponent - subBits);
+    }
+
+    var percentiles = [50, 90, 99, 99.9];
+    var percentileNames = ['p50', 'p90', 'p99', 'p999'];
+
+    function summarize(snapshot, offset, subBits, scale) {
+      var count = snapshot[offset];
+      var min = snapshot[offset + 2];
+      var max = snapshot[offset + 3];
+      var result = {
+        count: count,
+        min: min * scale,
+        max: max * scale,
+        mean: count === 0 ? 0 : snapshot[offset + 1] / count * scale
+      };
+
+      // Report the highest value of the bucket that the percentile falls in,
+      // like HdrHistogram does.
+      var seen = 0;
+      var p = 0;
+      var end = offset + getBinding().histogramSize;
+      for (var i = offset + 4; i < end && p < percentiles.length; i++) {
+        seen += snapshot[i];
+        while (p < percentiles.length &&
+               count !== 0 &&
+               seen >= Math.ceil(count * percentiles[p] / 100)) {
+          var value = bucketValue(i - offset - 4 + 1, subBits) - 1;
+          result[percentileNames[p++]] = Math.min(Math.max(value, min), max) *
+                                         scale;
+        }
+      }
+      while (p < percentiles.length)
+        result[percentileNames[p++]] = 0;
+
+      return result;
+    }
+
+    process.loopMetrics = {
+      start: function() {
+        return getBinding().start();
+      },
+
+      stop: function() {
+        getBinding().stop();
+      },
+
+      reset: function() {
+        getBinding().reset();
+      },
+
+      snapshot: function(target) {
+        var b = getBinding();
+        if (target === undefined)
+          target = new Float64Array(b.histograms.length * b.histogramSize);
+        return b.snapshot(target);
+      },
+
+      summary: function(snapshot) {
+        var b = getBinding();
+        if (snapshot === undefined)
+          snapshot = this.snapshot();
+
+        var result = {};
+        b.histograms.forEach(function(name, i) {
+          // Durations are in nanoseconds, report them in milliseconds.
+          var scale = name === 'events' || name === 'callbacks' ? 1 : 1e-6;
+          result[name] = summarize(snapshot, i * b.histogramSize, b.subBits,
+                                   scale);
+        });
+        return result;
+      }
+    };
+  };
+
   startup.processChannel = function() {
     // If we were spawned with env NODE_CHANNEL_FD then load that up and
     // start parsing data from that stream.
@@ -825,8 +918,12 @@
       var fd = parseInt(process.env.NODE_CHANNEL_FD, 10);
       assert(fd >= 0);
 
+      // 'json' unless the parent asked for something else.
+      var serialization = process.env.NODE_CHANNEL_SERIALIZATION;
+
       // Make sure it's not accidentally inherited by child processes.
       delete process.env.NODE_CHANNEL_FD;
+      delete process.env.NODE_CHANNEL_SERIALIZATION;
 
       var cp = NativeModule.require('child_process');
 
@@ -835,7 +932,7 @@
       // FIXME is this really necessary?
       process.binding('tcp_wrap');
 
-      cp._forkChild(fd);
+      cp._forkChild(fd, serialization);
       assert(process.send);
     }
   }
@@ -873,6 +970,11 @@
   NativeModule._source = process.binding('natives');
   NativeModule._cache = {};
 
+  // Wrapper functions compiled into the V8 snapshot, see --with-core-snapshot
+  // in configure.
+  NativeModule._snapshot = global.__nodeCore || {};
+  delete global.__nodeCore;
+
   NativeModule.require = function(id) {
     if (id == 'native_module') {
       return NativeModule;
@@ -919,10 +1021,14 @@
   ];
 
   NativeModule.prototype.compile = function() {
-    var source = NativeModule.getSource(this.id);
-    source = NativeModule.wrap(source);
+    var fn = NativeModule._snapshot[this.id];
+
+    if (!fn) {
+      var source = NativeModule.getSource(this.id);
+      source = NativeModule.wrap(source);
+      fn = runInThisContext(source, this.filename, true);
+    }
 
-    var fn = runInThisContext(source, this.filename, true);
     fn(this.exports, NativeModule.require, this, this.filename);
 
     this.loaded = true;
@@ -22,6 +22,7 @@
 
 #include "node_buffer.h"
 
+#include "buffer_pool.h"
 #include "node.h"
 #include "string_bytes.h"
 
@@ -64,7 +65,10 @@ using namespace v8;
 static Persistent<String> length_symbol;
 static Persistent<String> chars_written_sym;
 static Persistent<String> write_sym;
+static Persistent<String> parent_sym;
+static Persistent<String> offset_sym;
 static Persistent<Function> fast_buffer_constructor;
+static Persistent<Object> fast_buffer_boilerplate;
 Persistent<FunctionTemplate> Buffer::constructor_template;
 
 
@@ -122,6 +126,41 @@ Buffer* Buffer::New(char *data, size_t length,
 }
 
 
+Local<Object> Buffer::Slice(Handle<Object> parent,
+                            size_t offset,
+                            size_t length) {
+  HandleScope scope;
+
+  Buffer* buffer = ObjectWrap::Unwrap<Buffer>(parent);
+  assert(IsWithinBounds(offset, length, buffer->length_));
+
+  if (fast_buffer_boilerplate.IsEmpty()) {
+    // lib/buffer.js registers the constructor before anything can read.
+    assert(!fast_buffer_constructor.IsEmpty());
+    Local<Value> argv[3] = {
+      Local<Value>::New(parent),
+      Integer::New(0),
+      Integer::New(0)
+    };
+    Local<Object> obj = fast_buffer_constructor->NewInstance(3, argv);
+    obj->Set(parent_sym, Null());
+    fast_buffer_boilerplate = Persistent<Object>::New(obj);
+  }
+
+  // The clone shares the boilerplate's map, setting its fields and external
+  // data doesn't change it.
+  Local<Object> obj = fast_buffer_boilerplate->Clone();
+  obj->SetIndexedPropertiesToExternalArrayData(buffer->data_ + offset,
+                                               kExternalUnsignedByteArray,
+                                               length);
+  obj->Set(length_symbol, Integer::NewFromUnsigned(length));
+  obj->Set(parent_sym, parent);
+  obj->Set(offset_sym, Integer::NewFromUnsigned(offset));
+
+  return scope.Close(obj);
+}
+
+
 Handle<Value> Buffer::New(const Arguments& args) {
   if (!args.IsConstructCall()) {
     return FromConstructorTemplate(constructor_template, args);
@@ -638,6 +677,8 @@ void Buffer::Initialize(Handle<Object> target) {
 
   length_symbol = NODE_PSYMBOL("length");
   chars_written_sym = NODE_PSYMBOL("_charsWritten");
+  parent_sym = NODE_PSYMBOL("parent");
+  offset_sym = NODE_PSYMBOL("offset");
 
   Local<FunctionTemplate> t = FunctionTemplate::New(Buffer::New);
   constructor_template = Persistent<FunctionTemplate>::New(t);
@@ -680,6 +721,8 @@ void Buffer::Initialize(Handle<Object> target) {
   target->Set(String::NewSymbol("setFastBufferConstructor"),
               FunctionTemplate::New(SetFastBufferConstructor)->GetFunction());
 
+  NODE_SET_METHOD(target, "getPoolStats", BufferPool::GetStats);
+
   HeapProfiler::DefineWrapperClass(BUFFER_CLASS_ID, WrapperInfo);
 }
 
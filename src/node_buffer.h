@@ -125,6 +125,14 @@ class NODE_EXTERN Buffer: public ObjectWrap {
   static Buffer* New(char *data, size_t length,
                      free_callback callback, void *hint);
 
+  // Returns a JavaScript Buffer that views `length` bytes of the SlowBuffer
+  // `parent`, starting at `offset`. The Buffer is cloned from a boilerplate
+  // rather than constructed, and keeps `parent` alive through its `parent`
+  // property; it has no weak handle of its own.
+  static v8::Local<v8::Object> Slice(v8::Handle<v8::Object> parent,
+                                     size_t offset,
+                                     size_t length);
+
   private:
   static v8::Handle<v8::Value> New(const v8::Arguments &args);
 
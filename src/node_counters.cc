@@ -91,6 +91,8 @@ static void counter_gc_done(GCType type, GCCallbackFlags flags) {
     uint64_t totalperiod = endgc - counter_gc_end_time;
     uint64_t gcperiod = endgc - counter_gc_start_time;
 
+    NODE_COUNT_GC_PAUSE(gcperiod);
+
     if (totalperiod > 0) {
       unsigned int percent = static_cast<unsigned int>((gcperiod * 100) / totalperiod);
 
@@ -103,7 +105,7 @@ static void counter_gc_done(GCType type, GCCallbackFlags flags) {
 }
 
 
-#define NODE_PROBE(name) #name, name
+#define NODE_PROBE(name) #name, name, Persistent<FunctionTemplate>()
 
 void InitPerfCounters(Handle<Object> target) {
   HandleScope scope;
@@ -121,15 +123,17 @@ void InitPerfCounters(Handle<Object> target) {
     { NODE_PROBE(COUNTER_HTTP_CLIENT_RESPONSE) }
   };
 
-  for (int i = 0; i < ARRAY_SIZE(tab); i++) {
+  for (unsigned int i = 0; i < ARRAY_SIZE(tab); i++) {
     tab[i].templ = Persistent<FunctionTemplate>::New(
         FunctionTemplate::New(tab[i].func));
     target->Set(String::NewSymbol(tab[i].name), tab[i].templ->GetFunction());
   }
 
-  // Only Windows performance counters supported
-  // To enable other OS, use conditional compilation here
+#ifdef _WIN32
   InitPerfCountersWin32();
+#else
+  InitPerfCountersPosix();
+#endif
 
   // init times for GC percent calculation and hook callbacks
   counter_gc_start_time = NODE_COUNT_GET_GC_RAWTIME();
@@ -141,9 +145,11 @@ void InitPerfCounters(Handle<Object> target) {
 
 
 void TermPerfCounters(Handle<Object> target) {
-  // Only Windows performance counters supported
-  // To enable other OS, use conditional compilation here
+#ifdef _WIN32
   TermPerfCountersWin32();
+#else
+  TermPerfCountersPosix();
+#endif
 }
 
 }
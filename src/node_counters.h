@@ -33,8 +33,12 @@ void TermPerfCounters(v8::Handle<v8::Object> target);
 }
 
 #ifdef HAVE_PERFCTR
+#ifdef _WIN32
 #include "node_win32_perfctr_provider.h"
 #else
+#include "node_posix_perfctr_provider.h"
+#endif
+#else
 #define NODE_COUNTER_ENABLED() (false)
 #define NODE_COUNT_HTTP_SERVER_REQUEST()
 #define NODE_COUNT_HTTP_SERVER_RESPONSE()
@@ -46,6 +50,7 @@ void TermPerfCounters(v8::Handle<v8::Object> target);
 #define NODE_COUNT_NET_BYTES_RECV(bytes)
 #define NODE_COUNT_GET_GC_RAWTIME()
 #define NODE_COUNT_GC_PERCENTTIME()
+#define NODE_COUNT_GC_PAUSE(rawtime)
 #define NODE_COUNT_PIPE_BYTES_SENT(bytes)
 #define NODE_COUNT_PIPE_BYTES_RECV(bytes)
 #endif
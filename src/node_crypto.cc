@@ -225,11 +225,23 @@ void SecureContext::Initialize(Handle<Object> target) {
                                SecureContext::SetSessionIdContext);
   NODE_SET_PROTOTYPE_METHOD(t, "close", SecureContext::Close);
   NODE_SET_PROTOTYPE_METHOD(t, "loadPKCS12", SecureContext::LoadPKCS12);
+  NODE_SET_PROTOTYPE_METHOD(t, "setSessionCache",
+                               SecureContext::SetSessionCache);
+  NODE_SET_PROTOTYPE_METHOD(t, "openSessionCache",
+                               SecureContext::OpenSessionCache);
+  NODE_SET_PROTOTYPE_METHOD(t, "getSessionCacheStats",
+                               SecureContext::GetSessionCacheStats);
 
   target->Set(String::NewSymbol("SecureContext"), t->GetFunction());
 }
 
 
+bool SecureContext::HasInstance(Handle<Value> value) {
+  return !secure_context_constructor.IsEmpty() &&
+         secure_context_constructor->HasInstance(value);
+}
+
+
 Handle<Value> SecureContext::New(const Arguments& args) {
   HandleScope scope;
   SecureContext *p = new SecureContext();
@@ -310,6 +322,10 @@ Handle<Value> SecureContext::Init(const Arguments& args) {
                                  SSL_SESS_CACHE_NO_AUTO_CLEAR);
   SSL_CTX_sess_set_get_cb(sc->ctx_, GetSessionCallback);
   SSL_CTX_sess_set_new_cb(sc->ctx_, NewSessionCallback);
+  SSL_CTX_sess_set_remove_cb(sc->ctx_, RemoveSessionCallback);
+
+  // Lets the session callbacks find the native session cache.
+  SSL_CTX_set_app_data(sc->ctx_, sc);
 
   sc->ca_store_ = NULL;
   return True();
@@ -325,10 +341,21 @@ SSL_SESSION* SecureContext::GetSessionCallback(SSL* s,
   Connection* p = static_cast<Connection*>(SSL_get_app_data(s));
 
   *copy = 0;
-  SSL_SESSION* sess = p->next_sess_;
-  p->next_sess_ = NULL;
 
-  return sess;
+  // A session handed in from a 'resumeSession' listener wins.
+  if (p != NULL && p->next_sess_ != NULL) {
+    SSL_SESSION* sess = p->next_sess_;
+    p->next_sess_ = NULL;
+    return sess;
+  }
+
+  // The lookup happens on the context the SSL was created from, not the one
+  // an SNI callback may have switched it to.
+  SecureContext* sc = static_cast<SecureContext*>(
+      SSL_CTX_get_app_data(s->session_ctx));
+  if (sc == NULL || sc->session_cache_ == NULL) return NULL;
+
+  return sc->session_cache_->Get(key, len);
 }
 
 
@@ -342,6 +369,24 @@ int SecureContext::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
 
   Connection* p = static_cast<Connection*>(SSL_get_app_data(s));
 
+  SecureContext* sc = static_cast<SecureContext*>(
+      SSL_CTX_get_app_data(s->session_ctx));
+  bool cached = false;
+  if (sc != NULL && sc->session_cache_ != NULL) {
+    sc->session_cache_->Add(sess);
+    cached = true;
+  }
+
+  if (p == NULL) return 0;
+
+  if (onnewsession_sym.IsEmpty()) {
+    onnewsession_sym = NODE_PSYMBOL("onnewsession");
+  }
+
+  // With a native cache in place, only pay for the trip to JavaScript if
+  // somebody is listening for 'newSession'.
+  if (cached && !p->handle_->Get(onnewsession_sym)->IsFunction()) return 0;
+
   // Check if session is small enough to be stored
   int size = i2d_SSL_SESSION(sess, NULL);
   if (size > kMaxSessionSize) return 0;
@@ -358,15 +403,20 @@ int SecureContext::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
     Buffer::New(serialized, size, SessionDataFree, NULL)->handle_
   };
 
-  if (onnewsession_sym.IsEmpty()) {
-    onnewsession_sym = NODE_PSYMBOL("onnewsession");
-  }
   MakeCallback(p->handle_, onnewsession_sym, ARRAY_SIZE(argv), argv);
 
   return 0;
 }
 
 
+void SecureContext::RemoveSessionCallback(SSL_CTX* ctx, SSL_SESSION* sess) {
+  SecureContext* sc = static_cast<SecureContext*>(SSL_CTX_get_app_data(ctx));
+  if (sc == NULL || sc->session_cache_ == NULL) return;
+
+  sc->session_cache_->Remove(sess->session_id, sess->session_id_length);
+}
+
+
 // Takes a string or buffer and loads it into a BIO.
 // Caller responsible for BIO_free-ing the returned object.
 static BIO* LoadBIO (Handle<Value> v) {
@@ -719,6 +769,95 @@ Handle<Value> SecureContext::Close(const Arguments& args) {
   return False();
 }
 
+Handle<Value> SecureContext::SetSessionCache(const Arguments& args) {
+  HandleScope scope;
+
+  SecureContext *sc = ObjectWrap::Unwrap<SecureContext>(args.Holder());
+
+  if (args.Length() < 1 || !args[0]->IsUint32()) {
+    return ThrowTypeError("Bad parameter");
+  }
+
+  delete sc->session_cache_;
+  sc->session_cache_ = NULL;
+
+  uint32_t capacity = args[0]->Uint32Value();
+  if (capacity == 0) return False();
+
+  sc->session_cache_ = SessionCache::New(capacity);
+  if (sc->session_cache_ == NULL) {
+    return ThrowError("Unable to allocate the session cache");
+  }
+
+  return True();
+}
+
+
+Handle<Value> SecureContext::OpenSessionCache(const Arguments& args) {
+  HandleScope scope;
+
+  SecureContext *sc = ObjectWrap::Unwrap<SecureContext>(args.Holder());
+
+  if (args.Length() < 1 || !args[0]->IsString()) {
+    return ThrowTypeError("Bad parameter");
+  }
+
+  String::Utf8Value path(args[0]);
+  int err;
+  SessionCache* cache = SessionCache::Open(*path, &err);
+  if (cache == NULL) {
+    return ThrowException(ErrnoException(err, "open", "", *path));
+  }
+
+  delete sc->session_cache_;
+  sc->session_cache_ = cache;
+
+  return True();
+}
+
+
+Handle<Value> SecureContext::GetSessionCacheStats(const Arguments& args) {
+  HandleScope scope;
+
+  SecureContext *sc = ObjectWrap::Unwrap<SecureContext>(args.Holder());
+
+  if (sc->session_cache_ == NULL) return Null();
+
+  SessionCache::Stats stats;
+  sc->session_cache_->GetStats(&stats);
+
+  Local<Object> info = Object::New();
+  info->Set(String::New("capacity"), Integer::NewFromUnsigned(stats.capacity));
+  info->Set(String::New("entries"), Integer::NewFromUnsigned(stats.entries));
+  info->Set(String::New("hits"), Number::New(stats.hits));
+  info->Set(String::New("misses"), Number::New(stats.misses));
+  info->Set(String::New("stores"), Number::New(stats.stores));
+  info->Set(String::New("evictions"), Number::New(stats.evictions));
+  info->Set(String::New("shared"),
+            Boolean::New(sc->session_cache_->IsShared()));
+
+  return scope.Close(info);
+}
+
+
+// Creates the file behind a session cache shared between processes.
+Handle<Value> CreateSessionCache(const Arguments& args) {
+  HandleScope scope;
+
+  if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsUint32()) {
+    return ThrowTypeError("Bad parameter");
+  }
+
+  String::Utf8Value path(args[0]);
+  int err = SessionCache::Create(*path, args[1]->Uint32Value());
+  if (err) {
+    return ThrowException(ErrnoException(err, "open", "", *path));
+  }
+
+  return Undefined();
+}
+
+
 //Takes .pfx or .p12 and password in string or buffer format
 Handle<Value> SecureContext::LoadPKCS12(const Arguments& args) {
   HandleScope scope;
@@ -1161,7 +1300,7 @@ int Connection::AdvertiseNextProtoCallback_(SSL *s,
 
   Connection *p = static_cast<Connection*>(SSL_get_app_data(s));
 
-  if (p->npnProtos_.IsEmpty()) {
+  if (p == NULL || p->npnProtos_.IsEmpty()) {
     // No initialization - no NPN protocols
     *data = reinterpret_cast<const unsigned char*>("");
     *len = 0;
@@ -1178,6 +1317,7 @@ int Connection::SelectNextProtoCallback_(SSL *s,
                              const unsigned char* in,
                              unsigned int inlen, void *arg) {
   Connection *p = static_cast<Connection*> SSL_get_app_data(s);
+  if (p == NULL) return SSL_TLSEXT_ERR_NOACK;
 
   // Release old protocol handler if present
   if (!p->selectedNPNProto_.IsEmpty()) {
@@ -1227,6 +1367,7 @@ int Connection::SelectSNIContextCallback_(SSL *s, int *ad, void* arg) {
   HandleScope scope;
 
   Connection *p = static_cast<Connection*> SSL_get_app_data(s);
+  if (p == NULL) return SSL_TLSEXT_ERR_NOACK;
 
   const char* servername = SSL_get_servername(s, TLSEXT_NAMETYPE_host_name);
 
@@ -1570,122 +1711,132 @@ Handle<Value> Connection::ClearIn(const Arguments& args) {
 }
 
 
-Handle<Value> Connection::GetPeerCertificate(const Arguments& args) {
+// Converts a certificate into the object that getPeerCertificate() hands
+// to JavaScript. Used by both Connection and the native TLS stream.
+Handle<Value> X509ToObject(X509* cert) {
   HandleScope scope;
 
-  Connection *ss = Connection::Unwrap(args);
-
-  if (ss->ssl_ == NULL) return Undefined();
   Local<Object> info = Object::New();
-  X509* peer_cert = SSL_get_peer_certificate(ss->ssl_);
-  if (peer_cert != NULL) {
-    BIO* bio = BIO_new(BIO_s_mem());
-    BUF_MEM* mem;
-    if (X509_NAME_print_ex(bio, X509_get_subject_name(peer_cert), 0,
-                           X509_NAME_FLAGS) > 0) {
-      BIO_get_mem_ptr(bio, &mem);
-      info->Set(subject_symbol, String::New(mem->data, mem->length));
-    }
-    (void) BIO_reset(bio);
+  BIO* bio = BIO_new(BIO_s_mem());
+  BUF_MEM* mem;
+  if (X509_NAME_print_ex(bio, X509_get_subject_name(cert), 0,
+                         X509_NAME_FLAGS) > 0) {
+    BIO_get_mem_ptr(bio, &mem);
+    info->Set(subject_symbol, String::New(mem->data, mem->length));
+  }
+  (void) BIO_reset(bio);
 
-    if (X509_NAME_print_ex(bio, X509_get_issuer_name(peer_cert), 0,
-                           X509_NAME_FLAGS) > 0) {
-      BIO_get_mem_ptr(bio, &mem);
-      info->Set(issuer_symbol, String::New(mem->data, mem->length));
-    }
-    (void) BIO_reset(bio);
+  if (X509_NAME_print_ex(bio, X509_get_issuer_name(cert), 0,
+                         X509_NAME_FLAGS) > 0) {
+    BIO_get_mem_ptr(bio, &mem);
+    info->Set(issuer_symbol, String::New(mem->data, mem->length));
+  }
+  (void) BIO_reset(bio);
 
-    int index = X509_get_ext_by_NID(peer_cert, NID_subject_alt_name, -1);
-    if (index >= 0) {
-      X509_EXTENSION* ext;
-      int rv;
+  int index = X509_get_ext_by_NID(cert, NID_subject_alt_name, -1);
+  if (index >= 0) {
+    X509_EXTENSION* ext;
+    int rv;
 
-      ext = X509_get_ext(peer_cert, index);
-      assert(ext != NULL);
+    ext = X509_get_ext(cert, index);
+    assert(ext != NULL);
 
-      rv = X509V3_EXT_print(bio, ext, 0, 0);
-      assert(rv == 1);
+    rv = X509V3_EXT_print(bio, ext, 0, 0);
+    assert(rv == 1);
+
+    BIO_get_mem_ptr(bio, &mem);
+    info->Set(subjectaltname_symbol, String::New(mem->data, mem->length));
 
+    (void) BIO_reset(bio);
+  }
+
+  EVP_PKEY *pkey = NULL;
+  RSA *rsa = NULL;
+  if( NULL != (pkey = X509_get_pubkey(cert))
+      && NULL != (rsa = EVP_PKEY_get1_RSA(pkey)) ) {
+      BN_print(bio, rsa->n);
       BIO_get_mem_ptr(bio, &mem);
-      info->Set(subjectaltname_symbol, String::New(mem->data, mem->length));
+      info->Set(modulus_symbol, String::New(mem->data, mem->length) );
+      (void) BIO_reset(bio);
 
+      BN_print(bio, rsa->e);
+      BIO_get_mem_ptr(bio, &mem);
+      info->Set(exponent_symbol, String::New(mem->data, mem->length) );
       (void) BIO_reset(bio);
-    }
+  }
+
+  if (pkey != NULL) {
+    EVP_PKEY_free(pkey);
+    pkey = NULL;
+  }
+  if (rsa != NULL) {
+    RSA_free(rsa);
+    rsa = NULL;
+  }
+
+  ASN1_TIME_print(bio, X509_get_notBefore(cert));
+  BIO_get_mem_ptr(bio, &mem);
+  info->Set(valid_from_symbol, String::New(mem->data, mem->length));
+  (void) BIO_reset(bio);
+
+  ASN1_TIME_print(bio, X509_get_notAfter(cert));
+  BIO_get_mem_ptr(bio, &mem);
+  info->Set(valid_to_symbol, String::New(mem->data, mem->length));
+  BIO_free(bio);
 
-    EVP_PKEY *pkey = NULL;
-    RSA *rsa = NULL;
-    if( NULL != (pkey = X509_get_pubkey(peer_cert))
-        && NULL != (rsa = EVP_PKEY_get1_RSA(pkey)) ) {
-        BN_print(bio, rsa->n);
-        BIO_get_mem_ptr(bio, &mem);
-        info->Set(modulus_symbol, String::New(mem->data, mem->length) );
-        (void) BIO_reset(bio);
-
-        BN_print(bio, rsa->e);
-        BIO_get_mem_ptr(bio, &mem);
-        info->Set(exponent_symbol, String::New(mem->data, mem->length) );
-        (void) BIO_reset(bio);
+  unsigned int md_size, i;
+  unsigned char md[EVP_MAX_MD_SIZE];
+  if (X509_digest(cert, EVP_sha1(), md, &md_size)) {
+    const char hex[] = "0123456789ABCDEF";
+    char fingerprint[EVP_MAX_MD_SIZE * 3];
+
+    for (i = 0; i<md_size; i++) {
+      fingerprint[3*i] = hex[(md[i] & 0xf0) >> 4];
+      fingerprint[(3*i)+1] = hex[(md[i] & 0x0f)];
+      fingerprint[(3*i)+2] = ':';
     }
 
-    if (pkey != NULL) {
-      EVP_PKEY_free(pkey);
-      pkey = NULL;
+    if (md_size > 0) {
+      fingerprint[(3*(md_size-1))+2] = '\0';
     }
-    if (rsa != NULL) {
-      RSA_free(rsa);
-      rsa = NULL;
+    else {
+      fingerprint[0] = '\0';
     }
 
-    ASN1_TIME_print(bio, X509_get_notBefore(peer_cert));
-    BIO_get_mem_ptr(bio, &mem);
-    info->Set(valid_from_symbol, String::New(mem->data, mem->length));
-    (void) BIO_reset(bio);
+    info->Set(fingerprint_symbol, String::New(fingerprint));
+  }
 
-    ASN1_TIME_print(bio, X509_get_notAfter(peer_cert));
-    BIO_get_mem_ptr(bio, &mem);
-    info->Set(valid_to_symbol, String::New(mem->data, mem->length));
-    BIO_free(bio);
+  STACK_OF(ASN1_OBJECT) *eku = (STACK_OF(ASN1_OBJECT) *)X509_get_ext_d2i(
+      cert, NID_ext_key_usage, NULL, NULL);
+  if (eku != NULL) {
+    Local<Array> ext_key_usage = Array::New();
+    char buf[256];
 
-    unsigned int md_size, i;
-    unsigned char md[EVP_MAX_MD_SIZE];
-    if (X509_digest(peer_cert, EVP_sha1(), md, &md_size)) {
-      const char hex[] = "0123456789ABCDEF";
-      char fingerprint[EVP_MAX_MD_SIZE * 3];
+    for (int i = 0; i < sk_ASN1_OBJECT_num(eku); i++) {
+      memset(buf, 0, sizeof(buf));
+      OBJ_obj2txt(buf, sizeof(buf) - 1, sk_ASN1_OBJECT_value(eku, i), 1);
+      ext_key_usage->Set(Integer::New(i), String::New(buf));
+    }
 
-      for (i = 0; i<md_size; i++) {
-        fingerprint[3*i] = hex[(md[i] & 0xf0) >> 4];
-        fingerprint[(3*i)+1] = hex[(md[i] & 0x0f)];
-        fingerprint[(3*i)+2] = ':';
-      }
+    sk_ASN1_OBJECT_pop_free(eku, ASN1_OBJECT_free);
+    info->Set(ext_key_usage_symbol, ext_key_usage);
+  }
 
-      if (md_size > 0) {
-        fingerprint[(3*(md_size-1))+2] = '\0';
-      }
-      else {
-        fingerprint[0] = '\0';
-      }
+  return scope.Close(info);
+}
 
-      info->Set(fingerprint_symbol, String::New(fingerprint));
-    }
 
-    STACK_OF(ASN1_OBJECT) *eku = (STACK_OF(ASN1_OBJECT) *)X509_get_ext_d2i(
-        peer_cert, NID_ext_key_usage, NULL, NULL);
-    if (eku != NULL) {
-      Local<Array> ext_key_usage = Array::New();
-      char buf[256];
+Handle<Value> Connection::GetPeerCertificate(const Arguments& args) {
+  HandleScope scope;
 
-      for (int i = 0; i < sk_ASN1_OBJECT_num(eku); i++) {
-        memset(buf, 0, sizeof(buf));
-        OBJ_obj2txt(buf, sizeof(buf) - 1, sk_ASN1_OBJECT_value(eku, i), 1);
-        ext_key_usage->Set(Integer::New(i), String::New(buf));
-      }
+  Connection *ss = Connection::Unwrap(args);
 
-      sk_ASN1_OBJECT_pop_free(eku, ASN1_OBJECT_free);
-      info->Set(ext_key_usage_symbol, ext_key_usage);
-    }
+  if (ss->ssl_ == NULL) return Undefined();
+  X509* peer_cert = SSL_get_peer_certificate(ss->ssl_);
+  if (peer_cert == NULL) return scope.Close(Object::New());
 
-    X509_free(peer_cert);
-  }
+  Local<Value> info = Local<Value>::New(X509ToObject(peer_cert));
+  X509_free(peer_cert);
   return scope.Close(info);
 }
 
@@ -1846,16 +1997,13 @@ Handle<Value> Connection::IsInitFinished(const Arguments& args) {
 }
 
 
-Handle<Value> Connection::VerifyError(const Arguments& args) {
+// Maps the peer verification result onto an Error, or null if the peer
+// certificate checked out.
+Handle<Value> GetVerifyError(SSL* ssl) {
   HandleScope scope;
 
-  Connection *ss = Connection::Unwrap(args);
-
-  if (ss->ssl_ == NULL) return Null();
-
-
   // XXX Do this check in JS land?
-  X509* peer_cert = SSL_get_peer_certificate(ss->ssl_);
+  X509* peer_cert = SSL_get_peer_certificate(ssl);
   if (peer_cert == NULL) {
     // We requested a certificate and they did not send us one.
     // Definitely an error.
@@ -1866,7 +2014,7 @@ Handle<Value> Connection::VerifyError(const Arguments& args) {
   X509_free(peer_cert);
 
 
-  long x509_verify_error = SSL_get_verify_result(ss->ssl_);
+  long x509_verify_error = SSL_get_verify_result(ssl);
 
   Local<String> s;
 
@@ -1991,15 +2139,20 @@ Handle<Value> Connection::VerifyError(const Arguments& args) {
 }
 
 
-Handle<Value> Connection::GetCurrentCipher(const Arguments& args) {
+Handle<Value> Connection::VerifyError(const Arguments& args) {
   HandleScope scope;
 
   Connection *ss = Connection::Unwrap(args);
 
-  OPENSSL_CONST SSL_CIPHER *c;
+  if (ss->ssl_ == NULL) return Null();
+  return scope.Close(GetVerifyError(ss->ssl_));
+}
+
 
-  if ( ss->ssl_ == NULL ) return Undefined();
-  c = SSL_get_current_cipher(ss->ssl_);
+Handle<Value> GetCipherInfo(SSL* ssl) {
+  HandleScope scope;
+
+  OPENSSL_CONST SSL_CIPHER *c = SSL_get_current_cipher(ssl);
   if ( c == NULL ) return Undefined();
   Local<Object> info = Object::New();
   const char* cipher_name = SSL_CIPHER_get_name(c);
@@ -2009,6 +2162,16 @@ Handle<Value> Connection::GetCurrentCipher(const Arguments& args) {
   return scope.Close(info);
 }
 
+
+Handle<Value> Connection::GetCurrentCipher(const Arguments& args) {
+  HandleScope scope;
+
+  Connection *ss = Connection::Unwrap(args);
+
+  if ( ss->ssl_ == NULL ) return Undefined();
+  return scope.Close(GetCipherInfo(ss->ssl_));
+}
+
 Handle<Value> Connection::Close(const Arguments& args) {
   HandleScope scope;
 
@@ -4039,7 +4202,9 @@ RandomBytesRequest::~RandomBytesRequest() {
 }
 
 
+// |hint| is the size, the bytes may be key material.
 void RandomBytesFree(char* data, void* hint) {
+  OPENSSL_cleanse(data, reinterpret_cast<size_t>(hint));
   delete[] data;
 }
 
@@ -4083,13 +4248,18 @@ void RandomBytesCheck(RandomBytesRequest* req, Local<Value> argv[2]) {
     argv[1] = Local<Value>::New(Null());
   }
   else {
-    // avoids the malloc + memcpy
-    Buffer* buffer = Buffer::New(req->data_, req->size_, RandomBytesFree, NULL);
+    // avoids the malloc + memcpy, and keeps the bytes out of BufferPool's
+    // shared arenas
+    Buffer* buffer = Buffer::New(req->data_,
+                                 req->size_,
+                                 RandomBytesFree,
+                                 reinterpret_cast<void*>(req->size_));
     argv[0] = Local<Value>::New(Null());
-    argv[1] = Local<Object>::New(buffer->handle_);
+    argv[1] = Buffer::Slice(buffer->handle_, 0, req->size_);
     req->data_ = NULL;
   }
-  free(req->data_);
+  if (req->data_ != NULL)
+    RandomBytesFree(req->data_, reinterpret_cast<void*>(req->size_));
 }
 
 
@@ -4249,6 +4419,7 @@ void InitCrypto(Handle<Object> target) {
   NODE_SET_METHOD(target, "getSSLCiphers", GetSSLCiphers);
   NODE_SET_METHOD(target, "getCiphers", GetCiphers);
   NODE_SET_METHOD(target, "getHashes", GetHashes);
+  NODE_SET_METHOD(target, "createSessionCache", CreateSessionCache);
 
   subject_symbol    = NODE_PSYMBOL("subject");
   issuer_symbol     = NODE_PSYMBOL("issuer");
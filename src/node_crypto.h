@@ -25,6 +25,7 @@
 #include "node.h"
 
 #include "node_object_wrap.h"
+#include "node_crypto_session_cache.h"
 #include "v8.h"
 
 #include <openssl/ssl.h>
@@ -58,6 +59,7 @@ class Connection;
 class SecureContext : ObjectWrap {
  public:
   static void Initialize(v8::Handle<v8::Object> target);
+  static bool HasInstance(v8::Handle<v8::Value> value);
 
   SSL_CTX *ctx_;
   // TODO: ca_store_ should probably be removed, it's not used anywhere.
@@ -78,16 +80,22 @@ class SecureContext : ObjectWrap {
   static v8::Handle<v8::Value> SetSessionIdContext(const v8::Arguments& args);
   static v8::Handle<v8::Value> Close(const v8::Arguments& args);
   static v8::Handle<v8::Value> LoadPKCS12(const v8::Arguments& args);
+  static v8::Handle<v8::Value> SetSessionCache(const v8::Arguments& args);
+  static v8::Handle<v8::Value> OpenSessionCache(const v8::Arguments& args);
+  static v8::Handle<v8::Value> GetSessionCacheStats(
+      const v8::Arguments& args);
 
   static SSL_SESSION* GetSessionCallback(SSL* s,
                                          unsigned char* key,
                                          int len,
                                          int* copy);
   static int NewSessionCallback(SSL* s, SSL_SESSION* sess);
+  static void RemoveSessionCallback(SSL_CTX* ctx, SSL_SESSION* sess);
 
   SecureContext() : ObjectWrap() {
     ctx_ = NULL;
     ca_store_ = NULL;
+    session_cache_ = NULL;
   }
 
   void FreeCTXMem() {
@@ -109,9 +117,13 @@ class SecureContext : ObjectWrap {
 
   ~SecureContext() {
     FreeCTXMem();
+    delete session_cache_;
+    session_cache_ = NULL;
   }
 
  private:
+  // Native server-side session store, NULL unless enabled from JavaScript.
+  SessionCache* session_cache_;
 };
 
 class ClientHelloParser {
@@ -294,6 +306,11 @@ class Connection : ObjectWrap {
   friend class SecureContext;
 };
 
+// Helpers shared between Connection and the native TLS stream.
+v8::Handle<v8::Value> X509ToObject(X509* cert);
+v8::Handle<v8::Value> GetVerifyError(SSL* ssl);
+v8::Handle<v8::Value> GetCipherInfo(SSL* ssl);
+
 bool EntropySource(unsigned char* buffer, size_t length);
 void InitCrypto(v8::Handle<v8::Object> target);
 
@@ -0,0 +1,517 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "node_crypto_session_cache.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sched.h>
+# include <signal.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace node {
+namespace crypto {
+
+static const uint32_t kMagic = 0x6e747363;  // "ntsc"
+static const uint32_t kVersion = 2;
+static const int32_t kNone = -1;
+
+
+struct SessionCache::Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t bucket_count;
+  volatile long lock;
+  int32_t lru_head;
+  int32_t lru_tail;
+  int32_t free_head;
+  uint32_t entries;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t stores;
+  uint64_t evictions;
+};
+
+
+struct SessionCache::Slot {
+  int32_t hash_next;  // Next entry in the bucket, or in the free list
+  int32_t lru_prev;
+  int32_t lru_next;
+  uint32_t id_len;
+  uint32_t data_len;
+  unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+  unsigned char data[kMaxDataSize];
+};
+
+
+static uint32_t HashId(const unsigned char* id, unsigned int id_len) {
+  // FNV-1a. Session ids are random, this only has to spread them.
+  uint32_t hash = 2166136261u;
+  for (unsigned int i = 0; i < id_len; i++) {
+    hash ^= id[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+
+size_t SessionCache::SizeFor(unsigned int capacity,
+                             unsigned int* bucket_count) {
+  unsigned int buckets = 1;
+  while (buckets < capacity)
+    buckets <<= 1;
+  if (bucket_count != NULL)
+    *bucket_count = buckets;
+
+  // Keep the slots 8 byte aligned for the benefit of the header's counters
+  // in the next mapping over.
+  size_t header_size = (sizeof(Header) + buckets * sizeof(int32_t) + 7) & ~7;
+  return header_size + static_cast<size_t>(capacity) * sizeof(Slot);
+}
+
+
+void SessionCache::Init(char* base, unsigned int capacity) {
+  unsigned int bucket_count;
+  SizeFor(capacity, &bucket_count);
+
+  Header* h = reinterpret_cast<Header*>(base);
+  memset(h, 0, sizeof(*h));
+  h->magic = kMagic;
+  h->version = kVersion;
+  h->capacity = capacity;
+  h->bucket_count = bucket_count;
+
+  SessionCache cache(base, SizeFor(capacity, NULL), false);
+  cache.Reset();
+
+  // The block belongs to the caller.
+  cache.base_ = NULL;
+}
+
+
+// Empties the cache, leaving the lock and the counters alone.
+void SessionCache::Reset() {
+  Header* h = header();
+  h->lru_head = kNone;
+  h->lru_tail = kNone;
+  h->free_head = h->capacity > 0 ? 0 : kNone;
+  h->evictions += h->entries;
+  h->entries = 0;
+
+  int32_t* b = buckets();
+  for (unsigned int i = 0; i < h->bucket_count; i++)
+    b[i] = kNone;
+
+  for (unsigned int i = 0; i < h->capacity; i++) {
+    Slot* s = slot(i);
+    s->hash_next = (i + 1 < h->capacity) ? static_cast<int32_t>(i + 1) : kNone;
+    s->lru_prev = kNone;
+    s->lru_next = kNone;
+    s->id_len = 0;
+    s->data_len = 0;
+  }
+}
+
+
+SessionCache::SessionCache(char* base, size_t size, bool shared)
+    : base_(base),
+      size_(size),
+      shared_(shared) {
+}
+
+
+SessionCache::~SessionCache() {
+  if (base_ == NULL)
+    return;
+#ifndef _WIN32
+  if (shared_) {
+    munmap(base_, size_);
+    return;
+  }
+#endif
+  free(base_);
+}
+
+
+SessionCache* SessionCache::New(unsigned int capacity) {
+  size_t size = SizeFor(capacity, NULL);
+  char* base = static_cast<char*>(malloc(size));
+  if (base == NULL)
+    return NULL;
+  Init(base, capacity);
+  return new SessionCache(base, size, false);
+}
+
+
+#ifdef _WIN32
+
+int SessionCache::Create(const char* path, unsigned int capacity) {
+  return ENOSYS;
+}
+
+
+SessionCache* SessionCache::Open(const char* path, int* err) {
+  *err = ENOSYS;
+  return NULL;
+}
+
+#else  // !_WIN32
+
+int SessionCache::Create(const char* path, unsigned int capacity) {
+  size_t size = SizeFor(capacity, NULL);
+
+  int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1)
+    return errno;
+
+  if (ftruncate(fd, size)) {
+    int err = errno;
+    close(fd);
+    unlink(path);
+    return err;
+  }
+
+  void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int err = (base == MAP_FAILED) ? errno : 0;
+  close(fd);
+
+  if (err) {
+    unlink(path);
+    return err;
+  }
+
+  Init(static_cast<char*>(base), capacity);
+  munmap(base, size);
+  return 0;
+}
+
+
+SessionCache* SessionCache::Open(const char* path, int* err) {
+  int fd = open(path, O_RDWR);
+  if (fd == -1) {
+    *err = errno;
+    return NULL;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st)) {
+    *err = errno;
+    close(fd);
+    return NULL;
+  }
+
+  size_t size = st.st_size;
+  if (size < sizeof(Header)) {
+    *err = EINVAL;
+    close(fd);
+    return NULL;
+  }
+
+  void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    *err = errno;
+    return NULL;
+  }
+
+  // Don't trust a file that another build or another program laid out.
+  Header* h = static_cast<Header*>(base);
+  if (h->magic != kMagic ||
+      h->version != kVersion ||
+      SizeFor(h->capacity, NULL) != size) {
+    munmap(base, size);
+    *err = EINVAL;
+    return NULL;
+  }
+
+  *err = 0;
+  return new SessionCache(static_cast<char*>(base), size, true);
+}
+
+#endif  // _WIN32
+
+
+inline SessionCache::Header* SessionCache::header() {
+  return reinterpret_cast<Header*>(base_);
+}
+
+
+inline int32_t* SessionCache::buckets() {
+  return reinterpret_cast<int32_t*>(base_ + sizeof(Header));
+}
+
+
+inline SessionCache::Slot* SessionCache::slot(int32_t index) {
+  size_t header_size = (sizeof(Header) +
+                        header()->bucket_count * sizeof(int32_t) + 7) & ~7;
+  return reinterpret_cast<Slot*>(base_ + header_size) + index;
+}
+
+
+void SessionCache::Lock() {
+  volatile long* lock = &header()->lock;
+#ifdef _WIN32
+  while (InterlockedExchange(lock, 1) != 0) {
+    while (*lock != 0)
+      SwitchToThread();
+  }
+#else
+  // The lock word holds the pid of its owner. A worker that dies inside a
+  // critical section would otherwise leave it taken for good: whoever finds
+  // the owner gone takes the lock over and empties the cache, the dead
+  // worker may have left the lists half updated.
+  long self = static_cast<long>(getpid());
+  for (unsigned int spins = 1; ; spins++) {
+    long owner = __sync_val_compare_and_swap(lock, 0, self);
+    if (owner == 0)
+      return;
+
+    if (spins % 64 == 0 &&
+        kill(static_cast<pid_t>(owner), 0) == -1 &&
+        errno == ESRCH &&
+        __sync_bool_compare_and_swap(lock, owner, self)) {
+      Reset();
+      return;
+    }
+
+    sched_yield();
+  }
+#endif
+}
+
+
+void SessionCache::Unlock() {
+#ifdef _WIN32
+  InterlockedExchange(&header()->lock, 0);
+#else
+  __sync_lock_release(&header()->lock);
+#endif
+}
+
+
+int32_t SessionCache::Find(const unsigned char* id,
+                           unsigned int id_len,
+                           uint32_t hash) {
+  int32_t index = buckets()[hash & (header()->bucket_count - 1)];
+  while (index != kNone) {
+    Slot* s = slot(index);
+    if (s->id_len == id_len && memcmp(s->id, id, id_len) == 0)
+      return index;
+    index = s->hash_next;
+  }
+  return kNone;
+}
+
+
+void SessionCache::Unlink(int32_t index, uint32_t hash) {
+  int32_t* link = &buckets()[hash & (header()->bucket_count - 1)];
+  while (*link != index) {
+    assert(*link != kNone);
+    link = &slot(*link)->hash_next;
+  }
+  *link = slot(index)->hash_next;
+}
+
+
+void SessionCache::LRUUnlink(int32_t index) {
+  Header* h = header();
+  Slot* s = slot(index);
+
+  if (s->lru_prev == kNone)
+    h->lru_head = s->lru_next;
+  else
+    slot(s->lru_prev)->lru_next = s->lru_next;
+
+  if (s->lru_next == kNone)
+    h->lru_tail = s->lru_prev;
+  else
+    slot(s->lru_next)->lru_prev = s->lru_prev;
+
+  s->lru_prev = kNone;
+  s->lru_next = kNone;
+}
+
+
+void SessionCache::LRUPushFront(int32_t index) {
+  Header* h = header();
+  Slot* s = slot(index);
+
+  s->lru_prev = kNone;
+  s->lru_next = h->lru_head;
+  if (h->lru_head != kNone)
+    slot(h->lru_head)->lru_prev = index;
+  h->lru_head = index;
+  if (h->lru_tail == kNone)
+    h->lru_tail = index;
+}
+
+
+bool SessionCache::Add(SSL_SESSION* sess) {
+  unsigned int id_len = sess->session_id_length;
+  if (id_len == 0 || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+    return false;
+
+  int size = i2d_SSL_SESSION(sess, NULL);
+  if (size <= 0 || static_cast<unsigned int>(size) > kMaxDataSize)
+    return false;
+
+  // Serialize outside of the lock.
+  unsigned char data[kMaxDataSize];
+  unsigned char* p = data;
+  i2d_SSL_SESSION(sess, &p);
+
+  const unsigned char* id = sess->session_id;
+  uint32_t hash = HashId(id, id_len);
+
+  Lock();
+
+  Header* h = header();
+  if (h->capacity == 0) {
+    Unlock();
+    return false;
+  }
+
+  bool link = true;
+  int32_t index = Find(id, id_len, hash);
+  if (index != kNone) {
+    // Same session id again, replace the data in place.
+    LRUUnlink(index);
+    link = false;
+  } else if (h->free_head != kNone) {
+    index = h->free_head;
+    h->free_head = slot(index)->hash_next;
+    h->entries++;
+  } else {
+    // Evict the least recently used session.
+    index = h->lru_tail;
+    Slot* victim = slot(index);
+    Unlink(index, HashId(victim->id, victim->id_len));
+    LRUUnlink(index);
+    h->evictions++;
+  }
+
+  Slot* s = slot(index);
+  if (link) {
+    s->id_len = id_len;
+    memcpy(s->id, id, id_len);
+    int32_t* bucket = &buckets()[hash & (h->bucket_count - 1)];
+    s->hash_next = *bucket;
+    *bucket = index;
+  }
+  s->data_len = size;
+  memcpy(s->data, data, size);
+  LRUPushFront(index);
+  h->stores++;
+
+  Unlock();
+  return true;
+}
+
+
+SSL_SESSION* SessionCache::Get(const unsigned char* id,
+                               unsigned int id_len) {
+  if (id_len == 0 || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+    return NULL;
+
+  unsigned char data[kMaxDataSize];
+  unsigned int size = 0;
+  uint32_t hash = HashId(id, id_len);
+
+  Lock();
+
+  Header* h = header();
+  int32_t index = Find(id, id_len, hash);
+  if (index == kNone) {
+    h->misses++;
+  } else {
+    h->hits++;
+    Slot* s = slot(index);
+    size = s->data_len;
+    memcpy(data, s->data, size);
+    LRUUnlink(index);
+    LRUPushFront(index);
+  }
+
+  Unlock();
+
+  if (size == 0)
+    return NULL;
+
+  // Deserialize outside of the lock.
+  const unsigned char* p = data;
+  return d2i_SSL_SESSION(NULL, &p, size);
+}
+
+
+void SessionCache::Remove(const unsigned char* id, unsigned int id_len) {
+  if (id_len == 0 || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+    return;
+
+  uint32_t hash = HashId(id, id_len);
+
+  Lock();
+
+  Header* h = header();
+  int32_t index = Find(id, id_len, hash);
+  if (index != kNone) {
+    Unlink(index, hash);
+    LRUUnlink(index);
+
+    Slot* s = slot(index);
+    s->id_len = 0;
+    s->data_len = 0;
+    s->hash_next = h->free_head;
+    h->free_head = index;
+    h->entries--;
+  }
+
+  Unlock();
+}
+
+
+void SessionCache::GetStats(Stats* stats) {
+  Lock();
+
+  Header* h = header();
+  stats->capacity = h->capacity;
+  stats->entries = h->entries;
+  stats->hits = h->hits;
+  stats->misses = h->misses;
+  stats->stores = h->stores;
+  stats->evictions = h->evictions;
+
+  Unlock();
+}
+
+}  // namespace crypto
+}  // namespace node
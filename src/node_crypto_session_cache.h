@@ -0,0 +1,110 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SRC_NODE_CRYPTO_SESSION_CACHE_H_
+#define SRC_NODE_CRYPTO_SESSION_CACHE_H_
+
+#include <openssl/ssl.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+namespace crypto {
+
+// Size-bounded LRU store of serialized SSL sessions, keyed by session id.
+//
+// The whole cache lives in a single block of memory and links its entries
+// by index rather than by pointer, so the block can be a file mapping that
+// several processes share: cluster workers resume each other's sessions.
+// Access is serialized by a spinlock in the block's header; the critical
+// sections are a hash lookup and a memcpy of at most one slot. The lock
+// records its owner's pid, so a worker that dies holding it doesn't wedge
+// the others.
+class SessionCache {
+ public:
+  // Largest serialized session that fits in a slot.
+  static const unsigned int kMaxDataSize = 4044;
+
+  struct Stats {
+    unsigned int capacity;
+    unsigned int entries;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;
+  };
+
+  // Process-local cache holding up to `capacity` sessions.
+  static SessionCache* New(unsigned int capacity);
+
+  // Creates and initializes a cache file that processes can Open(). Returns
+  // 0 on success, an errno value otherwise.
+  static int Create(const char* path, unsigned int capacity);
+
+  // Maps a cache file made by Create(). Returns NULL and sets *err on error.
+  static SessionCache* Open(const char* path, int* err);
+
+  ~SessionCache();
+
+  // Takes a reference-less copy of `sess`. Sessions that don't fit in a
+  // slot are not cached. Returns true if the session was stored.
+  bool Add(SSL_SESSION* sess);
+
+  // Returns a new session the caller owns, or NULL on a miss.
+  SSL_SESSION* Get(const unsigned char* id, unsigned int id_len);
+
+  void Remove(const unsigned char* id, unsigned int id_len);
+
+  void GetStats(Stats* stats);
+  bool IsShared() const { return shared_; }
+
+ private:
+  struct Header;
+  struct Slot;
+
+  SessionCache(char* base, size_t size, bool shared);
+
+  static size_t SizeFor(unsigned int capacity, unsigned int* bucket_count);
+  static void Init(char* base, unsigned int capacity);
+
+  inline Header* header();
+  inline int32_t* buckets();
+  inline Slot* slot(int32_t index);
+
+  int32_t Find(const unsigned char* id, unsigned int id_len, uint32_t hash);
+  void Unlink(int32_t index, uint32_t hash);
+  void LRUUnlink(int32_t index);
+  void LRUPushFront(int32_t index);
+
+  void Reset();
+  void Lock();
+  void Unlock();
+
+  char* base_;
+  size_t size_;
+  bool shared_;
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // SRC_NODE_CRYPTO_SESSION_CACHE_H_
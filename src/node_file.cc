@@ -36,6 +36,8 @@
 
 #if defined(__MINGW32__) || defined(_MSC_VER)
 # include <io.h>
+#else
+# include <unistd.h>
 #endif
 
 namespace node {
@@ -961,6 +963,261 @@ static Handle<Value> FUTimes(const Arguments& args) {
 }
 
 
+#ifndef _WIN32
+// fs.batch() runs a group of operations back to back on one thread pool
+// thread and reports all of their results with a single callback. That
+// saves a thread pool round trip and an event loop wakeup per operation.
+//
+// The operations are executed with plain system calls, Windows uses the
+// JS fallback in lib/fs.js.
+
+enum BatchOpType {
+  BATCH_STAT,
+  BATCH_LSTAT,
+  BATCH_FSTAT,
+  BATCH_OPEN,
+  BATCH_CLOSE,
+  BATCH_READ,
+  BATCH_WRITE
+};
+
+struct BatchOp {
+  int type;
+  char* path;
+  int fd;  // When negative, the fd returned by operation -(fd + 1).
+  int flags;
+  int mode;
+  char* buf;
+  size_t len;
+  int64_t pos;
+  ssize_t result;
+  int errorno;
+  uv_statbuf_t statbuf;
+};
+
+class BatchReqWrap: public ReqWrap<uv_work_t> {
+ public:
+  explicit BatchReqWrap(int count)
+    : count_(count),
+      ops_(new BatchOp[count]) {
+    memset(ops_, 0, count * sizeof(*ops_));
+  }
+
+  ~BatchReqWrap() {
+    for (int i = 0; i < count_; i++)
+      free(ops_[i].path);
+    delete[] ops_;
+  }
+
+  inline int count() const { return count_; }
+  inline BatchOp* op(int i) { return ops_ + i; }
+
+ private:
+  int count_;
+  BatchOp* ops_;
+};
+
+
+static ssize_t BatchRun(BatchOp* op, int fd) {
+  switch (op->type) {
+    case BATCH_STAT:
+      return stat(op->path, &op->statbuf);
+    case BATCH_LSTAT:
+      return lstat(op->path, &op->statbuf);
+    case BATCH_FSTAT:
+      return fstat(fd, &op->statbuf);
+    case BATCH_OPEN:
+      return open(op->path, op->flags, op->mode);
+    case BATCH_CLOSE:
+      return close(fd);
+    case BATCH_READ:
+      if (op->pos < 0)
+        return read(fd, op->buf, op->len);
+      return pread(fd, op->buf, op->len, op->pos);
+    case BATCH_WRITE:
+      if (op->pos < 0)
+        return write(fd, op->buf, op->len);
+      return pwrite(fd, op->buf, op->len, op->pos);
+  }
+  abort();
+  return -1;
+}
+
+
+static void BatchWork(uv_work_t* req) {
+  BatchReqWrap* req_wrap = static_cast<BatchReqWrap*>(req->data);
+
+  for (int i = 0; i < req_wrap->count(); i++) {
+    BatchOp* op = req_wrap->op(i);
+    int fd = op->fd;
+
+    if (fd < 0) {
+      BatchOp* dep = req_wrap->op(-fd - 1);
+      if (dep->result == -1) {
+        op->result = -1;
+        op->errorno = EBADF;
+        continue;
+      }
+      fd = dep->result;
+    }
+
+    ssize_t r;
+    do {
+      errno = 0;
+      r = BatchRun(op, fd);
+    } while (r == -1 && errno == EINTR && op->type != BATCH_CLOSE);
+
+    op->result = r;
+    op->errorno = (r == -1) ? errno : 0;
+  }
+}
+
+
+static void BatchAfter(uv_work_t* req, int status) {
+  HandleScope scope;
+
+  BatchReqWrap* req_wrap = static_cast<BatchReqWrap*>(req->data);
+  assert(&req_wrap->req_ == req);
+  assert(status == 0);
+
+  static const char* const syscalls[] = {
+    "stat", "lstat", "fstat", "open", "close", "read", "write"
+  };
+
+  Local<Value> error = Local<Value>::New(Null());
+  Local<Array> results = Array::New(req_wrap->count());
+
+  for (int i = 0; i < req_wrap->count(); i++) {
+    BatchOp* op = req_wrap->op(i);
+
+    if (op->result == -1) {
+      // Report the first failure, the results of the other operations are
+      // still delivered.
+      if (error->IsNull()) {
+        error = ErrnoException(op->errorno, syscalls[op->type], "", op->path);
+        error->ToObject()->Set(String::NewSymbol("index"), Integer::New(i));
+      }
+      continue;
+    }
+
+    switch (op->type) {
+      case BATCH_STAT:
+      case BATCH_LSTAT:
+      case BATCH_FSTAT:
+        results->Set(i, BuildStatsObject(&op->statbuf));
+        break;
+      case BATCH_CLOSE:
+        results->Set(i, Undefined());
+        break;
+      default:
+        results->Set(i, Integer::New(op->result));
+        break;
+    }
+  }
+
+  Local<Value> argv[2] = { error, results };
+  MakeCallback(req_wrap->object_, oncomplete_sym, ARRAY_SIZE(argv), argv);
+
+  delete req_wrap;
+}
+
+
+// batch(ops, callback)
+//
+// Every element of ops is an array that starts with the BatchOpType:
+//
+//   [BATCH_STAT, path], [BATCH_LSTAT, path]
+//   [BATCH_FSTAT, fd], [BATCH_CLOSE, fd]
+//   [BATCH_OPEN, path, flags, mode]
+//   [BATCH_READ, fd, buffer, offset, length, position]
+//   [BATCH_WRITE, fd, buffer, offset, length, position]
+//
+// A negative fd refers to the fd returned by an earlier BATCH_OPEN, see
+// BatchOp::fd. lib/fs.js validates the arguments, the checks here only
+// protect against memory corruption.
+static Handle<Value> Batch(const Arguments& args) {
+  HandleScope scope;
+
+  if (!args[0]->IsArray() || !args[1]->IsFunction())
+    return THROW_BAD_ARGS;
+
+  Local<Array> ops = Local<Array>::Cast(args[0]);
+  int count = ops->Length();
+
+  BatchReqWrap* req_wrap = new BatchReqWrap(count);
+
+  for (int i = 0; i < count; i++) {
+    BatchOp* op = req_wrap->op(i);
+    Local<Value> val = ops->Get(i);
+
+    if (!val->IsArray()) {
+      delete req_wrap;
+      return THROW_BAD_ARGS;
+    }
+
+    Local<Array> arr = Local<Array>::Cast(val);
+    op->type = arr->Get(0)->Int32Value();
+
+    switch (op->type) {
+      case BATCH_STAT:
+      case BATCH_LSTAT:
+      case BATCH_OPEN:
+        op->path = strdup(*node::Utf8Value(arr->Get(1)));
+        op->flags = arr->Get(2)->Int32Value();
+        op->mode = arr->Get(3)->Int32Value();
+        break;
+
+      case BATCH_FSTAT:
+      case BATCH_CLOSE:
+        op->fd = arr->Get(1)->Int32Value();
+        break;
+
+      case BATCH_READ:
+      case BATCH_WRITE: {
+        op->fd = arr->Get(1)->Int32Value();
+        Local<Value> buffer = arr->Get(2);
+        size_t off = arr->Get(3)->Uint32Value();
+        size_t len = arr->Get(4)->Uint32Value();
+        if (!Buffer::HasInstance(buffer) ||
+            !Buffer::IsWithinBounds(off, len, Buffer::Length(buffer))) {
+          delete req_wrap;
+          return THROW_BAD_ARGS;
+        }
+        op->buf = Buffer::Data(buffer) + off;
+        op->len = len;
+        op->pos = GET_OFFSET(arr->Get(5));
+        break;
+      }
+
+      default:
+        delete req_wrap;
+        return THROW_BAD_ARGS;
+    }
+
+    if (op->fd < 0 &&
+        (-op->fd - 1 >= i || req_wrap->op(-op->fd - 1)->type != BATCH_OPEN)) {
+      delete req_wrap;
+      return THROW_BAD_ARGS;
+    }
+  }
+
+  // Keeps the buffers alive until the operations are done.
+  req_wrap->object_->Set(String::NewSymbol("ops"), ops);
+  req_wrap->object_->Set(oncomplete_sym, args[1]);
+  req_wrap->Dispatched();
+
+  int r = uv_queue_work_lane(uv_default_loop(),
+                             &req_wrap->req_,
+                             UV_WORK_FS,
+                             BatchWork,
+                             BatchAfter);
+  assert(r == 0);
+
+  return scope.Close(req_wrap->object_);
+}
+#endif  // _WIN32
+
+
 void File::Initialize(Handle<Object> target) {
   HandleScope scope;
 
@@ -993,6 +1250,10 @@ void File::Initialize(Handle<Object> target) {
 
   NODE_SET_METHOD(target, "utimes", UTimes);
   NODE_SET_METHOD(target, "futimes", FUTimes);
+
+#ifndef _WIN32
+  NODE_SET_METHOD(target, "batch", Batch);
+#endif
 }
 
 void InitFs(Handle<Object> target) {
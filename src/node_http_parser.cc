@@ -32,6 +32,7 @@
 #define strcasecmp _stricmp
 #endif
 #include <stdlib.h>  /* free() */
+#include <ctype.h>  /* tolower() */
 
 // This is a binding to http_parser (https://github.com/joyent/http-parser)
 // The goal is to decouple sockets from parsing for more javascript-level
@@ -62,6 +63,7 @@ static Persistent<String> version_minor_sym;
 static Persistent<String> should_keep_alive_sym;
 static Persistent<String> upgrade_sym;
 static Persistent<String> headers_sym;
+static Persistent<String> header_offsets_sym;
 static Persistent<String> url_sym;
 
 static Persistent<String> unknown_method_sym;
@@ -108,6 +110,93 @@ method_to_str(unsigned short m) {
 }
 
 
+// Header names that are common enough to be worth returning as pre-made
+// symbols rather than creating a new string for every message. Both the
+// canonical and the lower case spelling are interned, anything else is
+// created as before so that the original case is preserved.
+#define HTTP_HEADER_NAME_MAP(X)                                               \
+  X("Accept")                                                                 \
+  X("Accept-Charset")                                                         \
+  X("Accept-Encoding")                                                        \
+  X("Accept-Language")                                                        \
+  X("Authorization")                                                          \
+  X("Cache-Control")                                                          \
+  X("Connection")                                                             \
+  X("Content-Encoding")                                                       \
+  X("Content-Length")                                                         \
+  X("Content-Type")                                                           \
+  X("Cookie")                                                                 \
+  X("Date")                                                                   \
+  X("ETag")                                                                   \
+  X("Expect")                                                                 \
+  X("Expires")                                                                \
+  X("Host")                                                                   \
+  X("If-Modified-Since")                                                      \
+  X("If-None-Match")                                                          \
+  X("Keep-Alive")                                                             \
+  X("Last-Modified")                                                          \
+  X("Location")                                                               \
+  X("Origin")                                                                 \
+  X("Pragma")                                                                 \
+  X("Range")                                                                  \
+  X("Referer")                                                                \
+  X("Server")                                                                 \
+  X("Set-Cookie")                                                             \
+  X("Transfer-Encoding")                                                      \
+  X("Upgrade")                                                                \
+  X("User-Agent")                                                             \
+  X("Vary")                                                                   \
+  X("X-Forwarded-For")                                                        \
+  X("X-Requested-With")
+
+struct HeaderName {
+  char name[32];
+  size_t size;
+  Persistent<String> sym;
+};
+
+#define X(name) + 2
+static HeaderName header_names[0 HTTP_HEADER_NAME_MAP(X)];
+#undef X
+
+
+static void InitHeaderNames() {
+  static const char* const names[] = {
+#define X(name) name,
+    HTTP_HEADER_NAME_MAP(X)
+#undef X
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+    HeaderName* canonical = &header_names[2 * i];
+    HeaderName* lower = &header_names[2 * i + 1];
+    size_t size = strlen(names[i]);
+
+    assert(size < sizeof(canonical->name));
+    memcpy(canonical->name, names[i], size);
+    canonical->size = size;
+    canonical->sym = NODE_PSYMBOL(names[i]);
+
+    for (size_t k = 0; k < size; k++)
+      lower->name[k] = tolower(names[i][k]);
+    lower->size = size;
+    lower->sym = Persistent<String>::New(String::NewSymbol(lower->name,
+                                                           size));
+  }
+}
+
+
+// Returns an empty handle if `str` is not one of the interned names.
+static inline Local<String> InternedHeaderName(const char* str, size_t size) {
+  for (size_t i = 0; i < ARRAY_SIZE(header_names); i++) {
+    const HeaderName* h = &header_names[i];
+    if (h->size == size && memcmp(h->name, str, size) == 0)
+      return Local<String>::New(h->sym);
+  }
+  return Local<String>();
+}
+
+
 // helper class for the Parser
 struct StringPtr {
   StringPtr() {
@@ -174,6 +263,26 @@ struct StringPtr {
   }
 
 
+  Local<String> ToHeaderName() const {
+    if (str_) {
+      Local<String> name = InternedHeaderName(str_, size_);
+      if (!name.IsEmpty())
+        return name;
+    }
+    return ToString();
+  }
+
+
+  // True if the string still points into the buffer that is being parsed,
+  // i.e. it can be described by its offset into that buffer.
+  bool IsInCurrentBuffer() const {
+    return !on_heap_ &&
+           str_ != NULL &&
+           str_ >= current_buffer_data &&
+           str_ + size_ <= current_buffer_data + current_buffer_len;
+  }
+
+
   const char* str_;
   bool on_heap_;
   size_t size_;
@@ -183,6 +292,7 @@ struct StringPtr {
 class Parser : public ObjectWrap {
 public:
   Parser(enum http_parser_type type) : ObjectWrap() {
+    use_offsets_ = false;
     Init(type);
   }
 
@@ -256,7 +366,13 @@ public:
     }
     else {
       // Fast case, pass headers and URL to JS land.
-      message_info->Set(headers_sym, CreateHeaders());
+      Local<Array> offsets;
+      if (use_offsets_)
+        offsets = CreateHeaderOffsets();
+      if (offsets.IsEmpty())
+        message_info->Set(headers_sym, CreateHeaders());
+      else
+        message_info->Set(header_offsets_sym, offsets);
       if (parser_.type == HTTP_REQUEST)
         message_info->Set(url_sym, url_.ToString());
     }
@@ -495,6 +611,16 @@ public:
   }
 
 
+  // parser.useHeaderOffsets(true) makes onHeadersComplete() describe the
+  // headers as offsets into the buffer passed to execute() when possible.
+  static Handle<Value> UseHeaderOffsets(const Arguments& args) {
+    HandleScope scope;
+    Parser* parser = ObjectWrap::Unwrap<Parser>(args.This());
+    parser->use_offsets_ = args[0]->BooleanValue();
+    return Undefined();
+  }
+
+
   template <bool should_pause>
   static Handle<Value> Pause(const Arguments& args) {
     HandleScope scope;
@@ -512,7 +638,7 @@ private:
     Local<Array> headers = Array::New(2 * num_values_);
 
     for (int i = 0; i < num_values_; ++i) {
-      headers->Set(2 * i, fields_[i].ToString());
+      headers->Set(2 * i, fields_[i].ToHeaderName());
       headers->Set(2 * i + 1, values_[i].ToString());
     }
 
@@ -520,6 +646,37 @@ private:
   }
 
 
+  // Describes the headers as [name, nameLength, valueOffset, valueLength]
+  // tuples where `name` is an interned string for common header names and
+  // the offset of the name in the current buffer otherwise. Returns an
+  // empty handle when a header was split over several reads and has been
+  // copied to the heap, the caller falls back to CreateHeaders() then.
+  Local<Array> CreateHeaderOffsets() {
+    for (int i = 0; i < num_values_; ++i) {
+      if (!fields_[i].IsInCurrentBuffer() || !values_[i].IsInCurrentBuffer())
+        return Local<Array>();
+    }
+
+    Local<Array> offsets = Array::New(4 * num_values_);
+
+    for (int i = 0; i < num_values_; ++i) {
+      const StringPtr& field = fields_[i];
+      const StringPtr& value = values_[i];
+      Local<String> name = InternedHeaderName(field.str_, field.size_);
+
+      if (name.IsEmpty())
+        offsets->Set(4 * i, Integer::New(field.str_ - current_buffer_data));
+      else
+        offsets->Set(4 * i, name);
+      offsets->Set(4 * i + 1, Integer::New(field.size_));
+      offsets->Set(4 * i + 2, Integer::New(value.str_ - current_buffer_data));
+      offsets->Set(4 * i + 3, Integer::New(value.size_));
+    }
+
+    return offsets;
+  }
+
+
   // spill headers and request path to JS land
   void Flush() {
     HandleScope scope;
@@ -562,6 +719,7 @@ private:
   int num_values_;
   bool have_flushed_;
   bool got_exception_;
+  bool use_offsets_;
 };
 
 
@@ -585,6 +743,7 @@ void InitHttpParser(Handle<Object> target) {
   NODE_SET_PROTOTYPE_METHOD(t, "reinitialize", Parser::Reinitialize);
   NODE_SET_PROTOTYPE_METHOD(t, "pause", Parser::Pause<true>);
   NODE_SET_PROTOTYPE_METHOD(t, "resume", Parser::Pause<false>);
+  NODE_SET_PROTOTYPE_METHOD(t, "useHeaderOffsets", Parser::UseHeaderOffsets);
 
   target->Set(String::NewSymbol("HTTPParser"), t->GetFunction());
 
@@ -606,8 +765,11 @@ void InitHttpParser(Handle<Object> target) {
   should_keep_alive_sym = NODE_PSYMBOL("shouldKeepAlive");
   upgrade_sym = NODE_PSYMBOL("upgrade");
   headers_sym = NODE_PSYMBOL("headers");
+  header_offsets_sym = NODE_PSYMBOL("headerOffsets");
   url_sym = NODE_PSYMBOL("url");
 
+  InitHeaderNames();
+
   settings.on_message_begin    = Parser::on_message_begin;
   settings.on_url              = Parser::on_url;
   settings.on_header_field     = Parser::on_header_field;
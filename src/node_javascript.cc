@@ -36,6 +36,32 @@ Handle<String> MainSource() {
   return BUILTIN_ASCII_ARRAY(node_native, sizeof(node_native)-1);
 }
 
+Handle<String> NativeSource(const char* name) {
+  for (int i = 0; natives[i].name; i++) {
+    if (strcmp(natives[i].name, name) == 0) {
+      return BUILTIN_ASCII_ARRAY(natives[i].source, natives[i].source_len);
+    }
+  }
+  return Handle<String>();
+}
+
+Local<Function> SnapshotFunction(const char* name) {
+  Local<Value> core =
+      Context::GetCurrent()->Global()->Get(String::NewSymbol("__nodeCore"));
+  if (!core->IsObject()) return Local<Function>();
+
+  Local<Value> fn = core.As<Object>()->Get(String::New(name));
+  if (!fn->IsFunction()) return Local<Function>();
+
+  return fn.As<Function>();
+}
+
+void DeleteSnapshot(Handle<Context> context) {
+  HandleScope scope;
+  Context::Scope context_scope(context);
+  context->Global()->Delete(String::NewSymbol("__nodeCore"));
+}
+
 void DefineJavaScript(v8::Handle<v8::Object> target) {
   HandleScope scope;
 
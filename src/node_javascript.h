@@ -25,5 +25,14 @@ namespace node {
 
 void DefineJavaScript(v8::Handle<v8::Object> target);
 v8::Handle<v8::String> MainSource();
+// Returns an empty handle if there is no built-in module called |name|.
+v8::Handle<v8::String> NativeSource(const char* name);
+// Returns the wrapper function of built-in module |name| that was compiled
+// into the V8 snapshot, or an empty handle if node was built without
+// --with-core-snapshot. "node" is the bootstrap function of src/node.js.
+v8::Local<v8::Function> SnapshotFunction(const char* name);
+// Removes the snapshot's core library from the global object of |context|.
+// Every context is built from the snapshot, not only the ones node boots in.
+void DeleteSnapshot(v8::Handle<v8::Context> context);
 
 }  // namespace node
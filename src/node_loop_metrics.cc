@@ -0,0 +1,268 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// The histograms behind process.loopMetrics, see src/node.js for the JS side.
+//
+// libuv reports the phases of every loop iteration through UV_LOOP_METRICS,
+// MakeCallback() times the calls into JS. Each measurement goes into a
+// log-linear histogram, like HdrHistogram: values below kSubBuckets have a
+// bucket each and every power of two above that is split into kSubBuckets
+// buckets of equal width, which keeps the error under 1/kSubBuckets over the
+// whole range. Recording a value never allocates.
+//
+// All histograms live in one array of doubles that snapshot() copies into a
+// Float64Array. Each histogram is kHistogramSize doubles: count, sum, min,
+// max, then the bucket counts. Durations are in nanoseconds.
+
+#include "node_loop_metrics.h"
+#include "node.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace node {
+
+using v8::Arguments;
+using v8::Array;
+using v8::Exception;
+using v8::False;
+using v8::Handle;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::ThrowException;
+using v8::True;
+using v8::Undefined;
+using v8::Value;
+using v8::kExternalDoubleArray;
+
+static const int kSubBits = 4;
+static const int kSubBuckets = 1 << kSubBits;
+// Values from 2^(kMaxExponent + 1) up, 78 hours in nanoseconds, all end up
+// in the last bucket.
+static const int kMaxExponent = 47;
+static const int kBuckets = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+enum {
+  kCount,
+  kSum,
+  kMin,
+  kMax,
+  kHeaderSize
+};
+
+static const int kHistogramSize = kHeaderSize + kBuckets;
+
+enum {
+  // The phases, in uv_loop_phase order.
+  kTimers = UV_LOOP_PHASE_TIMERS,
+  kIdle = UV_LOOP_PHASE_IDLE,
+  kPrepare = UV_LOOP_PHASE_PREPARE,
+  kPending = UV_LOOP_PHASE_PENDING,
+  kPoll = UV_LOOP_PHASE_POLL,
+  kCheck = UV_LOOP_PHASE_CHECK,
+  kClosing = UV_LOOP_PHASE_CLOSING,
+  // Per iteration.
+  kPollWait = UV_LOOP_PHASE_MAX,
+  kBusy,
+  kIteration,
+  kEvents,
+  kCallbacks,
+  // Per call into JS.
+  kCallback,
+  kHistograms
+};
+
+static const char* const histogram_names[kHistograms] = {
+  "timers",
+  "idle",
+  "prepare",
+  "pending",
+  "poll",
+  "check",
+  "closing",
+  "pollWait",
+  "busy",
+  "iteration",
+  "events",
+  "callbacks",
+  "callback"
+};
+
+static double data[kHistograms * kHistogramSize];
+
+bool LoopMetrics::enabled;
+
+// Calls into JS made during the current iteration.
+static unsigned int callbacks;
+static unsigned int callback_depth;
+static uint64_t callback_start;
+
+
+static int BucketIndex(uint64_t value) {
+  if (value < static_cast<uint64_t>(kSubBuckets))
+    return static_cast<int>(value);
+
+  int exponent = 0;
+  for (int shift = 32; shift > 0; shift >>= 1) {
+    if (value >> (exponent + shift)) exponent += shift;
+  }
+
+  if (exponent > kMaxExponent)
+    return kBuckets - 1;
+
+  int sub = static_cast<int>(value >> (exponent - kSubBits)) &
+            (kSubBuckets - 1);
+  return (exponent - kSubBits + 1) * kSubBuckets + sub;
+}
+
+
+static void Record(int histogram, uint64_t value) {
+  double* h = data + histogram * kHistogramSize;
+  double v = static_cast<double>(value);
+
+  if (h[kCount] == 0 || v < h[kMin]) h[kMin] = v;
+  if (v > h[kMax]) h[kMax] = v;
+  h[kCount] += 1;
+  h[kSum] += v;
+  h[kHeaderSize + BucketIndex(value)] += 1;
+}
+
+
+static void OnIteration(uv_loop_t* loop, const uv_loop_metrics_t* metrics) {
+  uint64_t iteration = uv_hrtime() - metrics->start;
+  uint64_t poll_wait = metrics->poll_wait;
+
+  if (poll_wait > iteration) poll_wait = iteration;
+
+  for (int i = 0; i < UV_LOOP_PHASE_MAX; i++)
+    Record(i, metrics->phase_time[i]);
+
+  Record(kPollWait, poll_wait);
+  Record(kBusy, iteration - poll_wait);
+  Record(kIteration, iteration);
+  Record(kEvents, metrics->events);
+  Record(kCallbacks, callbacks);
+
+  callbacks = 0;
+}
+
+
+void LoopMetrics::EnterCallback() {
+  if (callback_depth++ == 0)
+    callback_start = uv_hrtime();
+}
+
+
+void LoopMetrics::ExitCallback() {
+  if (--callback_depth == 0) {
+    Record(kCallback, uv_hrtime() - callback_start);
+    callbacks++;
+  }
+}
+
+
+// start() returns false if the platform can't measure the loop.
+static Handle<Value> Start(const Arguments& args) {
+  HandleScope scope;
+
+  if (uv_loop_configure(uv_default_loop(), UV_LOOP_METRICS, OnIteration))
+    return scope.Close(False());
+
+  LoopMetrics::enabled = true;
+  return scope.Close(True());
+}
+
+
+static Handle<Value> Stop(const Arguments& args) {
+  HandleScope scope;
+
+  if (LoopMetrics::enabled) {
+    uv_loop_configure(uv_default_loop(),
+                      UV_LOOP_METRICS,
+                      static_cast<uv_loop_metrics_cb>(NULL));
+    LoopMetrics::enabled = false;
+  }
+
+  return Undefined();
+}
+
+
+static Handle<Value> Reset(const Arguments& args) {
+  HandleScope scope;
+
+  memset(data, 0, sizeof(data));
+  callbacks = 0;
+
+  return Undefined();
+}
+
+
+// snapshot(target) copies the histograms into a Float64Array.
+static Handle<Value> Snapshot(const Arguments& args) {
+  HandleScope scope;
+
+  if (!args[0]->IsObject())
+    return ThrowException(Exception::TypeError(
+        String::New("Argument must be a Float64Array")));
+
+  Local<Object> target = args[0]->ToObject();
+
+  if (target->GetIndexedPropertiesExternalArrayDataType() !=
+          kExternalDoubleArray ||
+      target->GetIndexedPropertiesExternalArrayDataLength() !=
+          kHistograms * kHistogramSize) {
+    return ThrowException(Exception::TypeError(
+        String::New("Argument must be a Float64Array of the right length")));
+  }
+
+  memcpy(target->GetIndexedPropertiesExternalArrayData(), data, sizeof(data));
+
+  return scope.Close(target);
+}
+
+
+void InitLoopMetrics(Handle<Object> target) {
+  HandleScope scope;
+
+  Local<Array> names = Array::New(kHistograms);
+  for (int i = 0; i < kHistograms; i++)
+    names->Set(i, String::NewSymbol(histogram_names[i]));
+
+  target->Set(String::NewSymbol("histograms"), names);
+  target->Set(String::NewSymbol("histogramSize"),
+              Integer::New(kHistogramSize));
+  target->Set(String::NewSymbol("subBits"), Integer::New(kSubBits));
+
+  NODE_SET_METHOD(target, "start", Start);
+  NODE_SET_METHOD(target, "stop", Stop);
+  NODE_SET_METHOD(target, "reset", Reset);
+  NODE_SET_METHOD(target, "snapshot", Snapshot);
+}
+
+
+}  // namespace node
+
+NODE_MODULE(node_loop_metrics, node::InitLoopMetrics)
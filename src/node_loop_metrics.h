@@ -0,0 +1,57 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SRC_NODE_LOOP_METRICS_H_
+#define SRC_NODE_LOOP_METRICS_H_
+
+namespace node {
+
+// Histograms of where the time goes in the event loop, for
+// process.loopMetrics. libuv measures the phases of every iteration, see
+// UV_LOOP_METRICS; the calls into JS are timed by MakeCallback().
+class LoopMetrics {
+ public:
+  // True while recording.
+  static bool enabled;
+
+  // Bracket a call into JS. Nested calls count as part of the outer one.
+  static void EnterCallback();
+  static void ExitCallback();
+};
+
+// Times a call into JS when metrics are being recorded.
+class LoopMetricsScope {
+ public:
+  LoopMetricsScope() : metered_(LoopMetrics::enabled) {
+    if (metered_) LoopMetrics::EnterCallback();
+  }
+
+  ~LoopMetricsScope() {
+    if (metered_) LoopMetrics::ExitCallback();
+  }
+
+ private:
+  bool metered_;
+};
+
+}  // namespace node
+
+#endif  // SRC_NODE_LOOP_METRICS_H_
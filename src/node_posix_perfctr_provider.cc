@@ -0,0 +1,228 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "node_posix_perfctr_provider.h"
+#include "node_counters.h"
+#include "uv.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace node {
+
+using v8::HeapStatistics;
+using v8::V8;
+
+// Gauges are refreshed this often, in milliseconds. A reader can tell that
+// the event loop is stuck from a sample_time that stops moving.
+static const uint64_t kSampleInterval = 100;
+
+static const char* const counter_names[PERFCTR_MAX] = {
+  "node.http.server.requests",    // PERFCTR_HTTP_SERVER_REQUESTS
+  "node.http.server.responses",   // PERFCTR_HTTP_SERVER_RESPONSES
+  "node.http.client.requests",    // PERFCTR_HTTP_CLIENT_REQUESTS
+  "node.http.client.responses",   // PERFCTR_HTTP_CLIENT_RESPONSES
+  "node.net.server.connections",  // PERFCTR_SERVER_CONNS
+  "node.net.server.accepted",     // PERFCTR_SERVER_CONNS_ACCEPTED
+  "node.net.bytesSent",           // PERFCTR_NET_BYTES_SENT
+  "node.net.bytesReceived",       // PERFCTR_NET_BYTES_RECV
+  "node.pipe.bytesSent",          // PERFCTR_PIPE_BYTES_SENT
+  "node.pipe.bytesReceived",      // PERFCTR_PIPE_BYTES_RECV
+  "node.gc.count",                // PERFCTR_GC_COUNT
+  "node.gc.pauseTotal",           // PERFCTR_GC_PAUSE_TOTAL
+  "node.gc.pauseMax",             // PERFCTR_GC_PAUSE_MAX
+  "node.gc.percentTime",          // PERFCTR_GC_PERCENTTIME
+  "node.loop.activeHandles",      // PERFCTR_ACTIVE_HANDLES
+  "node.threadpool.fs.queued",    // PERFCTR_THREADPOOL_FS_QUEUED
+  "node.threadpool.fs.threads",   // PERFCTR_THREADPOOL_FS_THREADS
+  "node.threadpool.dns.queued",   // PERFCTR_THREADPOOL_DNS_QUEUED
+  "node.threadpool.dns.threads",  // PERFCTR_THREADPOOL_DNS_THREADS
+  "node.threadpool.cpu.queued",   // PERFCTR_THREADPOOL_CPU_QUEUED
+  "node.threadpool.cpu.threads",  // PERFCTR_THREADPOOL_CPU_THREADS
+  "node.heap.total",              // PERFCTR_HEAP_TOTAL
+  "node.heap.used"                // PERFCTR_HEAP_USED
+};
+
+PerfDataEntry* perf_counters;
+
+static PerfDataHeader* perf_header;
+static char perf_path[PATH_MAX];
+static uv_timer_t sample_timer;
+
+
+static uint64_t WallClock() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+
+static void SetCounter(PerfCounter counter, uint64_t value) {
+  perf_counters[counter].value = value;
+}
+
+
+static void Sample(uv_timer_t* handle, int status) {
+  static const PerfCounter lane_counters[UV_WORK_LANE_MAX][2] = {
+    { PERFCTR_THREADPOOL_FS_QUEUED, PERFCTR_THREADPOOL_FS_THREADS },
+    { PERFCTR_THREADPOOL_DNS_QUEUED, PERFCTR_THREADPOOL_DNS_THREADS },
+    { PERFCTR_THREADPOOL_CPU_QUEUED, PERFCTR_THREADPOOL_CPU_THREADS }
+  };
+
+  if (perf_header == NULL)
+    return;
+
+  HeapStatistics heap;
+  V8::GetHeapStatistics(&heap);
+
+  // A seqlock: readers retry when sample_seq is odd or changed while they
+  // were copying the sampled counters.
+  perf_header->sample_seq++;
+  __sync_synchronize();
+
+  SetCounter(PERFCTR_ACTIVE_HANDLES, uv_default_loop()->active_handles);
+  for (int i = 0; i < UV_WORK_LANE_MAX; i++) {
+    uv_threadpool_stats_t stats;
+    if (uv_threadpool_stats(static_cast<uv_work_lane_t>(i), &stats) == 0) {
+      SetCounter(lane_counters[i][0], stats.queued);
+      SetCounter(lane_counters[i][1], stats.threads);
+    }
+  }
+  SetCounter(PERFCTR_HEAP_TOTAL, heap.total_heap_size());
+  SetCounter(PERFCTR_HEAP_USED, heap.used_heap_size());
+  perf_header->sample_time = WallClock();
+
+  __sync_synchronize();
+  perf_header->sample_seq++;
+}
+
+
+uint64_t NODE_COUNT_GET_GC_RAWTIME() {
+  return perf_counters != NULL ? uv_hrtime() : 0;
+}
+
+
+void NODE_COUNT_GC_PERCENTTIME(unsigned int percent) {
+  if (perf_counters != NULL)
+    SetCounter(PERFCTR_GC_PERCENTTIME, percent);
+}
+
+
+void NODE_COUNT_GC_PAUSE(uint64_t rawtime) {
+  if (perf_counters == NULL)
+    return;
+
+  perf_counters[PERFCTR_GC_COUNT].value++;
+  perf_counters[PERFCTR_GC_PAUSE_TOTAL].value += rawtime;
+  if (rawtime > perf_counters[PERFCTR_GC_PAUSE_MAX].value)
+    SetCounter(PERFCTR_GC_PAUSE_MAX, rawtime);
+}
+
+
+// Publishes the counters in $NODE_PERFDATA_DIR/<pid>. Does nothing when the
+// variable isn't set, the counters stay off and cost a NULL check each.
+void InitPerfCountersPosix() {
+  const char* dir = getenv("NODE_PERFDATA_DIR");
+  if (dir == NULL || dir[0] == '\0')
+    return;
+
+  int n = snprintf(perf_path,
+                   sizeof(perf_path),
+                   "%s/%d",
+                   dir,
+                   static_cast<int>(getpid()));
+  if (n < 0 || static_cast<size_t>(n) >= sizeof(perf_path)) {
+    fprintf(stderr, "node: NODE_PERFDATA_DIR is too long\n");
+    return;
+  }
+
+  if (mkdir(dir, 0755) && errno != EEXIST) {
+    fprintf(stderr, "node: cannot create %s: %s\n", dir, strerror(errno));
+    return;
+  }
+
+  // O_NOFOLLOW because the directory is likely shared, like /tmp is. A file
+  // left behind by an earlier process with the same pid gets truncated.
+  int fd = open(perf_path, O_RDWR | O_CREAT | O_TRUNC | O_NOFOLLOW, 0600);
+  if (fd == -1) {
+    fprintf(stderr, "node: cannot open %s: %s\n", perf_path, strerror(errno));
+    return;
+  }
+
+  size_t size = sizeof(PerfDataHeader) + PERFCTR_MAX * sizeof(PerfDataEntry);
+  void* base = MAP_FAILED;
+  if (ftruncate(fd, size) == 0) {
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  int err = errno;
+  close(fd);
+
+  if (base == MAP_FAILED) {
+    fprintf(stderr, "node: cannot map %s: %s\n", perf_path, strerror(err));
+    unlink(perf_path);
+    return;
+  }
+
+  PerfDataHeader* header = static_cast<PerfDataHeader*>(base);
+  PerfDataEntry* entries = reinterpret_cast<PerfDataEntry*>(header + 1);
+  for (int i = 0; i < PERFCTR_MAX; i++) {
+    strncpy(entries[i].name, counter_names[i], sizeof(entries[i].name) - 1);
+  }
+  header->version = NODE_PERFDATA_VERSION;
+  header->entries = PERFCTR_MAX;
+  header->pid = getpid();
+  header->start_time = WallClock();
+
+  perf_header = header;
+  perf_counters = entries;
+  Sample(NULL, 0);
+
+  // Readers ignore the file until the magic shows up.
+  __sync_synchronize();
+  memcpy(header->magic, NODE_PERFDATA_MAGIC, sizeof(header->magic));
+
+  uv_timer_init(uv_default_loop(), &sample_timer);
+  uv_timer_start(&sample_timer, Sample, kSampleInterval, kSampleInterval);
+  uv_unref(reinterpret_cast<uv_handle_t*>(&sample_timer));
+}
+
+
+// Also runs from the SIGINT and SIGTERM handlers, which can interrupt an
+// update of a counter. The mapping is left for the exiting process to drop.
+void TermPerfCountersPosix() {
+  if (perf_header == NULL)
+    return;
+
+  perf_counters = NULL;
+  perf_header = NULL;
+  unlink(perf_path);
+}
+
+}  // namespace node
@@ -0,0 +1,146 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SRC_NODE_POSIX_PERFCTR_PROVIDER_H_
+#define SRC_NODE_POSIX_PERFCTR_PROVIDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+
+// The counters are published in a file that other processes can map and
+// read without involving this one, see "Performance counters" in
+// doc/api/process.markdown. The file is a PerfDataHeader followed by one
+// PerfDataEntry per counter, in host byte order.
+//
+// The names are part of the file and readers look counters up by name, the
+// order of this enum can change between versions.
+enum PerfCounter {
+  PERFCTR_HTTP_SERVER_REQUESTS,
+  PERFCTR_HTTP_SERVER_RESPONSES,
+  PERFCTR_HTTP_CLIENT_REQUESTS,
+  PERFCTR_HTTP_CLIENT_RESPONSES,
+  PERFCTR_SERVER_CONNS,
+  PERFCTR_SERVER_CONNS_ACCEPTED,
+  PERFCTR_NET_BYTES_SENT,
+  PERFCTR_NET_BYTES_RECV,
+  PERFCTR_PIPE_BYTES_SENT,
+  PERFCTR_PIPE_BYTES_RECV,
+  PERFCTR_GC_COUNT,
+  PERFCTR_GC_PAUSE_TOTAL,
+  PERFCTR_GC_PAUSE_MAX,
+  PERFCTR_GC_PERCENTTIME,
+  // Sampled from a timer, see PerfDataHeader::sample_seq.
+  PERFCTR_ACTIVE_HANDLES,
+  PERFCTR_THREADPOOL_FS_QUEUED,
+  PERFCTR_THREADPOOL_FS_THREADS,
+  PERFCTR_THREADPOOL_DNS_QUEUED,
+  PERFCTR_THREADPOOL_DNS_THREADS,
+  PERFCTR_THREADPOOL_CPU_QUEUED,
+  PERFCTR_THREADPOOL_CPU_THREADS,
+  PERFCTR_HEAP_TOTAL,
+  PERFCTR_HEAP_USED,
+  PERFCTR_MAX
+};
+
+#define NODE_PERFDATA_MAGIC "NODEPERF"
+#define NODE_PERFDATA_VERSION 1
+
+struct PerfDataHeader {
+  char magic[8];          // NODE_PERFDATA_MAGIC, written last.
+  uint32_t version;       // NODE_PERFDATA_VERSION
+  uint32_t entries;       // Number of PerfDataEntry that follow.
+  uint64_t pid;
+  uint64_t start_time;    // Milliseconds since the epoch.
+  uint64_t sample_time;   // Milliseconds since the epoch.
+  uint64_t sample_seq;    // Odd while the sampled counters are written.
+  uint64_t reserved[2];
+};
+
+struct PerfDataEntry {
+  char name[56];          // NUL terminated.
+  uint64_t value;
+};
+
+// NULL unless the counters are being published.
+extern PerfDataEntry* perf_counters;
+
+inline bool NODE_COUNTER_ENABLED() { return perf_counters != NULL; }
+
+inline void NODE_COUNT_ADD(PerfCounter counter, uint64_t value) {
+  if (perf_counters != NULL) perf_counters[counter].value += value;
+}
+
+inline void NODE_COUNT_HTTP_SERVER_REQUEST() {
+  NODE_COUNT_ADD(PERFCTR_HTTP_SERVER_REQUESTS, 1);
+}
+
+inline void NODE_COUNT_HTTP_SERVER_RESPONSE() {
+  NODE_COUNT_ADD(PERFCTR_HTTP_SERVER_RESPONSES, 1);
+}
+
+inline void NODE_COUNT_HTTP_CLIENT_REQUEST() {
+  NODE_COUNT_ADD(PERFCTR_HTTP_CLIENT_REQUESTS, 1);
+}
+
+inline void NODE_COUNT_HTTP_CLIENT_RESPONSE() {
+  NODE_COUNT_ADD(PERFCTR_HTTP_CLIENT_RESPONSES, 1);
+}
+
+inline void NODE_COUNT_SERVER_CONN_OPEN() {
+  NODE_COUNT_ADD(PERFCTR_SERVER_CONNS, 1);
+  NODE_COUNT_ADD(PERFCTR_SERVER_CONNS_ACCEPTED, 1);
+}
+
+inline void NODE_COUNT_SERVER_CONN_CLOSE() {
+  NODE_COUNT_ADD(PERFCTR_SERVER_CONNS, static_cast<uint64_t>(-1));
+}
+
+inline void NODE_COUNT_NET_BYTES_SENT(int bytes) {
+  NODE_COUNT_ADD(PERFCTR_NET_BYTES_SENT, bytes);
+}
+
+inline void NODE_COUNT_NET_BYTES_RECV(int bytes) {
+  NODE_COUNT_ADD(PERFCTR_NET_BYTES_RECV, bytes);
+}
+
+inline void NODE_COUNT_PIPE_BYTES_SENT(int bytes) {
+  NODE_COUNT_ADD(PERFCTR_PIPE_BYTES_SENT, bytes);
+}
+
+inline void NODE_COUNT_PIPE_BYTES_RECV(int bytes) {
+  NODE_COUNT_ADD(PERFCTR_PIPE_BYTES_RECV, bytes);
+}
+
+// Nanoseconds, or 0 when the counters are off so that node_counters.cc
+// skips the GC bookkeeping.
+uint64_t NODE_COUNT_GET_GC_RAWTIME();
+void NODE_COUNT_GC_PERCENTTIME(unsigned int percent);
+void NODE_COUNT_GC_PAUSE(uint64_t rawtime);
+
+void InitPerfCountersPosix();
+void TermPerfCountersPosix();
+
+}  // namespace node
+
+#endif  // SRC_NODE_POSIX_PERFCTR_PROVIDER_H_
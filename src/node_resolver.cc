@@ -0,0 +1,1203 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// File lookups for Module._findPath() in lib/module.js.
+//
+// The candidate walk (<base>, <base><ext>, <base>/package.json's main,
+// <base>/index<ext> for every lookup path) runs here in one call. Instead of
+// a stat() per candidate, the parent directory is listed once and names that
+// aren't in the listing are known not to exist; a directory that can't be
+// listed because it doesn't exist answers for everything below it. Only the
+// names that are there get a stat(), to tell files from directories.
+//
+// Everything is kept for the life of the process. When a walk finds nothing
+// it is redone once more, checking every directory it relies on with a
+// stat(): a listing is redone if the directory changed since it was made,
+// and a directory that didn't exist is looked at again. That way a module
+// that was created after its directory was listed is still found, at the
+// cost of one stat() per directory rather than one per candidate.
+//
+// A name can be missing from the listing and still open: case-insensitive
+// filesystems (the default on OS X and Windows) find foo.js as Foo.js, and
+// HFS+ lists names in a different Unicode normalization than they may be
+// asked for. So a name that matches a listed one when ASCII case is ignored,
+// or that isn't plain ASCII, gets a stat() rather than taken as missing.
+//
+// Entries seeded from a manifest (NODE_RESOLVE_MANIFEST) were true when the
+// manifest was written. Each is checked once, the first time it is used:
+// the directory it is in gets the same stat() as in the walk above, so does
+// the entry itself if it is a listed directory, and a package.json main is
+// dropped if package.json changed since it was read.
+
+#include "node.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef _WIN32
+# define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+#endif
+
+namespace node {
+
+using v8::Arguments;
+using v8::Array;
+using v8::Exception;
+using v8::False;
+using v8::Function;
+using v8::Handle;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Local;
+using v8::Null;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::ThrowException;
+using v8::TryCatch;
+using v8::Undefined;
+using v8::Value;
+
+#define TYPE_ERROR(msg) ThrowException(Exception::TypeError(String::New(msg)))
+
+#ifdef _WIN32
+static const char kSep = '\\';
+#else
+static const char kSep = '/';
+#endif
+
+// Longer paths are looked up without the cache.
+static const size_t kMaxPath = 4096;
+
+// Directories with more entries than this aren't listed, their entries are
+// stat()ed one by one instead.
+static const unsigned int kMaxListing = 4096;
+
+// A listing is redone if the directory changed less than this many seconds
+// before it was made. Directory mtimes have a granularity of up to two
+// seconds (FAT), so a listing made in the same step as a change may miss it.
+static const double kMtimeSlack = 2;
+
+static inline bool IsSep(char c) {
+#ifdef _WIN32
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+
+class Resolver {
+ public:
+  enum Kind { kUnknown = 0, kMissing = 1, kFile = 2, kDir = 3 };
+
+  // Bits of an entry in the manifest, see Dump() and Load(). The time of
+  // the listing goes above them.
+  enum {
+    kKindMask = 3,
+    kListed = 4,
+    kEmpty = 8,
+    kUnlistable = 16,
+    kInListing = 32,
+    kFlagsSize = 64
+  };
+
+  enum Result { kNotFound, kFound, kError };
+
+  struct Stats {
+    double hits;
+    double readdirs;
+    double stats;
+    double package_reads;
+    double revalidations;
+  };
+
+  Resolver();
+
+  // Runs the candidate walk for every base path, stores the first match in
+  // |out|. Returns kError with a pending exception if a package.json can't
+  // be parsed.
+  Result FindPath(Handle<Array> bases,
+                  Handle<Array> exts,
+                  bool trailing_slash,
+                  char* out);
+
+  Local<Object> Dump();
+  void Load(Handle<Object> manifest);
+  void Forget(const char* path);
+  void Clear();
+  const Stats& stats() const { return stats_; }
+  unsigned int size() const { return size_; }
+
+ private:
+  struct Entry {
+    Entry* next;
+    uint32_t hash;
+    uint8_t kind;
+    uint8_t listed;      // All names in the directory are in the table.
+    uint8_t empty;       // Nothing exists below it (ENOENT or ENOTDIR).
+    uint8_t unlistable;  // Listing failed otherwise or was too long.
+    uint8_t in_listing;  // Seen in the listing of its directory.
+    uint8_t has_main;    // |main| below is valid.
+    char* main;          // package.json's main, NULL if there is none.
+    double listed_at;    // time() when the directory was listed.
+    unsigned int checked;  // Last generation it was revalidated in.
+    uint8_t loaded;      // From a manifest, not checked yet.
+    uint8_t main_loaded;  // |main| is from a manifest, not checked yet.
+    double main_at;      // time() when package.json was read.
+    char path[1];
+  };
+
+  static uint32_t Hash(const char* path, size_t len);
+  static uint32_t FoldedHash(const char* path, size_t len);
+  Entry* Find(const char* path, size_t len);
+  Entry* Insert(const char* path, size_t len, Kind kind);
+  void Rehash(unsigned int bucket_count);
+  void AddFolded(const char* path, size_t len);
+  bool MaybeListed(const char* path, size_t len);
+
+  Kind Lookup(const char* path, bool stat_unknown = true);
+  Kind StatPath(const char* path);
+  void List(Entry* dir);
+  Entry* Parent(const char* path, size_t len);
+  void Revalidate(Entry* dir);
+  void Recheck(Entry* dir);
+  void Verify(Entry* e);
+  void ForgetChildren(Entry* dir);
+  Result ReadMain(const char* dir, char** main);
+
+  Result TryFile(const char* path, char* out);
+  Result TryExtensions(const char* path, char* out);
+  Result TryPackage(const char* path, char* out);
+  Result Walk(char (*bases)[kMaxPath],
+              unsigned int base_count,
+              bool trailing_slash,
+              char* out);
+
+  Entry** buckets_;
+  unsigned int bucket_count_;
+  unsigned int size_;
+  // FoldedHash() of every listed name, 0 marks a free slot. Only grows,
+  // a stale hash costs a stat(). All names get a stat() once it is full.
+  uint32_t* folded_;
+  unsigned int folded_size_;
+  unsigned int folded_count_;
+  bool folded_full_;
+  // Set while a walk that found nothing is redone, see Revalidate().
+  bool revalidate_;
+  unsigned int generation_;
+  char (*exts_)[64];
+  unsigned int ext_count_;
+  Stats stats_;
+};
+
+
+static Resolver* resolver;
+
+
+Resolver::Resolver()
+    : buckets_(NULL),
+      bucket_count_(0),
+      size_(0),
+      folded_(NULL),
+      folded_size_(0),
+      folded_count_(0),
+      folded_full_(false),
+      revalidate_(false),
+      generation_(0),
+      exts_(NULL),
+      ext_count_(0) {
+  memset(&stats_, 0, sizeof(stats_));
+  Rehash(256);
+}
+
+
+uint32_t Resolver::Hash(const char* path, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<unsigned char>(path[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+
+// Hash() of |path| with ASCII letters in lower case, never 0.
+uint32_t Resolver::FoldedHash(const char* path, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = static_cast<unsigned char>(path[i]);
+    if (c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+
+void Resolver::AddFolded(const char* path, size_t len) {
+  if (folded_full_)
+    return;
+
+  if (2 * (folded_count_ + 1) > folded_size_) {
+    unsigned int size = folded_size_ == 0 ? 256 : folded_size_ * 2;
+    uint32_t* folded = static_cast<uint32_t*>(calloc(size, sizeof(*folded)));
+    if (folded == NULL) {
+      folded_full_ = true;
+      return;
+    }
+    for (unsigned int i = 0; i < folded_size_; i++) {
+      uint32_t hash = folded_[i];
+      if (hash == 0)
+        continue;
+      unsigned int j = hash & (size - 1);
+      while (folded[j] != 0)
+        j = (j + 1) & (size - 1);
+      folded[j] = hash;
+    }
+    free(folded_);
+    folded_ = folded;
+    folded_size_ = size;
+  }
+
+  uint32_t hash = FoldedHash(path, len);
+  unsigned int i = hash & (folded_size_ - 1);
+  while (folded_[i] != 0) {
+    if (folded_[i] == hash)
+      return;
+    i = (i + 1) & (folded_size_ - 1);
+  }
+  folded_[i] = hash;
+  folded_count_++;
+}
+
+
+// Whether |path|, which isn't in the listing of its directory, may still be
+// another spelling of a name that is, see the top of the file.
+bool Resolver::MaybeListed(const char* path, size_t len) {
+  if (folded_full_)
+    return true;
+
+  for (size_t i = len; i > 0 && !IsSep(path[i - 1]); i--) {
+    if (static_cast<unsigned char>(path[i - 1]) >= 0x80)
+      return true;
+  }
+
+  if (folded_size_ == 0)
+    return false;
+  uint32_t hash = FoldedHash(path, len);
+  unsigned int i = hash & (folded_size_ - 1);
+  while (folded_[i] != 0) {
+    if (folded_[i] == hash)
+      return true;
+    i = (i + 1) & (folded_size_ - 1);
+  }
+  return false;
+}
+
+
+void Resolver::Rehash(unsigned int bucket_count) {
+  Entry** buckets =
+      static_cast<Entry**>(calloc(bucket_count, sizeof(*buckets)));
+  if (buckets == NULL)
+    return;  // Keep the old table, chains just get longer.
+
+  for (unsigned int i = 0; i < bucket_count_; i++) {
+    Entry* e = buckets_[i];
+    while (e != NULL) {
+      Entry* next = e->next;
+      Entry** head = &buckets[e->hash & (bucket_count - 1)];
+      e->next = *head;
+      *head = e;
+      e = next;
+    }
+  }
+
+  free(buckets_);
+  buckets_ = buckets;
+  bucket_count_ = bucket_count;
+}
+
+
+Resolver::Entry* Resolver::Find(const char* path, size_t len) {
+  uint32_t hash = Hash(path, len);
+  Entry* e = buckets_[hash & (bucket_count_ - 1)];
+  while (e != NULL) {
+    if (e->hash == hash && memcmp(e->path, path, len) == 0 &&
+        e->path[len] == '\0') {
+      return e;
+    }
+    e = e->next;
+  }
+  return NULL;
+}
+
+
+Resolver::Entry* Resolver::Insert(const char* path, size_t len, Kind kind) {
+  Entry* e = static_cast<Entry*>(malloc(sizeof(*e) + len));
+  if (e == NULL)
+    return NULL;
+
+  memset(e, 0, sizeof(*e));
+  memcpy(e->path, path, len);
+  e->path[len] = '\0';
+  e->hash = Hash(path, len);
+  e->kind = kind;
+
+  if (size_ >= bucket_count_)
+    Rehash(bucket_count_ * 2);
+
+  Entry** head = &buckets_[e->hash & (bucket_count_ - 1)];
+  e->next = *head;
+  *head = e;
+  size_++;
+  return e;
+}
+
+
+void Resolver::Clear() {
+  for (unsigned int i = 0; i < bucket_count_; i++) {
+    Entry* e = buckets_[i];
+    while (e != NULL) {
+      Entry* next = e->next;
+      free(e->main);
+      free(e);
+      e = next;
+    }
+    buckets_[i] = NULL;
+  }
+  size_ = 0;
+
+  free(folded_);
+  folded_ = NULL;
+  folded_size_ = 0;
+  folded_count_ = 0;
+  folded_full_ = false;
+}
+
+
+Resolver::Kind Resolver::StatPath(const char* path) {
+  uv_fs_t req;
+  int r = uv_fs_stat(uv_default_loop(), &req, path, NULL);
+  stats_.stats++;
+  Kind kind = kMissing;
+  if (r == 0)
+    kind = S_ISDIR(req.statbuf.st_mode) ? kDir : kFile;
+  uv_fs_req_cleanup(&req);
+  return kind;
+}
+
+
+void Resolver::List(Entry* dir) {
+  uv_fs_t req;
+  dir->listed_at = static_cast<double>(time(NULL));
+  int r = uv_fs_readdir(uv_default_loop(), &req, dir->path, 0, NULL);
+  stats_.readdirs++;
+
+  if (r < 0) {
+    if (req.errorno == UV_ENOENT) {
+      dir->kind = kMissing;
+      dir->empty = 1;
+    } else if (req.errorno == UV_ENOTDIR) {
+      dir->empty = 1;
+    } else {
+      dir->unlistable = 1;
+    }
+    uv_fs_req_cleanup(&req);
+    return;
+  }
+
+  dir->kind = kDir;
+  if (static_cast<unsigned int>(r) > kMaxListing) {
+    dir->unlistable = 1;
+    uv_fs_req_cleanup(&req);
+    return;
+  }
+
+  size_t dir_len = strlen(dir->path);
+  bool has_sep = dir_len > 0 && IsSep(dir->path[dir_len - 1]);
+  char path[kMaxPath];
+  const char* name = static_cast<const char*>(req.ptr);
+  bool complete = true;
+
+  for (int i = 0; i < r && complete; i++) {
+    size_t name_len = strlen(name);
+    size_t len = dir_len + !has_sep + name_len;
+    if (len < sizeof(path)) {
+      memcpy(path, dir->path, dir_len);
+      if (!has_sep) path[dir_len] = kSep;
+      memcpy(path + dir_len + !has_sep, name, name_len);
+      path[len] = '\0';
+      Entry* e = Find(path, len);
+      if (e == NULL)
+        e = Insert(path, len, kUnknown);
+      if (e != NULL)
+        e->in_listing = 1;
+      else
+        complete = false;
+      AddFolded(path, len);
+    }
+    name += name_len + 1;
+  }
+
+  // Names that didn't make it into the table must not be taken as missing.
+  if (complete)
+    dir->listed = 1;
+  else
+    dir->unlistable = 1;
+
+  uv_fs_req_cleanup(&req);
+}
+
+
+// Called for the parent directory of every path a walk that found nothing
+// looks at, once per walk.
+void Resolver::Revalidate(Entry* dir) {
+  if (dir->checked == generation_)
+    return;
+  dir->checked = generation_;
+
+  // Known to be missing from a parent that was just checked.
+  if (dir->kind == kMissing) {
+    Entry* parent = Parent(dir->path, strlen(dir->path));
+    if (parent != NULL && parent->checked == generation_ &&
+        (parent->listed || parent->empty)) {
+      return;
+    }
+  }
+
+  stats_.revalidations++;
+  Recheck(dir);
+}
+
+
+// Looks at the directory again: its listing is dropped if it changed since
+// the listing was made, or if it isn't a directory any more.
+void Resolver::Recheck(Entry* dir) {
+  dir->loaded = 0;
+
+  uv_fs_t req;
+  int r = uv_fs_stat(uv_default_loop(), &req, dir->path, NULL);
+  stats_.stats++;
+
+  if (r < 0) {
+    if (dir->listed)
+      ForgetChildren(dir);
+    dir->kind = kMissing;
+    dir->listed = 0;
+    dir->empty = 1;
+  } else if (S_ISDIR(req.statbuf.st_mode)) {
+    if (dir->listed &&
+        static_cast<double>(req.statbuf.st_mtime) >
+            dir->listed_at - kMtimeSlack) {
+      ForgetChildren(dir);
+      dir->listed = 0;
+    }
+    dir->kind = kDir;
+    dir->empty = 0;
+  } else {
+    if (dir->listed)
+      ForgetChildren(dir);
+    dir->kind = kFile;
+    dir->listed = 0;
+    dir->empty = 1;
+  }
+
+  uv_fs_req_cleanup(&req);
+}
+
+
+// Checks an entry from a manifest before it is used, see the top of the file.
+void Resolver::Verify(Entry* e) {
+  e->loaded = 0;
+
+  Entry* dir = Parent(e->path, strlen(e->path));
+  if (dir != NULL && dir->loaded)
+    Verify(dir);
+
+  // A kind that a listing doesn't vouch for came from a stat() that can't be
+  // checked without doing it again.
+  if (dir == NULL || !dir->listed || !e->in_listing)
+    e->kind = kUnknown;
+
+  if (e->listed || e->empty)
+    Recheck(e);
+}
+
+
+// The directory's listing is out of date, so is what is known about the
+// names in it. Their entries stay, pointers to them may be held.
+void Resolver::ForgetChildren(Entry* dir) {
+  size_t dir_len = strlen(dir->path);
+  bool has_sep = dir_len > 0 && IsSep(dir->path[dir_len - 1]);
+
+  for (unsigned int i = 0; i < bucket_count_; i++) {
+    for (Entry* e = buckets_[i]; e != NULL; e = e->next) {
+      if (strncmp(e->path, dir->path, dir_len) != 0)
+        continue;
+      const char* name = e->path + dir_len;
+      if (!has_sep) {
+        if (!IsSep(*name))
+          continue;
+        name++;
+      }
+      if (*name == '\0')
+        continue;
+      while (*name != '\0' && !IsSep(*name))
+        name++;
+      if (*name == '\0') {
+        e->kind = kUnknown;
+        e->in_listing = 0;
+      }
+    }
+  }
+}
+
+
+// Drops what is known about |path|, its directory's listing and the
+// package.json mains above it. For a result that turned out not to exist.
+void Resolver::Forget(const char* path) {
+  size_t len = strlen(path);
+  if (len >= kMaxPath)
+    return;
+
+  Entry* e = Find(path, len);
+  if (e != NULL) {
+    e->kind = kUnknown;
+    e->loaded = 0;
+  }
+
+  Entry* dir = Parent(path, len);
+  if (dir != NULL && dir->listed) {
+    ForgetChildren(dir);
+    dir->listed = 0;
+  }
+
+  for (; dir != NULL; dir = Parent(dir->path, strlen(dir->path))) {
+    if (dir->has_main) {
+      free(dir->main);
+      dir->main = NULL;
+      dir->has_main = 0;
+      dir->main_loaded = 0;
+    }
+  }
+}
+
+
+// Returns the entry of the directory |path| is in, NULL for the root.
+Resolver::Entry* Resolver::Parent(const char* path, size_t len) {
+  // Keep the separator for the root.
+  size_t dir_len = len;
+  while (dir_len > 0 && !IsSep(path[dir_len - 1]))
+    dir_len--;
+  if (dir_len > 1 && path[dir_len - 2] != ':')
+    dir_len--;
+
+  if (dir_len == 0 || dir_len >= len)
+    return NULL;
+
+  Entry* dir = Find(path, dir_len);
+  if (dir == NULL)
+    dir = Insert(path, dir_len, kUnknown);
+  return dir;
+}
+
+
+// Returns what |path| is. With |stat_unknown| false, returns kUnknown instead
+// of calling stat() for a name that is in its directory.
+Resolver::Kind Resolver::Lookup(const char* path, bool stat_unknown) {
+  size_t len = strlen(path);
+  if (len >= kMaxPath)
+    return StatPath(path);
+
+  Entry* e;
+  if (!revalidate_) {
+    e = Find(path, len);
+    if (e != NULL && e->loaded)
+      Verify(e);
+    if (e != NULL && e->kind != kUnknown) {
+      stats_.hits++;
+      return static_cast<Kind>(e->kind);
+    }
+  }
+
+  Entry* dir = Parent(path, len);
+  if (dir != NULL) {
+    if (dir->loaded)
+      Verify(dir);
+    if (revalidate_)
+      Revalidate(dir);
+    // Ask the directory above rather than fail to list one that isn't there.
+    // Listing one that is there tells it's a directory, no need to stat().
+    if (dir->kind == kUnknown)
+      dir->kind = Lookup(dir->path, false);
+    if (dir->kind == kMissing || dir->kind == kFile)
+      dir->empty = 1;
+    if (!dir->listed && !dir->empty && !dir->unlistable)
+      List(dir);
+  }
+
+  e = Find(path, len);
+  if (e != NULL && e->kind != kUnknown) {
+    stats_.hits++;
+    return static_cast<Kind>(e->kind);
+  }
+
+  // The directory answers for names that aren't there, they don't get an
+  // entry of their own unless they are directories that were looked in.
+  if (dir != NULL &&
+      (dir->empty || (dir->listed && (e == NULL || !e->in_listing) &&
+                      !MaybeListed(path, len)))) {
+    stats_.hits++;
+    if (e != NULL)
+      e->kind = kMissing;
+    return kMissing;
+  }
+
+  if (e == NULL) {
+    e = Insert(path, len, kUnknown);
+    if (e == NULL)
+      return StatPath(path);
+  }
+
+  if (!stat_unknown)
+    return kUnknown;
+  e->kind = StatPath(path);
+  return static_cast<Kind>(e->kind);
+}
+
+
+// Reads <dir>/package.json and returns its main field in |main|, NULL if
+// there's no package.json or no main. The result is owned by the cache.
+Resolver::Result Resolver::ReadMain(const char* dir, char** main) {
+  *main = NULL;
+
+  size_t dir_len = strlen(dir);
+  Entry* e = NULL;
+  if (dir_len < kMaxPath) {
+    e = Find(dir, dir_len);
+    // A package.json may have shown up since, the walk that checks again
+    // looks for it.
+    if (e != NULL && e->has_main && !e->main_loaded &&
+        (e->main != NULL || !revalidate_)) {
+      *main = e->main;
+      return kFound;
+    }
+  }
+
+  char json_path[kMaxPath];
+  if (dir_len + sizeof("/package.json") > sizeof(json_path))
+    return kFound;
+  memcpy(json_path, dir, dir_len);
+  json_path[dir_len] = kSep;
+  memcpy(json_path + dir_len + 1, "package.json", sizeof("package.json"));
+
+  // A main from a manifest holds while package.json is as it was then.
+  if (e != NULL && e->main_loaded) {
+    e->main_loaded = 0;
+    uv_fs_t req;
+    int r = uv_fs_stat(uv_default_loop(), &req, json_path, NULL);
+    stats_.stats++;
+    bool fresh = r < 0 ? e->main == NULL
+                       : static_cast<double>(req.statbuf.st_mtime) <=
+                             e->main_at - kMtimeSlack;
+    uv_fs_req_cleanup(&req);
+    if (fresh) {
+      *main = e->main;
+      return kFound;
+    }
+  }
+
+  double main_at = static_cast<double>(time(NULL));
+
+  char* json = NULL;
+  size_t json_len = 0;
+
+  if (Lookup(json_path) == kFile) {
+    uv_loop_t* loop = uv_default_loop();
+    uv_fs_t req;
+    int fd = uv_fs_open(loop, &req, json_path, O_RDONLY, 0, NULL);
+    uv_fs_req_cleanup(&req);
+    if (fd >= 0) {
+      stats_.package_reads++;
+      size_t size = 4096;
+      json = static_cast<char*>(malloc(size));
+      for (;;) {
+        if (json == NULL)
+          break;
+        if (json_len == size) {
+          char* grown = static_cast<char*>(realloc(json, size * 2));
+          if (grown == NULL) {
+            free(json);
+            json = NULL;
+            break;
+          }
+          json = grown;
+          size *= 2;
+        }
+        int r = uv_fs_read(loop,
+                           &req,
+                           fd,
+                           json + json_len,
+                           size - json_len,
+                           -1,
+                           NULL);
+        uv_fs_req_cleanup(&req);
+        if (r < 0) {
+          free(json);
+          json = NULL;
+          break;
+        }
+        if (r == 0)
+          break;
+        json_len += r;
+      }
+      uv_fs_close(loop, &req, fd, NULL);
+      uv_fs_req_cleanup(&req);
+    }
+  }
+
+  if (json != NULL) {
+    HandleScope scope;
+    Local<Object> global = v8::Context::GetCurrent()->Global();
+    Local<Object> JSON = global->Get(String::NewSymbol("JSON"))->ToObject();
+    Local<Function> parse =
+        Local<Function>::Cast(JSON->Get(String::NewSymbol("parse")));
+    Local<Value> argv[] = { String::New(json, json_len) };
+    free(json);
+
+    TryCatch try_catch;
+    Local<Value> pkg = parse->Call(JSON, 1, argv);
+    if (pkg.IsEmpty()) {
+      // Same error as readPackage() used to throw.
+      Local<Value> err = try_catch.Exception();
+      if (err->IsObject()) {
+        Local<Object> obj = err->ToObject();
+        Local<String> path = String::New(json_path);
+        obj->Set(String::NewSymbol("path"), path);
+        obj->Set(String::NewSymbol("message"),
+                 String::Concat(
+                     String::Concat(String::New("Error parsing "), path),
+                     String::Concat(String::New(": "),
+                                    obj->Get(String::NewSymbol("message"))
+                                        ->ToString())));
+      }
+      try_catch.ReThrow();
+      return kError;
+    }
+
+    if (pkg->IsObject()) {
+      Local<Value> value = pkg->ToObject()->Get(String::NewSymbol("main"));
+      if (value->IsString() && value->ToString()->Length() > 0) {
+        String::Utf8Value utf8(value);
+        *main = strdup(*utf8);
+      }
+    }
+  }
+
+  if (dir_len >= kMaxPath)
+    return kFound;  // Not kept, rare enough to leak.
+
+  if (e == NULL)
+    e = Find(dir, dir_len);
+  if (e == NULL)
+    e = Insert(dir, dir_len, kUnknown);
+  if (e != NULL) {
+    free(e->main);
+    e->main = *main;
+    e->has_main = 1;
+    e->main_loaded = 0;
+    e->main_at = main_at;
+  }
+  return kFound;
+}
+
+
+// Joins |base| and |rel| like path.resolve() would, dropping '.' and '..'
+// segments and empty ones. |rel| may be absolute.
+static bool ResolvePath(const char* base, const char* rel, char* out) {
+  char buf[kMaxPath];
+  bool absolute = IsSep(rel[0]);
+#ifdef _WIN32
+  absolute = absolute || (rel[0] != '\0' && rel[1] == ':');
+#endif
+  int n = absolute ? snprintf(buf, sizeof(buf), "%s", rel)
+                   : snprintf(buf, sizeof(buf), "%s%c%s", base, kSep, rel);
+  if (n < 0 || static_cast<size_t>(n) >= sizeof(buf))
+    return false;
+
+  // Copy the root (a separator, or a drive and a separator) as is.
+  const char* p = buf;
+  char* o = out;
+#ifdef _WIN32
+  if (p[0] != '\0' && p[1] == ':') {
+    *o++ = *p++;
+    *o++ = *p++;
+  }
+#endif
+  if (IsSep(*p)) {
+    *o++ = kSep;
+    p++;
+  }
+  char* root_end = o;
+
+  while (*p != '\0') {
+    const char* seg = p;
+    while (*p != '\0' && !IsSep(*p))
+      p++;
+    size_t seg_len = p - seg;
+    if (*p != '\0')
+      p++;
+
+    if (seg_len == 0 || (seg_len == 1 && seg[0] == '.'))
+      continue;
+
+    if (seg_len == 2 && seg[0] == '.' && seg[1] == '.') {
+      // Back up to the previous separator, but not past the root.
+      if (o > root_end) {
+        o--;
+        while (o > root_end && !IsSep(o[-1]))
+          o--;
+        if (o > root_end)
+          o--;
+      }
+      continue;
+    }
+
+    if (o > root_end)
+      *o++ = kSep;
+    memcpy(o, seg, seg_len);
+    o += seg_len;
+  }
+  *o = '\0';
+  return true;
+}
+
+
+Resolver::Result Resolver::TryFile(const char* path, char* out) {
+  if (Lookup(path) != kFile)
+    return kNotFound;
+  snprintf(out, kMaxPath, "%s", path);
+  return kFound;
+}
+
+
+Resolver::Result Resolver::TryExtensions(const char* path, char* out) {
+  char buf[kMaxPath];
+  for (unsigned int i = 0; i < ext_count_; i++) {
+    int n = snprintf(buf, sizeof(buf), "%s%s", path, exts_[i]);
+    if (n < 0 || static_cast<size_t>(n) >= sizeof(buf))
+      continue;
+    if (TryFile(buf, out) == kFound)
+      return kFound;
+  }
+  return kNotFound;
+}
+
+
+Resolver::Result Resolver::TryPackage(const char* path, char* out) {
+  char* main;
+  if (ReadMain(path, &main) == kError)
+    return kError;
+  if (main == NULL)
+    return kNotFound;
+
+  char filename[kMaxPath];
+  char index[kMaxPath];
+  Result r = kNotFound;
+  if (ResolvePath(path, main, filename)) {
+    r = TryFile(filename, out);
+    if (r == kNotFound)
+      r = TryExtensions(filename, out);
+    if (r == kNotFound && ResolvePath(filename, "index", index))
+      r = TryExtensions(index, out);
+  }
+
+  return r;
+}
+
+
+Resolver::Result Resolver::Walk(char (*bases)[kMaxPath],
+                                unsigned int base_count,
+                                bool trailing_slash,
+                                char* out) {
+  char index[kMaxPath];
+
+  for (unsigned int i = 0; i < base_count; i++) {
+    const char* base = bases[i];
+    Result r = kNotFound;
+
+    if (!trailing_slash) {
+      r = TryFile(base, out);
+      if (r == kNotFound)
+        r = TryExtensions(base, out);
+    }
+    if (r == kNotFound)
+      r = TryPackage(base, out);
+    if (r == kNotFound && ResolvePath(base, "index", index))
+      r = TryExtensions(index, out);
+
+    if (r != kNotFound)
+      return r;
+  }
+
+  return kNotFound;
+}
+
+
+Resolver::Result Resolver::FindPath(Handle<Array> bases_array,
+                                    Handle<Array> exts_array,
+                                    bool trailing_slash,
+                                    char* out) {
+  unsigned int base_count = bases_array->Length();
+  char (*bases)[kMaxPath] =
+      static_cast<char (*)[kMaxPath]>(malloc(base_count * kMaxPath + 1));
+  ext_count_ = exts_array->Length();
+  exts_ = static_cast<char (*)[64]>(malloc(ext_count_ * 64 + 1));
+  if (bases == NULL || exts_ == NULL) {
+    free(bases);
+    free(exts_);
+    exts_ = NULL;
+    return kNotFound;
+  }
+
+  for (unsigned int i = 0; i < base_count; i++) {
+    String::Utf8Value base(bases_array->Get(i));
+    snprintf(bases[i], kMaxPath, "%s", *base ? *base : "");
+  }
+  for (unsigned int i = 0; i < ext_count_; i++) {
+    String::Utf8Value ext(exts_array->Get(i));
+    snprintf(exts_[i], 64, "%s", *ext ? *ext : "");
+  }
+
+  Result r = Walk(bases, base_count, trailing_slash, out);
+
+  if (r == kNotFound) {
+    // The cache may be out of date, check the directories it used.
+    generation_++;
+    revalidate_ = true;
+    r = Walk(bases, base_count, trailing_slash, out);
+    revalidate_ = false;
+  }
+
+  free(bases);
+  free(exts_);
+  exts_ = NULL;
+  return r;
+}
+
+
+Local<Object> Resolver::Dump() {
+  HandleScope scope;
+  Local<Object> entries = Object::New();
+  Local<Object> mains = Object::New();
+
+  for (unsigned int i = 0; i < bucket_count_; i++) {
+    for (Entry* e = buckets_[i]; e != NULL; e = e->next) {
+      Local<String> path = String::New(e->path);
+      int bits = e->kind |
+                 (e->listed ? kListed : 0) |
+                 (e->empty ? kEmpty : 0) |
+                 (e->unlistable ? kUnlistable : 0) |
+                 (e->in_listing ? kInListing : 0);
+      entries->Set(path, Number::New(bits + e->listed_at * kFlagsSize));
+      if (e->has_main) {
+        // [main or null, time() when package.json was read]
+        Local<Array> main = Array::New(2);
+        if (e->main != NULL)
+          main->Set(0, String::New(e->main));
+        else
+          main->Set(0, Null());
+        main->Set(1, Number::New(e->main_at));
+        mains->Set(path, main);
+      }
+    }
+  }
+
+  Local<Object> manifest = Object::New();
+  manifest->Set(String::NewSymbol("entries"), entries);
+  manifest->Set(String::NewSymbol("mains"), mains);
+  return scope.Close(manifest);
+}
+
+
+void Resolver::Load(Handle<Object> manifest) {
+  HandleScope scope;
+  Local<Value> entries_value = manifest->Get(String::NewSymbol("entries"));
+  Local<Value> mains_value = manifest->Get(String::NewSymbol("mains"));
+
+  if (entries_value->IsObject()) {
+    Local<Object> entries = entries_value->ToObject();
+    Local<Array> paths = entries->GetOwnPropertyNames();
+    for (unsigned int i = 0; i < paths->Length(); i++) {
+      Local<Value> path = paths->Get(i);
+      String::Utf8Value utf8(path);
+      size_t len = utf8.length();
+      if (len >= kMaxPath)
+        continue;
+      double value = entries->Get(path)->NumberValue();
+      if (!(value >= 0))
+        continue;
+      int bits = static_cast<int>(fmod(value, kFlagsSize));
+      Entry* e = Find(*utf8, len);
+      if (e == NULL)
+        e = Insert(*utf8, len, kUnknown);
+      if (e == NULL)
+        break;
+      e->kind = bits & kKindMask;
+      e->listed = (bits & kListed) != 0;
+      e->empty = (bits & kEmpty) != 0;
+      e->unlistable = (bits & kUnlistable) != 0;
+      e->in_listing = (bits & kInListing) != 0;
+      e->listed_at = floor(value / kFlagsSize);
+      e->loaded = 1;
+      if (e->in_listing)
+        AddFolded(*utf8, len);
+    }
+  }
+
+  if (mains_value->IsObject()) {
+    Local<Object> mains = mains_value->ToObject();
+    Local<Array> paths = mains->GetOwnPropertyNames();
+    for (unsigned int i = 0; i < paths->Length(); i++) {
+      Local<Value> path = paths->Get(i);
+      String::Utf8Value utf8(path);
+      size_t len = utf8.length();
+      if (len >= kMaxPath)
+        continue;
+      Entry* e = Find(*utf8, len);
+      if (e == NULL)
+        e = Insert(*utf8, len, kUnknown);
+      if (e == NULL)
+        break;
+      Local<Value> value = mains->Get(path);
+      if (!value->IsArray())
+        continue;
+      Local<Array> pair = value.As<Array>();
+      Local<Value> main = pair->Get(0);
+      double main_at = pair->Get(1)->NumberValue();
+      if (!(main_at >= 0))
+        continue;
+      free(e->main);
+      e->main = NULL;
+      if (main->IsString())
+        e->main = strdup(*String::Utf8Value(main));
+      e->has_main = 1;
+      e->main_loaded = 1;
+      e->main_at = main_at;
+    }
+  }
+}
+
+
+static Handle<Value> FindPath(const Arguments& args) {
+  HandleScope scope;
+
+  if (!args[0]->IsArray() || !args[1]->IsArray())
+    return TYPE_ERROR("paths and extensions must be arrays");
+
+  char out[kMaxPath];
+  Resolver::Result r = resolver->FindPath(args[0].As<Array>(),
+                                          args[1].As<Array>(),
+                                          args[2]->IsTrue(),
+                                          out);
+  if (r == Resolver::kError)
+    return Handle<Value>();  // Exception pending.
+  if (r == Resolver::kNotFound)
+    return scope.Close(False());
+  return scope.Close(String::New(out));
+}
+
+
+static Handle<Value> Dump(const Arguments& args) {
+  HandleScope scope;
+  return scope.Close(resolver->Dump());
+}
+
+
+static Handle<Value> Load(const Arguments& args) {
+  HandleScope scope;
+  if (!args[0]->IsObject())
+    return TYPE_ERROR("manifest must be an object");
+  resolver->Load(args[0]->ToObject());
+  return Undefined();
+}
+
+
+static Handle<Value> Forget(const Arguments& args) {
+  HandleScope scope;
+  String::Utf8Value path(args[0]);
+  if (*path != NULL)
+    resolver->Forget(*path);
+  return Undefined();
+}
+
+
+static Handle<Value> Clear(const Arguments& args) {
+  HandleScope scope;
+  resolver->Clear();
+  return Undefined();
+}
+
+
+static Handle<Value> GetStats(const Arguments& args) {
+  HandleScope scope;
+  const Resolver::Stats& stats = resolver->stats();
+  Local<Object> obj = Object::New();
+  obj->Set(String::NewSymbol("entries"), Integer::NewFromUnsigned(
+      resolver->size()));
+  obj->Set(String::NewSymbol("hits"), Number::New(stats.hits));
+  obj->Set(String::NewSymbol("readdirs"), Number::New(stats.readdirs));
+  obj->Set(String::NewSymbol("stats"), Number::New(stats.stats));
+  obj->Set(String::NewSymbol("packageReads"),
+           Number::New(stats.package_reads));
+  obj->Set(String::NewSymbol("revalidations"),
+           Number::New(stats.revalidations));
+  return scope.Close(obj);
+}
+
+
+void InitResolver(Handle<Object> target) {
+  HandleScope scope;
+
+  if (resolver == NULL)
+    resolver = new Resolver();
+
+  NODE_SET_METHOD(target, "findPath", FindPath);
+  NODE_SET_METHOD(target, "dump", Dump);
+  NODE_SET_METHOD(target, "load", Load);
+  NODE_SET_METHOD(target, "forget", Forget);
+  NODE_SET_METHOD(target, "clear", Clear);
+  NODE_SET_METHOD(target, "getStats", GetStats);
+}
+
+
+}  // namespace node
+
+NODE_MODULE(node_resolver, node::InitResolver)
@@ -20,6 +20,8 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "node.h"
+#include "node_buffer.h"
+#include "node_javascript.h"
 #include "node_script.h"
 #include <assert.h>
 
@@ -27,6 +29,8 @@ namespace node {
 
 using v8::Context;
 using v8::Script;
+using v8::ScriptData;
+using v8::ScriptOrigin;
 using v8::Value;
 using v8::Handle;
 using v8::HandleScope;
@@ -42,6 +46,7 @@ using v8::Persistent;
 using v8::Integer;
 using v8::Function;
 using v8::FunctionTemplate;
+using v8::Undefined;
 
 
 class WrappedContext : ObjectWrap {
@@ -94,6 +99,7 @@ class WrappedScript : ObjectWrap {
   static Handle<Value> CompileRunInContext(const Arguments& args);
   static Handle<Value> CompileRunInThisContext(const Arguments& args);
   static Handle<Value> CompileRunInNewContext(const Arguments& args);
+  static Handle<Value> PreCompile(const Arguments& args);
 
   Persistent<Script> script_;
 };
@@ -161,6 +167,7 @@ Handle<Value> WrappedContext::New(const Arguments& args) {
 
 WrappedContext::WrappedContext() : ObjectWrap() {
   context_ = Context::New();
+  DeleteSnapshot(context_);
 }
 
 
@@ -226,6 +233,10 @@ void WrappedScript::Initialize(Handle<Object> target) {
                   "runInNewContext",
                   WrappedScript::CompileRunInNewContext);
 
+  NODE_SET_METHOD(constructor_template,
+                  "precompile",
+                  WrappedScript::PreCompile);
+
   target->Set(String::NewSymbol("NodeScript"),
               constructor_template->GetFunction());
 }
@@ -308,6 +319,29 @@ Handle<Value> WrappedScript::CompileRunInNewContext(const Arguments& args) {
 }
 
 
+// Returns V8's preparse data for |code| in a buffer, to pass back to
+// runInThisContext() and friends later. Returns undefined if |code| has
+// a syntax error.
+Handle<Value> WrappedScript::PreCompile(const Arguments& args) {
+  HandleScope scope;
+
+  if (args.Length() < 1) {
+    return ThrowException(Exception::TypeError(
+          String::New("needs at least 'code' argument.")));
+  }
+
+  ScriptData* data = ScriptData::PreCompile(args[0]->ToString());
+  if (data->HasError()) {
+    delete data;
+    return Undefined();
+  }
+
+  Buffer* buf = Buffer::New(data->Data(), data->Length());
+  delete data;
+  return scope.Close(buf->handle_);
+}
+
+
 template <WrappedScript::EvalInputFlags input_flag,
           WrappedScript::EvalContextFlags context_flag,
           WrappedScript::EvalOutputFlags output_flag>
@@ -345,6 +379,17 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
                            ? args[filename_index]->ToString()
                            : String::New("evalmachine.<anonymous>");
 
+  // Optional preparse data from precompile(), V8 ignores it if it is
+  // malformed.
+  const int pre_data_index = filename_index + 1;
+  ScriptData* pre_data = NULL;
+  if (input_flag == compileCode &&
+      args.Length() > pre_data_index &&
+      Buffer::HasInstance(args[pre_data_index])) {
+    Local<Object> buf = args[pre_data_index].As<Object>();
+    pre_data = ScriptData::New(Buffer::Data(buf), Buffer::Length(buf));
+  }
+
   const int display_error_index = args.Length() - 1;
   bool display_error = false;
   if (args.Length() > display_error_index &&
@@ -365,6 +410,7 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
     Persistent<Context> tmp = Context::New();
     context = Local<Context>::New(tmp);
     tmp.Dispose();
+    DeleteSnapshot(context);
 
   } else if (context_flag == userContext) {
     // Use the passed in context
@@ -390,8 +436,11 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
   if (input_flag == compileCode) {
     // well, here WrappedScript::New would suffice in all cases, but maybe
     // Compile has a little better performance where possible
-    script = output_flag == returnResult ? Script::Compile(code, filename)
-                                         : Script::New(code, filename);
+    ScriptOrigin origin(filename);
+    script = output_flag == returnResult
+        ? Script::Compile(code, &origin, pre_data)
+        : Script::New(code, &origin, pre_data);
+    delete pre_data;
     if (script.IsEmpty()) {
       // FIXME UGLY HACK TO DISPLAY SYNTAX ERRORS.
       if (display_error) DisplayExceptionLine(try_catch);
@@ -0,0 +1,468 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// The binary message format of IPC channels that are opened with
+// `serialization: 'binary'`, see setupChannel() in lib/child_process.js.
+//
+// Every message is a frame: a uint32 with the size of the payload, then the
+// payload, a single tagged value. Both ends of a channel run on the same
+// machine so numbers are kept in native byte order.
+//
+//   '_'                          undefined
+//   '0'                          null
+//   'T', 'F'                     true, false
+//   'i' int32                    small integers
+//   'd' double                   all other numbers
+//   'D' double                   Dates, as milliseconds since the epoch
+//   's' uint32 bytes             strings, UTF-8
+//   'b' uint32 bytes             Buffers
+//   'a' uint32 values            arrays
+//   'o' uint32 (key value)       objects, keys being length prefixed UTF-8
+//
+// Like JSON.stringify(), only own enumerable properties are sent and
+// functions are left out of objects and turned into null in arrays.
+// Buffers are sent as bytes, and NaN, Infinity and undefined survive.
+
+#include "node.h"
+#include "node_buffer.h"
+#include "buffer_pool.h"
+#include "string_bytes.h"
+#include "v8.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace node {
+
+using v8::Arguments;
+using v8::Array;
+using v8::Date;
+using v8::Exception;
+using v8::False;
+using v8::Handle;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Local;
+using v8::Null;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::ThrowException;
+using v8::True;
+using v8::TryCatch;
+using v8::Undefined;
+using v8::Value;
+
+#define TYPE_ERROR(msg) ThrowException(Exception::TypeError(String::New(msg)))
+
+// Deep enough for any sane message, shallow enough to catch cycles long
+// before the stack runs out.
+static const int kMaxDepth = 1000;
+
+// The encoder's output buffer is kept between calls. Anything past this
+// size is given back once the message is out.
+static const size_t kKeepSize = 1024 * 1024;
+
+static char* scratch;
+static size_t scratch_size;
+
+
+class Encoder {
+ public:
+  Encoder() : len_(0), depth_(0), error_(NULL) {}
+
+  // Appends one frame. Returns false on error, Error() tells what went wrong
+  // unless a JS exception is pending.
+  bool WriteFrame(Handle<Value> value) {
+    size_t start = len_;
+    if (!Grow(4)) return false;
+    len_ += 4;
+    if (!WriteValue(value)) return false;
+    size_t size = len_ - start - 4;
+    if (size > 0xffffffff) return Fail("Message too large");
+    uint32_t frame_size = static_cast<uint32_t>(size);
+    memcpy(scratch + start, &frame_size, sizeof(frame_size));
+    return true;
+  }
+
+  const char* Data() const { return scratch; }
+  size_t Length() const { return len_; }
+  const char* Error() const { return error_; }
+
+ private:
+  bool Fail(const char* error) {
+    error_ = error;
+    return false;
+  }
+
+  bool Grow(size_t size) {
+    if (scratch_size - len_ >= size) return true;
+
+    size_t new_size = scratch_size > 0 ? scratch_size : 4096;
+    while (new_size - len_ < size) {
+      if (new_size > static_cast<size_t>(-1) / 2) return Fail("Out of memory");
+      new_size *= 2;
+    }
+
+    char* data = static_cast<char*>(realloc(scratch, new_size));
+    if (data == NULL) return Fail("Out of memory");
+    scratch = data;
+    scratch_size = new_size;
+    return true;
+  }
+
+  void Put(const void* data, size_t size) {
+    memcpy(scratch + len_, data, size);
+    len_ += size;
+  }
+
+  bool WriteTag(char tag) {
+    if (!Grow(1)) return false;
+    Put(&tag, 1);
+    return true;
+  }
+
+  bool WriteUint32(size_t value) {
+    if (value > 0xffffffff) return Fail("Message too large");
+    uint32_t n = static_cast<uint32_t>(value);
+    if (!Grow(sizeof(n))) return false;
+    Put(&n, sizeof(n));
+    return true;
+  }
+
+  bool WriteDouble(char tag, double value) {
+    if (!Grow(1 + sizeof(value))) return false;
+    Put(&tag, 1);
+    Put(&value, sizeof(value));
+    return true;
+  }
+
+  bool WriteBytes(const char* data, size_t size) {
+    if (!WriteUint32(size) || !Grow(size)) return false;
+    Put(data, size);
+    return true;
+  }
+
+  // A length prefixed UTF-8 string, without tag.
+  bool WriteString(Handle<String> string) {
+    size_t size;
+    if (string->Length() > 65535)
+      size = StringBytes::Size(string, UTF8);
+    else
+      size = StringBytes::StorageSize(string, UTF8);
+
+    if (!Grow(4 + size)) return false;
+    size_t written = StringBytes::Write(scratch + len_ + 4, size, string, UTF8);
+    if (!WriteUint32(written)) return false;
+    len_ += written;
+    return true;
+  }
+
+  bool WriteValue(Handle<Value> value) {
+    if (value->IsString()) {
+      return WriteTag('s') && WriteString(value.As<String>());
+    } else if (value->IsInt32()) {
+      int32_t n = value->Int32Value();
+      if (!Grow(1 + sizeof(n))) return false;
+      Put("i", 1);
+      Put(&n, sizeof(n));
+      return true;
+    } else if (value->IsNumber()) {
+      return WriteDouble('d', value->NumberValue());
+    } else if (value->IsBoolean()) {
+      return WriteTag(value->IsTrue() ? 'T' : 'F');
+    } else if (value->IsUndefined()) {
+      return WriteTag('_');
+    } else if (value->IsNull() || value->IsFunction()) {
+      return WriteTag('0');
+    } else if (value->IsDate()) {
+      return WriteDouble('D', value->NumberValue());
+    } else if (Buffer::HasInstance(value)) {
+      return WriteTag('b') &&
+             WriteBytes(Buffer::Data(value), Buffer::Length(value));
+    } else if (value->IsArray()) {
+      return WriteArray(value.As<Array>());
+    } else if (value->IsObject()) {
+      return WriteObject(value.As<Object>());
+    }
+
+    // Externals and the like, which don't make it to JS land.
+    return WriteTag('0');
+  }
+
+  bool WriteArray(Handle<Array> array) {
+    HandleScope scope;
+
+    if (++depth_ > kMaxDepth) return Fail("Message nested too deeply");
+
+    uint32_t length = array->Length();
+    if (!WriteTag('a') || !WriteUint32(length)) return false;
+
+    for (uint32_t i = 0; i < length; i++) {
+      Local<Value> value = array->Get(i);
+      if (value.IsEmpty() || !WriteValue(value)) return false;
+    }
+
+    depth_--;
+    return true;
+  }
+
+  bool WriteObject(Handle<Object> object) {
+    HandleScope scope;
+
+    if (++depth_ > kMaxDepth) return Fail("Message nested too deeply");
+
+    Local<Array> names = object->GetOwnPropertyNames();
+    if (names.IsEmpty()) return false;
+
+    if (!WriteTag('o') || !Grow(4)) return false;
+    size_t count_offset = len_;
+    len_ += 4;
+
+    uint32_t count = 0;
+    for (uint32_t i = 0, n = names->Length(); i < n; i++) {
+      Local<Value> name = names->Get(i);
+      Local<Value> value = object->Get(name);
+      if (value.IsEmpty()) return false;
+      if (value->IsFunction()) continue;
+      if (!WriteString(name->ToString()) || !WriteValue(value)) return false;
+      count++;
+    }
+
+    memcpy(scratch + count_offset, &count, sizeof(count));
+
+    depth_--;
+    return true;
+  }
+
+  size_t len_;
+  int depth_;
+  const char* error_;
+};
+
+
+class Decoder {
+ public:
+  Decoder(const char* data, size_t size)
+      : pos_(data), end_(data + size), depth_(0) {}
+
+  bool AtEnd() const { return pos_ == end_; }
+
+  // Returns an empty handle if the data is malformed.
+  Local<Value> ReadValue() {
+    char tag;
+    if (!Read(&tag, 1)) return Local<Value>();
+
+    switch (tag) {
+      case '_': return Local<Value>::New(Undefined());
+      case '0': return Local<Value>::New(Null());
+      case 'T': return Local<Value>::New(True());
+      case 'F': return Local<Value>::New(False());
+
+      case 'i': {
+        int32_t n;
+        if (!Read(&n, sizeof(n))) break;
+        return Integer::New(n);
+      }
+
+      case 'd': {
+        double n;
+        if (!Read(&n, sizeof(n))) break;
+        return Number::New(n);
+      }
+
+      case 'D': {
+        double n;
+        if (!Read(&n, sizeof(n))) break;
+        return Date::New(n);
+      }
+
+      case 's': {
+        const char* data;
+        uint32_t size;
+        if (!ReadBytes(&data, &size)) break;
+        return StringBytes::Encode(data, size, UTF8);
+      }
+
+      case 'b': {
+        const char* data;
+        uint32_t size;
+        if (!ReadBytes(&data, &size)) break;
+        return BufferPool::Default()->Take(data, size);
+      }
+
+      case 'a': return ReadArray();
+      case 'o': return ReadObject();
+    }
+
+    return Local<Value>();
+  }
+
+ private:
+  bool Read(void* out, size_t size) {
+    if (static_cast<size_t>(end_ - pos_) < size) return false;
+    memcpy(out, pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadBytes(const char** data, uint32_t* size) {
+    if (!Read(size, sizeof(*size))) return false;
+    if (static_cast<size_t>(end_ - pos_) < *size) return false;
+    *data = pos_;
+    pos_ += *size;
+    return true;
+  }
+
+  // Every value takes up at least a byte, which keeps a bad count from
+  // making us allocate a huge array.
+  bool ReadCount(uint32_t* count) {
+    return Read(count, sizeof(*count)) &&
+           *count <= static_cast<size_t>(end_ - pos_);
+  }
+
+  Local<Value> ReadArray() {
+    HandleScope scope;
+    uint32_t length;
+
+    if (++depth_ > kMaxDepth || !ReadCount(&length)) return Local<Value>();
+
+    Local<Array> array = Array::New(length);
+    for (uint32_t i = 0; i < length; i++) {
+      Local<Value> value = ReadValue();
+      if (value.IsEmpty()) return Local<Value>();
+      array->Set(i, value);
+    }
+
+    depth_--;
+    return scope.Close(array);
+  }
+
+  Local<Value> ReadObject() {
+    HandleScope scope;
+    uint32_t count;
+
+    if (++depth_ > kMaxDepth || !ReadCount(&count)) return Local<Value>();
+
+    Local<Object> object = Object::New();
+    for (uint32_t i = 0; i < count; i++) {
+      const char* name;
+      uint32_t size;
+      if (!ReadBytes(&name, &size)) return Local<Value>();
+      // Messages tend to share their keys, symbols save us from
+      // allocating them over and over again.
+      Local<String> key = String::NewSymbol(name, size);
+      Local<Value> value = ReadValue();
+      if (value.IsEmpty()) return Local<Value>();
+      // Not Set(): a "__proto__" key from the peer must become a property
+      // of its own rather than replace the object's prototype.
+      object->ForceSet(key, value);
+    }
+
+    depth_--;
+    return scope.Close(object);
+  }
+
+  const char* pos_;
+  const char* end_;
+  int depth_;
+};
+
+
+// encode(message) returns a Buffer with the message's frame.
+static Handle<Value> Encode(const Arguments& args) {
+  HandleScope scope;
+  TryCatch try_catch;
+  Encoder encoder;
+
+  bool ok = encoder.WriteFrame(args[0]);
+
+  if (try_catch.HasCaught())
+    return try_catch.ReThrow();
+
+  Local<Object> buffer;
+  if (ok)
+    buffer = BufferPool::Default()->Take(encoder.Data(), encoder.Length());
+
+  if (scratch_size > kKeepSize) {
+    free(scratch);
+    scratch = NULL;
+    scratch_size = 0;
+  }
+
+  if (!ok) {
+    return ThrowException(Exception::RangeError(
+        String::New(encoder.Error())));
+  }
+
+  return scope.Close(buffer);
+}
+
+
+// decode(buffer, messages) appends the messages of the complete frames at
+// the start of `buffer` to the `messages` array. Returns the number of bytes
+// they take up.
+static Handle<Value> Decode(const Arguments& args) {
+  HandleScope scope;
+
+  if (!Buffer::HasInstance(args[0]))
+    return TYPE_ERROR("First argument must be a Buffer");
+  if (!args[1]->IsArray())
+    return TYPE_ERROR("Second argument must be an array");
+
+  const char* data = Buffer::Data(args[0]);
+  size_t length = Buffer::Length(args[0]);
+  Local<Array> messages = args[1].As<Array>();
+  uint32_t count = messages->Length();
+  size_t offset = 0;
+
+  while (length - offset >= 4) {
+    uint32_t size;
+    memcpy(&size, data + offset, sizeof(size));
+    if (length - offset - 4 < size) break;
+
+    Decoder decoder(data + offset + 4, size);
+    Local<Value> message = decoder.ReadValue();
+    if (message.IsEmpty() || !decoder.AtEnd()) {
+      return ThrowException(Exception::Error(
+          String::New("Malformed IPC message")));
+    }
+
+    messages->Set(count++, message);
+    offset += 4 + size;
+  }
+
+  return scope.Close(Number::New(static_cast<double>(offset)));
+}
+
+
+void InitSerdes(Handle<Object> target) {
+  HandleScope scope;
+
+  NODE_SET_METHOD(target, "encode", Encode);
+  NODE_SET_METHOD(target, "decode", Decode);
+}
+
+
+}  // namespace node
+
+NODE_MODULE(node_serdes, node::InitSerdes)
@@ -43,6 +43,8 @@ void NODE_COUNT_NET_BYTES_SENT(int bytes);
 void NODE_COUNT_NET_BYTES_RECV(int bytes);
 uint64_t NODE_COUNT_GET_GC_RAWTIME();
 void NODE_COUNT_GC_PERCENTTIME(unsigned int percent);
+// Pause times are only published by the POSIX provider.
+INLINE void NODE_COUNT_GC_PAUSE(uint64_t rawtime) {}
 void NODE_COUNT_PIPE_BYTES_SENT(int bytes);
 void NODE_COUNT_PIPE_BYTES_RECV(int bytes);
 
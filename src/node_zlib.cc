@@ -53,6 +53,24 @@ enum node_zlib_mode {
 void InitZlib(v8::Handle<v8::Object> target);
 
 
+// Streams of closed contexts are reset and kept here for the next context
+// that is initialized with the same parameters. A fresh deflate stream costs
+// a few hundred KB of newly mapped memory, more than it takes to compress a
+// small response.
+struct PooledStream {
+  z_stream* strm;
+  node_zlib_mode mode;
+  int level;
+  int windowBits;
+  int memLevel;
+  int strategy;
+};
+
+static const int kStreamPoolSize = 16;
+static PooledStream stream_pool[kStreamPoolSize];
+static int stream_pool_count;
+
+
 /**
  * Deflate/Inflate
  */
@@ -62,6 +80,7 @@ class ZCtx : public ObjectWrap {
   ZCtx(node_zlib_mode mode)
     : ObjectWrap()
     , init_done_(false)
+    , strm_(NULL)
     , level_(0)
     , windowBits_(0)
     , memLevel_(0)
@@ -95,13 +114,20 @@ class ZCtx : public ObjectWrap {
     assert(mode_ <= UNZIP);
 
     if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW) {
-      (void)deflateEnd(&strm_);
+      if (!PoolStream(this)) {
+        (void)deflateEnd(strm_);
+        delete strm_;
+      }
       V8::AdjustAmountOfExternalAllocatedMemory(-kDeflateContextSize);
     } else if (mode_ == INFLATE || mode_ == GUNZIP || mode_ == INFLATERAW ||
                mode_ == UNZIP) {
-      (void)inflateEnd(&strm_);
+      if (!PoolStream(this)) {
+        (void)inflateEnd(strm_);
+        delete strm_;
+      }
       V8::AdjustAmountOfExternalAllocatedMemory(-kInflateContextSize);
     }
+    strm_ = NULL;
     mode_ = NONE;
 
     if (dictionary_ != NULL) {
@@ -120,6 +146,11 @@ class ZCtx : public ObjectWrap {
 
 
   // write(flush, in, in_off, in_len, out, out_off, out_len)
+  // writeSync(flush, in, in_off, in_len, out, out_off, out_len)
+  //
+  // writeSync() runs on the calling thread and returns
+  // [avail_in, avail_out], or undefined after calling onerror.
+  template <bool async>
   static Handle<Value> Write(const Arguments& args) {
     HandleScope scope;
     assert(args.Length() == 7);
@@ -177,15 +208,32 @@ class ZCtx : public ObjectWrap {
     // build up the work request
     uv_work_t* work_req = &(ctx->work_req_);
 
-    ctx->strm_.avail_in = in_len;
-    ctx->strm_.next_in = in;
-    ctx->strm_.avail_out = out_len;
-    ctx->strm_.next_out = out;
+    ctx->strm_->avail_in = in_len;
+    ctx->strm_->next_in = in;
+    ctx->strm_->avail_out = out_len;
+    ctx->strm_->next_out = out;
     ctx->flush_ = flush;
 
     // set this so that later on, I can easily tell how much was written.
     ctx->chunk_size_ = out_len;
 
+    if (!async) {
+      Process(work_req);
+      if (!CheckError(ctx))
+        return Undefined();
+
+      Local<Array> result = Array::New(2);
+      result->Set(0, Integer::New(ctx->strm_->avail_in));
+      result->Set(1, Integer::New(ctx->strm_->avail_out));
+
+      ctx->write_in_progress_ = false;
+      ctx->Unref();
+      if (ctx->pending_close_)
+        ctx->Close();
+
+      return scope.Close(result);
+    }
+
     uv_queue_work(uv_default_loop(),
                   work_req,
                   ZCtx::Process,
@@ -209,25 +257,25 @@ class ZCtx : public ObjectWrap {
       case DEFLATE:
       case GZIP:
       case DEFLATERAW:
-        ctx->err_ = deflate(&ctx->strm_, ctx->flush_);
+        ctx->err_ = deflate(ctx->strm_, ctx->flush_);
         break;
       case UNZIP:
       case INFLATE:
       case GUNZIP:
       case INFLATERAW:
-        ctx->err_ = inflate(&ctx->strm_, ctx->flush_);
+        ctx->err_ = inflate(ctx->strm_, ctx->flush_);
 
         // If data was encoded with dictionary
         if (ctx->err_ == Z_NEED_DICT && ctx->dictionary_ != NULL) {
 
           // Load it
-          ctx->err_ = inflateSetDictionary(&ctx->strm_,
+          ctx->err_ = inflateSetDictionary(ctx->strm_,
                                            ctx->dictionary_,
                                            ctx->dictionary_len_);
           if (ctx->err_ == Z_OK) {
 
             // And try to decode again
-            ctx->err_ = inflate(&ctx->strm_, ctx->flush_);
+            ctx->err_ = inflate(ctx->strm_, ctx->flush_);
           } else if (ctx->err_ == Z_DATA_ERROR) {
 
             // Both inflateSetDictionary() and inflate() return Z_DATA_ERROR.
@@ -248,13 +296,8 @@ class ZCtx : public ObjectWrap {
     // or shift the queue and call Process.
   }
 
-  // v8 land!
-  static void After(uv_work_t* work_req, int status) {
-    assert(status == 0);
-
-    HandleScope scope;
-    ZCtx *ctx = container_of(work_req, ZCtx, work_req_);
-
+  // Returns false after reporting a fatal error through onerror.
+  static bool CheckError(ZCtx* ctx) {
     // Acceptable error states depend on the type of zlib stream.
     switch (ctx->err_) {
       case Z_OK:
@@ -268,15 +311,28 @@ class ZCtx : public ObjectWrap {
         } else {
           ZCtx::Error(ctx, "Bad dictionary");
         }
-        return;
+        return false;
       default:
         // something else.
         ZCtx::Error(ctx, "Zlib error");
-        return;
+        return false;
     }
 
-    Local<Integer> avail_out = Integer::New(ctx->strm_.avail_out);
-    Local<Integer> avail_in = Integer::New(ctx->strm_.avail_in);
+    return true;
+  }
+
+  // v8 land!
+  static void After(uv_work_t* work_req, int status) {
+    assert(status == 0);
+
+    HandleScope scope;
+    ZCtx *ctx = container_of(work_req, ZCtx, work_req_);
+
+    if (!CheckError(ctx))
+      return;
+
+    Local<Integer> avail_out = Integer::New(ctx->strm_->avail_out);
+    Local<Integer> avail_in = Integer::New(ctx->strm_->avail_in);
 
     ctx->write_in_progress_ = false;
 
@@ -293,8 +349,8 @@ class ZCtx : public ObjectWrap {
 
   static void Error(ZCtx *ctx, const char *msg_) {
     const char *msg;
-    if (ctx->strm_.msg != NULL) {
-      msg = ctx->strm_.msg;
+    if (ctx->strm_->msg != NULL) {
+      msg = ctx->strm_->msg;
     } else {
       msg = msg_;
     }
@@ -389,10 +445,6 @@ class ZCtx : public ObjectWrap {
     ctx->memLevel_ = memLevel;
     ctx->strategy_ = strategy;
 
-    ctx->strm_.zalloc = Z_NULL;
-    ctx->strm_.zfree = Z_NULL;
-    ctx->strm_.opaque = Z_NULL;
-
     ctx->flush_ = Z_NO_FLUSH;
 
     ctx->err_ = Z_OK;
@@ -409,23 +461,34 @@ class ZCtx : public ObjectWrap {
       ctx->windowBits_ *= -1;
     }
 
+    bool pooled = UnpoolStream(ctx);
+    if (!pooled) {
+      ctx->strm_ = new z_stream();
+      ctx->strm_->zalloc = Z_NULL;
+      ctx->strm_->zfree = Z_NULL;
+      ctx->strm_->opaque = Z_NULL;
+    }
+
     switch (ctx->mode_) {
       case DEFLATE:
       case GZIP:
       case DEFLATERAW:
-        ctx->err_ = deflateInit2(&ctx->strm_,
-                                 ctx->level_,
-                                 Z_DEFLATED,
-                                 ctx->windowBits_,
-                                 ctx->memLevel_,
-                                 ctx->strategy_);
+        if (!pooled) {
+          ctx->err_ = deflateInit2(ctx->strm_,
+                                   ctx->level_,
+                                   Z_DEFLATED,
+                                   ctx->windowBits_,
+                                   ctx->memLevel_,
+                                   ctx->strategy_);
+        }
         V8::AdjustAmountOfExternalAllocatedMemory(kDeflateContextSize);
         break;
       case INFLATE:
       case GUNZIP:
       case INFLATERAW:
       case UNZIP:
-        ctx->err_ = inflateInit2(&ctx->strm_, ctx->windowBits_);
+        if (!pooled)
+          ctx->err_ = inflateInit2(ctx->strm_, ctx->windowBits_);
         V8::AdjustAmountOfExternalAllocatedMemory(kInflateContextSize);
         break;
       default:
@@ -452,7 +515,7 @@ class ZCtx : public ObjectWrap {
     switch (ctx->mode_) {
       case DEFLATE:
       case DEFLATERAW:
-        ctx->err_ = deflateSetDictionary(&ctx->strm_,
+        ctx->err_ = deflateSetDictionary(ctx->strm_,
                                          ctx->dictionary_,
                                          ctx->dictionary_len_);
         break;
@@ -471,11 +534,11 @@ class ZCtx : public ObjectWrap {
     switch (ctx->mode_) {
       case DEFLATE:
       case DEFLATERAW:
-        ctx->err_ = deflateReset(&ctx->strm_);
+        ctx->err_ = deflateReset(ctx->strm_);
         break;
       case INFLATE:
       case INFLATERAW:
-        ctx->err_ = inflateReset(&ctx->strm_);
+        ctx->err_ = inflateReset(ctx->strm_);
         break;
       default:
         break;
@@ -486,13 +549,60 @@ class ZCtx : public ObjectWrap {
     }
   }
 
+  // Resets the stream and keeps it for a later context with the same
+  // parameters. Returns false if the caller should free it instead.
+  static bool PoolStream(ZCtx* ctx) {
+    if (stream_pool_count == kStreamPoolSize)
+      return false;
+
+    int err;
+    if (ctx->mode_ == DEFLATE || ctx->mode_ == GZIP ||
+        ctx->mode_ == DEFLATERAW) {
+      err = deflateReset(ctx->strm_);
+    } else {
+      err = inflateReset(ctx->strm_);
+    }
+
+    // A stream whose init failed has no state to reset.
+    if (err != Z_OK)
+      return false;
+
+    PooledStream* p = &stream_pool[stream_pool_count++];
+    p->strm = ctx->strm_;
+    p->mode = ctx->mode_;
+    p->level = ctx->level_;
+    p->windowBits = ctx->windowBits_;
+    p->memLevel = ctx->memLevel_;
+    p->strategy = ctx->strategy_;
+    return true;
+  }
+
+  static bool UnpoolStream(ZCtx* ctx) {
+    for (int i = stream_pool_count - 1; i >= 0; i--) {
+      PooledStream* p = &stream_pool[i];
+      if (p->mode != ctx->mode_ ||
+          p->windowBits != ctx->windowBits_ ||
+          p->level != ctx->level_ ||
+          p->memLevel != ctx->memLevel_ ||
+          p->strategy != ctx->strategy_) {
+        continue;
+      }
+
+      ctx->strm_ = p->strm;
+      *p = stream_pool[--stream_pool_count];
+      return true;
+    }
+
+    return false;
+  }
+
  private:
   static const int kDeflateContextSize = 16384; // approximate
   static const int kInflateContextSize = 10240; // approximate
 
   bool init_done_;
 
-  z_stream strm_;
+  z_stream* strm_;
   int level_;
   int windowBits_;
   int memLevel_;
@@ -522,7 +632,8 @@ void InitZlib(Handle<Object> target) {
 
   z->InstanceTemplate()->SetInternalFieldCount(1);
 
-  NODE_SET_PROTOTYPE_METHOD(z, "write", ZCtx::Write);
+  NODE_SET_PROTOTYPE_METHOD(z, "write", ZCtx::Write<true>);
+  NODE_SET_PROTOTYPE_METHOD(z, "writeSync", ZCtx::Write<false>);
   NODE_SET_PROTOTYPE_METHOD(z, "init", ZCtx::Init);
   NODE_SET_PROTOTYPE_METHOD(z, "close", ZCtx::Close);
   NODE_SET_PROTOTYPE_METHOD(z, "reset", ZCtx::Reset);
@@ -22,7 +22,7 @@
 #include "node.h"
 #include "node_buffer.h"
 #include "handle_wrap.h"
-#include "slab_allocator.h"
+#include "buffer_pool.h"
 #include "stream_wrap.h"
 #include "pipe_wrap.h"
 #include "tcp_wrap.h"
@@ -33,13 +33,12 @@
 #include <stdlib.h> // abort()
 #include <limits.h> // INT_MAX
 
-#define SLAB_SIZE (1024 * 1024)
-
 
 namespace node {
 
 using v8::AccessorInfo;
 using v8::Arguments;
+using v8::Array;
 using v8::Context;
 using v8::Exception;
 using v8::Function;
@@ -55,47 +54,19 @@ using v8::String;
 using v8::TryCatch;
 using v8::Value;
 
-typedef class ReqWrap<uv_shutdown_t> ShutdownWrap;
-
-class WriteWrap: public ReqWrap<uv_write_t> {
- public:
-  void* operator new(size_t size, char* storage) { return storage; }
-
-  // This is just to keep the compiler happy. It should never be called, since
-  // we don't use exceptions in node.
-  void operator delete(void* ptr, char* storage) { assert(0); }
-
- protected:
-  // People should not be using the non-placement new and delete operator on a
-  // WriteWrap. Ensure this never happens.
-  void* operator new (size_t size) { assert(0); };
-  void operator delete(void* ptr) { assert(0); };
-};
-
-
 static Persistent<String> buffer_sym;
 static Persistent<String> bytes_sym;
 static Persistent<String> write_queue_size_sym;
 static Persistent<String> onread_sym;
 static Persistent<String> oncomplete_sym;
 static Persistent<String> handle_sym;
-static SlabAllocator* slab_allocator;
 static bool initialized;
 
 
-static void DeleteSlabAllocator(void*) {
-  delete slab_allocator;
-  slab_allocator = NULL;
-}
-
-
 void StreamWrap::Initialize(Handle<Object> target) {
   if (initialized) return;
   initialized = true;
 
-  slab_allocator = new SlabAllocator(SLAB_SIZE);
-  AtExit(DeleteSlabAllocator, NULL);
-
   HandleScope scope;
 
   HandleWrap::Initialize(target);
@@ -109,14 +80,32 @@ void StreamWrap::Initialize(Handle<Object> target) {
 
 
 StreamWrap::StreamWrap(Handle<Object> object, uv_stream_t* stream)
-    : HandleWrap(object, (uv_handle_t*)stream) {
+    : HandleWrap(object, (uv_handle_t*)stream),
+      default_callbacks_(this) {
   stream_ = stream;
+  callbacks_ = &default_callbacks_;
   if (stream) {
     stream->data = this;
   }
 }
 
 
+StreamWrap::~StreamWrap() {
+  if (callbacks_ != &default_callbacks_) {
+    delete callbacks_;
+    callbacks_ = NULL;
+  }
+}
+
+
+void StreamWrap::OverrideCallbacks(StreamWrapCallbacks* callbacks) {
+  StreamWrapCallbacks* old = callbacks_;
+  callbacks_ = callbacks;
+  if (old != &default_callbacks_)
+    delete old;
+}
+
+
 Handle<Value> StreamWrap::GetFD(Local<String>, const AccessorInfo& args) {
 #if defined(_WIN32)
   return v8::Null();
@@ -137,6 +126,11 @@ void StreamWrap::SetHandle(uv_handle_t* h) {
 }
 
 
+void StreamWrap::AfterClose() {
+  callbacks_->AfterClose();
+}
+
+
 void StreamWrap::UpdateWriteQueueSize() {
   HandleScope scope;
   object_->Set(write_queue_size_sym,
@@ -182,8 +176,7 @@ Handle<Value> StreamWrap::ReadStop(const Arguments& args) {
 uv_buf_t StreamWrap::OnAlloc(uv_handle_t* handle, size_t suggested_size) {
   StreamWrap* wrap = static_cast<StreamWrap*>(handle->data);
   assert(wrap->stream_ == reinterpret_cast<uv_stream_t*>(handle));
-  char* buf = slab_allocator->Allocate(wrap->object_, suggested_size);
-  return uv_buf_init(buf, suggested_size);
+  return wrap->callbacks_->DoAlloc(handle, suggested_size);
 }
 
 
@@ -219,56 +212,15 @@ void StreamWrap::OnReadCommon(uv_stream_t* handle, ssize_t nread,
   // uv_close() on the handle.
   assert(wrap->object_.IsEmpty() == false);
 
-  if (nread < 0)  {
-    // If libuv reports an error or EOF it *may* give us a buffer back. In that
-    // case, return the space to the slab.
-    if (buf.base != NULL) {
-      slab_allocator->Shrink(wrap->object_, buf.base, 0);
+  if (nread > 0) {
+    if (wrap->stream_->type == UV_TCP) {
+      NODE_COUNT_NET_BYTES_RECV(nread);
+    } else if (wrap->stream_->type == UV_NAMED_PIPE) {
+      NODE_COUNT_PIPE_BYTES_RECV(nread);
     }
-
-    SetErrno(uv_last_error(uv_default_loop()));
-    MakeCallback(wrap->object_, onread_sym, 0, NULL);
-    return;
-  }
-
-  assert(buf.base != NULL);
-  Local<Object> slab = slab_allocator->Shrink(wrap->object_,
-                                              buf.base,
-                                              nread);
-
-  if (nread == 0) return;
-  assert(static_cast<size_t>(nread) <= buf.len);
-
-  int argc = 3;
-  Local<Value> argv[4] = {
-    slab,
-    Integer::NewFromUnsigned(buf.base - Buffer::Data(slab)),
-    Integer::NewFromUnsigned(nread)
-  };
-
-  Local<Object> pending_obj;
-  if (pending == UV_TCP) {
-    pending_obj = AcceptHandle<TCPWrap, uv_tcp_t>(handle);
-  } else if (pending == UV_NAMED_PIPE) {
-    pending_obj = AcceptHandle<PipeWrap, uv_pipe_t>(handle);
-  } else if (pending == UV_UDP) {
-    pending_obj = AcceptHandle<UDPWrap, uv_udp_t>(handle);
-  } else {
-    assert(pending == UV_UNKNOWN_HANDLE);
   }
 
-  if (!pending_obj.IsEmpty()) {
-    argv[3] = pending_obj;
-    argc++;
-  }
-
-  if (wrap->stream_->type == UV_TCP) {
-    NODE_COUNT_NET_BYTES_RECV(nread);
-  } else if (wrap->stream_->type == UV_NAMED_PIPE) {
-    NODE_COUNT_PIPE_BYTES_RECV(nread);
-  }
-
-  MakeCallback(wrap->object_, onread_sym, argc, argv);
+  wrap->callbacks_->DoRead(handle, nread, buf, pending);
 }
 
 
@@ -283,18 +235,47 @@ void StreamWrap::OnRead2(uv_pipe_t* handle, ssize_t nread, uv_buf_t buf,
 }
 
 
+// On IPC pipes, a write can carry a handle along. Returns the handle that
+// `arg` wraps, or NULL when there's nothing to send.
+static uv_stream_t* SendHandle(StreamWrap* wrap,
+                               WriteWrap* req_wrap,
+                               Handle<Value> arg) {
+  bool ipc_pipe = wrap->GetStream()->type == UV_NAMED_PIPE &&
+                  reinterpret_cast<uv_pipe_t*>(wrap->GetStream())->ipc;
+
+  if (!ipc_pipe || !arg->IsObject())
+    return NULL;
+
+  Local<Object> send_handle_obj = arg->ToObject();
+  assert(send_handle_obj->InternalFieldCount() > 0);
+  HandleWrap* send_handle_wrap = static_cast<HandleWrap*>(
+      send_handle_obj->GetPointerFromInternalField(0));
+
+  // Reference StreamWrap instance to prevent it from being garbage
+  // collected before `AfterWrite` is called.
+  if (handle_sym.IsEmpty()) {
+    handle_sym = NODE_PSYMBOL("handle");
+  }
+  assert(!req_wrap->object_.IsEmpty());
+  req_wrap->object_->Set(handle_sym, send_handle_obj);
+
+  return reinterpret_cast<uv_stream_t*>(send_handle_wrap->GetHandle());
+}
+
+
 Handle<Value> StreamWrap::WriteBuffer(const Arguments& args) {
   HandleScope scope;
 
   UNWRAP(StreamWrap)
 
-  // The first argument is a buffer.
+  // The first argument is a buffer, the second an optional handle to send
+  // along on IPC pipes.
   assert(args.Length() >= 1 && Buffer::HasInstance(args[0]));
   Local<Object> buffer_obj = args[0]->ToObject();
   size_t offset = 0;
   size_t length = Buffer::Length(buffer_obj);
   char* storage = new char[sizeof(WriteWrap)];
-  WriteWrap* req_wrap = new (storage) WriteWrap();
+  WriteWrap* req_wrap = new (storage) WriteWrap(wrap);
 
   req_wrap->object_->SetHiddenValue(buffer_sym, buffer_obj);
 
@@ -302,11 +283,11 @@ Handle<Value> StreamWrap::WriteBuffer(const Arguments& args) {
   buf.base = Buffer::Data(buffer_obj) + offset;
   buf.len = length;
 
-  int r = uv_write(&req_wrap->req_,
-                   wrap->stream_,
-                   &buf,
-                   1,
-                   StreamWrap::AfterWrite);
+  int r = wrap->callbacks_->DoWrite(req_wrap,
+                                    &buf,
+                                    1,
+                                    SendHandle(wrap, req_wrap, args[1]),
+                                    StreamWrap::AfterWrite);
 
   req_wrap->Dispatched();
   req_wrap->object_->Set(bytes_sym,
@@ -360,7 +341,7 @@ Handle<Value> StreamWrap::WriteStringImpl(const Arguments& args) {
   }
 
   char* storage = new char[sizeof(WriteWrap) + storage_size + 15];
-  WriteWrap* req_wrap = new (storage) WriteWrap();
+  WriteWrap* req_wrap = new (storage) WriteWrap(wrap);
 
   char* data = reinterpret_cast<char*>(ROUND_UP(
       reinterpret_cast<uintptr_t>(storage) + sizeof(WriteWrap), 16));
@@ -374,45 +355,134 @@ Handle<Value> StreamWrap::WriteStringImpl(const Arguments& args) {
   buf.base = data;
   buf.len = data_size;
 
-  bool ipc_pipe = wrap->stream_->type == UV_NAMED_PIPE &&
-                  ((uv_pipe_t*)wrap->stream_)->ipc;
+  r = wrap->callbacks_->DoWrite(req_wrap,
+                                &buf,
+                                1,
+                                SendHandle(wrap, req_wrap, args[1]),
+                                StreamWrap::AfterWrite);
+
+  req_wrap->Dispatched();
+  req_wrap->object_->Set(bytes_sym, Integer::NewFromUnsigned(data_size));
 
-  if (!ipc_pipe) {
-    r = uv_write(&req_wrap->req_,
-                 wrap->stream_,
-                 &buf,
-                 1,
-                 StreamWrap::AfterWrite);
+  wrap->UpdateWriteQueueSize();
 
+  if (r) {
+    SetErrno(uv_last_error(uv_default_loop()));
+    req_wrap->~WriteWrap();
+    delete[] storage;
+    return scope.Close(v8::Null());
   } else {
-    uv_handle_t* send_handle = NULL;
-
-    if (args[1]->IsObject()) {
-      Local<Object> send_handle_obj = args[1]->ToObject();
-      assert(send_handle_obj->InternalFieldCount() > 0);
-      HandleWrap* send_handle_wrap = static_cast<HandleWrap*>(
-          send_handle_obj->GetPointerFromInternalField(0));
-      send_handle = send_handle_wrap->GetHandle();
-
-      // Reference StreamWrap instance to prevent it from being garbage
-      // collected before `AfterWrite` is called.
-      if (handle_sym.IsEmpty()) {
-        handle_sym = NODE_PSYMBOL("handle");
-      }
-      assert(!req_wrap->object_.IsEmpty());
-      req_wrap->object_->Set(handle_sym, send_handle_obj);
+    if (wrap->stream_->type == UV_TCP) {
+      NODE_COUNT_NET_BYTES_SENT(buf.len);
+    } else if (wrap->stream_->type == UV_NAMED_PIPE) {
+      NODE_COUNT_PIPE_BYTES_SENT(buf.len);
     }
 
-    r = uv_write2(&req_wrap->req_,
-                  wrap->stream_,
-                  &buf,
-                  1,
-                  reinterpret_cast<uv_stream_t*>(send_handle),
-                  StreamWrap::AfterWrite);
+    return scope.Close(req_wrap->object_);
+  }
+}
+
+
+Handle<Value> StreamWrap::Writev(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP(StreamWrap)
+
+  if (args.Length() < 1 || !args[0]->IsArray())
+    return ThrowTypeError("First argument must be an array");
+
+  // The array holds (chunk, encoding) pairs, chunks being either Buffers or
+  // strings. Buffers are written in place, strings get flattened into the
+  // storage that trails the WriteWrap.
+  Local<Array> chunks = Local<Array>::Cast(args[0]);
+  size_t count = chunks->Length() >> 1;
+
+  if (count == 0)
+    return ThrowTypeError("Nothing to write");
+
+  // Determine the storage size first.
+  size_t storage_size = 0;
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> chunk = chunks->Get(i * 2);
+
+    // Buffer chunks need no additional storage.
+    if (Buffer::HasInstance(chunk))
+      continue;
+
+    Local<String> string = chunk->ToString();
+    enum encoding encoding = ParseEncoding(chunks->Get(i * 2 + 1), UTF8);
+    size_t chunk_size;
+    if (encoding == UTF8 && string->Length() > 65535)
+      chunk_size = StringBytes::Size(string, encoding);
+    else
+      chunk_size = StringBytes::StorageSize(string, encoding);
+
+    // Leave room for aligning each string on a 16 byte boundary.
+    storage_size += chunk_size + 15;
+  }
+
+  if (storage_size > INT_MAX) {
+    uv_err_t err;
+    err.code = UV_ENOBUFS;
+    SetErrno(err);
+    return scope.Close(v8::Null());
   }
 
+  uv_buf_t bufs_[16];
+  uv_buf_t* bufs = bufs_;
+  if (ARRAY_SIZE(bufs_) < count)
+    bufs = new uv_buf_t[count];
+
+  char* storage = new char[sizeof(WriteWrap) + storage_size];
+  WriteWrap* req_wrap = new (storage) WriteWrap(wrap);
+
+  char* data = storage + sizeof(WriteWrap);
+  char* data_end = data + storage_size;
+  size_t bytes = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> chunk = chunks->Get(i * 2);
+
+    if (Buffer::HasInstance(chunk)) {
+      Local<Object> buffer_obj = chunk->ToObject();
+      bufs[i].base = Buffer::Data(buffer_obj);
+      bufs[i].len = Buffer::Length(buffer_obj);
+      bytes += bufs[i].len;
+      continue;
+    }
+
+    data = reinterpret_cast<char*>(ROUND_UP(
+        reinterpret_cast<uintptr_t>(data), 16));
+    assert(data <= data_end);
+
+    Local<String> string = chunk->ToString();
+    enum encoding encoding = ParseEncoding(chunks->Get(i * 2 + 1), UTF8);
+    size_t data_size = StringBytes::Write(data,
+                                          data_end - data,
+                                          string,
+                                          encoding);
+
+    bufs[i].base = data;
+    bufs[i].len = data_size;
+    data += data_size;
+    bytes += data_size;
+  }
+
+  // Keep the Buffers alive until the write completes.
+  req_wrap->object_->SetHiddenValue(buffer_sym, chunks);
+
+  int r = wrap->callbacks_->DoWrite(req_wrap,
+                                    bufs,
+                                    static_cast<int>(count),
+                                    NULL,
+                                    StreamWrap::AfterWrite);
+
+  // The uv_buf_t array is copied by the callee, its memory is ours to free.
+  if (bufs != bufs_)
+    delete[] bufs;
+
   req_wrap->Dispatched();
-  req_wrap->object_->Set(bytes_sym, Integer::NewFromUnsigned(data_size));
+  req_wrap->object_->Set(bytes_sym, Integer::NewFromUnsigned(bytes));
 
   wrap->UpdateWriteQueueSize();
 
@@ -423,9 +493,66 @@ Handle<Value> StreamWrap::WriteStringImpl(const Arguments& args) {
     return scope.Close(v8::Null());
   } else {
     if (wrap->stream_->type == UV_TCP) {
-      NODE_COUNT_NET_BYTES_SENT(buf.len);
+      NODE_COUNT_NET_BYTES_SENT(bytes);
     } else if (wrap->stream_->type == UV_NAMED_PIPE) {
-      NODE_COUNT_PIPE_BYTES_SENT(buf.len);
+      NODE_COUNT_PIPE_BYTES_SENT(bytes);
+    }
+
+    return scope.Close(req_wrap->object_);
+  }
+}
+
+
+Handle<Value> StreamWrap::SendFile(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP(StreamWrap)
+
+  if (args.Length() < 3 ||
+      !args[0]->IsInt32() ||
+      !args[1]->IsNumber() ||
+      !args[2]->IsNumber()) {
+    return ThrowTypeError("Bad arguments: fd, offset, length");
+  }
+
+  int fd = args[0]->Int32Value();
+  int64_t offset = args[1]->IntegerValue();
+  size_t length = static_cast<size_t>(args[2]->IntegerValue());
+
+  // The file goes to the socket as is. Callbacks that rewrite the outgoing
+  // bytes (TLS) never get to see it, so refuse instead of bypassing them.
+  if (wrap->callbacks_ != &wrap->default_callbacks_) {
+    uv_err_t err;
+    err.code = UV_ENOTSUP;
+    SetErrno(err);
+    return scope.Close(v8::Null());
+  }
+
+  char* storage = new char[sizeof(WriteWrap)];
+  WriteWrap* req_wrap = new (storage) WriteWrap(wrap);
+
+  int r = uv_sendfile(&req_wrap->req_,
+                      wrap->stream_,
+                      fd,
+                      offset,
+                      length,
+                      StreamWrap::AfterWrite);
+
+  req_wrap->Dispatched();
+  req_wrap->object_->Set(bytes_sym, Number::New(static_cast<double>(length)));
+
+  wrap->UpdateWriteQueueSize();
+
+  if (r) {
+    SetErrno(uv_last_error(uv_default_loop()));
+    req_wrap->~WriteWrap();
+    delete[] storage;
+    return scope.Close(v8::Null());
+  } else {
+    if (wrap->stream_->type == UV_TCP) {
+      NODE_COUNT_NET_BYTES_SENT(length);
+    } else if (wrap->stream_->type == UV_NAMED_PIPE) {
+      NODE_COUNT_PIPE_BYTES_SENT(length);
     }
 
     return scope.Close(req_wrap->object_);
@@ -450,7 +577,7 @@ Handle<Value> StreamWrap::WriteUcs2String(const Arguments& args) {
 
 void StreamWrap::AfterWrite(uv_write_t* req, int status) {
   WriteWrap* req_wrap = (WriteWrap*) req->data;
-  StreamWrap* wrap = (StreamWrap*) req->handle->data;
+  StreamWrap* wrap = req_wrap->wrap();
 
   HandleScope scope;
 
@@ -468,6 +595,7 @@ void StreamWrap::AfterWrite(uv_write_t* req, int status) {
   }
 
   wrap->UpdateWriteQueueSize();
+  wrap->callbacks_->AfterWrite(req_wrap);
 
   Local<Value> argv[] = {
     Integer::New(status),
@@ -489,7 +617,7 @@ Handle<Value> StreamWrap::Shutdown(const Arguments& args) {
 
   ShutdownWrap* req_wrap = new ShutdownWrap();
 
-  int r = uv_shutdown(&req_wrap->req_, wrap->stream_, AfterShutdown);
+  int r = wrap->callbacks_->DoShutdown(req_wrap, AfterShutdown);
 
   req_wrap->Dispatched();
 
@@ -529,4 +657,81 @@ void StreamWrap::AfterShutdown(uv_shutdown_t* req, int status) {
 }
 
 
+int StreamWrapCallbacks::DoWrite(WriteWrap* w,
+                                 uv_buf_t* bufs,
+                                 int count,
+                                 uv_stream_t* send_handle,
+                                 uv_write_cb cb) {
+  if (send_handle == NULL) {
+    return uv_write(&w->req_, wrap_->stream_, bufs, count, cb);
+  }
+  return uv_write2(&w->req_, wrap_->stream_, bufs, count, send_handle, cb);
+}
+
+
+void StreamWrapCallbacks::AfterWrite(WriteWrap* w) {
+}
+
+
+uv_buf_t StreamWrapCallbacks::DoAlloc(uv_handle_t* handle,
+                                      size_t suggested_size) {
+  return BufferPool::Default()->Scratch(suggested_size);
+}
+
+
+void StreamWrapCallbacks::DoRead(uv_stream_t* handle,
+                                 ssize_t nread,
+                                 uv_buf_t buf,
+                                 uv_handle_type pending) {
+  HandleScope scope;
+
+  if (nread < 0)  {
+    // If libuv reports an error or EOF it *may* give us a buffer back. It's
+    // the pool's scratch memory, there is nothing to return.
+    SetErrno(uv_last_error(uv_default_loop()));
+    MakeCallback(wrap_->object_, onread_sym, 0, NULL);
+    return;
+  }
+
+  if (nread == 0) return;
+  assert(buf.base != NULL);
+  assert(static_cast<size_t>(nread) <= buf.len);
+
+  // Copy the data out of the scratch area before anything else can read
+  // into it.
+  Local<Object> slice = BufferPool::Default()->Take(buf.base, nread);
+
+  int argc = 3;
+  Local<Value> argv[4] = {
+    slice,
+    Integer::NewFromUnsigned(0),
+    Integer::NewFromUnsigned(nread)
+  };
+
+  Local<Object> pending_obj;
+  if (pending == UV_TCP) {
+    pending_obj = AcceptHandle<TCPWrap, uv_tcp_t>(handle);
+  } else if (pending == UV_NAMED_PIPE) {
+    pending_obj = AcceptHandle<PipeWrap, uv_pipe_t>(handle);
+  } else if (pending == UV_UDP) {
+    pending_obj = AcceptHandle<UDPWrap, uv_udp_t>(handle);
+  } else {
+    assert(pending == UV_UNKNOWN_HANDLE);
+  }
+
+  if (!pending_obj.IsEmpty()) {
+    argv[3] = pending_obj;
+    argc++;
+  }
+
+  MakeCallback(wrap_->object_, onread_sym, argc, argv);
+}
+
+
+int StreamWrapCallbacks::DoShutdown(ShutdownWrap* req_wrap,
+                                    uv_shutdown_cb cb) {
+  return uv_shutdown(&req_wrap->req_, wrap_->stream_, cb);
+}
+
+
 }
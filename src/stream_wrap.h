@@ -25,14 +25,86 @@
 #include "v8.h"
 #include "node.h"
 #include "handle_wrap.h"
+#include "req_wrap.h"
 #include "string_bytes.h"
 
 namespace node {
 
+// Forward declaration
+class StreamWrap;
+
+typedef class ReqWrap<uv_shutdown_t> ShutdownWrap;
+
+class WriteWrap: public ReqWrap<uv_write_t> {
+ public:
+  explicit WriteWrap(StreamWrap* wrap) : wrap_(wrap) { }
+
+  void* operator new(size_t size, char* storage) { return storage; }
+
+  // This is just to keep the compiler happy. It should never be called, since
+  // we don't use exceptions in node.
+  void operator delete(void* ptr, char* storage) { assert(0); }
+
+  inline StreamWrap* wrap() const { return wrap_; }
+
+ protected:
+  // People should not be using the non-placement new and delete operator on a
+  // WriteWrap. Ensure this never happens.
+  void* operator new (size_t size) { assert(0); };
+  void operator delete(void* ptr) { assert(0); };
+
+  StreamWrap* const wrap_;
+};
+
+// Overridable hooks that sit between a StreamWrap and its libuv stream.
+// The default implementation talks to the stream directly; a subclass can
+// take over a live stream through StreamWrap::OverrideCallbacks() to
+// transform the bytes in both directions (see tls_wrap.cc).
+class StreamWrapCallbacks {
+ public:
+  explicit StreamWrapCallbacks(StreamWrap* wrap) : wrap_(wrap) { }
+  explicit StreamWrapCallbacks(StreamWrapCallbacks* old)
+      : wrap_(old->wrap_) { }
+
+  virtual ~StreamWrapCallbacks() { }
+
+  virtual int DoWrite(WriteWrap* w,
+                      uv_buf_t* bufs,
+                      int count,
+                      uv_stream_t* send_handle,
+                      uv_write_cb cb);
+  virtual void AfterWrite(WriteWrap* w);
+  virtual uv_buf_t DoAlloc(uv_handle_t* handle, size_t suggested_size);
+  virtual void DoRead(uv_stream_t* handle,
+                      ssize_t nread,
+                      uv_buf_t buf,
+                      uv_handle_type pending);
+  virtual int DoShutdown(ShutdownWrap* req_wrap, uv_shutdown_cb cb);
+  // The stream is closed. Requests the callbacks still hold must be
+  // completed now, the StreamWrap is deleted right after.
+  virtual void AfterClose() { }
+
+ protected:
+  StreamWrap* wrap_;
+};
+
 class StreamWrap : public HandleWrap {
  public:
   uv_stream_t* GetStream() { return stream_; }
 
+  // Takes ownership of `callbacks`. The previous non-default callbacks, if
+  // any, are deleted.
+  void OverrideCallbacks(StreamWrapCallbacks* callbacks);
+  StreamWrapCallbacks* GetCallbacks() { return callbacks_; }
+
+  v8::Handle<v8::Object> GetObject() { return object_; }
+  void UpdateWriteQueueSize();
+
+  // Completes a write request towards JavaScript. Callbacks that hold on to
+  // writes complete them through this once their data is on the wire.
+  static void AfterWrite(uv_write_t* req, int status);
+  static void AfterShutdown(uv_shutdown_t* req, int status);
+
   static void Initialize(v8::Handle<v8::Object> target);
 
   static v8::Handle<v8::Value> GetFD(v8::Local<v8::String>,
@@ -47,20 +119,19 @@ class StreamWrap : public HandleWrap {
   static v8::Handle<v8::Value> WriteAsciiString(const v8::Arguments& args);
   static v8::Handle<v8::Value> WriteUtf8String(const v8::Arguments& args);
   static v8::Handle<v8::Value> WriteUcs2String(const v8::Arguments& args);
+  static v8::Handle<v8::Value> Writev(const v8::Arguments& args);
+  static v8::Handle<v8::Value> SendFile(const v8::Arguments& args);
 
  protected:
   StreamWrap(v8::Handle<v8::Object> object, uv_stream_t* stream);
+  virtual ~StreamWrap();
   virtual void SetHandle(uv_handle_t* h);
+  virtual void AfterClose();
   void StateChange() { }
-  void UpdateWriteQueueSize();
 
  private:
-  static inline char* NewSlab(v8::Handle<v8::Object> global, v8::Handle<v8::Object> wrap_obj);
-
   // Callbacks for libuv
-  static void AfterWrite(uv_write_t* req, int status);
   static uv_buf_t OnAlloc(uv_handle_t* handle, size_t suggested_size);
-  static void AfterShutdown(uv_shutdown_t* req, int status);
 
   static void OnRead(uv_stream_t* handle, ssize_t nread, uv_buf_t buf);
   static void OnRead2(uv_pipe_t* handle, ssize_t nread, uv_buf_t buf,
@@ -71,8 +142,12 @@ class StreamWrap : public HandleWrap {
   template <enum encoding encoding>
   static v8::Handle<v8::Value> WriteStringImpl(const v8::Arguments& args);
 
-  size_t slab_offset_;
   uv_stream_t* stream_;
+
+  StreamWrapCallbacks default_callbacks_;
+  StreamWrapCallbacks* callbacks_;  // Overridable callbacks
+
+  friend class StreamWrapCallbacks;
 };
 
 
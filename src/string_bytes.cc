@@ -20,6 +20,7 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "string_bytes.h"
+#include "string_bytes_simd.h"
 
 #include <assert.h>
 #include <string.h>  // memcpy
@@ -37,6 +38,7 @@ using v8::Handle;
 using v8::HandleScope;
 using v8::Object;
 using v8::String;
+using v8::V8;
 using v8::Value;
 
 
@@ -108,6 +110,14 @@ static inline size_t base64_decode(char *buf,
   const char* srcEnd = src + srcLen;
 
   while (src < srcEnd && dst < dstEnd) {
+    // Whole blocks of plain base64 are decoded in bulk. Padding, whitespace
+    // and the tail are left to the loop below, after each group of four
+    // characters it goes back to the fast path.
+    size_t n = simd::Base64Decode(dst, dstEnd - dst, src, srcEnd - src);
+    src += n;
+    dst += n / 4 * 3;
+    if (src == srcEnd || dst == dstEnd) break;
+
     int remaining = srcEnd - src;
 
     while (unbase64(*src) < 0 && src < srcEnd) src++, remaining--;
@@ -153,8 +163,8 @@ static inline size_t hex_decode(char *buf,
                                 size_t len,
                                 const char *src,
                                 const size_t srcLen) {
-  size_t i;
-  for (i = 0; i < len && i * 2 + 1 < srcLen; ++i) {
+  size_t i = simd::HexDecode(buf, len, src, srcLen);
+  for (; i < len && i * 2 + 1 < srcLen; ++i) {
     unsigned a = hex2bin(src[i * 2 + 0]);
     unsigned b = hex2bin(src[i * 2 + 1]);
     if (!~a || !~b) return i;
@@ -401,6 +411,10 @@ static bool contains_non_ascii_slow(const char* buf, size_t len) {
 
 
 static bool contains_non_ascii(const char* src, size_t len) {
+  size_t n = simd::AsciiPrefix(src, len);
+  src += n;
+  len -= n;
+
   if (len < 16) {
     return contains_non_ascii_slow(src, len);
   }
@@ -448,6 +462,11 @@ static void force_ascii_slow(const char* src, char* dst, size_t len) {
 
 
 static void force_ascii(const char* src, char* dst, size_t len) {
+  size_t n = simd::ForceAscii(src, dst, len);
+  src += n;
+  dst += n;
+  len -= n;
+
   if (len < 16) {
     force_ascii_slow(src, dst, len);
     return;
@@ -464,7 +483,7 @@ static void force_ascii(const char* src, char* dst, size_t len) {
       force_ascii_slow(src, dst, unalign);
       src += unalign;
       dst += unalign;
-      len -= src_unalign;
+      len -= unalign;
     } else {
       force_ascii_slow(src, dst, len);
       return;
@@ -514,9 +533,9 @@ static size_t base64_encode(const char* src,
                               "abcdefghijklmnopqrstuvwxyz"
                               "0123456789+/";
 
-  i = 0;
-  k = 0;
   n = slen / 3 * 3;
+  i = simd::Base64Encode(src, n, dst);
+  k = i / 3 * 4;
 
   while (i < n) {
     a = src[i + 0] & 0xff;
@@ -563,7 +582,8 @@ static size_t hex_encode(const char* src, size_t slen, char* dst, size_t dlen) {
       "not enough space provided for hex encode");
 
   dlen = slen * 2;
-  for (uint32_t i = 0, k = 0; k < dlen; i += 1, k += 2) {
+  size_t n = simd::HexEncode(src, slen, dst);
+  for (size_t i = n, k = n * 2; k < dlen; i += 1, k += 2) {
     static const char hex[] = "0123456789abcdef";
     uint8_t val = static_cast<uint8_t>(src[i]);
     dst[k + 0] = hex[val >> 4];
@@ -575,6 +595,19 @@ static size_t hex_encode(const char* src, size_t slen, char* dst, size_t dlen) {
 
 
 
+// Buffers made by Encode() hold digests, cipher output and derived keys, so
+// they get memory of their own instead of a BufferPool arena that other
+// Buffers can reach through .parent, and it is wiped when they are collected.
+static void FreeWiped(char* data, void* hint) {
+  size_t length = reinterpret_cast<size_t>(hint);
+  volatile char* p = data;
+  for (size_t i = 0; i < length; i++)
+    p[i] = 0;
+  delete[] data;
+  V8::AdjustAmountOfExternalAllocatedMemory(-static_cast<intptr_t>(length));
+}
+
+
 Local<Value> StringBytes::Encode(const char* buf,
                                  size_t buflen,
                                  enum encoding encoding) {
@@ -586,8 +619,14 @@ Local<Value> StringBytes::Encode(const char* buf,
 
   Local<String> val;
   switch (encoding) {
-    case BUFFER:
-      return scope.Close(Buffer::New(buf, buflen)->handle_);
+    case BUFFER: {
+      char* data = new char[buflen];
+      memcpy(data, buf, buflen);
+      V8::AdjustAmountOfExternalAllocatedMemory(buflen);
+      Buffer* slow = Buffer::New(data, buflen, FreeWiped,
+                                 reinterpret_cast<void*>(buflen));
+      return scope.Close(Buffer::Slice(slow->handle_, 0, buflen));
+    }
 
     case ASCII:
       if (contains_non_ascii(buf, buflen)) {
@@ -0,0 +1,532 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "string_bytes_simd.h"
+
+#include <stdint.h>
+
+#if defined(__i386__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
+# if defined(_MSC_VER)
+#  define NODE_SIMD_TARGET(isa)
+#  define NODE_HAVE_SIMD 1
+# elif defined(__clang__) || \
+    __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+   // Compile the kernels for their instruction set only, the rest of node
+   // keeps running on the baseline that the compiler targets.
+#  define NODE_SIMD_TARGET(isa) __attribute__((target(isa)))
+#  define NODE_HAVE_SIMD 1
+# endif
+#endif
+
+#if NODE_HAVE_SIMD
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+# include <immintrin.h>
+#endif
+
+namespace node {
+namespace simd {
+
+static size_t AsciiPrefixNone(const char* src, size_t len) {
+  return 0;
+}
+
+
+static size_t ForceAsciiNone(const char* src, char* dst, size_t len) {
+  return 0;
+}
+
+
+static size_t EncodeNone(const char* src, size_t slen, char* dst) {
+  return 0;
+}
+
+
+static size_t DecodeNone(char* dst, size_t dlen, const char* src, size_t slen) {
+  return 0;
+}
+
+
+struct Kernels {
+  const char* level;
+  size_t (*ascii_prefix)(const char* src, size_t len);
+  size_t (*force_ascii)(const char* src, char* dst, size_t len);
+  size_t (*base64_encode)(const char* src, size_t slen, char* dst);
+  size_t (*base64_decode)(char* dst, size_t dlen, const char* src, size_t slen);
+  size_t (*hex_encode)(const char* src, size_t slen, char* dst);
+  size_t (*hex_decode)(char* dst, size_t dlen, const char* src, size_t slen);
+};
+
+
+static const Kernels kernels_none = {
+  "none",
+  AsciiPrefixNone,
+  ForceAsciiNone,
+  EncodeNone,
+  DecodeNone,
+  EncodeNone,
+  DecodeNone
+};
+
+
+#if NODE_HAVE_SIMD
+
+//// ASCII ////
+
+NODE_SIMD_TARGET("sse2")
+static size_t AsciiPrefixSSE2(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(v)) break;
+  }
+  return i;
+}
+
+
+NODE_SIMD_TARGET("avx2")
+static size_t AsciiPrefixAVX2(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    if (_mm256_movemask_epi8(v)) break;
+  }
+  return i;
+}
+
+
+NODE_SIMD_TARGET("sse2")
+static size_t ForceAsciiSSE2(const char* src, char* dst, size_t len) {
+  const __m128i mask = _mm_set1_epi8(0x7f);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_and_si128(v, mask));
+  }
+  return i;
+}
+
+
+NODE_SIMD_TARGET("avx2")
+static size_t ForceAsciiAVX2(const char* src, char* dst, size_t len) {
+  const __m256i mask = _mm256_set1_epi8(0x7f);
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_and_si256(v, mask));
+  }
+  return i;
+}
+
+
+//// Base 64 ////
+
+// The base64 kernels follow Wojciech Muła's and Daniel Lemire's approach,
+// see http://0x80.pl/articles/index.html#base64-algorithm-new
+
+// Splits 12 bytes, 3 at a time, into 16 six bit values.
+NODE_SIMD_TARGET("ssse3")
+static inline __m128i Base64Unpack(__m128i in) {
+  in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                          7, 6, 8, 7, 10, 9, 11, 10));
+  __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+
+// Maps six bit values to the characters of the base64 alphabet.
+NODE_SIMD_TARGET("ssse3")
+static inline __m128i Base64Translate(__m128i indices) {
+  const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '+' - 62,
+                                        '/' - 63, 'A', 0, 0);
+  // 0..25 map to 13, 26..51 to 0 and 52..63 to 1..12.
+  __m128i index = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  index = _mm_or_si128(index, _mm_and_si128(upper, _mm_set1_epi8(13)));
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, index));
+}
+
+
+NODE_SIMD_TARGET("ssse3")
+static size_t Base64EncodeSSSE3(const char* src, size_t slen, char* dst) {
+  size_t i = 0;
+  size_t k = 0;
+  // Loads are 16 bytes wide but only 12 of them are used.
+  for (; i + 16 <= slen; i += 12, k += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k),
+                     Base64Translate(Base64Unpack(in)));
+  }
+  return i;
+}
+
+
+NODE_SIMD_TARGET("avx2")
+static size_t Base64EncodeAVX2(const char* src, size_t slen, char* dst) {
+  const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                           7, 6, 8, 7, 10, 9, 11, 10,
+                                           1, 0, 2, 1, 4, 3, 5, 4,
+                                           7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0,
+                                           'a' - 26, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  size_t k = 0;
+  // Each lane takes 12 bytes, the second load reads 4 bytes past them.
+  for (; i + 28 <= slen; i += 24, k += 32) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+    in = _mm256_shuffle_epi8(in, shuffle);
+    __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i index = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    index = _mm256_or_si256(index,
+                            _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    __m256i out =
+        _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, index));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), out);
+  }
+  return i;
+}
+
+
+// Returns a mask of the bytes in [lo, hi].
+NODE_SIMD_TARGET("sse2")
+static inline __m128i InRange(__m128i v, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                       _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), v));
+}
+
+
+// Decodes 16 characters to 12 bytes in the low part of *out. Returns false
+// if any of them is not in the regular or the URL-safe alphabet.
+NODE_SIMD_TARGET("ssse3")
+static inline bool Base64DecodeBlock(__m128i v, __m128i* out) {
+  __m128i upper = InRange(v, 'A', 'Z');
+  __m128i lower = InRange(v, 'a', 'z');
+  __m128i digit = InRange(v, '0', '9');
+  __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+  __m128i minus = _mm_cmpeq_epi8(v, _mm_set1_epi8('-'));
+  __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+  __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+
+  __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                               _mm_or_si128(digit, plus));
+  valid = _mm_or_si128(_mm_or_si128(valid, minus),
+                       _mm_or_si128(slash, underscore));
+  if (_mm_movemask_epi8(valid) != 0xffff)
+    return false;
+
+  __m128i delta =
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                   _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+  delta = _mm_or_si128(delta,
+                       _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+  delta = _mm_or_si128(delta, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+  delta = _mm_or_si128(delta, _mm_and_si128(minus, _mm_set1_epi8(62 - '-')));
+  delta = _mm_or_si128(delta, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+  delta = _mm_or_si128(delta,
+                       _mm_and_si128(underscore, _mm_set1_epi8(63 - '_')));
+  __m128i values = _mm_add_epi8(v, delta);
+
+  // Merge pairs of six bit values into 12 bits, then pairs of those into 24.
+  __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+  *out = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4,
+                                                10, 9, 8, 14, 13, 12,
+                                                -1, -1, -1, -1));
+  return true;
+}
+
+
+NODE_SIMD_TARGET("ssse3")
+static size_t Base64DecodeSSSE3(char* dst,
+                                size_t dlen,
+                                const char* src,
+                                size_t slen) {
+  size_t i = 0;
+  size_t k = 0;
+  // Stores are 16 bytes wide but only 12 of them are used.
+  for (; i + 16 <= slen && k + 16 <= dlen; i += 16, k += 12) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i out;
+    if (!Base64DecodeBlock(v, &out)) break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), out);
+  }
+  return i;
+}
+
+
+//// HEX ////
+
+NODE_SIMD_TARGET("ssse3")
+static size_t HexEncodeSSSE3(const char* src, size_t slen, char* dst) {
+  const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= slen; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    __m128i lo = _mm_and_si128(v, nibble);
+    hi = _mm_shuffle_epi8(digits, hi);
+    lo = _mm_shuffle_epi8(digits, lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i),
+                     _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16),
+                     _mm_unpackhi_epi8(hi, lo));
+  }
+  return i;
+}
+
+
+NODE_SIMD_TARGET("avx2")
+static size_t HexEncodeAVX2(const char* src, size_t slen, char* dst) {
+  const __m256i digits =
+      _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                       '0', '1', '2', '3', '4', '5', '6', '7',
+                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= slen; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    __m256i lo = _mm256_and_si256(v, nibble);
+    hi = _mm256_shuffle_epi8(digits, hi);
+    lo = _mm256_shuffle_epi8(digits, lo);
+    // Unpacking works per 128 bit lane, put the halves back in order.
+    __m256i a = _mm256_unpacklo_epi8(hi, lo);
+    __m256i b = _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i),
+                        _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + 32),
+                        _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  return i;
+}
+
+
+// Turns 16 hex digits into their values, 0 to 15. Returns false if any of
+// them is not a hex digit.
+NODE_SIMD_TARGET("sse2")
+static inline bool HexNibbles(__m128i v, __m128i* out) {
+  __m128i digit = InRange(v, '0', '9');
+  // Folds 'A' to 'F' onto 'a' to 'f', nothing else lands there.
+  __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  __m128i alpha = InRange(folded, 'a', 'f');
+  if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xffff)
+    return false;
+
+  __m128i d = _mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0')));
+  __m128i a = _mm_and_si128(alpha,
+                            _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10)));
+  *out = _mm_or_si128(d, a);
+  return true;
+}
+
+
+NODE_SIMD_TARGET("ssse3")
+static size_t HexDecodeSSSE3(char* dst,
+                             size_t dlen,
+                             const char* src,
+                             size_t slen) {
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  size_t i = 0;
+  for (; i + 16 <= dlen && 2 * i + 32 <= slen; i += 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+    __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i + 16));
+    if (!HexNibbles(a, &a) || !HexNibbles(b, &b)) break;
+    // high * 16 + low for every pair of nibbles.
+    a = _mm_maddubs_epi16(a, weights);
+    b = _mm_maddubs_epi16(b, weights);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(a, b));
+  }
+  return i;
+}
+
+
+//// Dispatch ////
+
+static const Kernels kernels_sse2 = {
+  "sse2",
+  AsciiPrefixSSE2,
+  ForceAsciiSSE2,
+  EncodeNone,
+  DecodeNone,
+  EncodeNone,
+  DecodeNone
+};
+
+static const Kernels kernels_ssse3 = {
+  "ssse3",
+  AsciiPrefixSSE2,
+  ForceAsciiSSE2,
+  Base64EncodeSSSE3,
+  Base64DecodeSSSE3,
+  HexEncodeSSSE3,
+  HexDecodeSSSE3
+};
+
+// Decoding is branchy per block, wider vectors don't buy much there.
+static const Kernels kernels_avx2 = {
+  "avx2",
+  AsciiPrefixAVX2,
+  ForceAsciiAVX2,
+  Base64EncodeAVX2,
+  Base64DecodeSSSE3,
+  HexEncodeAVX2,
+  HexDecodeSSSE3
+};
+
+
+static void CpuId(unsigned int leaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuidex(info, leaf, 0);
+  for (int i = 0; i < 4; i++) regs[i] = info[i];
+#else
+  __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+// Whether the OS saves the YMM registers on context switches.
+static bool HaveOsAvx() {
+#if defined(_MSC_VER)
+  return (_xgetbv(0) & 6) == 6;
+#else
+  unsigned int eax;
+  unsigned int edx;
+  __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"  // xgetbv
+                       : "=a" (eax), "=d" (edx)
+                       : "c" (0));
+  return (eax & 6) == 6;
+#endif
+}
+
+
+#endif  // NODE_HAVE_SIMD
+
+
+static const Kernels* Detect() {
+#if NODE_HAVE_SIMD
+  unsigned int regs[4];
+
+  CpuId(0, regs);
+  unsigned int max_leaf = regs[0];
+  if (max_leaf < 1) return &kernels_none;
+
+  CpuId(1, regs);
+  bool sse2 = (regs[3] & (1 << 26)) != 0;
+  bool ssse3 = (regs[2] & (1 << 9)) != 0;
+  bool osxsave = (regs[2] & (1 << 27)) != 0;
+  bool avx = (regs[2] & (1 << 28)) != 0;
+
+  bool avx2 = false;
+  if (max_leaf >= 7 && osxsave && avx && HaveOsAvx()) {
+    CpuId(7, regs);
+    avx2 = (regs[1] & (1 << 5)) != 0;
+  }
+
+  if (avx2 && ssse3) return &kernels_avx2;
+  if (ssse3) return &kernels_ssse3;
+  if (sse2) return &kernels_sse2;
+#endif  // NODE_HAVE_SIMD
+  return &kernels_none;
+}
+
+
+// Set up on first use. Racing threads all store the same value.
+static const Kernels* kernels;
+
+static inline const Kernels* Get() {
+  if (kernels == NULL) kernels = Detect();
+  return kernels;
+}
+
+
+size_t AsciiPrefix(const char* src, size_t len) {
+  return Get()->ascii_prefix(src, len);
+}
+
+
+size_t ForceAscii(const char* src, char* dst, size_t len) {
+  return Get()->force_ascii(src, dst, len);
+}
+
+
+size_t Base64Encode(const char* src, size_t slen, char* dst) {
+  return Get()->base64_encode(src, slen, dst);
+}
+
+
+size_t Base64Decode(char* dst, size_t dlen, const char* src, size_t slen) {
+  return Get()->base64_decode(dst, dlen, src, slen);
+}
+
+
+size_t HexEncode(const char* src, size_t slen, char* dst) {
+  return Get()->hex_encode(src, slen, dst);
+}
+
+
+size_t HexDecode(char* dst, size_t dlen, const char* src, size_t slen) {
+  return Get()->hex_decode(dst, dlen, src, slen);
+}
+
+
+const char* Level() {
+  return Get()->level;
+}
+
+}  // namespace simd
+}  // namespace node
@@ -0,0 +1,70 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SRC_STRING_BYTES_SIMD_H_
+#define SRC_STRING_BYTES_SIMD_H_
+
+// Vectorized kernels for the loops in string_bytes.cc.
+//
+// Each kernel converts as much of its input as it can in whole vector blocks
+// and returns how far it got, the scalar code in string_bytes.cc does the
+// rest. Which instruction set is used is decided once, at startup, from what
+// the CPU supports. Where there is nothing to use, like on ARM, PPC or s390,
+// every kernel returns 0.
+
+#include <stddef.h>
+
+namespace node {
+namespace simd {
+
+// Length of the leading part of src that is known to be 7 bit ASCII. Stops
+// at the first block that has a byte with the high bit set.
+size_t AsciiPrefix(const char* src, size_t len);
+
+// Copies src to dst with the high bit of every byte cleared. Returns the
+// number of bytes copied.
+size_t ForceAscii(const char* src, char* dst, size_t len);
+
+// Encodes a multiple of 3 bytes from src, returns the number of bytes that
+// were encoded. dst receives 4 / 3 times as many characters.
+size_t Base64Encode(const char* src, size_t slen, char* dst);
+
+// Decodes regular and URL-safe base64. Stops at padding, whitespace or any
+// other character that needs the scalar decoder to look at it. Returns the
+// number of characters that were decoded, a multiple of 4. dst receives
+// 3 / 4 times as many bytes.
+size_t Base64Decode(char* dst, size_t dlen, const char* src, size_t slen);
+
+// Encodes bytes from src as lower case hex, returns the number of bytes that
+// were encoded. dst receives twice as many characters.
+size_t HexEncode(const char* src, size_t slen, char* dst);
+
+// Decodes pairs of hex digits from src. Stops at the first block with a
+// character that isn't a hex digit. Returns the number of bytes written.
+size_t HexDecode(char* dst, size_t dlen, const char* src, size_t slen);
+
+// The instruction set in use: "avx2", "ssse3", "sse2" or "none".
+const char* Level();
+
+}  // namespace simd
+}  // namespace node
+
+#endif  // SRC_STRING_BYTES_SIMD_H_
@@ -0,0 +1,248 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "timer_wheel.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace node {
+
+
+TimerWheel::TimerWheel(uint64_t now)
+    : entries_(NULL),
+      capacity_(0),
+      count_(0),
+      now_(now) {
+  for (int level = 0; level < kLevels; level++) {
+    for (int slot = 0; slot < kSlots; slot++)
+      heads_[level][slot] = kNone;
+    occupied_[level] = 0;
+    level_count_[level] = 0;
+  }
+}
+
+
+TimerWheel::~TimerWheel() {
+  free(entries_);
+}
+
+
+bool TimerWheel::Grow(int id) {
+  int capacity = capacity_ > 0 ? capacity_ : kSlots;
+  while (capacity <= id)
+    capacity *= 2;
+
+  Entry* entries = static_cast<Entry*>(
+      realloc(entries_, capacity * sizeof(*entries)));
+  if (entries == NULL)
+    return false;
+
+  memset(entries + capacity_, 0, (capacity - capacity_) * sizeof(*entries));
+  entries_ = entries;
+  capacity_ = capacity;
+  return true;
+}
+
+
+void TimerWheel::Link(int id) {
+  static const uint64_t kRange = static_cast<uint64_t>(1) << (kBits * kLevels);
+  Entry* e = entries_ + id;
+
+  uint64_t delta = e->when - now_;
+  if (delta >= kRange) {
+    e->when = now_ + kRange - 1;
+    delta = kRange - 1;
+  }
+
+  int level = 0;
+  while (delta >= static_cast<uint64_t>(1) << (kBits * (level + 1)))
+    level++;
+
+  int slot = (e->when >> (kBits * level)) & (kSlots - 1);
+
+  e->level = level;
+  e->slot = slot;
+  e->prev = kNone;
+  e->next = heads_[level][slot];
+  if (e->next != kNone)
+    entries_[e->next].prev = id;
+  e->active = true;
+
+  heads_[level][slot] = id;
+  occupied_[level] |= static_cast<uint64_t>(1) << slot;
+  level_count_[level]++;
+  count_++;
+}
+
+
+void TimerWheel::Unlink(int id) {
+  Entry* e = entries_ + id;
+  assert(e->active);
+
+  if (e->prev != kNone)
+    entries_[e->prev].next = e->next;
+  else
+    heads_[e->level][e->slot] = e->next;
+
+  if (e->next != kNone)
+    entries_[e->next].prev = e->prev;
+
+  if (heads_[e->level][e->slot] == kNone)
+    occupied_[e->level] &= ~(static_cast<uint64_t>(1) << e->slot);
+
+  e->active = false;
+  level_count_[e->level]--;
+  count_--;
+}
+
+
+bool TimerWheel::Start(int id, uint64_t timeout, uint64_t now) {
+  assert(id >= 0);
+
+  if (id >= capacity_ && !Grow(id))
+    return false;
+
+  if (entries_[id].active)
+    Unlink(id);
+
+  // An empty wheel is not advanced, catch up first so that the entry is
+  // filed relative to the current time.
+  if (count_ == 0 && now > now_)
+    now_ = now;
+
+  uint64_t when = now + timeout;
+  if (when <= now_)
+    when = now_ + 1;
+
+  entries_[id].when = when;
+  Link(id);
+  return true;
+}
+
+
+void TimerWheel::Stop(int id) {
+  if (IsActive(id))
+    Unlink(id);
+}
+
+
+bool TimerWheel::IsActive(int id) const {
+  return id >= 0 && id < capacity_ && entries_[id].active;
+}
+
+
+// Moves the entries of the current slot of `level` to the levels below.
+void TimerWheel::Cascade(int level) {
+  int slot = (now_ >> (kBits * level)) & (kSlots - 1);
+  int id = heads_[level][slot];
+
+  heads_[level][slot] = kNone;
+  occupied_[level] &= ~(static_cast<uint64_t>(1) << slot);
+
+  while (id != kNone) {
+    Entry* e = entries_ + id;
+    int next = e->next;
+    e->active = false;
+    level_count_[level]--;
+    count_--;
+    Link(id);
+    id = next;
+  }
+}
+
+
+void TimerWheel::Advance(uint64_t now, ExpireCallback cb, void* arg) {
+  uint64_t next;
+
+  while (NextWakeup(&next) && next <= now) {
+    // Nothing happens between now_ and next.
+    now_ = next;
+
+    // Slot boundaries line up: when level n starts a new slot, so do all
+    // levels below it. Cascade from the top so entries can drop several
+    // levels at once.
+    int top = 0;
+    while (top < kLevels - 1 &&
+           (now_ & ((static_cast<uint64_t>(1) << (kBits * (top + 1))) - 1))
+               == 0) {
+      top++;
+    }
+    for (int level = top; level > 0; level--)
+      Cascade(level);
+
+    int slot = now_ & (kSlots - 1);
+    int id = heads_[0][slot];
+
+    heads_[0][slot] = kNone;
+    occupied_[0] &= ~(static_cast<uint64_t>(1) << slot);
+
+    while (id != kNone) {
+      Entry* e = entries_ + id;
+      int next_id = e->next;
+      assert(e->when == now_);
+      e->active = false;
+      level_count_[0]--;
+      count_--;
+      cb(id, arg);
+      id = next_id;
+    }
+  }
+
+  if (now > now_)
+    now_ = now;
+}
+
+
+bool TimerWheel::NextWakeup(uint64_t* when) const {
+  if (count_ == 0)
+    return false;
+
+  uint64_t best = ~static_cast<uint64_t>(0);
+
+  // The next event of a level is the start of its first non-empty slot
+  // after the current one: an expiry in level 0, a cascade elsewhere.
+  for (int level = 0; level < kLevels; level++) {
+    if (level_count_[level] == 0)
+      continue;
+
+    int shift = kBits * level;
+    uint64_t block = now_ >> shift;
+    int index = block & (kSlots - 1);
+
+    for (int k = 1; k <= kSlots; k++) {
+      int slot = (index + k) & (kSlots - 1);
+      if (occupied_[level] & (static_cast<uint64_t>(1) << slot)) {
+        uint64_t t = (block + k) << shift;
+        if (t < best)
+          best = t;
+        break;
+      }
+    }
+  }
+
+  *when = best;
+  return true;
+}
+
+}  // namespace node
@@ -0,0 +1,99 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef SRC_TIMER_WHEEL_H_
+#define SRC_TIMER_WHEEL_H_
+
+#include <stdint.h>
+
+namespace node {
+
+// Hierarchical timing wheel for large numbers of coarse timeouts, like the
+// idle timeouts of sockets. Start, Stop and restarting an entry are O(1)
+// no matter how many entries there are.
+//
+// Time is measured in milliseconds. Level n of the wheel has kSlots slots
+// of kSlots^n milliseconds each. Entries are filed in the lowest level
+// whose range covers their expiry and are moved down a level when the
+// wheel reaches the start of their slot, until they expire in level 0.
+//
+// Entries are identified by small non-negative integers chosen by the
+// caller; the wheel grows its entry table to fit the largest id.
+class TimerWheel {
+ public:
+  typedef void (*ExpireCallback)(int id, void* arg);
+
+  explicit TimerWheel(uint64_t now);
+  ~TimerWheel();
+
+  // (Re)starts entry `id` to expire `timeout` milliseconds after `now`.
+  // Returns false if the entry table could not be grown.
+  bool Start(int id, uint64_t timeout, uint64_t now);
+
+  // Stops entry `id`. Stopping an inactive entry is a no-op.
+  void Stop(int id);
+
+  bool IsActive(int id) const;
+  inline bool IsEmpty() const { return count_ == 0; }
+  inline unsigned int count() const { return count_; }
+
+  // Moves the wheel forward to `now` and calls `cb` for every entry that
+  // expired on the way. Expired entries are inactive by the time `cb` runs.
+  // `cb` must not call back into the wheel.
+  void Advance(uint64_t now, ExpireCallback cb, void* arg);
+
+  // Stores in `when` the next time at which Advance() has work to do.
+  // Returns false if the wheel is empty.
+  bool NextWakeup(uint64_t* when) const;
+
+ private:
+  static const int kBits = 6;
+  static const int kSlots = 1 << kBits;
+  static const int kLevels = 6;
+  static const int kNone = -1;
+
+  struct Entry {
+    uint64_t when;
+    int next;
+    int prev;
+    unsigned char level;
+    unsigned char slot;
+    bool active;
+  };
+
+  bool Grow(int id);
+  void Link(int id);
+  void Unlink(int id);
+  void Cascade(int level);
+
+  Entry* entries_;
+  int capacity_;
+  unsigned int count_;
+  uint64_t now_;
+  int heads_[kLevels][kSlots];
+  uint64_t occupied_[kLevels];  // Bit n set when slot n is non-empty.
+  unsigned int level_count_[kLevels];
+};
+
+}  // namespace node
+
+#endif  // SRC_TIMER_WHEEL_H_
@@ -21,6 +21,7 @@
 
 #include "node.h"
 #include "handle_wrap.h"
+#include "timer_wheel.h"
 
 namespace node {
 
@@ -37,8 +38,10 @@ using v8::TryCatch;
 using v8::Context;
 using v8::Arguments;
 using v8::Integer;
+using v8::Array;
 
 static Persistent<String> ontimeout_sym;
+static Persistent<String> onexpire_sym;
 
 class TimerWrap : public HandleWrap {
  public:
@@ -177,6 +180,155 @@ class TimerWrap : public HandleWrap {
 };
 
 
+
+// Timing wheel backed by a single uv_timer_t, used by timers._unrefActive()
+// for socket idle timeouts. Entries are identified by integer ids that the
+// JS side hands out and maps back to objects. Starting, stopping and
+// restarting an entry does not touch the uv timer unless the entry expires
+// before anything else. Expired entries are reported in one batch per run
+// of the timer: onexpire(ids).
+class TimerWheelWrap : public HandleWrap {
+ public:
+  static void Initialize(Handle<Object> target) {
+    HandleScope scope;
+
+    Local<FunctionTemplate> constructor = FunctionTemplate::New(New);
+    constructor->InstanceTemplate()->SetInternalFieldCount(1);
+    constructor->SetClassName(String::NewSymbol("TimerWheel"));
+
+    NODE_SET_PROTOTYPE_METHOD(constructor, "close", HandleWrap::Close);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "ref", HandleWrap::Ref);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "unref", HandleWrap::Unref);
+
+    NODE_SET_PROTOTYPE_METHOD(constructor, "start", Start);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "stop", Stop);
+
+    onexpire_sym = NODE_PSYMBOL("onexpire");
+
+    target->Set(String::NewSymbol("TimerWheel"), constructor->GetFunction());
+  }
+
+ private:
+  static Handle<Value> New(const Arguments& args) {
+    assert(args.IsConstructCall());
+
+    HandleScope scope;
+    TimerWheelWrap* wrap = new TimerWheelWrap(args.This());
+    assert(wrap);
+
+    return scope.Close(args.This());
+  }
+
+  TimerWheelWrap(Handle<Object> object)
+      : HandleWrap(object, (uv_handle_t*) &handle_),
+        wheel_(uv_now(uv_default_loop())),
+        armed_(0) {
+    int r = uv_timer_init(uv_default_loop(), &handle_);
+    assert(r == 0);
+    handle_.data = this;
+  }
+
+  ~TimerWheelWrap() {
+  }
+
+  // Points the uv timer at the next time the wheel has work to do.
+  void Arm() {
+    uint64_t when;
+
+    if (!wheel_.NextWakeup(&when)) {
+      uv_timer_stop(&handle_);
+      armed_ = 0;
+      return;
+    }
+
+    uint64_t now = uv_now(uv_default_loop());
+    uv_timer_start(&handle_, OnTimeout, when > now ? when - now : 0, 0);
+    armed_ = when;
+  }
+
+  // start(id, msecs)
+  static Handle<Value> Start(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP(TimerWheelWrap)
+
+    int id = args[0]->Int32Value();
+    int64_t timeout = args[1]->IntegerValue();
+    assert(id >= 0);
+    assert(timeout >= 0);
+
+    // The loop time is from the start of this tick, JS may have been busy
+    // since. A stale clock would make the timeout expire early.
+    uv_update_time(uv_default_loop());
+    uint64_t now = uv_now(uv_default_loop());
+
+    if (!wrap->wheel_.Start(id, timeout, now)) {
+      uv_err_t err;
+      err.code = UV_ENOMEM;
+      SetErrno(err);
+      return scope.Close(Integer::New(-1));
+    }
+
+    // Only an entry that expires before the armed time needs a new one.
+    // Entries that just move down a level on the way are picked up when
+    // the timer fires anyway, Advance() handles everything up to now.
+    if (wrap->armed_ == 0 || now + timeout < wrap->armed_)
+      wrap->Arm();
+
+    return scope.Close(Integer::New(0));
+  }
+
+  // stop(id)
+  static Handle<Value> Stop(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP(TimerWheelWrap)
+
+    wrap->wheel_.Stop(args[0]->Int32Value());
+
+    // A timer that fires early finds nothing to do and rearms itself, only
+    // stop it when there is nothing left.
+    if (wrap->wheel_.IsEmpty() && wrap->armed_ != 0) {
+      uv_timer_stop(&wrap->handle_);
+      wrap->armed_ = 0;
+    }
+
+    return scope.Close(Integer::New(0));
+  }
+
+  static void OnExpire(int id, void* arg) {
+    Local<Array>* expired = static_cast<Local<Array>*>(arg);
+    (*expired)->Set((*expired)->Length(), Integer::New(id));
+  }
+
+  static void OnTimeout(uv_timer_t* handle, int status) {
+    HandleScope scope;
+
+    TimerWheelWrap* wrap = static_cast<TimerWheelWrap*>(handle->data);
+    assert(wrap);
+
+    Local<Array> expired = Array::New();
+    wrap->wheel_.Advance(uv_now(uv_default_loop()), OnExpire, &expired);
+    wrap->Arm();
+
+    if (expired->Length() == 0)
+      return;
+
+    Local<Value> argv[1] = { expired };
+    MakeCallback(wrap->object_, onexpire_sym, ARRAY_SIZE(argv), argv);
+  }
+
+  uv_timer_t handle_;
+  TimerWheel wheel_;
+  uint64_t armed_;  // Time the uv timer fires at, 0 when stopped.
+};
+
+
+static void InitTimerWrap(Handle<Object> target) {
+  TimerWrap::Initialize(target);
+  TimerWheelWrap::Initialize(target);
+}
+
 }  // namespace node
 
-NODE_MODULE(node_timer_wrap, node::TimerWrap::Initialize)
+NODE_MODULE(node_timer_wrap, node::InitTimerWrap)
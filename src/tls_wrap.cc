@@ -0,0 +1,813 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "node.h"
+#include "node_buffer.h"
+#include "node_crypto.h"
+#include "handle_wrap.h"
+#include "stream_wrap.h"
+#include "tls_wrap.h"
+#include "util.h"
+
+#include <openssl/err.h>
+#include <string.h>
+
+namespace node {
+
+using v8::Arguments;
+using v8::Exception;
+using v8::False;
+using v8::FunctionTemplate;
+using v8::Handle;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Local;
+using v8::Null;
+using v8::Object;
+using v8::Persistent;
+using v8::String;
+using v8::True;
+using v8::Undefined;
+using v8::Value;
+
+using crypto::SecureContext;
+
+static Persistent<String> onerror_sym;
+static Persistent<String> onhandshakestart_sym;
+static Persistent<String> onhandshakedone_sym;
+
+static Persistent<FunctionTemplate> tls_wrap_constructor;
+
+// The SSL app data slot belongs to crypto::Connection, the SecureContext
+// callbacks expect to find one there. Native streams keep their pointer in a
+// separate ex_data slot.
+static int ex_index = -1;
+
+
+// Accept every certificate, the verdict is read back through verifyError()
+// once the handshake is done. See VerifyCallback() in node_crypto.cc.
+static int VerifyCallback(int preverify_ok, X509_STORE_CTX* ctx) {
+  return 1;
+}
+
+
+TLSCallbacks::WriteItem::WriteItem(WriteWrap* w,
+                                   uv_write_cb cb,
+                                   uv_buf_t* bufs,
+                                   int count)
+    : w_(w),
+      cb_(cb),
+      bufs_(new uv_buf_t[count]),
+      count_(count),
+      index_(0) {
+  memcpy(bufs_, bufs, sizeof(*bufs) * count);
+}
+
+
+TLSCallbacks::WriteItem::~WriteItem() {
+  delete[] bufs_;
+}
+
+
+TLSCallbacks::EncWrite::EncWrite(TLSCallbacks* callbacks, size_t size)
+    : callbacks_(callbacks),
+      data_(new char[size]),
+      size_(size) {
+  ngx_queue_init(&items_);
+  req_.data = this;
+}
+
+
+TLSCallbacks::EncWrite::~EncWrite() {
+  delete[] data_;
+}
+
+
+TLSCallbacks::TLSCallbacks(StreamWrap* wrap,
+                           SecureContext* sc,
+                           Handle<Object> sc_obj,
+                           bool is_server)
+    : StreamWrapCallbacks(wrap),
+      is_server_(is_server),
+      started_(false),
+      established_(false),
+      shutdown_(false),
+      shutdown_req_(NULL),
+      shutdown_cb_(NULL),
+      shutdown_idle_(NULL) {
+  HandleScope scope;
+
+  object_ = Persistent<Object>::New(
+      tls_wrap_constructor->GetFunction()->NewInstance());
+  object_->SetPointerInInternalField(0, this);
+
+  // Keep the context alive for as long as the SSL uses it.
+  sc_handle_ = Persistent<Object>::New(sc_obj);
+
+  ngx_queue_init(&write_item_queue_);
+
+  ssl_ = SSL_new(sc->ctx_);
+  enc_in_ = BIO_new(BIO_s_mem());
+  enc_out_ = BIO_new(BIO_s_mem());
+
+  // An empty input BIO means "try again later", not end of stream.
+  BIO_set_mem_eof_return(enc_in_, -1);
+  SSL_set_bio(ssl_, enc_in_, enc_out_);
+  SSL_set_ex_data(ssl_, ex_index, this);
+
+#ifdef SSL_MODE_RELEASE_BUFFERS
+  long mode = SSL_get_mode(ssl_);
+  SSL_set_mode(ssl_, mode | SSL_MODE_RELEASE_BUFFERS);
+#endif
+
+  // Like crypto::Connection, clients always proceed and check the peer in
+  // JavaScript. Servers opt into client certificates with setVerifyMode().
+  SSL_set_verify(ssl_, SSL_VERIFY_NONE, VerifyCallback);
+
+  if (is_server_) {
+    SSL_set_info_callback(ssl_, SSLInfoCallback);
+    SSL_set_accept_state(ssl_);
+  } else {
+    SSL_set_connect_state(ssl_);
+  }
+}
+
+
+TLSCallbacks::~TLSCallbacks() {
+  SSL_free(ssl_);
+  ssl_ = NULL;
+  enc_in_ = NULL;
+  enc_out_ = NULL;
+
+  // AfterClose() has completed everything, unless the callbacks were
+  // replaced while the stream was open.
+  StopShutdownIdle();
+  delete shutdown_req_;
+  shutdown_req_ = NULL;
+
+  while (!ngx_queue_empty(&write_item_queue_)) {
+    ngx_queue_t* q = ngx_queue_head(&write_item_queue_);
+    ngx_queue_remove(q);
+
+    WriteItem* wi = ngx_queue_data(q, WriteItem, member_);
+    wi->w_->~WriteWrap();
+    delete[] reinterpret_cast<char*>(wi->w_);
+    delete wi;
+  }
+
+  object_->SetPointerInInternalField(0, NULL);
+  object_.Dispose();
+  object_.Clear();
+
+  sc_handle_.Dispose();
+  sc_handle_.Clear();
+}
+
+
+bool TLSCallbacks::IsClosing() {
+  return uv_is_closing(reinterpret_cast<uv_handle_t*>(wrap_->GetStream()));
+}
+
+
+void TLSCallbacks::SSLInfoCallback(const SSL* ssl_, int where, int ret) {
+  // Be compatible with older versions of OpenSSL. SSL_get_ex_data() wants
+  // a non-const SSL* in OpenSSL <= 0.9.7e.
+  SSL* ssl = const_cast<SSL*>(ssl_);
+  if (where & SSL_CB_HANDSHAKE_START) {
+    HandleScope scope;
+    TLSCallbacks* c = static_cast<TLSCallbacks*>(
+        SSL_get_ex_data(ssl, ex_index));
+    MakeCallback(c->object_, onhandshakestart_sym, 0, NULL);
+  }
+}
+
+
+Handle<Value> TLSCallbacks::GetSSLError(int status) {
+  HandleScope scope;
+
+  switch (SSL_get_error(ssl_, status)) {
+    case SSL_ERROR_NONE:
+    case SSL_ERROR_WANT_READ:
+    case SSL_ERROR_WANT_WRITE:
+      return Handle<Value>();
+
+    // The peer sent close_notify, the stream EOF follows shortly.
+    case SSL_ERROR_ZERO_RETURN:
+      return Handle<Value>();
+
+    default: {
+      BUF_MEM* mem;
+      BIO* bio = BIO_new(BIO_s_mem());
+      if (bio == NULL) {
+        ERR_clear_error();
+        return scope.Close(Exception::Error(String::New("Unknown SSL error")));
+      }
+      ERR_print_errors(bio);
+      BIO_get_mem_ptr(bio, &mem);
+      Local<Value> e = mem->length > 0 ?
+          Exception::Error(String::New(mem->data, mem->length)) :
+          Exception::Error(String::New("Unknown SSL error"));
+      BIO_free(bio);
+      return scope.Close(e);
+    }
+  }
+}
+
+
+void TLSCallbacks::EmitError(Handle<Value> err) {
+  HandleScope scope;
+  Local<Value> argv[1] = { Local<Value>::New(err) };
+  MakeCallback(object_, onerror_sym, ARRAY_SIZE(argv), argv);
+}
+
+
+void TLSCallbacks::MaybeEstablished() {
+  if (established_ || !SSL_is_init_finished(ssl_))
+    return;
+
+  established_ = true;
+
+  // Let JavaScript verify the peer before the first byte of cleartext.
+  MakeCallback(object_, onhandshakedone_sym, 0, NULL);
+
+  if (!IsClosing())
+    ClearIn();
+}
+
+
+void TLSCallbacks::ClearIn() {
+  // Cleartext waits in the write queue until the handshake is done.
+  if (!established_ || shutdown_)
+    return;
+
+  ngx_queue_t* q;
+  ngx_queue_foreach(q, &write_item_queue_) {
+    WriteItem* wi = ngx_queue_data(q, WriteItem, member_);
+
+    while (wi->index_ < wi->count_) {
+      uv_buf_t* buf = &wi->bufs_[wi->index_];
+      if (buf->len == 0) {
+        wi->index_++;
+        continue;
+      }
+
+      ERR_clear_error();
+      int written = SSL_write(ssl_, buf->base, buf->len);
+      if (written <= 0) {
+        // SSL_write() wants the same arguments again once the renegotiation
+        // it is waiting on has progressed, so the item stays where it is.
+        Handle<Value> err = GetSSLError(written);
+        if (!err.IsEmpty())
+          EmitError(err);
+        return;
+      }
+
+      // Memory BIOs never accept a partial record.
+      assert(static_cast<size_t>(written) == buf->len);
+      wi->index_++;
+    }
+  }
+}
+
+
+void TLSCallbacks::EncOut() {
+  // The stream is going away, queued writes are released with it.
+  if (IsClosing())
+    return;
+
+  size_t pending = BIO_pending(enc_out_);
+
+  // Nothing to send and no write waiting for completion.
+  if (pending == 0) {
+    if (ngx_queue_empty(&write_item_queue_)) {
+      MaybeShutdown();
+      return;
+    }
+    WriteItem* head = ngx_queue_data(ngx_queue_head(&write_item_queue_),
+                                     WriteItem,
+                                     member_);
+    if (head->index_ < head->count_)
+      return;
+  }
+
+  EncWrite* req = new EncWrite(this, pending);
+  int read = BIO_read(enc_out_, req->data_, pending);
+  assert(pending == 0 || read == static_cast<int>(pending));
+
+  // The writes whose cleartext has been encrypted complete along with the
+  // record that carries it.
+  while (!ngx_queue_empty(&write_item_queue_)) {
+    ngx_queue_t* q = ngx_queue_head(&write_item_queue_);
+    WriteItem* wi = ngx_queue_data(q, WriteItem, member_);
+    if (wi->index_ < wi->count_)
+      break;
+    ngx_queue_remove(q);
+    ngx_queue_insert_tail(&req->items_, q);
+  }
+
+  uv_buf_t buf = uv_buf_init(req->data_, pending);
+  int r = uv_write(&req->req_, wrap_->GetStream(), &buf, 1, EncOutCb);
+
+  if (r) {
+    // Put the writes back, they are released with the stream.
+    while (!ngx_queue_empty(&req->items_)) {
+      ngx_queue_t* q = ngx_queue_last(&req->items_);
+      ngx_queue_remove(q);
+      ngx_queue_insert_head(&write_item_queue_, q);
+    }
+    delete req;
+
+    uv_err_t err = uv_last_error(uv_default_loop());
+    SetErrno(err);
+    EmitError(UVException(err.code, "write"));
+    return;
+  }
+
+  MaybeShutdown();
+}
+
+
+void TLSCallbacks::EncOutCb(uv_write_t* req, int status) {
+  EncWrite* enc_write = static_cast<EncWrite*>(req->data);
+  TLSCallbacks* callbacks = enc_write->callbacks_;
+
+  if (status) {
+    SetErrno(uv_last_error(uv_default_loop()));
+  }
+
+  callbacks->InvokeQueued(&enc_write->items_, status);
+  delete enc_write;
+}
+
+
+void TLSCallbacks::InvokeQueued(ngx_queue_t* queue, int status) {
+  while (!ngx_queue_empty(queue)) {
+    ngx_queue_t* q = ngx_queue_head(queue);
+    ngx_queue_remove(q);
+
+    WriteItem* wi = ngx_queue_data(q, WriteItem, member_);
+    wi->cb_(&wi->w_->req_, status);
+    delete wi;
+  }
+}
+
+
+void TLSCallbacks::ClearOut() {
+  HandleScope scope;
+
+  char out[kClearOutChunkSize];
+  int read;
+  Handle<Value> err;
+  do {
+    ERR_clear_error();
+    read = SSL_read(ssl_, out, sizeof(out));
+
+    // The error belongs to this SSL_read(), look at it before the handshake
+    // callback and the writes it flushes make other calls.
+    if (read <= 0)
+      err = GetSSLError(read);
+
+    // SSL_read() drives the handshake too. Report it before any data.
+    MaybeEstablished();
+    if (IsClosing())
+      return;
+
+    if (read > 0) {
+      StreamWrapCallbacks::DoRead(wrap_->GetStream(),
+                                  read,
+                                  uv_buf_init(out, read),
+                                  UV_UNKNOWN_HANDLE);
+      if (IsClosing())
+        return;
+    }
+  } while (read > 0);
+
+  if (!err.IsEmpty())
+    EmitError(err);
+}
+
+
+int TLSCallbacks::DoWrite(WriteWrap* w,
+                          uv_buf_t* bufs,
+                          int count,
+                          uv_stream_t* send_handle,
+                          uv_write_cb cb) {
+  assert(send_handle == NULL);
+
+  WriteItem* wi = new WriteItem(w, cb, bufs, count);
+  ngx_queue_insert_tail(&write_item_queue_, &wi->member_);
+
+  // Flushed from MaybeEstablished() otherwise.
+  if (established_) {
+    ClearIn();
+    EncOut();
+  }
+
+  return 0;
+}
+
+
+void TLSCallbacks::DoRead(uv_stream_t* handle,
+                          ssize_t nread,
+                          uv_buf_t buf,
+                          uv_handle_type pending) {
+  if (nread <= 0) {
+    // EOF and errors go to JavaScript unchanged.
+    StreamWrapCallbacks::DoRead(handle, nread, buf, pending);
+    return;
+  }
+
+  // The scratch buffer is reused by the next read, the memory BIO takes a
+  // copy of the ciphertext.
+  int written = BIO_write(enc_in_, buf.base, nread);
+  assert(written == nread);
+
+  ClearOut();
+  if (IsClosing())
+    return;
+
+  // Handshake replies, alerts and anything the new state lets us send.
+  ClearIn();
+  EncOut();
+}
+
+
+int TLSCallbacks::DoShutdown(ShutdownWrap* req_wrap, uv_shutdown_cb cb) {
+  // Only the write side is closed, reads go on until the peer closes too.
+  // close_notify goes out once the handshake is done and everything that
+  // was written before it has been encrypted, see MaybeShutdown().
+  assert(shutdown_req_ == NULL);
+  shutdown_req_ = req_wrap;
+  shutdown_cb_ = cb;
+  if (!CanShutdown())
+    return 0;
+
+  // Fails like StreamWrapCallbacks::DoShutdown(), the caller owns the request
+  // again then.
+  int r = StartShutdown();
+  if (r) {
+    shutdown_req_ = NULL;
+    shutdown_cb_ = NULL;
+  }
+  return r;
+}
+
+
+bool TLSCallbacks::CanShutdown() {
+  return shutdown_req_ != NULL &&
+         !shutdown_ &&
+         !IsClosing() &&
+         established_ &&
+         ngx_queue_empty(&write_item_queue_);
+}
+
+
+// Sends close_notify and shuts the stream down. Leaves the request in
+// |shutdown_req_| if uv_shutdown() fails.
+int TLSCallbacks::StartShutdown() {
+  ShutdownWrap* req_wrap = shutdown_req_;
+  uv_shutdown_cb cb = shutdown_cb_;
+  shutdown_req_ = NULL;
+  shutdown_cb_ = NULL;
+  shutdown_ = true;
+
+  ERR_clear_error();
+  SSL_shutdown(ssl_);
+  EncOut();
+
+  // uv_shutdown() waits for the close_notify write to finish.
+  int r = StreamWrapCallbacks::DoShutdown(req_wrap, cb);
+  if (r) {
+    shutdown_req_ = req_wrap;
+    shutdown_cb_ = cb;
+  }
+  return r;
+}
+
+
+// Starts a shutdown that DoShutdown() had to put off.
+void TLSCallbacks::MaybeShutdown() {
+  if (!CanShutdown() || StartShutdown() == 0)
+    return;
+
+  // We may be deep inside a read or write callback, the request fails on
+  // the next loop iteration instead. A stream that is closing completes it
+  // from AfterClose().
+  shutdown_err_ = uv_last_error(uv_default_loop());
+  if (IsClosing())
+    return;
+
+  shutdown_idle_ = new uv_idle_t;
+  uv_idle_init(uv_default_loop(), shutdown_idle_);
+  shutdown_idle_->data = this;
+  uv_idle_start(shutdown_idle_, ShutdownFailedCb);
+}
+
+
+void TLSCallbacks::ShutdownFailedCb(uv_idle_t* handle, int status) {
+  TLSCallbacks* callbacks = static_cast<TLSCallbacks*>(handle->data);
+  callbacks->StopShutdownIdle();
+  callbacks->CompleteShutdown(callbacks->shutdown_err_);
+}
+
+
+static void FreeIdle(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_idle_t*>(handle);
+}
+
+
+void TLSCallbacks::StopShutdownIdle() {
+  if (shutdown_idle_ == NULL)
+    return;
+  uv_close(reinterpret_cast<uv_handle_t*>(shutdown_idle_), FreeIdle);
+  shutdown_idle_ = NULL;
+}
+
+
+// Fails the pending shutdown with |err|.
+void TLSCallbacks::CompleteShutdown(uv_err_t err) {
+  if (shutdown_req_ == NULL)
+    return;
+
+  ShutdownWrap* req_wrap = shutdown_req_;
+  uv_shutdown_cb cb = shutdown_cb_;
+  shutdown_req_ = NULL;
+  shutdown_cb_ = NULL;
+
+  req_wrap->req_.handle = wrap_->GetStream();
+  uv_default_loop()->last_err = err;
+  cb(&req_wrap->req_, -1);
+}
+
+
+// Like libuv does for its own requests, everything that is still queued
+// fails with ECANCELED before the close callback runs.
+void TLSCallbacks::AfterClose() {
+  uv_err_t canceled;
+  canceled.code = UV_ECANCELED;
+  canceled.sys_errno_ = 0;
+
+  StopShutdownIdle();
+
+  while (!ngx_queue_empty(&write_item_queue_)) {
+    ngx_queue_t* q = ngx_queue_head(&write_item_queue_);
+    ngx_queue_remove(q);
+
+    WriteItem* wi = ngx_queue_data(q, WriteItem, member_);
+    uv_default_loop()->last_err = canceled;
+    wi->cb_(&wi->w_->req_, -1);
+    delete wi;
+  }
+
+  CompleteShutdown(canceled);
+}
+
+
+#define UNWRAP_TLS                                                          \
+  UNWRAP_NO_ABORT(TLSCallbacks)                                             \
+  if (wrap == NULL) return scope.Close(Null());
+
+
+Handle<Value> TLSCallbacks::Wrap(const Arguments& args) {
+  HandleScope scope;
+
+  if (args.Length() < 1 || !args[0]->IsObject() ||
+      args[0]->ToObject()->InternalFieldCount() < 1) {
+    return ThrowTypeError("First argument should be a stream handle");
+  }
+  if (args.Length() < 2 || !SecureContext::HasInstance(args[1])) {
+    return ThrowTypeError("Second argument should be a SecureContext");
+  }
+
+  Local<Object> stream = args[0]->ToObject();
+  StreamWrap* wrap = static_cast<StreamWrap*>(
+      stream->GetPointerFromInternalField(0));
+  if (wrap == NULL)
+    return ThrowError("Stream handle is closed");
+
+  Local<Object> sc_obj = args[1]->ToObject();
+  SecureContext* sc = ObjectWrap::Unwrap<SecureContext>(sc_obj);
+
+  TLSCallbacks* callbacks = new TLSCallbacks(wrap,
+                                             sc,
+                                             sc_obj,
+                                             args[2]->BooleanValue());
+  wrap->OverrideCallbacks(callbacks);
+
+  return scope.Close(callbacks->object_);
+}
+
+
+Handle<Value> TLSCallbacks::Start(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  if (wrap->started_)
+    return ThrowError("Already started");
+  wrap->started_ = true;
+
+  // Servers wait for the ClientHello.
+  if (wrap->is_server_)
+    return scope.Close(Undefined());
+
+  ERR_clear_error();
+  int rv = SSL_connect(wrap->ssl_);
+  Handle<Value> err = wrap->GetSSLError(rv);
+  wrap->EncOut();
+  if (!err.IsEmpty())
+    wrap->EmitError(err);
+
+  return scope.Close(Undefined());
+}
+
+
+Handle<Value> TLSCallbacks::SetVerifyMode(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  if (wrap->started_ || !wrap->is_server_)
+    return ThrowError("setVerifyMode() only works on servers before start");
+
+  int verify_mode;
+  bool request_cert = args[0]->BooleanValue();
+  if (!request_cert) {
+    // Note reject_unauthorized ignored.
+    verify_mode = SSL_VERIFY_NONE;
+  } else {
+    bool reject_unauthorized = args[1]->BooleanValue();
+    verify_mode = SSL_VERIFY_PEER;
+    if (reject_unauthorized) verify_mode |= SSL_VERIFY_FAIL_IF_NO_PEER_CERT;
+  }
+
+  SSL_set_verify(wrap->ssl_, verify_mode, VerifyCallback);
+
+  return scope.Close(Undefined());
+}
+
+
+Handle<Value> TLSCallbacks::SetServername(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  if (args.Length() < 1 || !args[0]->IsString())
+    return ThrowTypeError("First argument should be a string");
+
+  if (wrap->started_ || wrap->is_server_)
+    return ThrowError("setServername() only works on clients before start");
+
+#ifdef SSL_CTRL_SET_TLSEXT_SERVERNAME_CB
+  node::Utf8Value servername(args[0]);
+  SSL_set_tlsext_host_name(wrap->ssl_, *servername);
+#endif
+
+  return scope.Close(Undefined());
+}
+
+
+Handle<Value> TLSCallbacks::GetPeerCertificate(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  X509* peer_cert = SSL_get_peer_certificate(wrap->ssl_);
+  if (peer_cert == NULL)
+    return scope.Close(Null());
+
+  Local<Value> info = Local<Value>::New(crypto::X509ToObject(peer_cert));
+  X509_free(peer_cert);
+  return scope.Close(info);
+}
+
+
+Handle<Value> TLSCallbacks::VerifyError(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  return scope.Close(crypto::GetVerifyError(wrap->ssl_));
+}
+
+
+Handle<Value> TLSCallbacks::GetCurrentCipher(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  return scope.Close(crypto::GetCipherInfo(wrap->ssl_));
+}
+
+
+Handle<Value> TLSCallbacks::GetSession(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  SSL_SESSION* sess = SSL_get_session(wrap->ssl_);
+  if (sess == NULL)
+    return scope.Close(Null());
+
+  int slen = i2d_SSL_SESSION(sess, NULL);
+  if (slen <= 0)
+    return scope.Close(Null());
+
+  Buffer* buf = Buffer::New(slen);
+  unsigned char* p = reinterpret_cast<unsigned char*>(Buffer::Data(buf));
+  i2d_SSL_SESSION(sess, &p);
+
+  return scope.Close(buf->handle_);
+}
+
+
+Handle<Value> TLSCallbacks::SetSession(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  if (args.Length() < 1 || !Buffer::HasInstance(args[0]))
+    return ThrowTypeError("First argument should be a Buffer");
+
+  if (wrap->started_)
+    return ThrowError("Already started");
+
+  Local<Object> buffer_obj = args[0]->ToObject();
+  const unsigned char* p =
+      reinterpret_cast<const unsigned char*>(Buffer::Data(buffer_obj));
+  SSL_SESSION* sess = d2i_SSL_SESSION(NULL, &p, Buffer::Length(buffer_obj));
+  if (sess == NULL)
+    return scope.Close(False());
+
+  int r = SSL_set_session(wrap->ssl_, sess);
+  SSL_SESSION_free(sess);
+
+  if (!r)
+    return ThrowError("SSL_set_session error");
+
+  return scope.Close(True());
+}
+
+
+Handle<Value> TLSCallbacks::IsSessionReused(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP_TLS
+
+  if (SSL_session_reused(wrap->ssl_))
+    return scope.Close(True());
+
+  return scope.Close(False());
+}
+
+
+void TLSCallbacks::Initialize(Handle<Object> target) {
+  HandleScope scope;
+
+  ex_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+
+  NODE_SET_METHOD(target, "wrap", TLSCallbacks::Wrap);
+
+  Local<FunctionTemplate> t = FunctionTemplate::New();
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(String::NewSymbol("TLSWrap"));
+
+  NODE_SET_PROTOTYPE_METHOD(t, "start", Start);
+  NODE_SET_PROTOTYPE_METHOD(t, "setVerifyMode", SetVerifyMode);
+  NODE_SET_PROTOTYPE_METHOD(t, "setServername", SetServername);
+  NODE_SET_PROTOTYPE_METHOD(t, "getPeerCertificate", GetPeerCertificate);
+  NODE_SET_PROTOTYPE_METHOD(t, "verifyError", VerifyError);
+  NODE_SET_PROTOTYPE_METHOD(t, "getCurrentCipher", GetCurrentCipher);
+  NODE_SET_PROTOTYPE_METHOD(t, "getSession", GetSession);
+  NODE_SET_PROTOTYPE_METHOD(t, "setSession", SetSession);
+  NODE_SET_PROTOTYPE_METHOD(t, "isSessionReused", IsSessionReused);
+
+  tls_wrap_constructor = Persistent<FunctionTemplate>::New(t);
+
+  onerror_sym = NODE_PSYMBOL("onerror");
+  onhandshakestart_sym = NODE_PSYMBOL("onhandshakestart");
+  onhandshakedone_sym = NODE_PSYMBOL("onhandshakedone");
+}
+
+}  // namespace node
+
+NODE_MODULE(node_tls_wrap, node::TLSCallbacks::Initialize)
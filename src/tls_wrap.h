@@ -0,0 +1,151 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef TLS_WRAP_H_
+#define TLS_WRAP_H_
+
+#include "v8.h"
+#include "stream_wrap.h"
+#include "ngx-queue.h"
+
+#include <openssl/ssl.h>
+
+namespace node {
+
+// Forward declarations
+namespace crypto {
+  class SecureContext;
+}
+
+// Terminates TLS inside a StreamWrap. Ciphertext read from the stream is
+// decrypted in place and delivered through the stream's regular onread
+// callback; writes are encrypted and handed straight to the socket. The
+// JavaScript side only ever sees cleartext and never touches the BIOs.
+class TLSCallbacks : public StreamWrapCallbacks {
+ public:
+  static void Initialize(v8::Handle<v8::Object> target);
+
+  int DoWrite(WriteWrap* w,
+              uv_buf_t* bufs,
+              int count,
+              uv_stream_t* send_handle,
+              uv_write_cb cb);
+  void DoRead(uv_stream_t* handle,
+              ssize_t nread,
+              uv_buf_t buf,
+              uv_handle_type pending);
+  int DoShutdown(ShutdownWrap* req_wrap, uv_shutdown_cb cb);
+  void AfterClose();
+
+ protected:
+  // Largest plaintext payload of a single TLS record.
+  static const int kClearOutChunkSize = 16 * 1024;
+
+  // A pending write. Its buffers are owned by the WriteWrap and stay alive
+  // until the write is completed.
+  class WriteItem {
+   public:
+    WriteItem(WriteWrap* w, uv_write_cb cb, uv_buf_t* bufs, int count);
+    ~WriteItem();
+
+    WriteWrap* w_;
+    uv_write_cb cb_;
+    uv_buf_t* bufs_;
+    int count_;
+    int index_;  // First buffer that has not been fed to SSL_write() yet
+    ngx_queue_t member_;
+  };
+
+  // Encrypted data on its way to the socket, along with the writes whose
+  // cleartext it carries.
+  class EncWrite {
+   public:
+    EncWrite(TLSCallbacks* callbacks, size_t size);
+    ~EncWrite();
+
+    uv_write_t req_;
+    TLSCallbacks* callbacks_;
+    char* data_;
+    size_t size_;
+    ngx_queue_t items_;
+  };
+
+  TLSCallbacks(StreamWrap* wrap,
+               crypto::SecureContext* sc,
+               v8::Handle<v8::Object> sc_obj,
+               bool is_server);
+  ~TLSCallbacks();
+
+  void EncOut();
+  static void EncOutCb(uv_write_t* req, int status);
+  void ClearIn();
+  void ClearOut();
+  void MaybeEstablished();
+  bool CanShutdown();
+  int StartShutdown();
+  void MaybeShutdown();
+  void CompleteShutdown(uv_err_t err);
+  static void ShutdownFailedCb(uv_idle_t* handle, int status);
+  void StopShutdownIdle();
+  void InvokeQueued(ngx_queue_t* queue, int status);
+  bool IsClosing();
+  v8::Handle<v8::Value> GetSSLError(int status);
+  void EmitError(v8::Handle<v8::Value> err);
+
+  static void SSLInfoCallback(const SSL* ssl_, int where, int ret);
+
+  static v8::Handle<v8::Value> Wrap(const v8::Arguments& args);
+  static v8::Handle<v8::Value> Start(const v8::Arguments& args);
+  static v8::Handle<v8::Value> SetVerifyMode(const v8::Arguments& args);
+  static v8::Handle<v8::Value> SetServername(const v8::Arguments& args);
+  static v8::Handle<v8::Value> GetPeerCertificate(const v8::Arguments& args);
+  static v8::Handle<v8::Value> VerifyError(const v8::Arguments& args);
+  static v8::Handle<v8::Value> GetCurrentCipher(const v8::Arguments& args);
+  static v8::Handle<v8::Value> GetSession(const v8::Arguments& args);
+  static v8::Handle<v8::Value> SetSession(const v8::Arguments& args);
+  static v8::Handle<v8::Value> IsSessionReused(const v8::Arguments& args);
+
+  v8::Persistent<v8::Object> object_;
+  v8::Persistent<v8::Object> sc_handle_;
+
+  SSL* ssl_;
+  BIO* enc_in_;
+  BIO* enc_out_;
+  bool is_server_;
+  bool started_;
+  bool established_;
+  bool shutdown_;
+
+  // A shutdown that waits for the handshake and the queued writes.
+  ShutdownWrap* shutdown_req_;
+  uv_shutdown_cb shutdown_cb_;
+  // Completes |shutdown_req_| with |shutdown_err_| on the next loop
+  // iteration if uv_shutdown() failed after DoShutdown() had returned.
+  uv_idle_t* shutdown_idle_;
+  uv_err_t shutdown_err_;
+
+  ngx_queue_t write_item_queue_;
+};
+
+}  // namespace node
+
+#endif  // TLS_WRAP_H_
@@ -21,21 +21,22 @@
 
 #include "node.h"
 #include "node_buffer.h"
-#include "slab_allocator.h"
+#include "buffer_pool.h"
 #include "req_wrap.h"
 #include "handle_wrap.h"
 #include "udp_wrap.h"
 #include "util.h"
 
 #include <stdlib.h>
+#include <string.h>
 
-#define SLAB_SIZE (1024 * 1024)
 
 
 namespace node {
 
 using v8::AccessorInfo;
 using v8::Arguments;
+using v8::Array;
 using v8::False;
 using v8::Function;
 using v8::FunctionTemplate;
@@ -60,17 +61,14 @@ static Persistent<Function> constructor;
 static Persistent<String> buffer_sym;
 static Persistent<String> oncomplete_sym;
 static Persistent<String> onmessage_sym;
-static SlabAllocator* slab_allocator;
-
-
-static void DeleteSlabAllocator(void*) {
-  delete slab_allocator;
-  slab_allocator = NULL;
-}
+static Persistent<String> onmessages_sym;
 
 
 UDPWrap::UDPWrap(Handle<Object> object): HandleWrap(object,
-                                                    (uv_handle_t*)&handle_) {
+                                                    (uv_handle_t*)&handle_),
+                                          batch_(NULL),
+                                          batch_size_(0),
+                                          batch_count_(0) {
   int r = uv_udp_init(uv_default_loop(), &handle_);
   assert(r == 0); // can't fail anyway
   handle_.data = reinterpret_cast<void*>(this);
@@ -78,20 +76,19 @@ UDPWrap::UDPWrap(Handle<Object> object): HandleWrap(object,
 
 
 UDPWrap::~UDPWrap() {
+  free(batch_);
 }
 
 
 void UDPWrap::Initialize(Handle<Object> target) {
   HandleWrap::Initialize(target);
 
-  slab_allocator = new SlabAllocator(SLAB_SIZE);
-  AtExit(DeleteSlabAllocator, NULL);
-
   HandleScope scope;
 
   buffer_sym = NODE_PSYMBOL("buffer");
   oncomplete_sym = NODE_PSYMBOL("oncomplete");
   onmessage_sym = NODE_PSYMBOL("onmessage");
+  onmessages_sym = NODE_PSYMBOL("onmessages");
 
   Local<FunctionTemplate> t = FunctionTemplate::New(New);
   t->InstanceTemplate()->SetInternalFieldCount(1);
@@ -120,6 +117,7 @@ void UDPWrap::Initialize(Handle<Object> target) {
   NODE_SET_PROTOTYPE_METHOD(t, "setMulticastLoopback", SetMulticastLoopback);
   NODE_SET_PROTOTYPE_METHOD(t, "setBroadcast", SetBroadcast);
   NODE_SET_PROTOTYPE_METHOD(t, "setTTL", SetTTL);
+  NODE_SET_PROTOTYPE_METHOD(t, "setBatch", SetBatch);
 
   NODE_SET_PROTOTYPE_METHOD(t, "ref", HandleWrap::Ref);
   NODE_SET_PROTOTYPE_METHOD(t, "unref", HandleWrap::Unref);
@@ -213,6 +211,41 @@ X(SetMulticastLoopback, uv_udp_set_multicast_loop)
 #undef X
 
 
+Handle<Value> UDPWrap::SetBatch(const Arguments& args) {
+  HandleScope scope;
+  UNWRAP(UDPWrap)
+
+  assert(args.Length() == 1);
+  assert(wrap->batch_count_ == 0);
+
+  unsigned int count = args[0]->Uint32Value();
+  int r = uv_udp_set_batch(&wrap->handle_, count);
+
+  if (r) {
+    SetErrno(uv_last_error(uv_default_loop()));
+    return scope.Close(Integer::New(r));
+  }
+
+  free(wrap->batch_);
+  wrap->batch_ = NULL;
+  wrap->batch_size_ = 0;
+
+  if (count > 1) {
+    wrap->batch_ = static_cast<Datagram*>(malloc(count * sizeof(Datagram)));
+    if (wrap->batch_ == NULL) {
+      uv_udp_set_batch(&wrap->handle_, 0);
+      uv_err_t err;
+      err.code = UV_ENOMEM;
+      SetErrno(err);
+      return scope.Close(Integer::New(-1));
+    }
+    wrap->batch_size_ = count;
+  }
+
+  return scope.Close(Integer::New(0));
+}
+
+
 Handle<Value> UDPWrap::SetMembership(const Arguments& args,
                                      uv_membership membership) {
   HandleScope scope;
@@ -388,9 +421,7 @@ void UDPWrap::OnSend(uv_udp_send_t* req, int status) {
 
 
 uv_buf_t UDPWrap::OnAlloc(uv_handle_t* handle, size_t suggested_size) {
-  UDPWrap* wrap = static_cast<UDPWrap*>(handle->data);
-  char* buf = slab_allocator->Allocate(wrap->object_, suggested_size);
-  return uv_buf_init(buf, suggested_size);
+  return BufferPool::Default()->Scratch(suggested_size);
 }
 
 
@@ -402,10 +433,26 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
   HandleScope scope;
 
   UDPWrap* wrap = reinterpret_cast<UDPWrap*>(handle->data);
-  Local<Object> slab = slab_allocator->Shrink(wrap->object_,
-                                              buf.base,
-                                              nread < 0 ? 0 : nread);
-  if (nread == 0) return;
+
+  // Datagrams of a batch point into the buffer that OnAlloc() returned, they
+  // are handed to JS together when libuv passes that buffer back.
+  if (flags & UV_UDP_MMSG_CHUNK) {
+    if (nread <= 0) return;
+    assert(wrap->batch_count_ < wrap->batch_size_);
+    Datagram* d = wrap->batch_ + wrap->batch_count_++;
+    d->data = buf.base;
+    d->length = nread;
+    memcpy(&d->addr,
+           addr,
+           addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                       : sizeof(sockaddr_in));
+    return;
+  }
+
+  if (nread == 0) {
+    if (addr == NULL && wrap->batch_count_ > 0) wrap->FlushBatch(buf);
+    return;
+  }
 
   if (nread < 0) {
     Local<Value> argv[] = { Local<Object>::New(wrap->object_) };
@@ -416,8 +463,8 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
 
   Local<Value> argv[] = {
     Local<Object>::New(wrap->object_),
-    slab,
-    Integer::NewFromUnsigned(buf.base - Buffer::Data(slab)),
+    BufferPool::Default()->Take(buf.base, nread),
+    Integer::NewFromUnsigned(0),
     Integer::NewFromUnsigned(nread),
     AddressToJS(addr)
   };
@@ -425,6 +472,38 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
 }
 
 
+void UDPWrap::FlushBatch(uv_buf_t buf) {
+  HandleScope scope;
+
+  unsigned int count = batch_count_;
+  batch_count_ = 0;
+
+  // Move the datagrams to the front of the buffer so they can be copied out
+  // in one go. Each one sits in a slot of its own, never before its target.
+  size_t total = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    memmove(buf.base + total, batch_[i].data, batch_[i].length);
+    total += batch_[i].length;
+  }
+
+  Local<Array> sizes = Array::New(count);
+  Local<Array> rinfos = Array::New(count);
+  for (unsigned int i = 0; i < count; i++) {
+    const sockaddr* addr = reinterpret_cast<const sockaddr*>(&batch_[i].addr);
+    sizes->Set(i, Integer::NewFromUnsigned(batch_[i].length));
+    rinfos->Set(i, AddressToJS(addr));
+  }
+
+  Local<Value> argv[] = {
+    Local<Object>::New(object_),
+    BufferPool::Default()->Take(buf.base, total),
+    sizes,
+    rinfos
+  };
+  MakeCallback(object_, onmessages_sym, ARRAY_SIZE(argv), argv);
+}
+
+
 UDPWrap* UDPWrap::Unwrap(Local<Object> obj) {
   assert(!obj.IsEmpty());
   assert(obj->InternalFieldCount() > 0);
@@ -26,6 +26,7 @@ class UDPWrap: public HandleWrap {
   static v8::Handle<v8::Value> SetMulticastLoopback(const v8::Arguments& args);
   static v8::Handle<v8::Value> SetBroadcast(const v8::Arguments& args);
   static v8::Handle<v8::Value> SetTTL(const v8::Arguments& args);
+  static v8::Handle<v8::Value> SetBatch(const v8::Arguments& args);
   static UDPWrap* Unwrap(v8::Local<v8::Object> obj);
 
   static v8::Local<v8::Object> Instantiate();
@@ -48,7 +49,19 @@ class UDPWrap: public HandleWrap {
                      struct sockaddr* addr,
                      unsigned flags);
 
+  // A datagram of the batch that is being read, see uv_udp_set_batch().
+  struct Datagram {
+    const char* data;
+    size_t length;
+    struct sockaddr_storage addr;
+  };
+
+  void FlushBatch(uv_buf_t buf);
+
   uv_udp_t handle_;
+  Datagram* batch_;
+  unsigned int batch_size_;
+  unsigned int batch_count_;
 };
 
 } // namespace node
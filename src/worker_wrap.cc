@@ -0,0 +1,785 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Workers run a script in a V8 isolate of their own, on a thread of their
+// own, with a uv_loop_t of their own. None of the node bindings are
+// available in there - they assume the main isolate and the default loop -
+// so a worker is a bare JavaScript environment that talks to its parent
+// through messages. See lib/_worker_context.js for the worker side of the
+// JS glue and lib/worker.js for the parent side.
+//
+// A message is a JSON string plus a list of binary blobs. Blobs are copied
+// out of Buffers when the parent posts a message. Going the other way, the
+// memory of a Bytes object is handed over as is and becomes the backing
+// store of a Buffer in the parent.
+
+#include "node.h"
+#include "node_buffer.h"
+#include "node_javascript.h"
+#include "handle_wrap.h"
+#include "ngx-queue.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace node {
+
+using v8::Arguments;
+using v8::Array;
+using v8::Context;
+using v8::Exception;
+using v8::External;
+using v8::Function;
+using v8::FunctionTemplate;
+using v8::Handle;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Locker;
+using v8::Object;
+using v8::Persistent;
+using v8::Script;
+using v8::String;
+using v8::ThrowException;
+using v8::TryCatch;
+using v8::Undefined;
+using v8::V8;
+using v8::Value;
+
+static Persistent<String> onmessage_sym;
+static Persistent<String> onerror_sym;
+static Persistent<String> onexit_sym;
+
+
+struct WorkerBlob {
+  char* data;
+  size_t length;
+};
+
+
+struct WorkerMessage {
+  enum Kind { kMessage, kError, kExit };
+
+  ngx_queue_t queue;
+  Kind kind;
+  char* data;       // JSON text, or the error message.
+  size_t length;
+  char* stack;      // kError only.
+  size_t stack_length;
+  int exit_code;    // kExit only.
+  WorkerBlob* blobs;
+  unsigned int nblobs;
+};
+
+
+static WorkerMessage* NewMessage(WorkerMessage::Kind kind) {
+  WorkerMessage* msg = new WorkerMessage;
+  memset(msg, 0, sizeof(*msg));
+  msg->kind = kind;
+  return msg;
+}
+
+
+static void DeleteMessage(WorkerMessage* msg) {
+  for (unsigned int i = 0; i < msg->nblobs; i++)
+    free(msg->blobs[i].data);
+  delete[] msg->blobs;
+  delete[] msg->data;
+  delete[] msg->stack;
+  delete msg;
+}
+
+
+static void DeleteMessages(ngx_queue_t* queue) {
+  while (!ngx_queue_empty(queue)) {
+    ngx_queue_t* q = ngx_queue_head(queue);
+    ngx_queue_remove(q);
+    DeleteMessage(ngx_queue_data(q, WorkerMessage, queue));
+  }
+}
+
+
+// Copies out the UTF-8 representation of |value|.
+static char* CopyUtf8(Handle<Value> value, size_t* length) {
+  String::Utf8Value utf8(value);
+  char* data = new char[utf8.length() + 1];
+  memcpy(data, *utf8, utf8.length() + 1);
+  *length = utf8.length();
+  return data;
+}
+
+
+static void FreeBlob(char* data, void* hint) {
+  free(data);
+}
+
+
+class WorkerWrap : public HandleWrap {
+ public:
+  static void Initialize(Handle<Object> target) {
+    HandleScope scope;
+
+    HandleWrap::Initialize(target);
+
+    Local<FunctionTemplate> constructor = FunctionTemplate::New(New);
+    constructor->InstanceTemplate()->SetInternalFieldCount(1);
+    constructor->SetClassName(String::NewSymbol("Worker"));
+
+    NODE_SET_PROTOTYPE_METHOD(constructor, "close", Close);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "ref", HandleWrap::Ref);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "unref", HandleWrap::Unref);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "start", Start);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "postMessage", PostMessage);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "terminate", Terminate);
+
+    onmessage_sym = NODE_PSYMBOL("onmessage");
+    onerror_sym = NODE_PSYMBOL("onerror");
+    onexit_sym = NODE_PSYMBOL("onexit");
+
+    target->Set(String::NewSymbol("Worker"), constructor->GetFunction());
+  }
+
+ private:
+  static Handle<Value> New(const Arguments& args) {
+    // This constructor should not be exposed to public javascript.
+    // Therefore we assert that we are not trying to call this as a
+    // normal function.
+    assert(args.IsConstructCall());
+
+    HandleScope scope;
+    new WorkerWrap(args.This());
+
+    return scope.Close(args.This());
+  }
+
+  WorkerWrap(Handle<Object> object)
+      : HandleWrap(object, reinterpret_cast<uv_handle_t*>(&async_)),
+        worker_async_(NULL),
+        isolate_(NULL),
+        terminate_(false),
+        started_(false),
+        source_(NULL),
+        source_length_(0),
+        filename_(NULL),
+        filename_length_(0),
+        loop_(NULL),
+        closing_(false),
+        exit_code_(0) {
+    int r = uv_async_init(uv_default_loop(), &async_, OnParentMessages);
+    assert(r == 0);
+    r = uv_mutex_init(&mutex_);
+    assert(r == 0);
+    ngx_queue_init(&to_worker_);
+    ngx_queue_init(&to_parent_);
+  }
+
+  ~WorkerWrap() {
+    assert(!started_);
+    DeleteMessages(&to_worker_);
+    DeleteMessages(&to_parent_);
+    delete[] source_;
+    delete[] filename_;
+    uv_mutex_destroy(&mutex_);
+  }
+
+  // Parent side.
+
+  static Handle<Value> Start(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP(WorkerWrap)
+
+    if (wrap->started_) {
+      return ThrowException(Exception::Error(
+          String::New("Worker already started")));
+    }
+
+    wrap->source_ = CopyUtf8(args[0], &wrap->source_length_);
+    wrap->filename_ = CopyUtf8(args[1], &wrap->filename_length_);
+
+    if (uv_thread_create(&wrap->thread_, WorkerMain, wrap)) {
+      return ThrowException(ErrnoException(errno, "uv_thread_create"));
+    }
+
+    wrap->started_ = true;
+    return Undefined();
+  }
+
+  static Handle<Value> PostMessage(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP(WorkerWrap)
+
+    WorkerMessage* msg = NewMessage(WorkerMessage::kMessage);
+    msg->data = CopyUtf8(args[0], &msg->length);
+
+    if (args[1]->IsArray()) {
+      Local<Array> buffers = args[1].As<Array>();
+      msg->blobs = new WorkerBlob[buffers->Length()];
+
+      for (uint32_t i = 0; i < buffers->Length(); i++) {
+        Local<Value> buffer = buffers->Get(i);
+        if (!Buffer::HasInstance(buffer)) {
+          DeleteMessage(msg);
+          return ThrowException(Exception::TypeError(
+              String::New("Not a buffer")));
+        }
+
+        WorkerBlob* blob = msg->blobs + msg->nblobs++;
+        blob->length = Buffer::Length(buffer.As<Object>());
+        blob->data = static_cast<char*>(malloc(blob->length + 1));
+        if (blob->data == NULL) {
+          DeleteMessage(msg);
+          return ThrowException(Exception::Error(
+              String::New("Out of memory")));
+        }
+        memcpy(blob->data, Buffer::Data(buffer.As<Object>()), blob->length);
+      }
+    }
+
+    uv_mutex_lock(&wrap->mutex_);
+    if (wrap->worker_async_ != NULL) {
+      ngx_queue_insert_tail(&wrap->to_worker_, &msg->queue);
+      uv_async_send(wrap->worker_async_);
+      msg = NULL;
+    } else if (!wrap->terminate_) {
+      // Not up and running yet, the worker picks it up when it is.
+      ngx_queue_insert_tail(&wrap->to_worker_, &msg->queue);
+      msg = NULL;
+    }
+    uv_mutex_unlock(&wrap->mutex_);
+
+    // The worker is gone, drop the message on the floor.
+    if (msg != NULL)
+      DeleteMessage(msg);
+
+    return Undefined();
+  }
+
+  static Handle<Value> Terminate(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP(WorkerWrap)
+
+    wrap->RequestTerminate();
+
+    return Undefined();
+  }
+
+  static Handle<Value> Close(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP_NO_ABORT(WorkerWrap)
+
+    // Don't let the thread outlive the handle it reports to.
+    if (wrap != NULL && wrap->started_) {
+      wrap->RequestTerminate();
+      uv_thread_join(&wrap->thread_);
+      wrap->started_ = false;
+    }
+
+    return HandleWrap::Close(args);
+  }
+
+  void RequestTerminate() {
+    uv_mutex_lock(&mutex_);
+    terminate_ = true;
+    if (isolate_ != NULL)
+      V8::TerminateExecution(isolate_);
+    if (worker_async_ != NULL)
+      uv_async_send(worker_async_);
+    uv_mutex_unlock(&mutex_);
+  }
+
+  static void OnParentMessages(uv_async_t* handle, int status) {
+    HandleScope scope;
+
+    WorkerWrap* wrap = container_of(handle, WorkerWrap, async_);
+    ngx_queue_t queue;
+
+    uv_mutex_lock(&wrap->mutex_);
+    if (ngx_queue_empty(&wrap->to_parent_)) {
+      ngx_queue_init(&queue);
+    } else {
+      queue = wrap->to_parent_;
+      ngx_queue_head(&queue)->prev = &queue;
+      ngx_queue_last(&queue)->next = &queue;
+      ngx_queue_init(&wrap->to_parent_);
+    }
+    uv_mutex_unlock(&wrap->mutex_);
+
+    while (!ngx_queue_empty(&queue)) {
+      // A callback may have closed the handle.
+      if (uv_is_closing(reinterpret_cast<uv_handle_t*>(handle)))
+        break;
+
+      ngx_queue_t* q = ngx_queue_head(&queue);
+      ngx_queue_remove(q);
+      WorkerMessage* msg = ngx_queue_data(q, WorkerMessage, queue);
+
+      switch (msg->kind) {
+        case WorkerMessage::kMessage: {
+          Local<Array> buffers = Array::New(msg->nblobs);
+          for (unsigned int i = 0; i < msg->nblobs; i++) {
+            WorkerBlob* blob = msg->blobs + i;
+            Buffer* buffer;
+            if (blob->data == NULL) {
+              buffer = Buffer::New(0);
+            } else {
+              buffer = Buffer::New(blob->data, blob->length, FreeBlob, NULL);
+              blob->data = NULL;  // Owned by the buffer now.
+            }
+            buffers->Set(i, buffer->handle_);
+          }
+          Local<Value> argv[2] = {
+            String::New(msg->data, msg->length),
+            buffers
+          };
+          MakeCallback(wrap->object_, onmessage_sym, ARRAY_SIZE(argv), argv);
+          break;
+        }
+
+        case WorkerMessage::kError: {
+          Local<Value> argv[2] = {
+            String::New(msg->data, msg->length),
+            String::New(msg->stack, msg->stack_length)
+          };
+          MakeCallback(wrap->object_, onerror_sym, ARRAY_SIZE(argv), argv);
+          break;
+        }
+
+        case WorkerMessage::kExit: {
+          Local<Value> argv[1] = { Integer::New(msg->exit_code) };
+          MakeCallback(wrap->object_, onexit_sym, ARRAY_SIZE(argv), argv);
+          break;
+        }
+      }
+
+      DeleteMessage(msg);
+    }
+
+    DeleteMessages(&queue);
+  }
+
+  // Worker side. Everything below runs on the worker thread, with the
+  // worker's isolate entered.
+
+  static void WorkerMain(void* arg) {
+    static_cast<WorkerWrap*>(arg)->Run();
+  }
+
+  void Run() {
+    Isolate* isolate = Isolate::New();
+
+    {
+      // Uncontended, but V8 insists once node.cc has taken a Locker.
+      Locker locker(isolate);
+      Isolate::Scope isolate_scope(isolate);
+      HandleScope scope;
+
+      loop_ = uv_loop_new();
+      int r = uv_async_init(loop_, &worker_async_storage_, OnWorkerMessages);
+      assert(r == 0);
+
+      uv_mutex_lock(&mutex_);
+      bool terminate = terminate_;
+      if (!terminate) {
+        isolate_ = isolate;
+        worker_async_ = &worker_async_storage_;
+        // Messages that were posted before we got here.
+        if (!ngx_queue_empty(&to_worker_))
+          uv_async_send(worker_async_);
+      }
+      uv_mutex_unlock(&mutex_);
+
+      Persistent<Context> context = Context::New();
+
+      if (!terminate) {
+        Context::Scope context_scope(context);
+        if (Boot())
+          uv_run(loop_, UV_RUN_DEFAULT);
+        else
+          exit_code_ = 1;
+        dispatch_.Dispose();
+        dispatch_.Clear();
+        bytes_.Dispose();
+        bytes_.Clear();
+      }
+
+      StopLoop();
+      uv_run(loop_, UV_RUN_DEFAULT);
+      uv_loop_delete(loop_);
+      loop_ = NULL;
+
+      uv_mutex_lock(&mutex_);
+      isolate_ = NULL;
+      if (terminate_)
+        exit_code_ = 1;
+      uv_mutex_unlock(&mutex_);
+
+      context.Dispose();
+      V8::ContextDisposedNotification();
+      // Runs the weak callbacks of the Bytes objects that are left.
+      V8::LowMemoryNotification();
+    }
+
+    isolate->Dispose();
+
+    WorkerMessage* msg = NewMessage(WorkerMessage::kExit);
+    msg->exit_code = exit_code_;
+    PostToParent(msg);
+  }
+
+  void StopLoop() {
+    if (closing_)
+      return;
+
+    closing_ = true;
+    uv_mutex_lock(&mutex_);
+    worker_async_ = NULL;
+    uv_mutex_unlock(&mutex_);
+    uv_close(reinterpret_cast<uv_handle_t*>(&worker_async_storage_), NULL);
+  }
+
+  void PostToParent(WorkerMessage* msg) {
+    uv_mutex_lock(&mutex_);
+    ngx_queue_insert_tail(&to_parent_, &msg->queue);
+    uv_mutex_unlock(&mutex_);
+    uv_async_send(&async_);
+  }
+
+  void ReportException(const TryCatch& try_catch) {
+    HandleScope scope;
+
+    WorkerMessage* msg = NewMessage(WorkerMessage::kError);
+    Handle<Value> stack = try_catch.StackTrace();
+
+    msg->data = CopyUtf8(try_catch.Exception(), &msg->length);
+    if (stack.IsEmpty() || !stack->IsString())
+      msg->stack = CopyUtf8(try_catch.Exception(), &msg->stack_length);
+    else
+      msg->stack = CopyUtf8(stack, &msg->stack_length);
+
+    PostToParent(msg);
+  }
+
+  // Sets up the worker's global object and runs the script. Returns false
+  // if the script threw or was terminated.
+  bool Boot() {
+    HandleScope scope;
+
+    Local<External> self = External::New(this);
+    Local<Object> global = Context::GetCurrent()->Global();
+    Local<Object> binding = Object::New();
+
+    Local<FunctionTemplate> bytes = FunctionTemplate::New(BytesNew);
+    bytes->SetClassName(String::NewSymbol("Bytes"));
+    bytes_ = Persistent<Function>::New(bytes->GetFunction());
+    binding->Set(String::NewSymbol("Bytes"), bytes_);
+
+    binding->Set(String::NewSymbol("send"),
+                 FunctionTemplate::New(Send, self)->GetFunction());
+    binding->Set(String::NewSymbol("close"),
+                 FunctionTemplate::New(WorkerClose, self)->GetFunction());
+    binding->Set(String::NewSymbol("print"),
+                 FunctionTemplate::New(Print)->GetFunction());
+
+    TryCatch try_catch;
+
+    Local<Value> wrapper = SnapshotFunction("_worker_context");
+    DeleteSnapshot(Context::GetCurrent());
+
+    Local<Script> script;
+    if (wrapper.IsEmpty()) {
+      Handle<String> bootstrap = NativeSource("_worker_context");
+      assert(!bootstrap.IsEmpty());
+
+      // Same wrapper as NativeModule.wrap() in src/node.js.
+      Local<String> source = String::Concat(
+          String::Concat(
+              String::New("(function (exports, require, module, __filename, "
+                          "__dirname) { "),
+              bootstrap),
+          String::New("\n});"));
+
+      script = Script::Compile(source, String::New("_worker_context.js"));
+      if (!script.IsEmpty())
+        wrapper = script->Run();
+      if (wrapper.IsEmpty()) {
+        ReportException(try_catch);
+        return false;
+      }
+    }
+
+    Local<Object> exports = Object::New();
+    Local<Object> module = Object::New();
+    module->Set(String::NewSymbol("exports"), exports);
+
+    Local<Value> argv[3] = { exports, Local<Value>::New(Undefined()), module };
+    wrapper.As<Function>()->Call(global, ARRAY_SIZE(argv), argv);
+
+    Local<Value> init = module->Get(String::NewSymbol("exports"));
+    Local<Value> init_argv[2] = { binding, global };
+    Local<Value> dispatch =
+        init.As<Function>()->Call(global, ARRAY_SIZE(init_argv), init_argv);
+    if (dispatch.IsEmpty() || !dispatch->IsFunction()) {
+      ReportException(try_catch);
+      return false;
+    }
+
+    dispatch_ = Persistent<Function>::New(dispatch.As<Function>());
+
+    script = Script::Compile(String::New(source_, source_length_),
+                             String::New(filename_, filename_length_));
+    if (script.IsEmpty() || script->Run().IsEmpty()) {
+      if (try_catch.CanContinue())
+        ReportException(try_catch);
+      return false;
+    }
+
+    return true;
+  }
+
+  static void OnWorkerMessages(uv_async_t* handle, int status) {
+    WorkerWrap* wrap = container_of(handle, WorkerWrap, worker_async_storage_);
+    ngx_queue_t queue;
+    bool terminate;
+
+    uv_mutex_lock(&wrap->mutex_);
+    terminate = wrap->terminate_;
+    if (terminate || ngx_queue_empty(&wrap->to_worker_)) {
+      ngx_queue_init(&queue);
+    } else {
+      queue = wrap->to_worker_;
+      ngx_queue_head(&queue)->prev = &queue;
+      ngx_queue_last(&queue)->next = &queue;
+      ngx_queue_init(&wrap->to_worker_);
+    }
+    uv_mutex_unlock(&wrap->mutex_);
+
+    if (terminate)
+      return wrap->StopLoop();
+
+    while (!ngx_queue_empty(&queue) && !wrap->closing_) {
+      ngx_queue_t* q = ngx_queue_head(&queue);
+      ngx_queue_remove(q);
+      WorkerMessage* msg = ngx_queue_data(q, WorkerMessage, queue);
+      wrap->Dispatch(msg);
+      DeleteMessage(msg);
+    }
+
+    DeleteMessages(&queue);
+  }
+
+  void Dispatch(WorkerMessage* msg) {
+    HandleScope scope;
+
+    Local<Array> bytes = Array::New(msg->nblobs);
+    for (unsigned int i = 0; i < msg->nblobs; i++) {
+      WorkerBlob* blob = msg->blobs + i;
+      bytes->Set(i, NewBytes(blob->data, blob->length));
+      blob->data = NULL;
+    }
+
+    Local<Value> argv[2] = {
+      String::New(msg->data, msg->length),
+      bytes
+    };
+
+    TryCatch try_catch;
+    dispatch_->Call(Context::GetCurrent()->Global(), ARRAY_SIZE(argv), argv);
+
+    if (try_catch.HasCaught()) {
+      if (try_catch.CanContinue()) {
+        ReportException(try_catch);
+      } else {
+        // Terminated.
+        StopLoop();
+      }
+    }
+  }
+
+  static WorkerWrap* Unwrap(const Arguments& args) {
+    return static_cast<WorkerWrap*>(args.Data().As<External>()->Value());
+  }
+
+  static Handle<Value> Send(const Arguments& args) {
+    HandleScope scope;
+    WorkerWrap* wrap = Unwrap(args);
+
+    if (wrap->closing_)
+      return Undefined();
+
+    WorkerMessage* msg = NewMessage(WorkerMessage::kMessage);
+    msg->data = CopyUtf8(args[0], &msg->length);
+
+    if (args[1]->IsArray()) {
+      Local<Array> list = args[1].As<Array>();
+      msg->blobs = new WorkerBlob[list->Length()];
+
+      for (uint32_t i = 0; i < list->Length(); i++) {
+        Local<Value> value = list->Get(i);
+        if (!value->IsObject() ||
+            !value.As<Object>()->HasIndexedPropertiesInExternalArrayData()) {
+          DeleteMessage(msg);
+          return ThrowException(Exception::TypeError(
+              String::New("Not a Bytes object")));
+        }
+
+        // Transfer, don't copy. The Bytes object is empty afterwards.
+        Local<Object> obj = value.As<Object>();
+        WorkerBlob* blob = msg->blobs + msg->nblobs++;
+        blob->data = static_cast<char*>(
+            obj->GetIndexedPropertiesExternalArrayData());
+        blob->length = obj->GetIndexedPropertiesExternalArrayDataLength();
+        SetBytesData(obj, NULL, 0);
+        V8::AdjustAmountOfExternalAllocatedMemory(
+            -static_cast<intptr_t>(blob->length));
+      }
+    }
+
+    wrap->PostToParent(msg);
+
+    return Undefined();
+  }
+
+  static Handle<Value> WorkerClose(const Arguments& args) {
+    Unwrap(args)->StopLoop();
+    return Undefined();
+  }
+
+  static Handle<Value> Print(const Arguments& args) {
+    HandleScope scope;
+    String::Utf8Value s(args[1]);
+    FILE* stream = args[0]->Int32Value() == 1 ? stdout : stderr;
+    fwrite(*s, 1, s.length(), stream);
+    fflush(stream);
+    return Undefined();
+  }
+
+  static void SetBytesData(Handle<Object> obj, char* data, size_t length) {
+    obj->SetIndexedPropertiesToExternalArrayData(data,
+                                                 v8::kExternalUnsignedByteArray,
+                                                 length);
+    obj->ForceSet(String::NewSymbol("length"),
+                  Integer::NewFromUnsigned(length),
+                  static_cast<v8::PropertyAttribute>(v8::ReadOnly |
+                                                     v8::DontDelete));
+  }
+
+  static void BytesWeakCallback(Persistent<Value> value, void* arg) {
+    HandleScope scope;
+    Local<Object> obj = value->ToObject();
+    void* data = obj->GetIndexedPropertiesExternalArrayData();
+    int length = obj->GetIndexedPropertiesExternalArrayDataLength();
+
+    if (data != NULL) {
+      free(data);
+      V8::AdjustAmountOfExternalAllocatedMemory(-length);
+    }
+
+    value.Dispose();
+    value.Clear();
+  }
+
+  static void MakeBytes(Handle<Object> obj, char* data, size_t length) {
+    SetBytesData(obj, data, length);
+    V8::AdjustAmountOfExternalAllocatedMemory(length);
+    Persistent<Object>::New(obj).MakeWeak(NULL, BytesWeakCallback);
+  }
+
+  // new Bytes(length)
+  static Handle<Value> BytesNew(const Arguments& args) {
+    HandleScope scope;
+
+    if (!args.IsConstructCall()) {
+      return ThrowException(Exception::TypeError(
+          String::New("Constructor Bytes requires 'new'")));
+    }
+
+    // V8's external arrays are limited to a signed 32 bit length.
+    size_t length = args[0]->Uint32Value();
+    if (length > 0x3fffffff) {
+      return ThrowException(Exception::RangeError(
+          String::New("Bytes length out of range")));
+    }
+
+    char* data = static_cast<char*>(calloc(1, length + 1));
+    if (data == NULL) {
+      return ThrowException(Exception::Error(
+          String::New("Out of memory")));
+    }
+
+    MakeBytes(args.This(), data, length);
+
+    return scope.Close(args.This());
+  }
+
+  // Wraps a blob from the parent, taking ownership of |data|.
+  Local<Object> NewBytes(char* data, size_t length) {
+    HandleScope scope;
+
+    Local<Value> argv[1] = { Integer::New(0) };
+    Local<Object> obj = bytes_->NewInstance(ARRAY_SIZE(argv), argv);
+
+    // Swap the empty block for the blob.
+    free(obj->GetIndexedPropertiesExternalArrayData());
+    SetBytesData(obj, data, length);
+    V8::AdjustAmountOfExternalAllocatedMemory(length);
+
+    return scope.Close(obj);
+  }
+
+  // Shared with the worker thread, protected by mutex_.
+  uv_mutex_t mutex_;
+  ngx_queue_t to_worker_;
+  ngx_queue_t to_parent_;
+  uv_async_t* worker_async_;  // NULL unless the worker loop is accepting.
+  Isolate* isolate_;          // NULL unless the worker may be running JS.
+  bool terminate_;
+
+  // Parent thread only.
+  uv_async_t async_;
+  uv_thread_t thread_;
+  bool started_;
+
+  // Set before the thread starts, read-only afterwards.
+  char* source_;
+  size_t source_length_;
+  char* filename_;
+  size_t filename_length_;
+
+  // Worker thread only.
+  uv_loop_t* loop_;
+  uv_async_t worker_async_storage_;
+  Persistent<Function> dispatch_;
+  Persistent<Function> bytes_;
+  bool closing_;
+  int exit_code_;
+};
+
+
+}  // namespace node
+
+NODE_MODULE(node_worker_wrap, node::WorkerWrap::Initialize)
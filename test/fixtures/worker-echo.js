@@ -0,0 +1,30 @@
+// Runs inside a worker, see test/simple/test-worker.js.
+
+onmessage = function(msg) {
+  switch (msg.cmd) {
+    case 'echo':
+      postMessage({ cmd: 'echo', value: msg.value });
+      break;
+
+    case 'invert':
+      var input = msg.data;
+      var out = new Bytes(input.length);
+      for (var i = 0; i < input.length; i++)
+        out[i] = 255 - input[i];
+      postMessage({ cmd: 'invert', data: out, isBytes: input instanceof Bytes });
+      // Transferred, not copied.
+      postMessage({ cmd: 'transferred', length: out.length });
+      break;
+
+    case 'throw':
+      throw new TypeError('boom');
+
+    case 'spin':
+      postMessage({ cmd: 'spinning' });
+      for (;;);
+
+    case 'close':
+      close();
+      break;
+  }
+};
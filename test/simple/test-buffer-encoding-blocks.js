@@ -0,0 +1,82 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// base64, hex and ascii are converted in vector sized blocks with a scalar
+// tail. Check every split between the two against plain JS implementations.
+
+var common = require('../common');
+var assert = require('assert');
+
+var alphabet =
+    'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+
+function toBase64(buf) {
+  var s = '';
+  for (var i = 0; i < buf.length; i += 3) {
+    var n = buf[i] << 16 | (buf[i + 1] | 0) << 8 | (buf[i + 2] | 0);
+    s += alphabet[n >> 18 & 63] + alphabet[n >> 12 & 63];
+    s += i + 1 < buf.length ? alphabet[n >> 6 & 63] : '=';
+    s += i + 2 < buf.length ? alphabet[n & 63] : '=';
+  }
+  return s;
+}
+
+function toHex(buf) {
+  var s = '';
+  for (var i = 0; i < buf.length; i++)
+    s += (buf[i] < 16 ? '0' : '') + buf[i].toString(16);
+  return s;
+}
+
+for (var len = 0; len < 200; len++) {
+  var buf = new Buffer(len);
+  for (var i = 0; i < len; i++)
+    buf[i] = (i * 151 + len) & 255;
+
+  var b64 = toBase64(buf);
+  assert.equal(buf.toString('base64'), b64);
+  assert.deepEqual(new Buffer(b64, 'base64'), buf);
+
+  // URL-safe alphabet.
+  var url = b64.replace(/\+/g, '-').replace(/\//g, '_');
+  assert.deepEqual(new Buffer(url, 'base64'), buf);
+
+  // Line breaks and other characters that aren't base64 are skipped.
+  var wrapped = b64.replace(/(.{13})/g, '$1\r\n');
+  assert.deepEqual(new Buffer(wrapped, 'base64'), buf);
+
+  var hex = toHex(buf);
+  assert.equal(buf.toString('hex'), hex);
+  assert.deepEqual(new Buffer(hex, 'hex'), buf);
+  assert.deepEqual(new Buffer(hex.toUpperCase(), 'hex'), buf);
+
+  // Hex decoding stops at the first pair that isn't hex.
+  if (len > 0) {
+    var at = (len * 7) % len;
+    var bad = hex.slice(0, at * 2) + 'zz' + hex.slice(at * 2 + 2);
+    assert.deepEqual(new Buffer(bad, 'hex'), buf.slice(0, at));
+  }
+
+  var ascii = '';
+  for (var i = 0; i < len; i++)
+    ascii += String.fromCharCode(buf[i] & 127);
+  assert.equal(buf.toString('ascii'), ascii);
+}
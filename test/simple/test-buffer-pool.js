@@ -0,0 +1,80 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Flags: --expose-gc
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+var SlowBuffer = require('buffer').SlowBuffer;
+
+var binding = process.binding('buffer');
+var chunks = [];
+var received = 0;
+var total = 1024 * 1024;
+
+function stats() {
+  var s = binding.getPoolStats();
+  assert(s.pinnedBytes >= s.usedBytes);
+  assert(s.fragmentation >= 0 && s.fragmentation <= 1);
+  return s;
+}
+
+var before = stats();
+
+var server = net.createServer(function(socket) {
+  socket.on('data', function(data) {
+    // Reads are plain Buffers that view an arena, not SlowBuffers.
+    assert(data instanceof Buffer);
+    assert(!(data instanceof SlowBuffer));
+    assert(data.parent instanceof SlowBuffer);
+    assert(data.offset + data.length <= data.parent.length);
+    chunks.push(data);
+    received += data.length;
+  });
+  socket.on('end', function() {
+    var during = stats();
+    assert(during.buffers >= before.buffers + chunks.length);
+    assert(during.usedBytes >= before.usedBytes + received);
+    assert(during.arenas > 1);
+
+    server.close();
+    chunks = null;
+
+    setImmediate(function() {
+      gc();
+      // Only the arena that is still being filled survives.
+      var after = stats();
+      assert(after.arenas <= 1);
+      assert(after.pinnedBytes < during.pinnedBytes);
+      assert(after.usedBytes < during.usedBytes);
+    });
+  });
+}).listen(common.PORT, function() {
+  var conn = net.connect(common.PORT, function() {
+    conn.write('hello world');
+    conn.end(new Buffer(total - 11));
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(received, total);
+});
@@ -0,0 +1,116 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fork = require('child_process').fork;
+var net = require('net');
+
+if (process.argv[2] === 'child') {
+  // Echo everything back, noting the messages that came with a handle.
+  process.on('message', function(m, handle) {
+    if (handle) {
+      handle.close();
+      m = { handle: m };
+    }
+    process.send(m);
+    if (m === 'done') process.disconnect();
+  });
+  return;
+}
+
+assert.throws(function() {
+  fork(__filename, ['child'], { serialization: 'xml' });
+}, TypeError);
+
+// A "__proto__" key sent by the peer is a plain property of the message.
+var serdes = process.binding('serdes');
+var frame = serdes.encode({ __proto_X: { polluted: 1 } });
+frame.write('_', frame.toString('binary').indexOf('X'), 'binary');
+var decoded = [];
+serdes.decode(frame, decoded);
+assert.equal(decoded.length, 1);
+assert.equal(Object.getPrototypeOf(decoded[0]), Object.prototype);
+assert.ok(decoded[0].hasOwnProperty('__proto__'));
+assert.equal(decoded[0].polluted, undefined);
+assert.equal({}.polluted, undefined);
+
+var big = new Buffer(256 * 1024);
+for (var i = 0; i < big.length; i++) big[i] = i % 251;
+
+var messages = [
+  'hello',
+  { a: 1, b: [1.5, null, undefined, true], c: new Buffer('raw') },
+  { date: new Date(1234), nan: NaN, inf: -Infinity, fn: function() {} },
+  [function() {}, ''],
+  big,
+  { nested: { big: big, text: 'ünïcödé' } }
+];
+
+var child = fork(__filename, ['child'], { serialization: 'binary' });
+var received = [];
+
+child.on('message', function(m) {
+  received.push(m);
+  if (m && m.handle) server.close();
+});
+
+// Everything sent in one tick goes out together, the handle in its place.
+messages.forEach(function(m) {
+  child.send(m);
+});
+
+var server = net.createServer();
+server.listen(common.PORT, function() {
+  child.send('server', server);
+  child.send(42);
+  child.send('done');
+});
+
+process.on('exit', function() {
+  assert.equal(received.length, messages.length + 3);
+
+  assert.equal(received[0], 'hello');
+
+  assert.equal(received[1].a, 1);
+  assert.deepEqual(received[1].b, [1.5, null, undefined, true]);
+  assert.equal(received[1].b.length, 4);
+  assert.ok(Buffer.isBuffer(received[1].c));
+  assert.equal(received[1].c.toString(), 'raw');
+
+  assert.ok(received[2].date instanceof Date);
+  assert.equal(received[2].date.getTime(), 1234);
+  assert.ok(isNaN(received[2].nan));
+  assert.equal(received[2].inf, -Infinity);
+  assert.ok(!('fn' in received[2]));
+
+  assert.deepEqual(received[3], [null, '']);
+
+  assert.ok(Buffer.isBuffer(received[4]));
+  assert.equal(received[4].toString('hex'), big.toString('hex'));
+
+  assert.equal(received[5].nested.big.toString('hex'), big.toString('hex'));
+  assert.equal(received[5].nested.text, 'ünïcödé');
+
+  assert.deepEqual(received[6], { handle: 'server' });
+  assert.equal(received[7], 42);
+  assert.equal(received[8], 'done');
+});
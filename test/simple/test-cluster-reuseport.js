@@ -0,0 +1,77 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var cluster = require('cluster');
+var net = require('net');
+
+var NUM_CONNECTIONS = 32;
+
+if (process.platform !== 'linux') {
+  console.error('Skipping test, SO_REUSEPORT balancing is Linux only.');
+  process.exit(0);
+}
+
+if (cluster.isMaster) {
+  var seen = {};
+  var listening = 0;
+  var done = 0;
+
+  cluster.setupMaster({ reusePort: true });
+  assert.equal(cluster.settings.reusePort, true);
+
+  cluster.on('listening', function(worker, address) {
+    assert.equal(address.port, common.PORT);
+    if (++listening === 2) connectAll();
+  });
+
+  cluster.fork();
+  cluster.fork();
+
+  function connectAll() {
+    for (var i = 0; i < NUM_CONNECTIONS; i++) {
+      net.connect(common.PORT, '127.0.0.1', function() {
+        var data = '';
+        this.setEncoding('utf8');
+        this.on('data', function(chunk) { data += chunk; });
+        this.on('end', function() {
+          seen[data] = (seen[data] || 0) + 1;
+          if (++done === NUM_CONNECTIONS) cluster.disconnect();
+        });
+      });
+    }
+  }
+
+  process.on('exit', function() {
+    assert.equal(done, NUM_CONNECTIONS);
+    // Both workers should have accepted connections, the chance that one of
+    // them got all 32 is 2^-31.
+    assert.deepEqual(Object.keys(seen).sort(), ['1', '2']);
+  });
+} else {
+  // Read at startup, not passed on to the processes the worker starts.
+  assert.equal(process.env.NODE_CLUSTER_REUSEPORT, undefined);
+
+  net.createServer(function(socket) {
+    socket.end(String(cluster.worker.id));
+  }).listen(common.PORT, '127.0.0.1');
+}
@@ -0,0 +1,93 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// With schedulingPolicy 'rr' the master accepts the connections and passes
+// them to the workers. Equally idle workers take turns, and a worker that
+// closes its server gets no more connections.
+
+var common = require('../common');
+var assert = require('assert');
+var cluster = require('cluster');
+var net = require('net');
+
+var NUM_CONNECTIONS = 20;
+
+if (cluster.isMaster) {
+  var seen = {};
+  var listening = 0;
+  var done = 0;
+  var closed = false;
+
+  cluster.setupMaster({ schedulingPolicy: 'rr' });
+  assert.equal(cluster.settings.schedulingPolicy, 'rr');
+
+  cluster.on('listening', function(worker, address) {
+    assert.equal(address.port, common.PORT);
+    if (++listening === 2) connectAll(done, NUM_CONNECTIONS);
+  });
+
+  var workers = [cluster.fork(), cluster.fork()];
+
+  function connectAll(from, to) {
+    for (var i = from; i < to; i++) {
+      net.connect(common.PORT, '127.0.0.1', function() {
+        var data = '';
+        this.setEncoding('utf8');
+        this.on('data', function(chunk) { data += chunk; });
+        this.on('end', function() {
+          seen[data] = (seen[data] || 0) + 1;
+          if (++done === NUM_CONNECTIONS) closeOne();
+          else if (done === 2 * NUM_CONNECTIONS) cluster.disconnect();
+        });
+      });
+    }
+  }
+
+  // Once worker 1 closed its server, all connections go to worker 2.
+  function closeOne() {
+    assert.ok(seen[1] > 0);
+    assert.ok(seen[2] > 0);
+    seen = {};
+    workers[0].send('close');
+    workers[0].once('message', function(msg) {
+      assert.equal(msg, 'closed');
+      closed = true;
+      connectAll(NUM_CONNECTIONS, 2 * NUM_CONNECTIONS);
+    });
+  }
+
+  process.on('exit', function() {
+    assert.ok(closed);
+    assert.equal(done, 2 * NUM_CONNECTIONS);
+    assert.deepEqual(seen, { 2: NUM_CONNECTIONS });
+  });
+} else {
+  var server = net.createServer(function(socket) {
+    socket.end(String(cluster.worker.id));
+  }).listen(common.PORT, '127.0.0.1');
+
+  process.on('message', function(msg) {
+    if (msg !== 'close') return;
+    server.close(function() {
+      process.send('closed');
+    });
+  });
+}
@@ -0,0 +1,76 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+if (!process.versions.openssl) {
+  console.error('Skipping because node compiled without OpenSSL.');
+  process.exit(0);
+}
+
+if (process.platform === 'win32') {
+  console.log('Skipping: no shared session cache on Windows.');
+  process.exit(0);
+}
+
+var common = require('../common');
+var assert = require('assert');
+var cluster = require('cluster');
+var fs = require('fs');
+var tls = require('tls');
+
+if (cluster.isWorker) {
+  // Not passed on to the processes the worker starts.
+  assert.equal(process.env.NODE_TLS_SESSION_CACHE, undefined);
+
+  var options = {
+    key: fs.readFileSync(common.fixturesDir + '/keys/agent1-key.pem'),
+    cert: fs.readFileSync(common.fixturesDir + '/keys/agent1-cert.pem')
+  };
+
+  // Only servers that listen through the master attach to the shared cache.
+  var local = tls.createServer(options);
+  assert.equal(local.getSessionCacheStats(), null);
+
+  var server = tls.createServer(options).listen(common.PORT, function() {
+    var stats = server.getSessionCacheStats();
+    assert.ok(stats);
+    assert.equal(stats.shared, true);
+    assert.equal(stats.capacity, 16);
+    assert.equal(local.getSessionCacheStats(), null);
+    process.send('ok');
+  });
+  return;
+}
+
+var messages = 0;
+
+cluster.setupMaster({ tlsSessionCacheSize: 16 });
+var worker = cluster.fork();
+
+worker.on('message', function(msg) {
+  assert.equal(msg, 'ok');
+  messages++;
+  worker.kill();
+});
+
+process.on('exit', function() {
+  assert.equal(messages, 1);
+});
@@ -0,0 +1,67 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Crypto output must not share memory with other Buffers: anything in a
+// BufferPool arena can read the rest of it through `parent`.
+
+var common = require('../common');
+var assert = require('assert');
+
+try {
+  var crypto = require('crypto');
+} catch (e) {
+  console.log('Not compiled with OPENSSL support.');
+  process.exit();
+}
+
+var binding = process.binding('buffer');
+
+function checkOwn(buf) {
+  assert(Buffer.isBuffer(buf));
+  assert.equal(buf.offset, 0);
+  assert.equal(buf.parent.length, buf.length);
+}
+
+var before = binding.getPoolStats();
+
+checkOwn(crypto.randomBytes(16));
+checkOwn(crypto.pseudoRandomBytes(16));
+checkOwn(crypto.createHash('sha1').update('abc').digest());
+checkOwn(crypto.createHmac('sha1', 'key').update('abc').digest());
+checkOwn(crypto.pbkdf2Sync('password', 'salt', 1, 20));
+
+var key = new Buffer('0123456789abcdef');
+var cipher = crypto.createCipheriv('aes-128-ecb', key, new Buffer(0));
+checkOwn(cipher.update('some secret text'));
+checkOwn(cipher.final());
+
+var after = binding.getPoolStats();
+assert.equal(after.buffers, before.buffers);
+assert.equal(after.usedBytes, before.usedBytes);
+
+crypto.randomBytes(32, common.mustCall(function(err, buf) {
+  assert.ifError(err);
+  checkOwn(buf);
+}));
+crypto.pbkdf2('password', 'salt', 1, 20, common.mustCall(function(err, buf) {
+  assert.ifError(err);
+  checkOwn(buf);
+}));
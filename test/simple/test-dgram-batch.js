@@ -0,0 +1,77 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var dgram = require('dgram');
+
+var COUNT = 100;
+
+var source = dgram.createSocket('udp4');
+var target = dgram.createSocket('udp4');
+var received = [];
+
+assert.throws(function() {
+  target.setBatchSize('8');
+}, TypeError);
+
+if (process.platform !== 'linux') {
+  assert.throws(function() {
+    target.setBatchSize(8);
+  }, /ENOSYS/);
+  console.log('skipping, batched UDP I/O is only supported on Linux');
+  source.close();
+  target.close();
+  return;
+}
+
+assert.throws(function() {
+  target.setBatchSize(65);
+}, /EINVAL/);
+
+assert.equal(target.setBatchSize(16), 16);
+assert.equal(source.setBatchSize(16), 16);
+
+process.on('exit', function() {
+  assert.equal(received.length, COUNT);
+  // Datagrams of one batch arrive in order, with their own rinfo.
+  for (var i = 0; i < COUNT; i++)
+    assert.equal(received[i], 'message ' + i);
+});
+
+target.on('message', function(buf, rinfo) {
+  assert.equal(rinfo.address, '127.0.0.1');
+  assert.equal(rinfo.size, buf.length);
+  received.push(buf.toString());
+  if (received.length === COUNT) {
+    source.close();
+    target.close();
+  }
+});
+
+target.on('listening', function() {
+  for (var i = 0; i < COUNT; i++) {
+    var buf = Buffer('message ' + i);
+    source.send(buf, 0, buf.length, common.PORT, '127.0.0.1');
+  }
+});
+
+target.bind(common.PORT);
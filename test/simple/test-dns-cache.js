@@ -0,0 +1,86 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var dns = require('dns');
+
+assert.strictEqual(dns.getCacheStats(), null);
+
+assert.throws(function() {
+  dns.enableCache({ ttl: -1 });
+}, TypeError);
+
+assert.throws(function() {
+  dns.enableCache({ maxEntries: 'many' });
+}, TypeError);
+
+dns.enableCache({ maxEntries: 10, ttl: 60000 });
+
+var answers = [];
+
+function onlookup(err, address, family) {
+  assert.ifError(err);
+  answers.push(address);
+}
+
+// Two lookups of the same name at once share one getaddrinfo() request.
+dns.lookup('localhost', 4, onlookup);
+dns.lookup('localhost', 4, function(err, address, family) {
+  onlookup(err, address, family);
+
+  var stats = dns.getCacheStats().lookup;
+  assert.equal(stats.capacity, 10);
+  assert.equal(stats.misses, 1);
+  assert.equal(stats.coalesced, 1);
+  assert.equal(stats.stores, 1);
+  assert.equal(stats.entries, 1);
+
+  // The next one is answered from the cache, still asynchronously.
+  var sync = true;
+  dns.lookup('LOCALHOST', 4, function(err, address, family) {
+    assert.ok(!sync);
+    onlookup(err, address, family);
+    assert.equal(family, 4);
+
+    stats = dns.getCacheStats().lookup;
+    assert.equal(stats.hits, 1);
+    assert.equal(stats.misses, 1);
+
+    dns.clearCache();
+    assert.equal(dns.getCacheStats().lookup.entries, 0);
+
+    dns.disableCache();
+    dns.lookup('localhost', 4, function(err, address, family) {
+      onlookup(err, address, family);
+      assert.equal(dns.getCacheStats().lookup.entries, 0);
+      assert.equal(dns.getCacheStats().lookup.hits, 1);
+    });
+  });
+  sync = false;
+});
+
+process.on('exit', function() {
+  assert.equal(answers.length, 4);
+  answers.forEach(function(address) {
+    assert.equal(address, answers[0]);
+  });
+});
@@ -0,0 +1,105 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+
+var file = path.join(common.tmpDir, 'batch.txt');
+var missing = path.join(common.tmpDir, 'does-not-exist.txt');
+var data = new Buffer('hello batch');
+
+try { fs.unlinkSync(file); } catch (e) {}
+
+var written = false;
+var read = false;
+var failed = false;
+
+// Write and read back a file in two batches.
+fs.batch([
+  ['open', file, 'w'],
+  ['write', fs.batch.fd(0), data, 0, data.length, 0],
+  ['close', fs.batch.fd(0)]
+], function(err, results) {
+  assert.ifError(err);
+  assert.equal(results.length, 3);
+  assert.equal(typeof results[0], 'number');
+  assert.equal(results[1], data.length);
+  written = true;
+
+  var buffer = new Buffer(64);
+  fs.batch([
+    ['stat', file],
+    ['open', file],
+    ['fstat', fs.batch.fd(1)],
+    ['read', fs.batch.fd(1), buffer, 0, buffer.length, 0],
+    ['close', fs.batch.fd(1)]
+  ], function(err, results) {
+    assert.ifError(err);
+    assert.ok(results[0] instanceof fs.Stats);
+    assert.ok(results[0].isFile());
+    assert.equal(results[0].size, data.length);
+    assert.equal(results[2].size, data.length);
+    assert.equal(results[3], data.length);
+    assert.equal(buffer.toString('utf8', 0, results[3]), data.toString());
+    read = true;
+  });
+});
+
+// A failed open fails the operations that use its fd with EBADF, the others
+// still run.
+fs.batch([
+  ['open', missing],
+  ['fstat', fs.batch.fd(0)],
+  ['stat', __filename],
+  ['close', fs.batch.fd(0)]
+], function(err, results) {
+  assert.ok(err instanceof Error);
+  assert.equal(err.code, 'ENOENT');
+  assert.equal(err.index, 0);
+  assert.equal(results[0], undefined);
+  assert.equal(results[1], undefined);
+  assert.ok(results[2].isFile());
+  failed = true;
+});
+
+assert.throws(function() {
+  fs.batch([['fstat', fs.batch.fd(0)]], function() {});
+}, TypeError);
+
+assert.throws(function() {
+  fs.batch([['stat', __filename], ['close', fs.batch.fd(0)]], function() {});
+}, TypeError);
+
+assert.throws(function() {
+  fs.batch([['unlink', file]], function() {});
+}, TypeError);
+
+assert.throws(function() {
+  fs.batch([['read', 0, new Buffer(4), 2, 4]], function() {});
+}, RangeError);
+
+process.on('exit', function() {
+  assert.ok(written);
+  assert.ok(read);
+  assert.ok(failed);
+});
@@ -547,3 +547,68 @@ function expectBody(expected) {
   parser.onHeadersComplete = onHeadersComplete2;
   parser.execute(req2, 0, req2.length);
 })();
+
+
+//
+// Test header offsets.
+//
+(function() {
+  var request = Buffer(
+      'GET /offsets HTTP/1.1' + CRLF +
+      'Host: example.com' + CRLF +
+      'X-Custom-Header: yes' + CRLF +
+      'content-length: 0' + CRLF +
+      CRLF);
+
+  var parser = newParser(REQUEST);
+  parser.useHeaderOffsets(true);
+
+  function slice(start, len) {
+    return request.toString('utf8', start, start + len);
+  }
+
+  parser.onHeadersComplete = mustCall(function(info) {
+    assert.equal(info.url, '/offsets');
+    assert.equal(info.headers, undefined);
+
+    var offsets = info.headerOffsets;
+    assert.equal(offsets.length, 12);
+
+    // Common header names are interned, whatever their case.
+    assert.equal(offsets[0], 'Host');
+    assert.equal(offsets[1], 4);
+    assert.equal(slice(offsets[2], offsets[3]), 'example.com');
+
+    assert.equal(typeof offsets[4], 'number');
+    assert.equal(slice(offsets[4], offsets[5]), 'X-Custom-Header');
+    assert.equal(slice(offsets[6], offsets[7]), 'yes');
+
+    assert.equal(offsets[8], 'content-length');
+    assert.equal(slice(offsets[10], offsets[11]), '0');
+  });
+
+  parser.execute(request, 0, request.length);
+})();
+
+
+//
+// Test header offsets fall back to strings for headers that span reads.
+//
+(function() {
+  var request = Buffer(
+      'GET /split HTTP/1.1' + CRLF +
+      'Host: example.com' + CRLF +
+      CRLF);
+
+  var parser = newParser(REQUEST);
+  parser.useHeaderOffsets(true);
+
+  parser.onHeadersComplete = mustCall(function(info) {
+    assert.equal(info.headerOffsets, undefined);
+    assert.deepEqual(info.headers, ['Host', 'example.com']);
+  });
+
+  var split = 28;
+  parser.execute(request.slice(0, split), 0, split);
+  parser.execute(request.slice(split), 0, request.length - split);
+})();
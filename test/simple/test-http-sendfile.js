@@ -0,0 +1,128 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var http = require('http');
+var net = require('net');
+var fs = require('fs');
+var path = require('path');
+
+var file = path.join(common.tmpDir, 'http-sendfile.txt');
+var body = new Array(20000).join('sendfile ');
+fs.writeFileSync(file, body);
+var fd = fs.openSync(file, 'r');
+
+var nativeSends = 0;
+var sendFile = net.Socket.prototype.sendFile;
+net.Socket.prototype.sendFile = function() {
+  nativeSends++;
+  return sendFile.apply(this, arguments);
+};
+
+var callbacks = 0;
+var server = http.createServer(function(req, res) {
+  function done(er) {
+    assert.ifError(er);
+    callbacks++;
+  }
+
+  switch (req.url) {
+    case '/whole':
+      res.sendFile(fd, done);
+      break;
+    case '/range':
+      res.sendFile(fd, 9, 18, done);
+      break;
+    case '/chunked':
+      // Headers already committed to chunked encoding, takes the slow path.
+      res.writeHead(200, {'Transfer-Encoding': 'chunked'});
+      res.sendFile(fd, 0, 8, done);
+      break;
+    case '/head':
+      res.sendFile(fd, done);
+      break;
+    case '/badfd':
+      res.sendFile(-1, function(er) {
+        assert.ok(er instanceof Error);
+        callbacks++;
+        res.writeHead(404);
+        res.end();
+      });
+      break;
+  }
+});
+
+function get(method, url, cb) {
+  var req = http.request({
+    method: method,
+    port: common.PORT,
+    path: url,
+    agent: agent
+  }, function(res) {
+    var data = '';
+    res.setEncoding('utf8');
+    res.on('data', function(chunk) { data += chunk; });
+    res.on('end', function() { cb(res, data); });
+  });
+  req.end();
+}
+
+// One keep-alive connection, so every response has to leave the socket in
+// a state the next one can use.
+var agent = new http.Agent({maxSockets: 1});
+var finished = 0;
+
+server.listen(common.PORT, function() {
+  get('GET', '/whole', function(res, data) {
+    assert.equal(res.statusCode, 200);
+    assert.equal(res.headers['content-length'], body.length);
+    assert.ok(data === body);
+    finished++;
+  });
+  get('GET', '/range', function(res, data) {
+    assert.equal(res.headers['content-length'], 18);
+    assert.equal(data, 'sendfile sendfile ');
+    finished++;
+  });
+  get('GET', '/chunked', function(res, data) {
+    assert.equal(res.headers['transfer-encoding'], 'chunked');
+    assert.equal(data, 'sendfile');
+    finished++;
+  });
+  get('HEAD', '/head', function(res, data) {
+    assert.equal(res.headers['content-length'], body.length);
+    assert.equal(data, '');
+    finished++;
+  });
+  get('GET', '/badfd', function(res, data) {
+    assert.equal(res.statusCode, 404);
+    finished++;
+    server.close();
+  });
+});
+
+process.on('exit', function() {
+  fs.closeSync(fd);
+  assert.equal(finished, 5);
+  assert.equal(callbacks, 5);
+  assert.equal(nativeSends, 2);
+});
@@ -0,0 +1,118 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var spawn = require('child_process').spawn;
+
+var cacheDir = path.join(common.tmpDir, 'compile-cache');
+var modFile = path.join(common.tmpDir, 'compile-cache-mod.js');
+
+if (process.argv[2] === 'child') {
+  var mod = require(modFile);
+  assert.equal(mod.add(2, 3), 5);
+  assert.equal(mod.version, process.argv[3]);
+  console.log(JSON.stringify(require('module').compileCacheStats));
+  return;
+}
+
+function rimraf(dir) {
+  try {
+    fs.readdirSync(dir).forEach(function(f) {
+      fs.unlinkSync(path.join(dir, f));
+    });
+    fs.rmdirSync(dir);
+  } catch (e) {
+    if (e.code !== 'ENOENT') throw e;
+  }
+}
+
+function writeModule(version) {
+  fs.writeFileSync(modFile,
+                   'exports.version = "' + version + '";\n' +
+                   'exports.add = function(a, b) {\n' +
+                   '  return a + b;\n' +
+                   '};\n');
+}
+
+function run(version, cb, useCache) {
+  var env = {};
+  for (var k in process.env) env[k] = process.env[k];
+  delete env.NODE_COMPILE_CACHE;
+  if (useCache !== false) env.NODE_COMPILE_CACHE = cacheDir;
+  var child = spawn(process.execPath, [__filename, 'child', version],
+                    { env: env });
+  var out = '';
+  child.stdout.setEncoding('utf8');
+  child.stdout.on('data', function(s) { out += s; });
+  child.stderr.pipe(process.stderr);
+  child.on('exit', function(code) {
+    assert.equal(code, 0);
+    cb(JSON.parse(out));
+  });
+}
+
+rimraf(cacheDir);
+writeModule('1');
+
+var runs = 0;
+
+// The cache is off unless NODE_COMPILE_CACHE is set: require() doesn't look
+// for entries and doesn't create the directory.
+run('1', function(stats) {
+  runs++;
+  assert.deepEqual(stats, { hits: 0, misses: 0, stores: 0, errors: 0 });
+  assert.ok(!fs.existsSync(cacheDir));
+
+  // The first run with the cache fills it, the directory is created on
+  // demand.
+  run('1', function(stats) {
+    runs++;
+    assert.equal(stats.hits, 0);
+    assert.ok(stats.misses >= 1);
+    assert.equal(stats.stores, stats.misses);
+    assert.equal(stats.errors, 0);
+    assert.ok(fs.readdirSync(cacheDir).length >= 1);
+
+    // The second run compiles with the stored data.
+    run('1', function(stats) {
+      runs++;
+      assert.equal(stats.misses, 0);
+      assert.ok(stats.hits >= 1);
+
+      // A changed module doesn't match its entry any more.
+      writeModule('22');
+      run('22', function(stats) {
+        runs++;
+        assert.equal(stats.misses, 1);
+        assert.equal(stats.stores, 1);
+      });
+    });
+  });
+}, false);
+
+process.on('exit', function() {
+  assert.equal(runs, 4);
+  rimraf(cacheDir);
+  fs.unlinkSync(modFile);
+});
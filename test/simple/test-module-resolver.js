@@ -0,0 +1,189 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var spawn = require('child_process').spawn;
+var resolver = process.binding('resolver');
+
+var root = path.join(common.tmpDir, 'resolver');
+var manifest = path.join(common.tmpDir, 'resolver-manifest.json');
+
+if (process.argv[2] === 'child') {
+  var main = require(path.join(root, 'main'));
+  console.log(JSON.stringify({ a: main.a,
+                               foo: main.foo,
+                               stats: resolver.getStats() }));
+  return;
+}
+
+function rimraf(p) {
+  try {
+    var stat = fs.lstatSync(p);
+  } catch (e) {
+    return;
+  }
+  if (stat.isDirectory()) {
+    fs.readdirSync(p).forEach(function(f) {
+      rimraf(path.join(p, f));
+    });
+    fs.rmdirSync(p);
+  } else {
+    fs.unlinkSync(p);
+  }
+}
+
+function mkdirp(dir) {
+  if (fs.existsSync(dir)) return;
+  mkdirp(path.dirname(dir));
+  fs.mkdirSync(dir);
+}
+
+function write(file, content) {
+  mkdirp(path.dirname(file));
+  fs.writeFileSync(file, content);
+}
+
+rimraf(root);
+rimraf(manifest);
+write(path.join(root, 'node_modules', 'a', 'package.json'),
+      JSON.stringify({ main: './lib/../lib/a' }));
+write(path.join(root, 'node_modules', 'a', 'lib', 'a.js'),
+      'exports.a = "a";');
+write(path.join(root, 'foo.js'), 'exports.foo = "file";');
+write(path.join(root, 'main.js'), 'exports.a = require("a").a;\n' +
+                                  'exports.foo = require("./foo").foo;\n');
+
+// The candidate walk, package.json mains included.
+assert.equal(require(path.join(root, 'main')).a, 'a');
+
+// Misses are answered from directory listings, checking again costs a
+// stat() of the directory, and a new listing if it changed this second.
+assert.throws(function() { require(path.join(root, 'nope')); },
+              /Cannot find module/);
+var before = resolver.getStats();
+assert.throws(function() { require(path.join(root, 'nope2')); },
+              /Cannot find module/);
+var after = resolver.getStats();
+assert.ok(after.readdirs - before.readdirs <= 1);
+assert.ok(after.stats - before.stats <= 1);
+
+// A module that shows up after its directory was listed is still found.
+write(path.join(root, 'late.js'), 'exports.late = true;');
+assert.equal(require(path.join(root, 'late')).late, true);
+
+// So is a new directory.
+write(path.join(root, 'node_modules', 'b', 'index.js'), 'exports.b = 1;');
+assert.equal(require(path.join(root, 'node_modules', 'b')).b, 1);
+
+// Errors in package.json are reported as before.
+write(path.join(root, 'node_modules', 'bad', 'package.json'), '{ main: ');
+assert.throws(function() {
+  require(path.join(root, 'node_modules', 'bad'));
+}, function(e) {
+  return e instanceof SyntaxError &&
+         e.path === path.join(root, 'node_modules', 'bad', 'package.json') &&
+         /^Error parsing /.test(e.message);
+});
+
+// A result that is gone by the time it is opened is looked up again.
+write(path.join(root, 'ghost.js'), 'exports.ghost = "file";');
+assert.equal(require(path.join(root, 'ghost')).ghost, 'file');
+fs.unlinkSync(path.join(root, 'ghost.js'));
+write(path.join(root, 'ghost', 'index.js'), 'exports.ghost = "dir";');
+age(root);
+require('module')._pathCache = {};
+delete require.cache[path.join(root, 'ghost.js')];
+assert.equal(require(path.join(root, 'ghost')).ghost, 'dir');
+
+// Files and directories written in the same second as they are listed are
+// listed again, so make everything old enough to be trusted.
+function age(p, recurse) {
+  var then = Date.now() / 1000 - 60;
+  fs.utimesSync(p, then, then);
+  if (recurse !== false && fs.statSync(p).isDirectory()) {
+    fs.readdirSync(p).forEach(function(f) {
+      age(path.join(p, f));
+    });
+  }
+}
+
+// A manifest written by one process spares the next one the listings.
+function run(cb) {
+  var env = {};
+  for (var k in process.env) env[k] = process.env[k];
+  env.NODE_RESOLVE_MANIFEST = manifest;
+  var child = spawn(process.execPath, [__filename, 'child'], { env: env });
+  var out = '';
+  child.stdout.setEncoding('utf8');
+  child.stdout.on('data', function(s) { out += s; });
+  child.stderr.pipe(process.stderr);
+  child.on('exit', function(code) {
+    assert.equal(code, 0);
+    cb(JSON.parse(out));
+  });
+}
+
+var runs = 0;
+
+// A manifest that isn't one is ignored and replaced.
+fs.writeFileSync(manifest, '{"dirs": [');
+run(function(r) {
+  runs++;
+  assert.equal(r.a, 'a');
+  assert.equal(r.foo, 'file');
+  assert.ok(r.stats.readdirs > 0);
+  assert.equal(typeof JSON.parse(fs.readFileSync(manifest, 'utf8')), 'object');
+  assert.deepEqual(fs.readdirSync(common.tmpDir).filter(function(f) {
+    return f.indexOf('resolver-manifest.json.') === 0;
+  }), []);
+
+  // The test runner recreates the tmp directory.
+  age(root);
+  age(common.tmpDir, false);
+  age(path.dirname(common.tmpDir), false);
+  run(function(r) {
+    runs++;
+    assert.equal(r.foo, 'file');
+    assert.equal(r.stats.readdirs, 0);
+
+    // What changed since the manifest was written isn't taken from it.
+    fs.unlinkSync(path.join(root, 'foo.js'));
+    write(path.join(root, 'foo', 'index.js'), 'exports.foo = "dir";');
+    write(path.join(root, 'node_modules', 'a', 'lib', 'b.js'),
+          'exports.a = "b";');
+    write(path.join(root, 'node_modules', 'a', 'package.json'),
+          JSON.stringify({ main: './lib/b' }));
+    run(function(r) {
+      runs++;
+      assert.equal(r.a, 'b');
+      assert.equal(r.foo, 'dir');
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(runs, 3);
+  rimraf(root);
+  rimraf(manifest);
+});
@@ -0,0 +1,112 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+var fs = require('fs');
+var path = require('path');
+
+var file = path.join(common.tmpDir, 'sendfile.bin');
+var size = 2 * 1024 * 1024;
+var data = new Buffer(size);
+for (var i = 0; i < size; i++)
+  data[i] = (i * 7 + (i >> 12)) & 0xff;
+fs.writeFileSync(file, data);
+var fd = fs.openSync(file, 'r');
+
+var expected = Buffer.concat([
+  new Buffer('head'),
+  data.slice(5, size - 3),
+  new Buffer('middle'),
+  data.slice(0, 100),
+  new Buffer('tail')
+]);
+
+function sendAll(socket, done) {
+  var callbacks = [];
+  socket.write('head');
+  socket.sendFile(fd, 5, size - 8, function(er) {
+    assert.ifError(er);
+    callbacks.push('file1');
+  });
+  // Corked writes reach the handle through _writev(), the file range in the
+  // middle has to split the batch without reordering it.
+  socket.cork();
+  socket.write('mid');
+  socket.write('dle');
+  socket.sendFile(fd, 0, 100, function(er) {
+    assert.ifError(er);
+    callbacks.push('file2');
+  });
+  socket.sendFile(fd, 0, 0);
+  socket.write('tail', function() {
+    callbacks.push('tail');
+  });
+  socket.uncork();
+  socket.end(function() {
+    assert.deepEqual(callbacks, ['file1', 'file2', 'tail']);
+    done();
+  });
+  assert.equal(socket.bytesWritten, expected.length);
+}
+
+function test(address, next) {
+  var senderDone = false;
+  var server = net.createServer(function(socket) {
+    sendAll(socket, function() {
+      senderDone = true;
+    });
+  });
+
+  server.listen(address, function() {
+    var client = net.connect(address);
+    var chunks = [];
+    client.on('data', function(chunk) {
+      chunks.push(chunk);
+    });
+    client.on('end', function() {
+      var received = Buffer.concat(chunks);
+      assert.equal(received.length, expected.length);
+      assert.ok(received.toString('hex') === expected.toString('hex'));
+      assert.ok(senderDone);
+      server.close();
+      next();
+    });
+  });
+}
+
+assert.throws(function() {
+  new net.Socket().sendFile(fd, -1, 10);
+}, TypeError);
+
+var tested = 0;
+test(common.PORT, function() {
+  tested++;
+  test(common.PIPE, function() {
+    tested++;
+  });
+});
+
+process.on('exit', function() {
+  fs.closeSync(fd);
+  assert.equal(tested, 2);
+});
@@ -0,0 +1,67 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+var received = '';
+var writes = 0;
+var expected = 'hello, ' + 'world' + '!' + 'été' + '\nand then...';
+
+var server = net.createServer(function(socket) {
+  socket.setEncoding('utf8');
+  socket.on('data', function(data) {
+    received += data;
+  });
+  socket.on('end', function() {
+    server.close();
+  });
+}).listen(common.PORT, function() {
+  var conn = net.connect(common.PORT);
+  function onwrite(er) {
+    assert.ifError(er);
+    writes++;
+  }
+
+  conn.on('connect', function() {
+    // Everything written while corked goes out as a single writev.
+    conn.cork();
+    conn.write('hello, ', 'ascii', onwrite);
+    conn.write(new Buffer('world'), onwrite);
+    conn.write('!', 'utf8', onwrite);
+    conn.write('été', 'utf8', onwrite);
+    conn.write(new Buffer('\nand then...').toString('hex'), 'hex', onwrite);
+    assert.equal(conn._writableState.buffer.length, 5);
+    conn.uncork();
+    assert.equal(conn._writableState.buffer.length, 0);
+    conn.end();
+  });
+
+  conn.on('finish', function() {
+    assert.equal(conn.bytesWritten, Buffer.byteLength(expected));
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(received, expected);
+  assert.equal(writes, 5);
+});
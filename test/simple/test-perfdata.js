@@ -0,0 +1,125 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var http = require('http');
+var os = require('os');
+var path = require('path');
+var spawn = require('child_process').spawn;
+
+if (process.platform === 'win32' || !global.COUNTER_NET_SERVER_CONNECTION) {
+  console.log('Skipping: built without shared memory performance counters.');
+  return;
+}
+
+var dir = path.join(common.tmpDir, 'perfdata');
+
+function readUInt64(buf, offset) {
+  var lo = buf['readUInt32' + os.endianness()](offset);
+  var hi = buf['readUInt32' + os.endianness()](offset + 4);
+  if (os.endianness() === 'BE') {
+    var t = lo;
+    lo = hi;
+    hi = t;
+  }
+  return hi * 0x100000000 + lo;
+}
+
+function readCounters(file) {
+  var buf = fs.readFileSync(file);
+  assert.equal(buf.toString('ascii', 0, 8), 'NODEPERF');
+  assert.equal(buf['readUInt32' + os.endianness()](8), 1);
+
+  var entries = buf['readUInt32' + os.endianness()](12);
+  assert.equal(buf.length, 64 + entries * 64);
+
+  var counters = {
+    pid: readUInt64(buf, 16),
+    startTime: readUInt64(buf, 24),
+    sampleTime: readUInt64(buf, 32)
+  };
+  for (var i = 0; i < entries; i++) {
+    var offset = 64 + i * 64;
+    var name = buf.toString('ascii', offset, offset + 56).replace(/\0.*$/, '');
+    counters[name] = readUInt64(buf, offset + 56);
+  }
+  return counters;
+}
+
+if (process.argv[2] === 'child') {
+  var file = path.join(dir, String(process.pid));
+  var server = http.createServer(function(req, res) {
+    res.end('ok');
+  });
+
+  server.listen(common.PORT, function() {
+    var left = 10;
+    (function next() {
+      if (left-- === 0) {
+        server.close();
+        // Let the sampler run once more.
+        return setTimeout(function() {
+          var c = readCounters(file);
+          assert.equal(c.pid, process.pid);
+          assert.ok(c.sampleTime >= c.startTime);
+          assert.equal(c['node.http.server.requests'], 10);
+          assert.equal(c['node.http.server.responses'], 10);
+          assert.equal(c['node.http.client.requests'], 10);
+          assert.equal(c['node.http.client.responses'], 10);
+          assert.equal(c['node.net.server.accepted'], 10);
+          assert.equal(c['node.net.server.connections'], 0);
+          assert.ok(c['node.net.bytesSent'] > 0);
+          assert.equal(c['node.net.bytesSent'], c['node.net.bytesReceived']);
+          assert.ok(c['node.heap.used'] > 0);
+          assert.ok(c['node.heap.total'] >= c['node.heap.used']);
+          assert.ok(c['node.loop.activeHandles'] > 0);
+          assert.ok(c['node.threadpool.fs.threads'] > 0);
+          console.log('ok');
+        }, 250);
+      }
+      http.get({ port: common.PORT, agent: false }, function(res) {
+        res.resume();
+        res.on('end', next);
+      });
+    })();
+  });
+  return;
+}
+
+var env = {};
+for (var key in process.env) env[key] = process.env[key];
+env.NODE_PERFDATA_DIR = dir;
+
+var child = spawn(process.execPath, [__filename, 'child'], { env: env });
+var out = '';
+child.stdout.setEncoding('utf8');
+child.stdout.on('data', function(s) { out += s; });
+child.stderr.pipe(process.stderr);
+
+child.on('exit', function(code) {
+  assert.equal(code, 0);
+  assert.equal(out.trim(), 'ok');
+  // Removed on exit.
+  assert.ok(!fs.existsSync(path.join(dir, String(child.pid))));
+});
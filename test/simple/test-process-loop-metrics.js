@@ -0,0 +1,83 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+
+var metrics = process.loopMetrics;
+
+if (process.platform === 'win32') {
+  assert.equal(metrics, undefined);
+  console.log('Skipping: loop metrics not supported on this platform.');
+  return;
+}
+
+if (!metrics.start()) {
+  console.log('Skipping: loop metrics not supported on this platform.');
+  return;
+}
+
+var snapshot;
+var ticks = 0;
+
+function spin() {
+  var end = Date.now() + 2;
+  while (Date.now() < end);
+  if (++ticks < 20) return setImmediate(spin);
+
+  metrics.stop();
+  snapshot = metrics.snapshot();
+  var summary = metrics.summary(snapshot);
+
+  assert.ok(summary.iteration.count >= 19);
+  assert.equal(summary.iteration.count, summary.busy.count);
+  assert.equal(summary.iteration.count, summary.timers.count);
+  assert.ok(summary.callback.count >= 19);
+  assert.ok(summary.callback.max >= 2);
+  assert.ok(summary.iteration.max >= 2);
+  assert.ok(summary.iteration.p50 >= summary.iteration.min);
+  assert.ok(summary.iteration.p999 <= summary.iteration.max);
+  assert.ok(summary.iteration.p50 <= summary.iteration.p99);
+
+  // Nothing is recorded while stopped, apart from the callback that was
+  // running when stop() was called.
+  setImmediate(function() {
+    snapshot = metrics.snapshot(snapshot);
+    setImmediate(verifyStopped);
+  });
+}
+
+function verifyStopped() {
+  var again = metrics.snapshot(new Float64Array(snapshot.length));
+  assert.deepEqual(Array.prototype.slice.call(again),
+                   Array.prototype.slice.call(snapshot));
+
+  metrics.reset();
+  assert.equal(metrics.summary().iteration.count, 0);
+  assert.equal(metrics.summary().iteration.p99, 0);
+}
+
+setImmediate(spin);
+
+process.on('exit', function() {
+  assert.ok(snapshot);
+});
@@ -0,0 +1,66 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+
+if (process.platform === 'win32') {
+  console.log('Skipping test, the thread pool has no lanes on windows.');
+  process.exit();
+}
+
+var N = 20;
+
+function check(lane) {
+  assert.ok(lane.minThreads >= 1);
+  assert.ok(lane.maxThreads >= lane.minThreads);
+  assert.ok(lane.threads <= lane.maxThreads);
+  assert.ok(lane.idle <= lane.threads);
+  assert.ok(lane.completed <= lane.submitted);
+  assert.ok(lane.maxWaitTime <= lane.waitTime);
+}
+
+var before = process.threadpoolUsage();
+assert.deepEqual(Object.keys(before).sort(), ['cpu', 'dns', 'fs']);
+Object.keys(before).forEach(function(name) {
+  check(before[name]);
+});
+
+// Use readdir, on Linux stat() may bypass the thread pool through io_uring.
+var done = 0;
+for (var i = 0; i < N; i++) {
+  fs.readdir(__dirname, function(err) {
+    if (err) throw err;
+    if (++done < N) return;
+
+    var after = process.threadpoolUsage();
+    check(after.fs);
+    assert.equal(after.fs.submitted - before.fs.submitted, N);
+    assert.equal(after.fs.completed - before.fs.completed, N);
+    assert.equal(after.fs.queued, 0);
+    assert.equal(after.cpu.submitted, before.cpu.submitted);
+  });
+}
+
+process.on('exit', function() {
+  assert.equal(done, N);
+});
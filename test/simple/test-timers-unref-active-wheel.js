@@ -0,0 +1,83 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Timeouts queued with timers._unrefActive live in a native timing wheel.
+// Queue many of them with different durations and check that each one
+// fires once and not early, that restarted ones are pushed back and that
+// unenrolled ones never fire.
+
+var common = require('../common');
+var assert = require('assert');
+var timers = require('timers');
+
+var N = 1000;
+var items = [];
+var fired = 0;
+
+function onTimeout() {
+  var elapsed = Date.now() - this.start;
+  // Date.now() and the loop clock may disagree by a millisecond.
+  assert.ok(elapsed >= this.timeout - 1,
+            'fired after ' + elapsed + 'ms, expected ' + this.timeout + 'ms');
+  assert.ok(!this.fired, 'fired twice');
+  assert.ok(!this.removed, 'unenrolled item fired');
+  this.fired = true;
+  fired++;
+}
+
+for (var i = 0; i < N; i++) {
+  var item = { timeout: 1 + (i * 37) % 300, fired: false, removed: false };
+  item._onTimeout = onTimeout;
+  timers.enroll(item, item.timeout);
+  item.start = Date.now();
+  timers._unrefActive(item);
+  items.push(item);
+}
+
+// Never fires and doesn't keep the process alive.
+var far = { _onTimeout: function() { assert.fail('far timeout fired'); } };
+timers.enroll(far, 3600 * 1000);
+timers._unrefActive(far);
+
+setTimeout(function() {
+  // Unenroll the last 100 items and restart the 100 before them.
+  for (var i = N - 200; i < N; i++) {
+    var item = items[i];
+    if (item.fired) continue;
+    if (i >= N - 100) {
+      item.removed = true;
+      timers.unenroll(item);
+    } else {
+      item.start = Date.now();
+      timers._unrefActive(item);
+    }
+  }
+}, 50);
+
+setTimeout(function() {
+  items.forEach(function(item) {
+    assert.equal(item.fired, !item.removed);
+  });
+}, 700);
+
+process.on('exit', function() {
+  assert.ok(fired > N - 100);
+});
@@ -0,0 +1,74 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if (!process.versions.openssl) {
+  console.error('Skipping because node compiled without OpenSSL.');
+  process.exit(0);
+}
+
+// Writes and a shutdown that wait for a handshake that never finishes are
+// completed with ECANCELED when the socket is destroyed.
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+var tls = require('tls');
+
+var completed = [];
+
+// Never answers the ClientHello.
+var server = net.createServer(function(socket) {
+  socket.on('close', function() {
+    server.close();
+  });
+});
+
+server.listen(common.PORT, function() {
+  var client = tls.connect({
+    port: common.PORT,
+    rejectUnauthorized: false,
+    nativeWrap: true
+  });
+
+  client.on('connect', function() {
+    var handle = client._handle;
+
+    var writeReq = handle.writeUtf8String('queued until the handshake');
+    writeReq.oncomplete = function(status) {
+      completed.push(['write', status, process._errno]);
+    };
+
+    var shutdownReq = handle.shutdown();
+    assert.ok(shutdownReq);
+    shutdownReq.oncomplete = function(status) {
+      completed.push(['shutdown', status, process._errno]);
+    };
+
+    client.destroy();
+  });
+});
+
+process.on('exit', function() {
+  assert.deepEqual(completed, [
+    ['write', -1, 'ECANCELED'],
+    ['shutdown', -1, 'ECANCELED']
+  ]);
+});
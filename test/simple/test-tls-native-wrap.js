@@ -0,0 +1,88 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if (!process.versions.openssl) {
+  console.error('Skipping because node compiled without OpenSSL.');
+  process.exit(0);
+}
+
+var common = require('../common');
+var assert = require('assert');
+var tls = require('tls');
+var fs = require('fs');
+
+var options = {
+  key: fs.readFileSync(common.fixturesDir + '/keys/agent1-key.pem'),
+  cert: fs.readFileSync(common.fixturesDir + '/keys/agent1-cert.pem'),
+  nativeWrap: true
+};
+
+var serverConnections = 0;
+var clientsDone = 0;
+var payload = new Buffer(256 * 1024);
+payload.fill('x');
+
+var server = tls.createServer(options, function(socket) {
+  serverConnections++;
+  assert.equal(socket.authorized, false);
+  assert.ok(socket.getCipher().name);
+  socket.pipe(socket);
+});
+
+function runClient(nativeWrap, cb) {
+  var received = 0;
+  var client = tls.connect({
+    port: common.PORT,
+    rejectUnauthorized: false,
+    nativeWrap: nativeWrap
+  }, function() {
+    var cert = client.getPeerCertificate();
+    assert.equal(cert.subject.CN, 'agent1');
+    assert.equal(client.authorized, false);
+    client.end(payload.slice(1024));
+  });
+
+  // Queued until the handshake is done.
+  client.write(payload.slice(0, 1024));
+
+  client.on('data', function(chunk) {
+    received += chunk.length;
+  });
+
+  client.on('close', function() {
+    assert.equal(received, payload.length);
+    clientsDone++;
+    cb();
+  });
+}
+
+server.listen(common.PORT, function() {
+  runClient(true, function() {
+    runClient(false, function() {
+      server.close();
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(serverConnections, 2);
+  assert.equal(clientsDone, 2);
+});
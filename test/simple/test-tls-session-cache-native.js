@@ -0,0 +1,98 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if (!process.versions.openssl) {
+  console.error('Skipping because node compiled without OpenSSL.');
+  process.exit(0);
+}
+
+var common = require('../common');
+var assert = require('assert');
+var tls = require('tls');
+var fs = require('fs');
+var constants = require('constants');
+
+// Session tickets would let clients resume without the server's cache.
+var options = {
+  key: fs.readFileSync(common.fixturesDir + '/keys/agent1-key.pem'),
+  cert: fs.readFileSync(common.fixturesDir + '/keys/agent1-cert.pem'),
+  secureOptions: constants.SSL_OP_NO_TICKET,
+  sessionCacheSize: 2
+};
+
+var connections = 0;
+var reused = [];
+
+var server = tls.createServer(options, function(cleartext) {
+  connections++;
+  cleartext.end('hello');
+});
+
+function connect(session, cb) {
+  var client = tls.connect({
+    port: common.PORT,
+    rejectUnauthorized: false,
+    session: session
+  }, function() {
+    reused.push(client.isSessionReused());
+    var s = client.getSession();
+    client.on('close', function() {
+      cb(s);
+    });
+  });
+  client.resume();
+}
+
+server.listen(common.PORT, function() {
+  assert.deepEqual(server.getSessionCacheStats(), {
+    capacity: 2,
+    entries: 0,
+    hits: 0,
+    misses: 0,
+    stores: 0,
+    evictions: 0,
+    shared: false
+  });
+
+  connect(null, function(first) {
+    connect(first, function() {
+      // Two more full handshakes push the first session out.
+      connect(null, function() {
+        connect(null, function() {
+          connect(first, function() {
+            server.close();
+          });
+        });
+      });
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(connections, 5);
+  assert.deepEqual(reused, [false, true, false, false, false]);
+
+  var stats = server.getSessionCacheStats();
+  assert.equal(stats.entries, 2);
+  assert.equal(stats.hits, 1);
+  assert.equal(stats.misses, 1);
+  assert.equal(stats.evictions, 2);
+});
@@ -19,31 +19,15 @@
 // OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
-#include "v8.h"
+// Contexts made by vm must not see the core library that
+// --with-core-snapshot compiles into the snapshot.
 
-namespace node {
+var common = require('../common');
+var assert = require('assert');
+var vm = require('vm');
 
-class SlabAllocator {
-public:
-  SlabAllocator(unsigned int size = 10485760); // default to 10M
-  ~SlabAllocator();
-
-  // allocate memory from slab, attaches the slice to `obj`
-  char* Allocate(v8::Handle<v8::Object> obj, unsigned int size);
-
-  // return excess memory to the slab, returns a handle to the parent buffer
-  v8::Local<v8::Object> Shrink(v8::Handle<v8::Object> obj,
-                               char* ptr,
-                               unsigned int size);
-
-private:
-  void Initialize();
-  bool initialized_;
-  v8::Persistent<v8::Object> slab_;
-  v8::Persistent<v8::String> slab_sym_;
-  unsigned int offset_;
-  unsigned int size_;
-  char* last_ptr_;
-};
-
-} // namespace node
+assert.equal(typeof __nodeCore, 'undefined');
+assert.equal(vm.runInNewContext('typeof __nodeCore'), 'undefined');
+assert.equal(vm.runInContext('typeof __nodeCore', vm.createContext()),
+             'undefined');
+assert.equal(vm.runInThisContext('typeof __nodeCore'), 'undefined');
@@ -0,0 +1,104 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var Worker = require('worker').Worker;
+
+var script = path.join(common.fixturesDir, 'worker-echo.js');
+
+var echoed = 0;
+var inverted = false;
+var transferred = false;
+var errors = 0;
+var exitCodes = [];
+
+// Messages, binary data and a clean exit.
+var worker = new Worker(script);
+
+worker.on('message', function(msg) {
+  switch (msg.cmd) {
+    case 'echo':
+      assert.deepEqual(msg.value, { a: [1, 'two', null], b: { c: true } });
+      echoed++;
+      break;
+
+    case 'invert':
+      assert.ok(msg.isBytes);
+      assert.ok(Buffer.isBuffer(msg.data));
+      assert.equal(msg.data.length, 256);
+      for (var i = 0; i < 256; i++)
+        assert.equal(msg.data[i], 255 - i);
+      inverted = true;
+      break;
+
+    case 'transferred':
+      assert.equal(msg.length, 0);
+      transferred = true;
+      // Everything before this has been processed, try an error next.
+      worker.postMessage({ cmd: 'throw' });
+      break;
+  }
+});
+
+worker.on('error', function(err) {
+  assert.ok(/boom/.test(err.message));
+  assert.ok(/worker-echo\.js/.test(err.stack));
+  errors++;
+  // The worker survives exceptions thrown by onmessage.
+  worker.postMessage({ cmd: 'echo', value: { a: [1, 'two', null], b: { c: true } } });
+  worker.postMessage({ cmd: 'close' });
+});
+
+worker.on('exit', function(code) {
+  exitCodes.push(code);
+});
+
+var data = new Buffer(256);
+for (var i = 0; i < 256; i++) data[i] = i;
+
+worker.postMessage({ cmd: 'echo', value: { a: [1, 'two', null], b: { c: true } } });
+worker.postMessage({ cmd: 'invert', data: data });
+
+// terminate() stops a worker that is stuck in a loop.
+var spinner = new Worker(script);
+
+spinner.on('message', function(msg) {
+  assert.equal(msg.cmd, 'spinning');
+  spinner.terminate();
+});
+
+spinner.on('exit', function(code) {
+  exitCodes.push(code);
+  // Dropped, not thrown.
+  spinner.postMessage({ cmd: 'echo' });
+});
+
+spinner.postMessage({ cmd: 'spin' });
+
+process.on('exit', function() {
+  assert.equal(echoed, 2);
+  assert.ok(inverted);
+  assert.ok(transferred);
+  assert.equal(errors, 1);
+  assert.deepEqual(exitCodes.sort(), [0, 1]);
+});
@@ -0,0 +1,113 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var zlib = require('zlib');
+
+var input = new Buffer(new Array(200).join('synchronous zlib '));
+
+// Round trip through every pair of synchronous methods.
+[
+  ['deflateSync', 'inflateSync'],
+  ['deflateSync', 'unzipSync'],
+  ['gzipSync', 'gunzipSync'],
+  ['gzipSync', 'unzipSync'],
+  ['deflateRawSync', 'inflateRawSync']
+].forEach(function(pair) {
+  var compressed = zlib[pair[0]](input);
+  assert.ok(Buffer.isBuffer(compressed));
+  assert.ok(compressed.length < input.length);
+  assert.equal(zlib[pair[1]](compressed).toString(), input.toString(),
+               pair.join(' -> '));
+});
+
+assert.equal(zlib.inflateSync(zlib.deflateSync('a string')).toString(),
+             'a string');
+
+assert.throws(function() {
+  zlib.gunzipSync(new Buffer('this is not valid compressed data.'));
+}, /incorrect header check/);
+
+// Engines that fail are closed too, their state goes back to the pool and
+// must come out of it clean.
+var gzipped = zlib.gzipSync(input);
+for (var i = 0; i < 20; i++) {
+  assert.throws(function() {
+    zlib.gunzipSync(new Buffer('not compressed ' + i));
+  }, /incorrect header check/);
+  assert.equal(zlib.gunzipSync(gzipped).toString(), input.toString());
+}
+
+assert.throws(function() {
+  zlib.inflateSync(1);
+}, TypeError);
+
+assert.throws(function() {
+  zlib.createGzip({ syncThreshold: -1 });
+}, /Invalid syncThreshold/);
+
+// Streams produce the same output whether their small chunks are
+// processed on the main thread or in the thread pool.
+function gzipChunks(threshold, callback) {
+  var gzip = zlib.createGzip({ syncThreshold: threshold });
+  var buffers = [];
+  gzip.on('data', function(chunk) {
+    buffers.push(chunk);
+  });
+  gzip.on('end', function() {
+    callback(Buffer.concat(buffers));
+  });
+  for (var i = 0; i < input.length; i += 100)
+    gzip.write(input.slice(i, i + 100));
+  gzip.end();
+}
+
+var streamed = 0;
+gzipChunks(1024, function(onThread) {
+  gzipChunks(0, function(inPool) {
+    assert.equal(onThread.toString('hex'), inPool.toString('hex'));
+    assert.equal(zlib.gunzipSync(onThread).toString(), input.toString());
+    streamed++;
+  });
+});
+
+// Closed streams hand their state to the next one; the output must not
+// depend on what the previous user of that state did.
+var first = zlib.deflateSync(input);
+for (var i = 0; i < 20; i++) {
+  zlib.inflateSync(zlib.deflateSync(new Buffer('unrelated ' + i)));
+  assert.equal(zlib.deflateSync(input).toString('hex'),
+               first.toString('hex'));
+}
+
+// Small stream writes that fail still report the error asynchronously.
+var gunzip = zlib.createGunzip();
+var hadError = false;
+gunzip.write('this is not valid compressed data either.');
+gunzip.on('error', function(err) {
+  hadError = true;
+});
+
+process.on('exit', function() {
+  assert.equal(streamed, 1);
+  assert.ok(hadError);
+});
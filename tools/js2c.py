@@ -363,10 +363,69 @@ def JS2C(source, target):
     })
     output.close()
 
+SNAPSHOT_HEADER = """\
+// Generated by tools/js2c.py, do not edit. Input for mksnapshot --extra_code,
+// every '// @script' line starts a script of its own. src/node.js finds the
+// compiled modules in __nodeCore.
+Object.defineProperty(this, '__nodeCore', { value: {}, configurable: true });
+"""
+
+# Same wrapper as NativeModule.wrap() in src/node.js, so line numbers in
+# stack traces don't change. It is passed as an argument rather than
+# assigned, or V8 would prefix '__nodeCore.<id>.' to every inferred
+# function name in the module.
+SNAPSHOT_MODULE = """\
+// @script %(id)s.js
+(function (f) { __nodeCore['%(id)s'] = f; })(\
+function (exports, require, module, __filename, __dirname) { %(source)s
+});
+"""
+
+# src/node.js evaluates to the bootstrap function.
+SNAPSHOT_MAIN = """\
+// @script node.js
+(function (f) { __nodeCore['node'] = f; })(%(source)s);
+"""
+
+# Only loaded by the REPL and the debugger; leaving them out keeps the
+# snapshot spaces within one page, see SizeOfFirstPage() in V8.
+SNAPSHOT_SKIP = ['_debugger', 'readline', 'repl']
+
+def JS2Snapshot(source, target):
+  macro_lines = []
+  modules = []
+
+  for s in source:
+    if (os.path.split(str(s))[1]).endswith('macros.py'):
+      macro_lines.extend(ReadLines(str(s)))
+    elif str(s).endswith('.js'):
+      if os.path.basename(str(s)).split('.')[0] not in SNAPSHOT_SKIP:
+        modules.append(s)
+
+  (consts, macros) = ReadMacros(macro_lines)
+
+  output = open(str(target[0]), "w")
+  output.write(SNAPSHOT_HEADER)
+  for s in modules:
+    lines = ReadFile(str(s))
+    lines = ExpandConstants(lines, consts)
+    lines = ExpandMacros(lines, macros)
+    id = os.path.basename(str(s)).split('.')[0]
+    if id == 'node':
+      template = SNAPSHOT_MAIN
+      lines = lines.rstrip().rstrip(';')
+    else:
+      template = SNAPSHOT_MODULE
+    output.write(template % { 'id': id, 'source': lines })
+  output.close()
+
 def main():
   natives = sys.argv[1]
   source_files = sys.argv[2:]
-  JS2C(source_files, [natives])
+  if natives.endswith('.js'):
+    JS2Snapshot(source_files, [natives])
+  else:
+    JS2C(source_files, [natives])
 
 if __name__ == "__main__":
   main()